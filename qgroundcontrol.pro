@@ -470,6 +470,10 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory { APMFirmwarePlugin {
         src/qgcunittest
 
     HEADERS += \
+        src/AnalyzeView/GeoTagControllerTest.h \
+        src/AnalyzeView/LogAnalysisStoreTest.h \
+        src/AnalyzeView/MAVLinkTimeSeriesTest.h \
+        src/AnalyzeView/ULogReaderTest.h \
         src/Audio/AudioOutputTest.h \
         src/FactSystem/FactSystemTestBase.h \
         src/FactSystem/FactSystemTestGeneric.h \
@@ -504,21 +508,31 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory { APMFirmwarePlugin {
         src/qgcunittest/MavlinkLogTest.h \
         src/qgcunittest/MultiSignalSpy.h \
         src/qgcunittest/MultiSignalSpyV2.h \
+        src/qgcunittest/QGCTileCacheWorkerTest.h \
+        src/qgcunittest/QGCTileDownloadSchedulerTest.h \
+        src/qgcunittest/QGCTilePrefetcherTest.h \
+        src/qgcunittest/TerrainQueryCacheTest.h \
+        src/qgcunittest/TerrainQueryTest.h \
         src/qgcunittest/UnitTest.h \
         src/Vehicle/FTPManagerTest.h \
+        src/Vehicle/InitialConnectProfileTest.h \
         src/Vehicle/InitialConnectTest.h \
         src/Vehicle/RequestMessageTest.h \
         src/Vehicle/SendMavCommandWithHandlerTest.h \
         src/Vehicle/SendMavCommandWithSignallingTest.h \
         src/Vehicle/VehicleLinkManagerTest.h \
         #src/qgcunittest/RadioConfigTest.h \
-        #src/AnalyzeView/LogDownloadTest.h \
+        src/AnalyzeView/LogDownloadTest.h \
         #src/qgcunittest/FileDialogTest.h \
         #src/qgcunittest/FileManagerTest.h \
         #src/qgcunittest/MainWindowTest.h \
         #src/qgcunittest/MessageBoxTest.h \
 
     SOURCES += \
+        src/AnalyzeView/GeoTagControllerTest.cc \
+        src/AnalyzeView/LogAnalysisStoreTest.cc \
+        src/AnalyzeView/MAVLinkTimeSeriesTest.cc \
+        src/AnalyzeView/ULogReaderTest.cc \
         src/Audio/AudioOutputTest.cc \
         src/FactSystem/FactSystemTestBase.cc \
         src/FactSystem/FactSystemTestGeneric.cc \
@@ -553,16 +567,22 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory { APMFirmwarePlugin {
         src/qgcunittest/MavlinkLogTest.cc \
         src/qgcunittest/MultiSignalSpy.cc \
         src/qgcunittest/MultiSignalSpyV2.cc \
+        src/qgcunittest/QGCTileCacheWorkerTest.cc \
+        src/qgcunittest/QGCTileDownloadSchedulerTest.cc \
+        src/qgcunittest/QGCTilePrefetcherTest.cc \
+        src/qgcunittest/TerrainQueryCacheTest.cc \
+        src/qgcunittest/TerrainQueryTest.cc \
         src/qgcunittest/UnitTest.cc \
         src/qgcunittest/UnitTestList.cc \
         src/Vehicle/FTPManagerTest.cc \
+        src/Vehicle/InitialConnectProfileTest.cc \
         src/Vehicle/InitialConnectTest.cc \
         src/Vehicle/RequestMessageTest.cc \
         src/Vehicle/SendMavCommandWithHandlerTest.cc \
         src/Vehicle/SendMavCommandWithSignallingTest.cc \
         src/Vehicle/VehicleLinkManagerTest.cc \
         #src/qgcunittest/RadioConfigTest.cc \
-        #src/AnalyzeView/LogDownloadTest.cc \
+        src/AnalyzeView/LogDownloadTest.cc \
         #src/qgcunittest/FileDialogTest.cc \
         #src/qgcunittest/FileManagerTest.cc \
         #src/qgcunittest/MainWindowTest.cc \
@@ -575,9 +595,12 @@ DebugBuild { PX4FirmwarePlugin { PX4FirmwarePluginFactory { APMFirmwarePlugin {
 HEADERS += \
     src/ADSB/ADSBVehicle.h \
     src/ADSB/ADSBVehicleManager.h \
+    src/AnalyzeView/LogAnalysisStore.h \
     src/AnalyzeView/LogDownloadController.h \
+    src/AnalyzeView/MAVLinkTimeSeries.h \
     src/AnalyzeView/PX4LogParser.h \
     src/AnalyzeView/ULogParser.h \
+    src/AnalyzeView/ULogReader.h \
     src/AnalyzeView/MavlinkConsoleController.h \
     src/Audio/AudioOutput.h \
     src/Vehicle/Autotune.h \
@@ -613,6 +636,7 @@ HEADERS += \
     src/MissionManager/MissionCommandUIInfo.h \
     src/MissionManager/MissionController.h \
     src/MissionManager/MissionItem.h \
+    src/MissionManager/MissionItemStore.h \
     src/MissionManager/MissionManager.h \
     src/MissionManager/MissionSettingsItem.h \
     src/MissionManager/PlanElementController.h \
@@ -699,6 +723,7 @@ HEADERS += \
     src/ShapeFileHelper.h \
     src/SHPFileHelper.h \
     src/Terrain/TerrainQuery.h \
+    src/Terrain/TerrainQueryCache.h \
     src/TerrainTile.h \
     src/Vehicle/Actuators/ActuatorActions.h \
     src/Vehicle/Actuators/Actuators.h \
@@ -721,6 +746,7 @@ HEADERS += \
     src/Vehicle/GPSRTKFactGroup.h \
     src/Vehicle/HealthAndArmingCheckReport.h \
     src/Vehicle/ImageProtocolManager.h \
+    src/Vehicle/InitialConnectProfile.h \
     src/Vehicle/InitialConnectStateMachine.h \
     src/Vehicle/MAVLinkLogManager.h \
     src/Vehicle/MAVLinkStreamConfig.h \
@@ -840,9 +866,12 @@ AndroidBuild {
 SOURCES += \
     src/ADSB/ADSBVehicle.cc \
     src/ADSB/ADSBVehicleManager.cc \
+    src/AnalyzeView/LogAnalysisStore.cc \
     src/AnalyzeView/LogDownloadController.cc \
+    src/AnalyzeView/MAVLinkTimeSeries.cc \
     src/AnalyzeView/PX4LogParser.cc \
     src/AnalyzeView/ULogParser.cc \
+    src/AnalyzeView/ULogReader.cc \
     src/AnalyzeView/MavlinkConsoleController.cc \
     src/Audio/AudioOutput.cc \
     src/Vehicle/Autotune.cpp \
@@ -877,6 +906,7 @@ SOURCES += \
     src/MissionManager/MissionCommandUIInfo.cc \
     src/MissionManager/MissionController.cc \
     src/MissionManager/MissionItem.cc \
+    src/MissionManager/MissionItemStore.cc \
     src/MissionManager/MissionManager.cc \
     src/MissionManager/MissionSettingsItem.cc \
     src/MissionManager/PlanElementController.cc \
@@ -960,6 +990,7 @@ SOURCES += \
     src/ShapeFileHelper.cc \
     src/SHPFileHelper.cc \
     src/Terrain/TerrainQuery.cc \
+    src/Terrain/TerrainQueryCache.cc \
     src/TerrainTile.cc\
     src/Vehicle/Actuators/ActuatorActions.cc \
     src/Vehicle/Actuators/Actuators.cc \
@@ -982,6 +1013,7 @@ SOURCES += \
     src/Vehicle/GPSRTKFactGroup.cc \
     src/Vehicle/HealthAndArmingCheckReport.cc \
     src/Vehicle/ImageProtocolManager.cc \
+    src/Vehicle/InitialConnectProfile.cc \
     src/Vehicle/InitialConnectStateMachine.cc \
     src/Vehicle/MAVLinkLogManager.cc \
     src/Vehicle/MAVLinkStreamConfig.cc \
@@ -1289,14 +1321,16 @@ SOURCES += \
     src/FactSystem/SettingsFact.cc \
 
 #-------------------------------------------------------------------------------------
-# MAVLink Inspector
+# MAVLink Inspector and Log Analysis, both chart with QtCharts
 
 contains (DEFINES, QGC_DISABLE_MAVLINK_INSPECTOR) {
-    message("Disable mavlink inspector")
+    message("Disable mavlink inspector and log analysis")
 } else {
     HEADERS += \
+        src/AnalyzeView/LogAnalysisController.h \
         src/AnalyzeView/MAVLinkInspectorController.h
     SOURCES += \
+        src/AnalyzeView/LogAnalysisController.cc \
         src/AnalyzeView/MAVLinkInspectorController.cc
     QT += \
         charts
@@ -13,6 +13,41 @@ ExifParser::~ExifParser()
 
 }
 
+bool ExifParser::readHeader(QIODevice& device, QByteArray& header)
+{
+    // Exif data is normally the first segment, some cameras put a JFIF APP0 in front of it
+    static const int maxHeaderSize = 256 * 1024;
+
+    header = device.read(2);
+    if (header != QByteArray("\xff\xd8", 2)) {
+        return false;
+    }
+
+    while (header.size() < maxHeaderSize) {
+        QByteArray segmentHeader = device.read(4);
+        if (segmentHeader.size() != 4 || static_cast<uint8_t>(segmentHeader[0]) != 0xff) {
+            return false;
+        }
+        uint8_t marker = static_cast<uint8_t>(segmentHeader[1]);
+        if (marker == 0xda || marker == 0xd9) {
+            // Start of scan or end of image, there is no Exif segment
+            return false;
+        }
+        int segmentSize = qFromBigEndian<quint16>(reinterpret_cast<const uchar*>(segmentHeader.constData() + 2)) - 2;
+        QByteArray segment = device.read(segmentSize);
+        if (segment.size() != segmentSize) {
+            return false;
+        }
+        header.append(segmentHeader);
+        header.append(segment);
+        if (marker == 0xe1 && segment.startsWith(QByteArray("Exif\0\0", 6))) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 double ExifParser::readTime(QByteArray& buf)
 {
     QByteArray tiffHeader("\x49\x49\x2A", 3);
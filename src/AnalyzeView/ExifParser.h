@@ -3,6 +3,7 @@
 
 #include <QGeoCoordinate>
 #include <QDebug>
+#include <QIODevice>
 
 #include "GeoTagController.h"
 
@@ -11,6 +12,9 @@ class ExifParser
 public:
     ExifParser();
     ~ExifParser();
+    /// Reads the start of a JPEG file up to and including the Exif APP1 segment. The tags are read and written
+    /// from that part only, the compressed image data which follows is not needed.
+    bool readHeader(QIODevice& device, QByteArray& header);
     double readTime(QByteArray& buf);
     bool write(QByteArray& buf, GeoTagWorker::cameraFeedbackPacket& geotag);
 };
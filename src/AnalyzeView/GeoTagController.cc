@@ -13,8 +13,10 @@
 #include <QtEndian>
 #include <QDebug>
 #include <cfloat>
+#include <limits>
 #include <QDir>
 #include <QUrl>
+#include <QtConcurrent>
 
 #include "ExifParser.h"
 #include "ULogParser.h"
@@ -161,20 +163,22 @@ void GeoTagWorker::run()
     emit progressChanged((100/nSteps));
 
     // Parse EXIF
-    ExifParser exifParser;
+    QStringList imagePaths;
+    for (const QFileInfo& imageInfo: _imageList) {
+        imagePaths.append(imageInfo.absoluteFilePath());
+    }
     _imageTime.clear();
-    for (int i = 0; i < _imageList.size(); ++i) {
-        QFile file(_imageList.at(i).absoluteFilePath());
-        if (!file.open(QIODevice::ReadOnly)) {
-            emit error(tr("Geotagging failed. Couldn't open an image."));
-            return;
+    for (int batchStart = 0; batchStart < imagePaths.count(); batchStart += _batchSize()) {
+        QList<double> batchImageTimes = QtConcurrent::blockingMapped<QList<double>>(imagePaths.mid(batchStart, _batchSize()), &GeoTagWorker::readImageTime);
+        for (double imageTime: batchImageTimes) {
+            if (qIsNaN(imageTime)) {
+                emit error(tr("Geotagging failed. Couldn't open an image."));
+                return;
+            }
         }
-        QByteArray imageBuffer = file.readAll();
-        file.close();
-
-        _imageTime.append(exifParser.readTime(imageBuffer));
+        _imageTime.append(batchImageTimes);
 
-        emit progressChanged((100/nSteps) + ((100/nSteps) / _imageList.size())*i);
+        emit progressChanged((100/nSteps) + ((100/nSteps) / _imageList.size())*(batchStart + batchImageTimes.count()));
 
         if (_cancel) {
             qCDebug(GeotaggingLog) << "Tagging cancelled";
@@ -183,28 +187,35 @@ void GeoTagWorker::run()
         }
     }
 
-    // Load log
+    // Load log, the log is memory mapped instead of being read into memory since it can be GBs in size
     bool isULog = _logFile.endsWith(".ulg", Qt::CaseSensitive);
     QFile file(_logFile);
     if (!file.open(QIODevice::ReadOnly)) {
         emit error(tr("Geotagging failed. Couldn't open log file."));
         return;
     }
-    QByteArray log = file.readAll();
-    file.close();
 
     // Instantiate appropriate parser
     _triggerList.clear();
     bool parseComplete = false;
     QString errorString;
     if (isULog) {
+        file.close();
         ULogParser parser;
-        parseComplete = parser.getTagsFromLog(log, _triggerList, errorString);
+        parseComplete = parser.getTagsFromLog(_logFile, _triggerList, errorString);
 
     } else {
+        uchar* logData = file.size() <= std::numeric_limits<int>::max() ? file.map(0, file.size()) : nullptr;
+        if (!logData) {
+            emit error(tr("Geotagging failed. Couldn't open log file."));
+            return;
+        }
+        // PX4LogParser only reads from the log so it can work directly on the mapping
+        QByteArray log = QByteArray::fromRawData(reinterpret_cast<const char*>(logData), static_cast<int>(file.size()));
         PX4LogParser parser;
         parseComplete = parser.getTagsFromLog(log, _triggerList);
-
+        file.unmap(logData);
+        file.close();
     }
 
     if (!parseComplete) {
@@ -246,38 +257,32 @@ void GeoTagWorker::run()
     // Tag images
     int maxIndex = std::min(_imageIndices.count(), _triggerIndices.count());
     maxIndex = std::min(maxIndex, _imageList.count());
+    QList<TagJob_t> tagJobs;
     for(int i = 0; i < maxIndex; i++) {
         int imageIndex = _imageIndices[i];
         if (imageIndex >= _imageList.count()) {
             emit error(tr("Geotagging failed. Requesting image #%1, but only %2 images present.").arg(imageIndex).arg(_imageList.count()));
             return;
         }
-        QFile fileRead(_imageList.at(_imageIndices[i]).absoluteFilePath());
-        if (!fileRead.open(QIODevice::ReadOnly)) {
-            emit error(tr("Geotagging failed. Couldn't open an image."));
-            return;
-        }
-        QByteArray imageBuffer = fileRead.readAll();
-        fileRead.close();
-
-        if (!exifParser.write(imageBuffer, _triggerList[_triggerIndices[i]])) {
-            emit error(tr("Geotagging failed. Couldn't write to image."));
-            return;
+        TagJob_t tagJob;
+        tagJob.imagePath = _imageList.at(imageIndex).absoluteFilePath();
+        if(_saveDirectory == "") {
+            tagJob.taggedImagePath = _imageDirectory + "/TAGGED/" + _imageList.at(imageIndex).fileName();
         } else {
-            QFile fileWrite;
-            if(_saveDirectory == "") {
-                fileWrite.setFileName(_imageDirectory + "/TAGGED/" + _imageList.at(_imageIndices[i]).fileName());
-            } else {
-                fileWrite.setFileName(_saveDirectory + "/" + _imageList.at(_imageIndices[i]).fileName());
-            }
-            if (!fileWrite.open(QFile::WriteOnly)) {
-                emit error(tr("Geotagging failed. Couldn't write to an image."));
+            tagJob.taggedImagePath = _saveDirectory + "/" + _imageList.at(imageIndex).fileName();
+        }
+        tagJob.geotag = _triggerList[_triggerIndices[i]];
+        tagJobs.append(tagJob);
+    }
+    for (int batchStart = 0; batchStart < tagJobs.count(); batchStart += _batchSize()) {
+        QStringList batchErrors = QtConcurrent::blockingMapped<QStringList>(tagJobs.mid(batchStart, _batchSize()), &GeoTagWorker::_tagImageJob);
+        for (const QString& errorString: batchErrors) {
+            if (!errorString.isEmpty()) {
+                emit error(errorString);
                 return;
             }
-            fileWrite.write(imageBuffer);
-            fileWrite.close();
         }
-        emit progressChanged(4*(100/nSteps) + ((100/nSteps) / maxIndex)*i);
+        emit progressChanged(4*(100/nSteps) + ((100/nSteps) / maxIndex)*(batchStart + batchErrors.count()));
 
         if (_cancel) {
             qCDebug(GeotaggingLog) << "Tagging cancelled";
@@ -295,6 +300,59 @@ void GeoTagWorker::run()
     emit progressChanged(100);
 }
 
+double GeoTagWorker::readImageTime(const QString& imagePath)
+{
+    QFile file(imagePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return qQNaN();
+    }
+
+    ExifParser  exifParser;
+    QByteArray  exifHeader;
+    if (!exifParser.readHeader(file, exifHeader)) {
+        qCDebug(GeotaggingLog) << "No Exif header found" << imagePath;
+        return -1.0;
+    }
+
+    return exifParser.readTime(exifHeader);
+}
+
+QString GeoTagWorker::tagImage(const QString& imagePath, const QString& taggedImagePath, const cameraFeedbackPacket& geotag)
+{
+    QFile fileRead(imagePath);
+    if (!fileRead.open(QIODevice::ReadOnly)) {
+        return tr("Geotagging failed. Couldn't open an image.");
+    }
+
+    ExifParser              exifParser;
+    QByteArray              exifHeader;
+    cameraFeedbackPacket    writeGeotag = geotag;
+    if (!exifParser.readHeader(fileRead, exifHeader) || !exifParser.write(exifHeader, writeGeotag)) {
+        return tr("Geotagging failed. Couldn't write to image.");
+    }
+
+    QFile fileWrite(taggedImagePath);
+    if (!fileWrite.open(QFile::WriteOnly) || fileWrite.write(exifHeader) != exifHeader.size()) {
+        return tr("Geotagging failed. Couldn't write to an image.");
+    }
+
+    // Copy the image data which follows the Exif header unchanged
+    static const qint64 copyChunkSize = 1024 * 1024;
+    while (!fileRead.atEnd()) {
+        QByteArray chunk = fileRead.read(copyChunkSize);
+        if (chunk.isEmpty() || fileWrite.write(chunk) != chunk.size()) {
+            return tr("Geotagging failed. Couldn't write to an image.");
+        }
+    }
+
+    return QString();
+}
+
+QString GeoTagWorker::_tagImageJob(const TagJob_t& job)
+{
+    return tagImage(job.imagePath, job.taggedImagePath, job.geotag);
+}
+
 bool GeoTagWorker::triggerFiltering()
 {
     _imageIndices.clear();
@@ -50,6 +50,15 @@ public:
         uint8_t captureResult;
     };
 
+    /// Reads the capture time from the Exif data of an image. Only the Exif header is read from the file.
+    /// @return Capture time in seconds since epoch, -1 if it could not be decoded, NaN if the file could not be read
+    static double readImageTime(const QString& imagePath);
+
+    /// Writes a copy of an image with the geotag added to the Exif data. The image data following the Exif header
+    /// is streamed across without loading the whole file.
+    /// @return Empty string on success, error message otherwise
+    static QString tagImage(const QString& imagePath, const QString& taggedImagePath, const cameraFeedbackPacket& geotag);
+
 protected:
     void run() final;
 
@@ -59,7 +68,17 @@ signals:
     void progressChanged    (double progress);
 
 private:
+    typedef struct {
+        QString                 imagePath;
+        QString                 taggedImagePath;
+        cameraFeedbackPacket    geotag;
+    } TagJob_t;
+
     bool triggerFiltering();
+    static QString _tagImageJob(const TagJob_t& job);
+
+    /// Images are processed in batches across all cores, progress and cancel are checked between batches
+    static int _batchSize() { return QThread::idealThreadCount() * 4; }
 
     bool                    _cancel;
     QString                 _logFile;
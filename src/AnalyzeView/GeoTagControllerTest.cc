@@ -0,0 +1,176 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "GeoTagControllerTest.h"
+#include "ExifParser.h"
+
+#include <QTemporaryDir>
+#include <QElapsedTimer>
+#include <QDateTime>
+#include <QtEndian>
+#include <QtConcurrent>
+
+const char* GeoTagControllerTest::_testImageTime = "2020:01:02 03:04:05";
+
+/// Writes a JPEG with the minimal Exif layout ExifParser expects followed by imageDataSize bytes of image data
+void GeoTagControllerTest::_writeTestImage(const QString& imagePath, int imageDataSize)
+{
+    // Offsets are relative to the start of the TIFF header
+    static const int dateOffset     = 0x30;
+    static const int nextIfdOffset  = 0x50;
+    static const int tiffSize       = 0x70;
+
+    QByteArray tiff(tiffSize, 0);
+    tiff.replace(0, 4, "II*\0", 4);
+    qToLittleEndian<quint32>(8, tiff.data() + 4);
+    // IFD0 with a single DateTimeDigitized entry
+    qToLittleEndian<quint16>(1, tiff.data() + 8);
+    qToLittleEndian<quint16>(0x9004, tiff.data() + 10);
+    qToLittleEndian<quint16>(2, tiff.data() + 12);
+    qToLittleEndian<quint32>(20, tiff.data() + 14);
+    qToLittleEndian<quint32>(dateOffset, tiff.data() + 18);
+    qToLittleEndian<quint32>(nextIfdOffset, tiff.data() + 22);
+    // Image description padding which ExifParser::write makes room in
+    tiff.replace(26, dateOffset - 26, QByteArray(dateOffset - 26, ' '));
+    tiff.replace(dateOffset, 20, QByteArray(_testImageTime, 20));
+
+    QByteArray app1Payload = QByteArray("Exif\0\0", 6) + tiff;
+    QByteArray app1Length(2, 0);
+    qToBigEndian<quint16>(static_cast<quint16>(app1Payload.size() + 2), app1Length.data());
+
+    QByteArray image("\xff\xd8\xff\xe1", 4);
+    image += app1Length;
+    image += app1Payload;
+    image += QByteArray("\xff\xda", 2);
+    for (int i=0; i<imageDataSize; i++) {
+        image += static_cast<char>((i * 7) & 0x7f);
+    }
+    image += QByteArray("\xff\xd9", 2);
+
+    QFile file(imagePath);
+    QVERIFY(file.open(QFile::WriteOnly));
+    QCOMPARE(file.write(image), static_cast<qint64>(image.size()));
+}
+
+GeoTagWorker::cameraFeedbackPacket GeoTagControllerTest::_testGeotag(int index)
+{
+    GeoTagWorker::cameraFeedbackPacket geotag;
+
+    memset(&geotag, 0, sizeof(geotag));
+    geotag.imageSequence    = static_cast<uint32_t>(index);
+    geotag.latitude         = 47.3764 + (index * 0.0001);
+    geotag.longitude        = 8.5481 - (index * 0.0001);
+    geotag.altitude         = 400.0f + index;
+
+    return geotag;
+}
+
+/// Tags IMG_<index>.jpg into the parallel subdirectory for the benchmark
+QString GeoTagControllerTest::_tagBenchmarkImage(const QString& imagePath)
+{
+    QFileInfo imageInfo(imagePath);
+    int index = imageInfo.baseName().mid(4).toInt();
+
+    return GeoTagWorker::tagImage(imagePath, imageInfo.dir().filePath("parallel/" + imageInfo.fileName()), _testGeotag(index));
+}
+
+void GeoTagControllerTest::_readImageTime_test(void)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    QString imagePath = tempDir.filePath("image.jpg");
+    _writeTestImage(imagePath, 1024);
+
+    double expectedTime = QDateTime::fromString(_testImageTime, "yyyy:MM:dd hh:mm:ss").toMSecsSinceEpoch() / 1000.0;
+    QCOMPARE(GeoTagWorker::readImageTime(imagePath), expectedTime);
+
+    QVERIFY(qIsNaN(GeoTagWorker::readImageTime(tempDir.filePath("missing.jpg"))));
+}
+
+void GeoTagControllerTest::_tagImage_test(void)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    // Streamed tagging must produce the same file as tagging the whole file in memory
+    QString imagePath = tempDir.filePath("image.jpg");
+    QString taggedImagePath = tempDir.filePath("tagged.jpg");
+    _writeTestImage(imagePath, 3 * 1024 * 1024);
+
+    GeoTagWorker::cameraFeedbackPacket geotag = _testGeotag(1);
+    QCOMPARE(GeoTagWorker::tagImage(imagePath, taggedImagePath, geotag), QString());
+
+    QFile imageFile(imagePath);
+    QVERIFY(imageFile.open(QFile::ReadOnly));
+    QByteArray expectedImage = imageFile.readAll();
+    ExifParser exifParser;
+    QVERIFY(exifParser.write(expectedImage, geotag));
+
+    QFile taggedImageFile(taggedImagePath);
+    QVERIFY(taggedImageFile.open(QFile::ReadOnly));
+    QVERIFY(taggedImageFile.readAll() == expectedImage);
+}
+
+void GeoTagControllerTest::_tagImageSetBenchmark_test(void)
+{
+    const int cImages       = 100;
+    const int imageDataSize = 512 * 1024;
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QDir dir(tempDir.path());
+    QVERIFY(dir.mkdir("serial"));
+    QVERIFY(dir.mkdir("parallel"));
+
+    QStringList imagePaths;
+    for (int i=0; i<cImages; i++) {
+        imagePaths.append(tempDir.filePath(QStringLiteral("IMG_%1.jpg").arg(i, 4, 10, QChar('0'))));
+        _writeTestImage(imagePaths.last(), imageDataSize);
+    }
+
+    // Previous implementation: whole files loaded twice, one image at a time
+    QElapsedTimer timer;
+    timer.start();
+    for (int i=0; i<cImages; i++) {
+        QFile fileRead(imagePaths[i]);
+        QVERIFY(fileRead.open(QFile::ReadOnly));
+        QByteArray imageBuffer = fileRead.readAll();
+        fileRead.close();
+        ExifParser().readTime(imageBuffer);
+
+        QVERIFY(fileRead.open(QFile::ReadOnly));
+        imageBuffer = fileRead.readAll();
+        GeoTagWorker::cameraFeedbackPacket geotag = _testGeotag(i);
+        QVERIFY(ExifParser().write(imageBuffer, geotag));
+        QFile fileWrite(tempDir.filePath("serial/" + QFileInfo(imagePaths[i]).fileName()));
+        QVERIFY(fileWrite.open(QFile::WriteOnly));
+        fileWrite.write(imageBuffer);
+    }
+    qint64 serialMsecs = timer.elapsed();
+
+    // Same steps as GeoTagWorker::run
+    timer.restart();
+    QList<double> imageTimes = QtConcurrent::blockingMapped<QList<double>>(imagePaths, &GeoTagWorker::readImageTime);
+    QStringList errors = QtConcurrent::blockingMapped<QStringList>(imagePaths, &GeoTagControllerTest::_tagBenchmarkImage);
+    qint64 parallelMsecs = timer.elapsed();
+
+    qDebug() << "Geotagging" << cImages << "images serial:parallel msecs" << serialMsecs << parallelMsecs;
+
+    QCOMPARE(imageTimes.count(), cImages);
+    for (int i=0; i<cImages; i++) {
+        QCOMPARE(errors[i], QString());
+
+        QFile serialFile(tempDir.filePath("serial/" + QFileInfo(imagePaths[i]).fileName()));
+        QFile parallelFile(tempDir.filePath("parallel/" + QFileInfo(imagePaths[i]).fileName()));
+        QVERIFY(serialFile.open(QFile::ReadOnly));
+        QVERIFY(parallelFile.open(QFile::ReadOnly));
+        QVERIFY(serialFile.readAll() == parallelFile.readAll());
+    }
+}
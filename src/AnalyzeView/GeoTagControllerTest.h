@@ -0,0 +1,30 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "GeoTagController.h"
+
+class GeoTagControllerTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _readImageTime_test(void);
+    void _tagImage_test(void);
+    void _tagImageSetBenchmark_test(void);
+
+private:
+    void _writeTestImage(const QString& imagePath, int imageDataSize);
+    static GeoTagWorker::cameraFeedbackPacket _testGeotag(int index);
+    static QString _tagBenchmarkImage(const QString& imagePath);
+
+    static const char* _testImageTime;
+};
@@ -0,0 +1,149 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LogAnalysisController.h"
+
+#include <QUrl>
+#include <QElapsedTimer>
+#include <QtConcurrent>
+#include <QtCharts/QXYSeries>
+
+QGC_LOGGING_CATEGORY(LogAnalysisLog, "LogAnalysisLog")
+
+QT_CHARTS_USE_NAMESPACE
+
+Q_DECLARE_METATYPE(QAbstractSeries*)
+
+LogAnalysisController::LogAnalysisController(void)
+{
+    connect(&_loadWatcher, &QFutureWatcher<LoadResult_t>::finished, this, &LogAnalysisController::_loadFinished);
+}
+
+LogAnalysisController::~LogAnalysisController()
+{
+    _loadWatcher.waitForFinished();
+}
+
+void LogAnalysisController::setLogFile(QString logFile)
+{
+    logFile = QUrl(logFile).toLocalFile();
+    if (logFile.isEmpty() || loading()) {
+        return;
+    }
+
+    _logFile = logFile;
+    emit logFileChanged(_logFile);
+    _setErrorMessage(QString());
+
+    _loadWatcher.setFuture(QtConcurrent::run(&LogAnalysisController::_loadLog, _logFile));
+    emit loadingChanged();
+}
+
+LogAnalysisController::LoadResult_t LogAnalysisController::_loadLog(const QString& logFile)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    LoadResult_t result;
+    result.store.reset(new LogAnalysisStore);
+    if (!result.store->load(logFile, result.errorString)) {
+        result.store.reset();
+    } else {
+        qCDebug(LogAnalysisLog) << "Loaded" << logFile << result.store->seriesNames().count() << "series in" << timer.elapsed() << "ms";
+    }
+    return result;
+}
+
+void LogAnalysisController::_loadFinished(void)
+{
+    LoadResult_t result = _loadWatcher.result();
+
+    _store = result.store;
+    _seriesNames.clear();
+    _vibration.clear();
+    if (_store) {
+        _seriesNames = _store->seriesNames();
+        for (const QString& seriesName: _store->vibrationSeriesNames()) {
+            LogAnalysisStore::Statistics statistics = _store->statistics(seriesName);
+            LogAnalysisStore::Spectrum spectrum = _store->spectrum(seriesName);
+            QVariantMap axis;
+            axis[QStringLiteral("name")] =          seriesName;
+            axis[QStringLiteral("stdDev")] =        statistics.stdDev;
+            axis[QStringLiteral("peakFrequency")] = spectrum.peakFrequency;
+            axis[QStringLiteral("peakMagnitude")] = spectrum.peakMagnitude;
+            _vibration.append(axis);
+        }
+    } else {
+        _setErrorMessage(result.errorString);
+    }
+
+    emit loadingChanged();
+    emit logLoaded();
+}
+
+QVariantMap LogAnalysisController::statistics(const QString& seriesName) const
+{
+    QVariantMap map;
+    if (_store && _store->contains(seriesName)) {
+        LogAnalysisStore::Statistics statistics = _store->statistics(seriesName);
+        map[QStringLiteral("count")] =  statistics.count;
+        map[QStringLiteral("min")] =    statistics.min;
+        map[QStringLiteral("max")] =    statistics.max;
+        map[QStringLiteral("mean")] =   statistics.mean;
+        map[QStringLiteral("stdDev")] = statistics.stdDev;
+    }
+    return map;
+}
+
+void LogAnalysisController::updateSeries(QAbstractSeries* series, const QString& seriesName, double startTime, double endTime, int maxPoints)
+{
+    QXYSeries* xySeries = qobject_cast<QXYSeries*>(series);
+    if (!xySeries) {
+        qWarning() << "LogAnalysisController::updateSeries not an xy series";
+        return;
+    }
+
+    QList<QPointF> points;
+    if (_store) {
+        _store->samples(seriesName, startTime, endTime, maxPoints, points);
+    }
+    xySeries->replace(points);
+}
+
+QVariantMap LogAnalysisController::updateSpectrum(QAbstractSeries* series, const QString& seriesName)
+{
+    QVariantMap map;
+    QXYSeries* xySeries = qobject_cast<QXYSeries*>(series);
+    if (!xySeries) {
+        qWarning() << "LogAnalysisController::updateSpectrum not an xy series";
+        return map;
+    }
+
+    QList<QPointF> points;
+    if (_store) {
+        LogAnalysisStore::Spectrum spectrum = _store->spectrum(seriesName);
+        points.reserve(spectrum.frequencies.count());
+        for (int i=0; i<spectrum.frequencies.count(); i++) {
+            points.append(QPointF(spectrum.frequencies[i], spectrum.magnitudes[i]));
+        }
+        map[QStringLiteral("sampleRate")] =     spectrum.sampleRate;
+        map[QStringLiteral("peakFrequency")] =  spectrum.peakFrequency;
+        map[QStringLiteral("peakMagnitude")] =  spectrum.peakMagnitude;
+    }
+    xySeries->replace(points);
+    return map;
+}
+
+void LogAnalysisController::_setErrorMessage(const QString& errorMessage)
+{
+    if (_errorMessage != errorMessage) {
+        _errorMessage = errorMessage;
+        emit errorMessageChanged(_errorMessage);
+    }
+}
@@ -0,0 +1,90 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "LogAnalysisStore.h"
+#include "QGCLoggingCategory.h"
+
+#include <QObject>
+#include <QSharedPointer>
+#include <QFutureWatcher>
+#include <QVariantList>
+#include <QVariantMap>
+#include <QtCharts/QAbstractSeries>
+
+Q_DECLARE_LOGGING_CATEGORY(LogAnalysisLog)
+
+QT_CHARTS_USE_NAMESPACE
+
+/// Controller for LogAnalysisPage.qml. Loads a ULog or telemetry log into a LogAnalysisStore in the background and feeds
+/// the charts from it.
+class LogAnalysisController : public QObject
+{
+    Q_OBJECT
+public:
+    LogAnalysisController(void);
+    ~LogAnalysisController();
+
+    Q_PROPERTY(QString      logFile         READ logFile        WRITE setLogFile    NOTIFY logFileChanged)
+    Q_PROPERTY(bool         loading         READ loading                            NOTIFY loadingChanged)
+    Q_PROPERTY(QString      errorMessage    READ errorMessage                       NOTIFY errorMessageChanged)
+    Q_PROPERTY(QStringList  seriesNames     READ seriesNames                        NOTIFY logLoaded)
+    Q_PROPERTY(double       startTime       READ startTime                          NOTIFY logLoaded)   ///< Seconds
+    Q_PROPERTY(double       endTime         READ endTime                            NOTIFY logLoaded)   ///< Seconds
+
+    /// Vibration summary, one entry per accelerometer axis: { name, stdDev, peakFrequency, peakMagnitude }
+    Q_PROPERTY(QVariantList vibration       READ vibration                          NOTIFY logLoaded)
+
+    /// @return { count, min, max, mean, stdDev } for the series
+    Q_INVOKABLE QVariantMap statistics(const QString& seriesName) const;
+
+    /// Replaces the points of a chart series with at most maxPoints decimated samples of the time range
+    Q_INVOKABLE void updateSeries(QAbstractSeries* series, const QString& seriesName, double startTime, double endTime, int maxPoints);
+
+    /// Replaces the points of a chart series with the magnitude spectrum of a series
+    /// @return { sampleRate, peakFrequency, peakMagnitude }
+    Q_INVOKABLE QVariantMap updateSpectrum(QAbstractSeries* series, const QString& seriesName);
+
+    QString         logFile         (void) const { return _logFile; }
+    bool            loading         (void) const { return _loadWatcher.isRunning(); }
+    QString         errorMessage    (void) const { return _errorMessage; }
+    QStringList     seriesNames     (void) const { return _seriesNames; }
+    double          startTime       (void) const { return _store ? _store->startTime() : 0; }
+    double          endTime         (void) const { return _store ? _store->endTime() : 0; }
+    QVariantList    vibration       (void) const { return _vibration; }
+
+    void setLogFile(QString logFile);
+
+signals:
+    void logFileChanged     (QString logFile);
+    void loadingChanged     (void);
+    void errorMessageChanged(QString errorMessage);
+    void logLoaded          (void);
+
+private slots:
+    void _loadFinished(void);
+
+private:
+    typedef struct {
+        QSharedPointer<LogAnalysisStore>    store;
+        QString                             errorString;
+    } LoadResult_t;
+
+    static LoadResult_t _loadLog(const QString& logFile);
+
+    void _setErrorMessage(const QString& errorMessage);
+
+    QString                             _logFile;
+    QString                             _errorMessage;
+    QSharedPointer<LogAnalysisStore>    _store;
+    QStringList                         _seriesNames;
+    QVariantList                        _vibration;
+    QFutureWatcher<LoadResult_t>        _loadWatcher;
+};
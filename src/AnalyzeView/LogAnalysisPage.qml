@@ -0,0 +1,273 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+import QtQuick                      2.11
+import QtQuick.Controls             2.4
+import QtQuick.Dialogs              1.3
+import QtQuick.Layouts              1.11
+import QtCharts                     2.3
+
+import QGroundControl               1.0
+import QGroundControl.Palette       1.0
+import QGroundControl.Controls      1.0
+import QGroundControl.ScreenTools   1.0
+import QGroundControl.Controllers   1.0
+
+AnalyzePage {
+    id:                 logAnalysisPage
+    pageComponent:      pageComponent
+    pageDescription:    qsTr("Plot and summarize a flight log (ULog or telemetry log) without external tools.")
+    allowPopout:        true
+
+    readonly property real  _margin:        ScreenTools.defaultFontPixelWidth
+    readonly property real  _chartHeight:   ScreenTools.defaultFontPixelHeight * 14
+    readonly property int   _maxPoints:     2000
+
+    QGCPalette { id: qgcPal; colorGroupEnabled: true }
+
+    LogAnalysisController {
+        id: controller
+    }
+
+    function _formatValue(value) {
+        return isNaN(value) ? "-" : value.toPrecision(5)
+    }
+
+    Component {
+        id: pageComponent
+
+        ColumnLayout {
+            width:      availableWidth
+            spacing:    _margin
+
+            property string _seriesName:    seriesCombo.currentText
+            property var    _statistics:    { controller.seriesNames; return controller.statistics(_seriesName) }
+            property real   _viewStart:     controller.startTime
+            property real   _viewEnd:       controller.endTime
+
+            function updateChart() {
+                if (_seriesName !== "") {
+                    controller.updateSeries(timeSeries, _seriesName, _viewStart, _viewEnd, _maxPoints)
+                    timeAxisY.min = _statistics.min
+                    timeAxisY.max = _statistics.min === _statistics.max ? _statistics.max + 1 : _statistics.max
+                }
+            }
+
+            function zoom(factor) {
+                var center  = (_viewStart + _viewEnd) / 2
+                var half    = Math.max((_viewEnd - _viewStart) * factor / 2, 0.01)
+                _viewStart  = Math.max(controller.startTime, center - half)
+                _viewEnd    = Math.min(controller.endTime, center + half)
+                updateChart()
+            }
+
+            function pan(fraction) {
+                var width   = _viewEnd - _viewStart
+                var start   = Math.min(Math.max(controller.startTime, _viewStart + width * fraction), controller.endTime - width)
+                _viewStart  = start
+                _viewEnd    = start + width
+                updateChart()
+            }
+
+            function resetView() {
+                _viewStart = controller.startTime
+                _viewEnd = controller.endTime
+                updateChart()
+            }
+
+            on_SeriesNameChanged: resetView()
+
+            Connections {
+                target:         controller
+                onLogLoaded:    resetView()
+            }
+
+            RowLayout {
+                spacing: _margin
+
+                QGCButton {
+                    text:       qsTr("Select log file")
+                    enabled:    !controller.loading
+                    onClicked:  openLogFile.open()
+
+                    FileDialog {
+                        id:             openLogFile
+                        title:          qsTr("Select log file")
+                        folder:         shortcuts.home
+                        nameFilters:    [qsTr("ULog file (*.ulg)"), qsTr("Telemetry log (*.tlog)"), qsTr("All Files (*)")]
+                        selectExisting: true
+                        onAccepted: {
+                            controller.logFile = openLogFile.fileUrl
+                            close()
+                        }
+                    }
+                }
+
+                BusyIndicator {
+                    running:                controller.loading
+                    visible:                controller.loading
+                    Layout.preferredHeight: ScreenTools.defaultFontPixelHeight * 2
+                    Layout.preferredWidth:  Layout.preferredHeight
+                }
+
+                QGCLabel {
+                    text:               controller.logFile
+                    elide:              Text.ElideLeft
+                    Layout.fillWidth:   true
+                }
+            }
+
+            QGCLabel {
+                text:       controller.errorMessage
+                color:      "red"
+                visible:    controller.errorMessage !== ""
+            }
+
+            //-----------------------------------------------------------------
+            //-- Vibration summary
+            QGCLabel {
+                text:       qsTr("Vibration")
+                font.bold:  true
+                visible:    controller.vibration.length > 0
+            }
+
+            GridLayout {
+                columns:        4
+                columnSpacing:  _margin * 2
+                visible:        controller.vibration.length > 0
+
+                QGCLabel { text: qsTr("Axis") }
+                QGCLabel { text: qsTr("Std dev") }
+                QGCLabel { text: qsTr("Peak frequency (Hz)") }
+                QGCLabel { text: qsTr("Peak amplitude") }
+
+                Repeater {
+                    model: controller.vibration.length * 4
+
+                    QGCLabel {
+                        text: {
+                            var axis = controller.vibration[Math.floor(index / 4)]
+                            switch (index % 4) {
+                            case 0:  return axis.name
+                            case 1:  return _formatValue(axis.stdDev)
+                            case 2:  return _formatValue(axis.peakFrequency)
+                            default: return _formatValue(axis.peakMagnitude)
+                            }
+                        }
+                    }
+                }
+            }
+
+            //-----------------------------------------------------------------
+            //-- Series
+            RowLayout {
+                spacing: _margin
+                visible: controller.seriesNames.length > 0
+
+                QGCComboBox {
+                    id:                 seriesCombo
+                    model:              controller.seriesNames
+                    sizeToContents:     true
+                }
+
+                QGCButton { text: qsTr("Zoom in");  onClicked: zoom(0.5) }
+                QGCButton { text: qsTr("Zoom out"); onClicked: zoom(2) }
+                QGCButton { text: "<";              onClicked: pan(-0.25) }
+                QGCButton { text: ">";              onClicked: pan(0.25) }
+                QGCButton { text: qsTr("Spectrum"); onClicked: spectrumInfo.text = _spectrumText(controller.updateSpectrum(spectrumSeries, _seriesName)) }
+            }
+
+            QGCLabel {
+                visible:    controller.seriesNames.length > 0
+                text:       qsTr("Samples: %1  Min: %2  Max: %3  Mean: %4  Std dev: %5").arg(_statistics.count).arg(_formatValue(_statistics.min)).arg(_formatValue(_statistics.max)).arg(_formatValue(_statistics.mean)).arg(_formatValue(_statistics.stdDev))
+            }
+
+            ChartView {
+                id:                     timeChart
+                Layout.fillWidth:       true
+                Layout.preferredHeight: _chartHeight
+                visible:                controller.seriesNames.length > 0
+                backgroundColor:        qgcPal.window
+                legend.visible:         false
+                antialiasing:           true
+                margins.top:            0
+                margins.bottom:         0
+
+                ValueAxis {
+                    id:                 timeAxisX
+                    min:                _viewStart
+                    max:                _viewEnd
+                    labelsColor:        qgcPal.text
+                    labelsFont.pointSize: ScreenTools.smallFontPointSize
+                    titleText:          qsTr("Time (s)")
+                }
+
+                ValueAxis {
+                    id:                 timeAxisY
+                    labelsColor:        qgcPal.text
+                    labelsFont.pointSize: ScreenTools.smallFontPointSize
+                }
+
+                LineSeries {
+                    id:         timeSeries
+                    axisX:      timeAxisX
+                    axisY:      timeAxisY
+                    useOpenGL:  true
+                }
+            }
+
+            QGCLabel {
+                id:         spectrumInfo
+                visible:    text !== ""
+            }
+
+            ChartView {
+                id:                     spectrumChart
+                Layout.fillWidth:       true
+                Layout.preferredHeight: _chartHeight
+                visible:                spectrumInfo.text !== ""
+                backgroundColor:        qgcPal.window
+                legend.visible:         false
+                antialiasing:           true
+                margins.top:            0
+                margins.bottom:         0
+
+                ValueAxis {
+                    id:                 spectrumAxisX
+                    labelsColor:        qgcPal.text
+                    labelsFont.pointSize: ScreenTools.smallFontPointSize
+                    titleText:          qsTr("Frequency (Hz)")
+                }
+
+                ValueAxis {
+                    id:                 spectrumAxisY
+                    labelsColor:        qgcPal.text
+                    labelsFont.pointSize: ScreenTools.smallFontPointSize
+                }
+
+                LineSeries {
+                    id:         spectrumSeries
+                    axisX:      spectrumAxisX
+                    axisY:      spectrumAxisY
+                }
+            }
+
+            function _spectrumText(spectrum) {
+                if (spectrum.sampleRate === undefined || spectrum.sampleRate === 0) {
+                    return qsTr("Not enough samples for a spectrum")
+                }
+                spectrumAxisX.min = 0
+                spectrumAxisX.max = spectrum.sampleRate / 2
+                spectrumAxisY.min = 0
+                spectrumAxisY.max = spectrum.peakMagnitude * 1.1
+                return qsTr("%1: sample rate %2 Hz, peak %3 at %4 Hz").arg(_seriesName).arg(_formatValue(spectrum.sampleRate)).arg(_formatValue(spectrum.peakMagnitude)).arg(_formatValue(spectrum.peakFrequency))
+            }
+        }
+    }
+}
@@ -0,0 +1,699 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LogAnalysisStore.h"
+#include "QGCMAVLink.h"
+
+#include <QFile>
+#include <QSet>
+#include <QDateTime>
+#include <QtEndian>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <limits>
+
+/// Accelerometer series used for the vibration summary, the first complete set found in the log is used
+static const char* kVibrationSeries[][3] = {
+    { "sensor_combined.accelerometer_m_s2[0]",  "sensor_combined.accelerometer_m_s2[1]",    "sensor_combined.accelerometer_m_s2[2]" },
+    { "vehicle_acceleration.xyz[0]",            "vehicle_acceleration.xyz[1]",              "vehicle_acceleration.xyz[2]" },
+    { "HIGHRES_IMU.xacc",                       "HIGHRES_IMU.yacc",                         "HIGHRES_IMU.zacc" },
+    { "SCALED_IMU.xacc",                        "SCALED_IMU.yacc",                          "SCALED_IMU.zacc" },
+    { "RAW_IMU.xacc",                           "RAW_IMU.yacc",                             "RAW_IMU.zacc" },
+};
+
+bool LogAnalysisStore::load(const QString& logFile, QString& errorString)
+{
+    clear();
+    errorString.clear();
+
+    bool success;
+    if (logFile.endsWith(QStringLiteral(".ulg"), Qt::CaseInsensitive)) {
+        success = _loadULog(logFile, errorString);
+    } else if (logFile.endsWith(QStringLiteral(".tlog"), Qt::CaseInsensitive)) {
+        success = _loadTLog(logFile, errorString);
+    } else {
+        errorString = tr("Unsupported log file type, only ULog (.ulg) and telemetry logs (.tlog) can be analyzed");
+        return false;
+    }
+    if (!success) {
+        clear();
+        return false;
+    }
+
+    if (_series.isEmpty()) {
+        errorString = tr("Log does not contain any data");
+        return false;
+    }
+
+    finalize();
+    return true;
+}
+
+void LogAnalysisStore::clear(void)
+{
+    _tables.clear();
+    _series.clear();
+    _seriesIndices.clear();
+    _vibrationSeriesNames.clear();
+    _startTime = 0;
+    _endTime = 0;
+}
+
+void LogAnalysisStore::addTable(const QString& tableName, const QVector<double>& times, const QStringList& columnNames, const QVector<QVector<float>>& columns)
+{
+    if (times.isEmpty()) {
+        return;
+    }
+
+    Table table;
+    table.name = tableName;
+    table.times = times;
+    _tables.append(table);
+
+    for (int i=0; i<columnNames.count() && i<columns.count(); i++) {
+        if (columns[i].count() != times.count()) {
+            qWarning() << "LogAnalysisStore::addTable column count mismatch" << tableName << columnNames[i];
+            continue;
+        }
+
+        Series series;
+        series.name =       tableName + QStringLiteral(".") + columnNames[i];
+        series.tableIndex = _tables.count() - 1;
+        series.times =      nullptr;
+        series.values =     columns[i];
+        series.vibration =  false;
+
+        _seriesIndices[series.name] = _series.count();
+        _series.append(series);
+    }
+}
+
+void LogAnalysisStore::finalize(void)
+{
+    _startTime = std::numeric_limits<double>::max();
+    _endTime = std::numeric_limits<double>::lowest();
+    for (const Table& table: _tables) {
+        _startTime = qMin(_startTime, table.times.first());
+        _endTime = qMax(_endTime, table.times.last());
+    }
+    if (_tables.isEmpty()) {
+        _startTime = _endTime = 0;
+    }
+
+    _findVibrationSeries();
+
+    for (Series& series: _series) {
+        series.times = &_tables[series.tableIndex].times;
+    }
+    QtConcurrent::blockingMap(_series, &LogAnalysisStore::_finalizeSeries);
+    for (Series& series: _series) {
+        series.times = nullptr;
+    }
+}
+
+void LogAnalysisStore::_findVibrationSeries(void)
+{
+    _vibrationSeriesNames.clear();
+    for (const auto& candidate: kVibrationSeries) {
+        QStringList names = { candidate[0], candidate[1], candidate[2] };
+        if (contains(names[0]) && contains(names[1]) && contains(names[2])) {
+            _vibrationSeriesNames = names;
+            break;
+        }
+    }
+    for (const QString& name: _vibrationSeriesNames) {
+        _series[_seriesIndices[name]].vibration = true;
+    }
+}
+
+QStringList LogAnalysisStore::seriesNames(void) const
+{
+    QStringList names;
+    names.reserve(_series.count());
+    for (const Series& series: _series) {
+        names.append(series.name);
+    }
+    names.sort();
+    return names;
+}
+
+LogAnalysisStore::Statistics LogAnalysisStore::statistics(const QString& seriesName) const
+{
+    auto seriesIndex = _seriesIndices.constFind(seriesName);
+    return seriesIndex == _seriesIndices.constEnd() ? Statistics() : _series[*seriesIndex].statistics;
+}
+
+void LogAnalysisStore::samples(const QString& seriesName, double startTime, double endTime, int maxPoints, QList<QPointF>& points) const
+{
+    points.clear();
+
+    auto seriesIndex = _seriesIndices.constFind(seriesName);
+    if (seriesIndex == _seriesIndices.constEnd() || maxPoints < 2) {
+        return;
+    }
+    const Series&           series  = _series[*seriesIndex];
+    const QVector<double>&  times   = _tables[series.tableIndex].times;
+
+    // Include one sample on each side so lines run to the edges of the range
+    int first = static_cast<int>(std::lower_bound(times.constBegin(), times.constEnd(), startTime) - times.constBegin());
+    int last = static_cast<int>(std::upper_bound(times.constBegin(), times.constEnd(), endTime) - times.constBegin());
+    first = qMax(0, first - 1);
+    last = qMin(times.count(), last + 1);
+    int count = last - first;
+    if (count <= 0) {
+        return;
+    }
+
+    // Find the finest level which fits, decimated levels contribute a min and a max point for each bucket. If nothing fits
+    // the coarsest level is used.
+    int level = 0;
+    int bucketSize = 1;
+    if (count > maxPoints) {
+        while (level < series.levels.count()) {
+            level++;
+            bucketSize *= decimationFactor;
+            int bucketCount = (last - 1) / bucketSize - first / bucketSize + 1;
+            if (2 * bucketCount <= maxPoints) {
+                break;
+            }
+        }
+    }
+
+    if (level == 0) {
+        points.reserve(count);
+        for (int i=first; i<last; i++) {
+            float value = series.values[i];
+            if (std::isfinite(value)) {
+                points.append(QPointF(times[i], static_cast<double>(value)));
+            }
+        }
+        return;
+    }
+
+    const Level& decimated = series.levels[level - 1];
+    int firstBucket = first / bucketSize;
+    int lastBucket = qMin(decimated.min.count() - 1, (last - 1) / bucketSize);
+    points.reserve(2 * (lastBucket - firstBucket + 1));
+    for (int bucket=firstBucket; bucket<=lastBucket; bucket++) {
+        int bucketStart = bucket * bucketSize;
+        int bucketMiddle = qMin(times.count() - 1, bucketStart + bucketSize / 2);
+        if (std::isfinite(decimated.min[bucket])) {
+            points.append(QPointF(times[bucketStart], static_cast<double>(decimated.min[bucket])));
+            points.append(QPointF(times[bucketMiddle], static_cast<double>(decimated.max[bucket])));
+        }
+    }
+}
+
+LogAnalysisStore::Spectrum LogAnalysisStore::spectrum(const QString& seriesName) const
+{
+    auto seriesIndex = _seriesIndices.constFind(seriesName);
+    if (seriesIndex == _seriesIndices.constEnd()) {
+        return Spectrum();
+    }
+    const Series& series = _series[*seriesIndex];
+    if (series.vibration) {
+        return series.spectrum;
+    }
+    return computeSpectrum(_tables[series.tableIndex].times, series.values);
+}
+
+void LogAnalysisStore::_finalizeSeries(Series& series)
+{
+    const QVector<float>& values = series.values;
+
+    // Statistics over the finite samples (Welford)
+    Statistics statistics;
+    double mean = 0;
+    double m2 = 0;
+    for (float value: values) {
+        if (!std::isfinite(value)) {
+            continue;
+        }
+        statistics.count++;
+        if (statistics.count == 1) {
+            statistics.min = statistics.max = value;
+        } else {
+            statistics.min = qMin(statistics.min, static_cast<double>(value));
+            statistics.max = qMax(statistics.max, static_cast<double>(value));
+        }
+        double delta = value - mean;
+        mean += delta / statistics.count;
+        m2 += delta * (value - mean);
+    }
+    if (statistics.count > 0) {
+        statistics.mean = mean;
+        statistics.stdDev = std::sqrt(m2 / statistics.count);
+    }
+    series.statistics = statistics;
+
+    // Min/max pyramid, each level built from the one below
+    series.levels.clear();
+    while (true) {
+        const QVector<float>& sourceMin = series.levels.isEmpty() ? values : series.levels.last().min;
+        const QVector<float>& sourceMax = series.levels.isEmpty() ? values : series.levels.last().max;
+        if (sourceMin.count() <= decimationFactor) {
+            break;
+        }
+
+        int bucketCount = (sourceMin.count() + decimationFactor - 1) / decimationFactor;
+        Level level;
+        level.min.resize(bucketCount);
+        level.max.resize(bucketCount);
+        for (int bucket=0; bucket<bucketCount; bucket++) {
+            float bucketMin = NAN;
+            float bucketMax = NAN;
+            int end = qMin(sourceMin.count(), (bucket + 1) * decimationFactor);
+            for (int i=bucket * decimationFactor; i<end; i++) {
+                float minValue = sourceMin[i];
+                float maxValue = sourceMax[i];
+                if (std::isfinite(minValue) && (std::isnan(bucketMin) || minValue < bucketMin)) {
+                    bucketMin = minValue;
+                }
+                if (std::isfinite(maxValue) && (std::isnan(bucketMax) || maxValue > bucketMax)) {
+                    bucketMax = maxValue;
+                }
+            }
+            level.min[bucket] = bucketMin;
+            level.max[bucket] = bucketMax;
+        }
+        series.levels.append(level);
+    }
+
+    if (series.vibration && series.times) {
+        series.spectrum = computeSpectrum(*series.times, values);
+    }
+}
+
+LogAnalysisStore::Spectrum LogAnalysisStore::computeSpectrum(const QVector<double>& times, const QVector<float>& values)
+{
+    Spectrum spectrum;
+
+    int count = qMin(times.count(), values.count());
+    if (count < 16) {
+        return spectrum;
+    }
+    double duration = times[count - 1] - times[0];
+    if (duration <= 0) {
+        return spectrum;
+    }
+    spectrum.sampleRate = (count - 1) / duration;
+
+    int segmentSize = spectrumSegmentSize;
+    while (segmentSize > count) {
+        segmentSize /= 2;
+    }
+    // 50% overlap, long logs are sampled with evenly spread segments instead
+    int segmentCount = qBound(1, 2 * (count - segmentSize) / segmentSize + 1, static_cast<int>(maxSpectrumSegments));
+
+    QVector<double> window(segmentSize);
+    double windowSum = 0;
+    for (int i=0; i<segmentSize; i++) {
+        window[i] = 0.5 * (1.0 - std::cos(2.0 * M_PI * i / (segmentSize - 1)));
+        windowSum += window[i];
+    }
+
+    int binCount = segmentSize / 2 + 1;
+    QVector<double> magnitudes(binCount, 0.0);
+    QVector<double> real(segmentSize);
+    QVector<double> imag(segmentSize);
+    for (int segment=0; segment<segmentCount; segment++) {
+        int start = segmentCount == 1 ? 0 : static_cast<int>(static_cast<qint64>(segment) * (count - segmentSize) / (segmentCount - 1));
+
+        // Remove the mean so gravity and bias do not swamp the low bins
+        double mean = 0;
+        int finiteCount = 0;
+        for (int i=0; i<segmentSize; i++) {
+            float value = values[start + i];
+            if (std::isfinite(value)) {
+                mean += value;
+                finiteCount++;
+            }
+        }
+        mean = finiteCount ? mean / finiteCount : 0;
+
+        for (int i=0; i<segmentSize; i++) {
+            float value = values[start + i];
+            real[i] = std::isfinite(value) ? (value - mean) * window[i] : 0;
+            imag[i] = 0;
+        }
+        _fft(real, imag);
+        for (int bin=0; bin<binCount; bin++) {
+            magnitudes[bin] += std::hypot(real[bin], imag[bin]);
+        }
+    }
+
+    spectrum.frequencies.resize(binCount);
+    spectrum.magnitudes.resize(binCount);
+    for (int bin=0; bin<binCount; bin++) {
+        // Single sided amplitude
+        double scale = (bin == 0 || bin == binCount - 1 ? 1.0 : 2.0) / (windowSum * segmentCount);
+        spectrum.frequencies[bin] = bin * spectrum.sampleRate / segmentSize;
+        spectrum.magnitudes[bin] = magnitudes[bin] * scale;
+        if (bin > 0 && (std::isnan(spectrum.peakMagnitude) || spectrum.magnitudes[bin] > spectrum.peakMagnitude)) {
+            spectrum.peakMagnitude = spectrum.magnitudes[bin];
+            spectrum.peakFrequency = spectrum.frequencies[bin];
+        }
+    }
+
+    return spectrum;
+}
+
+/// In place iterative radix-2 FFT, the size must be a power of two
+void LogAnalysisStore::_fft(QVector<double>& real, QVector<double>& imag)
+{
+    const int n = real.count();
+
+    for (int i=1, j=0; i<n; i++) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(real[i], real[j]);
+            std::swap(imag[i], imag[j]);
+        }
+    }
+
+    for (int length=2; length<=n; length <<= 1) {
+        double angle = -2.0 * M_PI / length;
+        double stepReal = std::cos(angle);
+        double stepImag = std::sin(angle);
+        for (int i=0; i<n; i+=length) {
+            double wReal = 1;
+            double wImag = 0;
+            for (int j=0; j<length/2; j++) {
+                int even = i + j;
+                int odd = i + j + length / 2;
+                double oddReal = real[odd] * wReal - imag[odd] * wImag;
+                double oddImag = real[odd] * wImag + imag[odd] * wReal;
+                real[odd] = real[even] - oddReal;
+                imag[odd] = imag[even] - oddImag;
+                real[even] += oddReal;
+                imag[even] += oddImag;
+                double nextReal = wReal * stepReal - wImag * stepImag;
+                wImag = wReal * stepImag + wImag * stepReal;
+                wReal = nextReal;
+            }
+        }
+    }
+}
+
+LogAnalysisStore::ValueType LogAnalysisStore::_uLogValueType(const QString& typeName)
+{
+    if (typeName == QLatin1String("int8_t")) {
+        return ValueTypeInt8;
+    } else if (typeName == QLatin1String("uint8_t") || typeName == QLatin1String("bool")) {
+        return ValueTypeUInt8;
+    } else if (typeName == QLatin1String("int16_t")) {
+        return ValueTypeInt16;
+    } else if (typeName == QLatin1String("uint16_t")) {
+        return ValueTypeUInt16;
+    } else if (typeName == QLatin1String("int32_t")) {
+        return ValueTypeInt32;
+    } else if (typeName == QLatin1String("uint32_t")) {
+        return ValueTypeUInt32;
+    } else if (typeName == QLatin1String("int64_t")) {
+        return ValueTypeInt64;
+    } else if (typeName == QLatin1String("uint64_t")) {
+        return ValueTypeUInt64;
+    } else if (typeName == QLatin1String("float")) {
+        return ValueTypeFloat;
+    } else if (typeName == QLatin1String("double")) {
+        return ValueTypeDouble;
+    }
+    // char and nested types are not signals
+    return ValueTypeUnknown;
+}
+
+int LogAnalysisStore::_sizeOfValueType(ValueType type)
+{
+    switch (type) {
+    case ValueTypeInt8:
+    case ValueTypeUInt8:
+        return 1;
+    case ValueTypeInt16:
+    case ValueTypeUInt16:
+        return 2;
+    case ValueTypeInt32:
+    case ValueTypeUInt32:
+    case ValueTypeFloat:
+        return 4;
+    case ValueTypeInt64:
+    case ValueTypeUInt64:
+    case ValueTypeDouble:
+        return 8;
+    case ValueTypeUnknown:
+        break;
+    }
+    return 0;
+}
+
+float LogAnalysisStore::_readValue(const uchar* data, ValueType type)
+{
+    switch (type) {
+    case ValueTypeInt8:
+        return static_cast<float>(*reinterpret_cast<const int8_t*>(data));
+    case ValueTypeUInt8:
+        return static_cast<float>(*data);
+    case ValueTypeInt16:
+        return static_cast<float>(qFromLittleEndian<qint16>(data));
+    case ValueTypeUInt16:
+        return static_cast<float>(qFromLittleEndian<quint16>(data));
+    case ValueTypeInt32:
+        return static_cast<float>(qFromLittleEndian<qint32>(data));
+    case ValueTypeUInt32:
+        return static_cast<float>(qFromLittleEndian<quint32>(data));
+    case ValueTypeInt64:
+        return static_cast<float>(qFromLittleEndian<qint64>(data));
+    case ValueTypeUInt64:
+        return static_cast<float>(qFromLittleEndian<quint64>(data));
+    case ValueTypeFloat:
+    {
+        float value;
+        memcpy(&value, data, sizeof(value));
+        return value;
+    }
+    case ValueTypeDouble:
+    {
+        double value;
+        memcpy(&value, data, sizeof(value));
+        return static_cast<float>(value);
+    }
+    case ValueTypeUnknown:
+        break;
+    }
+    return NAN;
+}
+
+bool LogAnalysisStore::_loadULog(const QString& logFile, QString& errorString)
+{
+    ULogReader reader;
+    if (!reader.open(logFile, errorString)) {
+        return false;
+    }
+
+    // Times are relative to the first logged message
+    QList<ULogTopicJob> jobs;
+    quint64 startTimestamp = std::numeric_limits<quint64>::max();
+    for (const QString& topicName: reader.topicNames()) {
+        for (int multiId: reader.multiIds(topicName)) {
+            ULogTopicJob job;
+            job.topic = reader.topic(topicName, multiId);
+            if (!job.topic.isValid() || job.topic.count() == 0) {
+                continue;
+            }
+            job.tableName = multiId == 0 ? topicName : QStringLiteral("%1_%2").arg(topicName).arg(multiId);
+            startTimestamp = qMin(startTimestamp, job.topic.timestamp(0));
+            jobs.append(job);
+        }
+    }
+    for (ULogTopicJob& job: jobs) {
+        job.startTimestamp = startTimestamp;
+    }
+
+    // Topics are independent, so they are extracted from the mapping in parallel
+    QList<TableData> tables = QtConcurrent::blockingMapped<QList<TableData>>(jobs, &LogAnalysisStore::_readULogTopic);
+    for (const TableData& table: tables) {
+        addTable(table.name, table.times, table.columnNames, table.columns);
+    }
+
+    return true;
+}
+
+LogAnalysisStore::TableData LogAnalysisStore::_readULogTopic(const ULogTopicJob& job)
+{
+    TableData table;
+    table.name = job.tableName;
+
+    QList<ColumnSource> sources;
+    for (const ULogReader::Field& field: job.topic.format()->fields) {
+        ValueType type = _uLogValueType(field.typeName);
+        if (type == ValueTypeUnknown || field.name == QLatin1String("timestamp") || field.arraySize > maxArrayColumns) {
+            continue;
+        }
+        for (int i=0; i<field.arraySize; i++) {
+            ColumnSource source;
+            source.offset = field.offset + i * _sizeOfValueType(type);
+            source.type = type;
+            sources.append(source);
+            table.columnNames.append(field.arraySize == 1 ? field.name : QStringLiteral("%1[%2]").arg(field.name).arg(i));
+        }
+    }
+
+    const int count = job.topic.count();
+    table.times.resize(count);
+    table.columns.resize(sources.count());
+    for (QVector<float>& column: table.columns) {
+        column.resize(count);
+    }
+
+    for (int i=0; i<count; i++) {
+        table.times[i] = static_cast<double>(static_cast<qint64>(job.topic.timestamp(i) - job.startTimestamp)) / 1.0e6;
+        int size;
+        const uchar* payload = job.topic.messagePayload(i, size);
+        for (int column=0; column<sources.count(); column++) {
+            const ColumnSource& source = sources[column];
+            table.columns[column][i] = source.offset + _sizeOfValueType(source.type) <= size ? _readValue(payload + source.offset, source.type) : NAN;
+        }
+    }
+
+    return table;
+}
+
+bool LogAnalysisStore::_loadTLog(const QString& logFile, QString& errorString)
+{
+    static const int cbTimestamp = sizeof(quint64);
+
+    QFile file(logFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        errorString = tr("Could not open log file %1").arg(logFile);
+        return false;
+    }
+    const qint64 size = file.size();
+    const uchar* data = size > 0 ? file.map(0, size) : nullptr;
+    if (!data) {
+        errorString = tr("Could not map log file %1: %2").arg(logFile).arg(file.errorString());
+        return false;
+    }
+
+    struct TLogTable {
+        TableData           data;
+        QList<ColumnSource> sources;
+    };
+    // Keyed by message id, system id and component id
+    QHash<quint64, TLogTable>   tables;
+    QSet<QString>               tableNames;
+
+    // Parsing is done on local buffers instead of a mavlink channel so this can run away from the main thread
+    mavlink_message_t   rxMessage;
+    mavlink_status_t    rxStatus;
+    memset(&rxMessage, 0, sizeof(rxMessage));
+    memset(&rxStatus, 0, sizeof(rxStatus));
+
+    const quint64 currentTimestamp = static_cast<quint64>(QDateTime::currentMSecsSinceEpoch()) * 1000;
+    quint64 firstTimestamp = 0;
+    qint64 index = 0;
+    while (index + cbTimestamp < size) {
+        // Same handling as LogReplayLink: older logs stored the timestamp little endian
+        quint64 timestamp = qFromBigEndian<quint64>(data + index);
+        if (timestamp > currentTimestamp) {
+            timestamp = qbswap(timestamp);
+        }
+        index += cbTimestamp;
+
+        mavlink_message_t message;
+        mavlink_status_t status;
+        bool messageFound = false;
+        while (!messageFound && index < size) {
+            messageFound = mavlink_frame_char_buffer(&rxMessage, &rxStatus, data[index++], &message, &status) == MAVLINK_FRAMING_OK;
+        }
+        if (!messageFound) {
+            break;
+        }
+        if (firstTimestamp == 0) {
+            firstTimestamp = timestamp;
+        }
+
+        quint64 key = static_cast<quint64>(message.msgid) | (static_cast<quint64>(message.sysid) << 24) | (static_cast<quint64>(message.compid) << 32);
+        auto tableIter = tables.find(key);
+        if (tableIter == tables.end()) {
+            TLogTable table;
+            const mavlink_message_info_t* msgInfo = mavlink_get_message_info(&message);
+            if (msgInfo) {
+                // The first system/component to send a message gets the plain message name
+                QString name = msgInfo->name;
+                table.data.name = tableNames.contains(name) ? QStringLiteral("%1_%2_%3").arg(name).arg(message.sysid).arg(message.compid) : name;
+                tableNames.insert(table.data.name);
+
+                for (unsigned int i=0; i<msgInfo->num_fields; i++) {
+                    const mavlink_field_info_t& field = msgInfo->fields[i];
+                    ValueType type = ValueTypeUnknown;
+                    switch (field.type) {
+                    case MAVLINK_TYPE_INT8_T:   type = ValueTypeInt8;   break;
+                    case MAVLINK_TYPE_UINT8_T:  type = ValueTypeUInt8;  break;
+                    case MAVLINK_TYPE_INT16_T:  type = ValueTypeInt16;  break;
+                    case MAVLINK_TYPE_UINT16_T: type = ValueTypeUInt16; break;
+                    case MAVLINK_TYPE_INT32_T:  type = ValueTypeInt32;  break;
+                    case MAVLINK_TYPE_UINT32_T: type = ValueTypeUInt32; break;
+                    case MAVLINK_TYPE_INT64_T:  type = ValueTypeInt64;  break;
+                    case MAVLINK_TYPE_UINT64_T: type = ValueTypeUInt64; break;
+                    case MAVLINK_TYPE_FLOAT:    type = ValueTypeFloat;  break;
+                    case MAVLINK_TYPE_DOUBLE:   type = ValueTypeDouble; break;
+                    default:                                            break;
+                    }
+                    int arraySize = qMax(1, static_cast<int>(field.array_length));
+                    if (type == ValueTypeUnknown || arraySize > maxArrayColumns) {
+                        continue;
+                    }
+                    for (int j=0; j<arraySize; j++) {
+                        ColumnSource source;
+                        source.offset = static_cast<int>(field.wire_offset) + j * _sizeOfValueType(type);
+                        source.type = type;
+                        table.sources.append(source);
+                        table.data.columnNames.append(field.array_length == 0 ? QString(field.name) : QStringLiteral("%1[%2]").arg(field.name).arg(j));
+                    }
+                }
+                table.data.columns.resize(table.sources.count());
+            }
+            tableIter = tables.insert(key, table);
+        }
+
+        TLogTable& table = *tableIter;
+        if (table.sources.isEmpty()) {
+            continue;
+        }
+
+        // MAVLink 2 trims trailing zeros from the payload
+        uchar payload[MAVLINK_MAX_PAYLOAD_LEN] = {};
+        memcpy(payload, _MAV_PAYLOAD(&message), message.len);
+
+        table.data.times.append(static_cast<double>(static_cast<qint64>(timestamp - firstTimestamp)) / 1.0e6);
+        for (int column=0; column<table.sources.count(); column++) {
+            const ColumnSource& source = table.sources[column];
+            table.data.columns[column].append(source.offset + _sizeOfValueType(source.type) <= MAVLINK_MAX_PAYLOAD_LEN ? _readValue(payload + source.offset, source.type) : NAN);
+        }
+    }
+
+    file.unmap(const_cast<uchar*>(data));
+
+    if (firstTimestamp == 0) {
+        errorString = tr("Could not detect any MAVLink messages in the telemetry log");
+        return false;
+    }
+
+    for (const TLogTable& table: tables) {
+        if (!table.sources.isEmpty()) {
+            addTable(table.data.name, table.data.times, table.data.columnNames, table.data.columns);
+        }
+    }
+
+    return true;
+}
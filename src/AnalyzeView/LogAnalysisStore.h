@@ -0,0 +1,160 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QVector>
+#include <QList>
+#include <QHash>
+#include <QPointF>
+#include <QStringList>
+#include <QCoreApplication>
+
+#include <cmath>
+
+#include "ULogReader.h"
+
+/// Columnar, time indexed store for the numeric content of a flight log. Samples are grouped in tables which share a
+/// time column (all fields of a ULog topic instance or of a MAVLink message). Each column is a series named
+/// "table.column". Once loaded every series has its statistics and a min/max decimation pyramid, so any time range can be
+/// plotted with a bounded number of points without losing spikes.
+class LogAnalysisStore
+{
+    Q_DECLARE_TR_FUNCTIONS(LogAnalysisStore)
+
+public:
+    LogAnalysisStore(void) = default;
+
+    struct Statistics {
+        int     count =     0;      ///< Number of finite samples
+        double  min =       NAN;
+        double  max =       NAN;
+        double  mean =      NAN;
+        double  stdDev =    NAN;
+    };
+
+    struct Spectrum {
+        QVector<double> frequencies;        ///< Hz
+        QVector<double> magnitudes;         ///< Amplitude in series units
+        double          sampleRate =        0;
+        double          peakFrequency =     NAN;
+        double          peakMagnitude =     NAN;
+    };
+
+    /// Loads a ULog (.ulg) or MAVLink telemetry log (.tlog), replacing the current content. Statistics and decimation
+    /// levels are calculated in parallel before returning.
+    /// @return false: failed, errorString set
+    bool load(const QString& logFile, QString& errorString);
+
+    /// Adds a table. Times are in seconds and must be ascending, each column must have the same count as the times.
+    /// finalize must be called once all tables are added.
+    void addTable(const QString& tableName, const QVector<double>& times, const QStringList& columnNames, const QVector<QVector<float>>& columns);
+
+    /// Calculates statistics, decimation levels and vibration spectra for all series in parallel
+    void finalize(void);
+
+    void clear(void);
+
+    QStringList seriesNames     (void) const;
+    bool        contains        (const QString& seriesName) const { return _seriesIndices.contains(seriesName); }
+    double      startTime       (void) const { return _startTime; }
+    double      endTime         (void) const { return _endTime; }
+    Statistics  statistics      (const QString& seriesName) const;
+
+    /// Returns the points covering the time range. Ranges with more than maxPoints samples are taken from the finest
+    /// decimation level which still fits, each bucket contributing its min and max.
+    void samples(const QString& seriesName, double startTime, double endTime, int maxPoints, QList<QPointF>& points) const;
+
+    /// @return Spectrum of the series, cached for the vibration series
+    Spectrum spectrum(const QString& seriesName) const;
+
+    /// @return The accelerometer series used for the vibration summary, empty if the log has none
+    QStringList vibrationSeriesNames(void) const { return _vibrationSeriesNames; }
+
+    /// Averaged (Welch) magnitude spectrum of uniformly sampled values. The sample rate is derived from the times.
+    static Spectrum computeSpectrum(const QVector<double>& times, const QVector<float>& values);
+
+    static const int decimationFactor =     8;
+    static const int spectrumSegmentSize =  1024;
+    static const int maxSpectrumSegments =  64;
+    static const int maxArrayColumns =      16;     ///< Larger arrays are binary blobs rather than signals
+
+private:
+    struct Table {
+        QString             name;
+        QVector<double>     times;
+    };
+
+    struct Level {
+        QVector<float>      min;
+        QVector<float>      max;
+    };
+
+    struct Series {
+        QString                 name;
+        int                     tableIndex;
+        const QVector<double>*  times;          ///< Only valid during finalize
+        QVector<float>          values;
+        QList<Level>            levels;         ///< levels[i] buckets are decimationFactor^(i+1) samples
+        Statistics              statistics;
+        bool                    vibration;
+        Spectrum                spectrum;
+    };
+
+    enum ValueType {
+        ValueTypeInt8,
+        ValueTypeUInt8,
+        ValueTypeInt16,
+        ValueTypeUInt16,
+        ValueTypeInt32,
+        ValueTypeUInt32,
+        ValueTypeInt64,
+        ValueTypeUInt64,
+        ValueTypeFloat,
+        ValueTypeDouble,
+        ValueTypeUnknown,
+    };
+
+    /// Location of a column value within a raw message payload
+    struct ColumnSource {
+        int         offset;
+        ValueType   type;
+    };
+
+    struct TableData {
+        QString                 name;
+        QVector<double>         times;
+        QStringList             columnNames;
+        QVector<QVector<float>> columns;
+    };
+
+    struct ULogTopicJob {
+        ULogReader::Topic   topic;
+        QString             tableName;
+        quint64             startTimestamp;
+    };
+
+    bool _loadULog              (const QString& logFile, QString& errorString);
+    bool _loadTLog              (const QString& logFile, QString& errorString);
+    void _findVibrationSeries   (void);
+
+    static TableData    _readULogTopic      (const ULogTopicJob& job);
+    static ValueType    _uLogValueType      (const QString& typeName);
+    static int          _sizeOfValueType    (ValueType type);
+    static float        _readValue          (const uchar* data, ValueType type);
+    static void         _finalizeSeries     (Series& series);
+    static void         _fft                (QVector<double>& real, QVector<double>& imag);
+
+    QList<Table>        _tables;
+    QVector<Series>     _series;
+    QHash<QString, int> _seriesIndices;
+    QStringList         _vibrationSeriesNames;
+    double              _startTime =    0;
+    double              _endTime =      0;
+};
@@ -0,0 +1,263 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LogAnalysisStoreTest.h"
+#include "LogAnalysisStore.h"
+#include "QGCMAVLink.h"
+
+#include <QTemporaryDir>
+#include <QtEndian>
+
+QByteArray LogAnalysisStoreTest::_uLogMessage(char msgType, const QByteArray& payload)
+{
+    QByteArray message(ULogReader::messageHeaderLength, 0);
+    qToLittleEndian<quint16>(static_cast<quint16>(payload.size()), message.data());
+    message[2] = msgType;
+    return message + payload;
+}
+
+void LogAnalysisStoreTest::_writeFile(const QString& fileName, const QByteArray& bytes)
+{
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(bytes), static_cast<qint64>(bytes.size()));
+}
+
+void LogAnalysisStoreTest::_statistics_test(void)
+{
+    QVector<double> times = { 1, 2, 3, 4, 5 };
+    QVector<float>  values = { 1, 2, NAN, 3, 6 };
+
+    LogAnalysisStore store;
+    store.addTable(QStringLiteral("topic"), times, { QStringLiteral("value") }, { values });
+    store.finalize();
+
+    QCOMPARE(store.seriesNames(), QStringList(QStringLiteral("topic.value")));
+    QCOMPARE(store.startTime(), 1.0);
+    QCOMPARE(store.endTime(), 5.0);
+
+    // Non-finite samples are ignored
+    LogAnalysisStore::Statistics statistics = store.statistics(QStringLiteral("topic.value"));
+    QCOMPARE(statistics.count, 4);
+    QCOMPARE(statistics.min, 1.0);
+    QCOMPARE(statistics.max, 6.0);
+    QCOMPARE(statistics.mean, 3.0);
+    QCOMPARE(statistics.stdDev, std::sqrt(3.5));
+
+    QCOMPARE(store.statistics(QStringLiteral("missing")).count, 0);
+}
+
+void LogAnalysisStoreTest::_decimation_test(void)
+{
+    const int       sampleCount =   100000;
+    const int       spikeIndex =    54321;
+    QVector<double> times(sampleCount);
+    QVector<float>  values(sampleCount);
+    for (int i=0; i<sampleCount; i++) {
+        times[i] = i / 1000.0;
+        values[i] = static_cast<float>(std::sin(i * 0.01));
+    }
+    values[spikeIndex] = 50;
+
+    LogAnalysisStore store;
+    store.addTable(QStringLiteral("topic"), times, { QStringLiteral("value") }, { values });
+    store.finalize();
+
+    // The whole range is decimated to the point budget but the single sample spike survives
+    QList<QPointF> points;
+    const int maxPoints = 1000;
+    store.samples(QStringLiteral("topic.value"), store.startTime(), store.endTime(), maxPoints, points);
+    QVERIFY(points.count() <= maxPoints);
+    QVERIFY(points.count() > maxPoints / LogAnalysisStore::decimationFactor);
+    double maxValue = 0;
+    for (const QPointF& point: points) {
+        maxValue = qMax(maxValue, point.y());
+    }
+    QCOMPARE(maxValue, 50.0);
+
+    // Zoomed in far enough the raw samples are returned, with one extra sample on each side
+    store.samples(QStringLiteral("topic.value"), 10.0, 10.1, maxPoints, points);
+    QCOMPARE(points.count(), 103);
+    QCOMPARE(points.first().x(), times[9999]);
+    QCOMPARE(points.last().x(), times[10101]);
+    QCOMPARE(points[1].y(), static_cast<double>(values[10000]));
+}
+
+void LogAnalysisStoreTest::_spectrum_test(void)
+{
+    // 2 m/s^2 at 80Hz on top of gravity, sampled at 1kHz
+    const double    sampleRate =    1000;
+    const double    frequency =     80;
+    const int       sampleCount =   20000;
+    QVector<double> times(sampleCount);
+    QVector<float>  values(sampleCount);
+    for (int i=0; i<sampleCount; i++) {
+        times[i] = i / sampleRate;
+        values[i] = static_cast<float>(-9.81 + 2.0 * std::sin(2.0 * M_PI * frequency * times[i]));
+    }
+
+    LogAnalysisStore::Spectrum spectrum = LogAnalysisStore::computeSpectrum(times, values);
+    QCOMPARE(spectrum.frequencies.count(), LogAnalysisStore::spectrumSegmentSize / 2 + 1);
+    QVERIFY(qAbs(spectrum.sampleRate - sampleRate) < 0.01);
+    QVERIFY(qAbs(spectrum.peakFrequency - frequency) <= sampleRate / LogAnalysisStore::spectrumSegmentSize);
+    QVERIFY(spectrum.peakMagnitude > 1.6 && spectrum.peakMagnitude < 2.1);
+
+    // Accelerometer series get a cached spectrum for the vibration summary
+    LogAnalysisStore store;
+    QVector<float> zeros(sampleCount, 0);
+    store.addTable(QStringLiteral("sensor_combined"), times, { QStringLiteral("accelerometer_m_s2[0]"), QStringLiteral("accelerometer_m_s2[1]"), QStringLiteral("accelerometer_m_s2[2]") }, { zeros, zeros, values });
+    store.finalize();
+    QCOMPARE(store.vibrationSeriesNames().count(), 3);
+    QCOMPARE(store.spectrum(QStringLiteral("sensor_combined.accelerometer_m_s2[2]")).peakFrequency, spectrum.peakFrequency);
+
+    // Too short for a spectrum
+    QVERIFY(qIsNaN(LogAnalysisStore::computeSpectrum(times.mid(0, 8), values.mid(0, 8)).peakFrequency));
+}
+
+void LogAnalysisStoreTest::_uLogLoad_test(void)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    // Multi instance imu topic with an array field, instance 1 starts logging later
+    QByteArray log("ULog\x01\x12\x35\x01", 8);
+    log += QByteArray(8, 0);
+    log += _uLogMessage('F', "imu:uint64_t timestamp;float[3] acc;int16_t temp;uint8_t[2] _padding0;");
+    for (int multiId=0; multiId<2; multiId++) {
+        QByteArray addLogged(3, 0);
+        addLogged[0] = static_cast<char>(multiId);
+        qToLittleEndian<quint16>(static_cast<quint16>(multiId + 1), addLogged.data() + 1);
+        log += _uLogMessage('A', addLogged + "imu");
+    }
+    const struct {
+        int     multiId;
+        quint64 timestamp;
+        qint16  temp;
+    } rgData[] = {
+        { 0, 2000000, 20 },
+        { 0, 2500000, -5 },
+        { 1, 3000000, 40 },
+    };
+    for (const auto& data: rgData) {
+        QByteArray payload(2 + 8 + 12 + 2, 0);
+        qToLittleEndian<quint16>(static_cast<quint16>(data.multiId + 1), payload.data());
+        qToLittleEndian<quint64>(data.timestamp, payload.data() + 2);
+        for (int i=0; i<3; i++) {
+            float acc = data.temp + i;
+            memcpy(payload.data() + 2 + 8 + i * 4, &acc, sizeof(acc));
+        }
+        qToLittleEndian<qint16>(data.temp, payload.data() + 2 + 8 + 12);
+        log += _uLogMessage('D', payload);
+    }
+    QString logFile = tempDir.filePath(QStringLiteral("test.ulg"));
+    _writeFile(logFile, log);
+
+    LogAnalysisStore store;
+    QString errorString;
+    QVERIFY2(store.load(logFile, errorString), qPrintable(errorString));
+
+    // Each instance is its own table, array elements are their own series and padding is skipped
+    QStringList seriesNames = store.seriesNames();
+    seriesNames.sort();
+    QCOMPARE(seriesNames, QStringList({ QStringLiteral("imu.acc[0]"), QStringLiteral("imu.acc[1]"), QStringLiteral("imu.acc[2]"), QStringLiteral("imu.temp"),
+                                        QStringLiteral("imu_1.acc[0]"), QStringLiteral("imu_1.acc[1]"), QStringLiteral("imu_1.acc[2]"), QStringLiteral("imu_1.temp") }));
+
+    // Times are relative to the first message in the log
+    QCOMPARE(store.startTime(), 0.0);
+    QCOMPARE(store.endTime(), 1.0);
+
+    LogAnalysisStore::Statistics statistics = store.statistics(QStringLiteral("imu.temp"));
+    QCOMPARE(statistics.count, 2);
+    QCOMPARE(statistics.min, -5.0);
+    QCOMPARE(statistics.max, 20.0);
+    QCOMPARE(store.statistics(QStringLiteral("imu.acc[2]")).max, 22.0);
+    QCOMPARE(store.statistics(QStringLiteral("imu_1.temp")).mean, 40.0);
+
+    QList<QPointF> points;
+    store.samples(QStringLiteral("imu.temp"), store.startTime(), store.endTime(), 100, points);
+    QCOMPARE(points.count(), 2);
+    QCOMPARE(points[0], QPointF(0.0, 20.0));
+    QCOMPARE(points[1], QPointF(0.5, -5.0));
+}
+
+void LogAnalysisStoreTest::_tLogLoad_test(void)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    // ATTITUDE from two systems, telemetry logs store a big endian microsecond timestamp in front of each message
+    const quint64 startTimestamp = Q_UINT64_C(1600000000000000);
+    const struct {
+        quint64 timestamp;
+        uint8_t sysid;
+        float   roll;
+        float   yawspeed;
+    } rgData[] = {
+        { startTimestamp,           1, 0.1f,    1.0f },
+        { startTimestamp + 100000,  1, 0.3f,    0.0f },     // Trailing zero is trimmed from the MAVLink 2 payload
+        { startTimestamp + 200000,  2, -0.2f,   2.0f },
+    };
+    QByteArray log;
+    for (const auto& data: rgData) {
+        mavlink_message_t msg;
+        mavlink_msg_attitude_pack(data.sysid, MAV_COMP_ID_AUTOPILOT1, &msg, 1000, data.roll, 0.5f, 0.6f, 0.7f, 0.8f, data.yawspeed);
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        uint16_t length = mavlink_msg_to_send_buffer(buffer, &msg);
+
+        QByteArray timestamp(8, 0);
+        qToBigEndian<quint64>(data.timestamp, timestamp.data());
+        log += timestamp;
+        log += QByteArray(reinterpret_cast<const char*>(buffer), length);
+    }
+    QString logFile = tempDir.filePath(QStringLiteral("test.tlog"));
+    _writeFile(logFile, log);
+
+    LogAnalysisStore store;
+    QString errorString;
+    QVERIFY2(store.load(logFile, errorString), qPrintable(errorString));
+
+    // The second system gets its own table
+    QVERIFY(store.contains(QStringLiteral("ATTITUDE.roll")));
+    QVERIFY(store.contains(QStringLiteral("ATTITUDE.time_boot_ms")));
+    QVERIFY(store.contains(QStringLiteral("ATTITUDE_2_1.roll")));
+    QCOMPARE(store.startTime(), 0.0);
+    QCOMPARE(store.endTime(), 0.2);
+
+    QList<QPointF> points;
+    store.samples(QStringLiteral("ATTITUDE.roll"), store.startTime(), store.endTime(), 100, points);
+    QCOMPARE(points.count(), 2);
+    QCOMPARE(points[0], QPointF(0.0, static_cast<double>(0.1f)));
+    QCOMPARE(points[1], QPointF(0.1, static_cast<double>(0.3f)));
+
+    LogAnalysisStore::Statistics statistics = store.statistics(QStringLiteral("ATTITUDE.yawspeed"));
+    QCOMPARE(statistics.count, 2);
+    QCOMPARE(statistics.min, 0.0);
+    QCOMPARE(statistics.max, 1.0);
+    QCOMPARE(store.statistics(QStringLiteral("ATTITUDE_2_1.roll")).count, 1);
+}
+
+void LogAnalysisStoreTest::_unsupportedLoad_test(void)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    LogAnalysisStore store;
+    QString errorString;
+    QString textFile = tempDir.filePath(QStringLiteral("test.txt"));
+    _writeFile(textFile, QByteArray("not a log"));
+    QVERIFY(!store.load(textFile, errorString));
+    QVERIFY(!errorString.isEmpty());
+
+    // A telemetry log without a single MAVLink frame
+    QString tlogFile = tempDir.filePath(QStringLiteral("empty.tlog"));
+    _writeFile(tlogFile, QByteArray(64, 'x'));
+    QVERIFY(!store.load(tlogFile, errorString));
+    QVERIFY(!errorString.isEmpty());
+    QVERIFY(store.seriesNames().isEmpty());
+}
@@ -0,0 +1,29 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class LogAnalysisStoreTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _statistics_test(void);
+    void _decimation_test(void);
+    void _spectrum_test(void);
+    void _uLogLoad_test(void);
+    void _tLogLoad_test(void);
+    void _unsupportedLoad_test(void);
+
+private:
+    static QByteArray _uLogMessage(char msgType, const QByteArray& payload);
+    static void _writeFile(const QString& fileName, const QByteArray& bytes);
+};
@@ -25,18 +25,28 @@
 #include <QBitArray>
 #include <QtCore/qmath.h>
 
-#define kTimeOutMilliseconds 500
-#define kGUIRateMilliseconds 17
-#define kTableBins           512
-#define kChunkSize           (kTableBins * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN)
+#define kTimeOutMilliseconds            500
+#define kMinDataTimeOutMilliseconds     200
+#define kMaxDataTimeOutMilliseconds     5000
+#define kMaxTimeoutBackoff              16
+#define kGUIRateMilliseconds            17
+#define kTableBins                      512
+#define kWindowChunks                   8
+#define kWindowBins                     (kTableBins * kWindowChunks)
+#define kMaxHoleGapBins                 32
 
 QGC_LOGGING_CATEGORY(LogDownloadLog, "LogDownloadLog")
 
 //-----------------------------------------------------------------------------
 struct LogDownloadData {
     LogDownloadData(QGCLogEntry* entry);
-    QBitArray     chunk_table;
-    uint32_t      current_chunk;
+    QBitArray     bins;             ///< One bit for each MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN bytes of the whole log
+    uint32_t      binsReceived;
+    uint32_t      firstMissingBin;  ///< All bins below this one have been received
+    uint32_t      requestStartBin;  ///< Bin range of the outstanding LOG_REQUEST_DATA
+    uint32_t      requestEndBin;
+    bool          requestSampled;   ///< true: Outstanding request already gave a round trip sample, or is a resend
+    QElapsedTimer requestTimer;
     QFile         file;
     QString       filename;
     uint          ID;
@@ -45,37 +55,28 @@ struct LogDownloadData {
     size_t        rate_bytes;
     qreal         rate_avg;
     QElapsedTimer elapsed;
+    QElapsedTimer downloadTimer;
 
-    void advanceChunk()
+    // The number of MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN bins in the file
+    uint32_t numBins() const
     {
-           current_chunk++;
-           chunk_table = QBitArray(chunkBins(), false);
+        return qCeil(entry->size() / static_cast<qreal>(MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN));
     }
 
-    // The number of MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN bins in the current chunk
-    uint32_t chunkBins() const
+    bool complete() const
     {
-        return qMin(qCeil((entry->size() - current_chunk*kChunkSize)/static_cast<qreal>(MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN)),
-                    kTableBins);
+        return binsReceived == static_cast<uint32_t>(bins.size());
     }
-
-    // The number of kChunkSize chunks in the file
-    uint32_t numChunks() const
-    {
-        return qCeil(entry->size() / static_cast<qreal>(kChunkSize));
-    }
-
-    // True if all bins in the chunk have been set to val
-    bool chunkEquals(const bool val) const
-    {
-        return chunk_table == QBitArray(chunk_table.size(), val);
-    }
-
 };
 
 //----------------------------------------------------------------------------------------
 LogDownloadData::LogDownloadData(QGCLogEntry* entry_)
-    : ID(entry_->id())
+    : binsReceived(0)
+    , firstMissingBin(0)
+    , requestStartBin(0)
+    , requestEndBin(0)
+    , requestSampled(false)
+    , ID(entry_->id())
     , entry(entry_)
     , written(0)
     , rate_bytes(0)
@@ -111,6 +112,9 @@ LogDownloadController::LogDownloadController(void)
     , _downloadingLogs(false)
     , _retries(0)
     , _apmOneBased(0)
+    , _srttMilliseconds(-1)
+    , _rttVarMilliseconds(0)
+    , _timeoutBackoff(1)
 {
     MultiVehicleManager *manager = qgcApp()->toolbox()->multiVehicleManager();
     connect(manager, &MultiVehicleManager::activeVehicleChanged, this, &LogDownloadController::_setActiveVehicle);
@@ -330,75 +334,65 @@ LogDownloadController::_logData(UASInterface* uas, uint32_t ofs, uint16_t id, ui
         return;
     }
 
-    bool result = false;
-    uint32_t timeout_time = kTimeOutMilliseconds;
-    if(ofs <= _downloadData->entry->size()) {
-        const uint32_t chunk = ofs / kChunkSize;
-        if (chunk != _downloadData->current_chunk) {
-            qWarning() << "Ignored packet for out of order chunk actual:expected" << chunk << _downloadData->current_chunk;
-            return;
-        }
-        const uint16_t bin = (ofs - chunk*kChunkSize) / MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
-        if (bin >= _downloadData->chunk_table.size()) {
-            qWarning() << "Out of range bin received";
-        } else
-            _downloadData->chunk_table.setBit(bin);
+    //-- Any data inside the log is accepted, no matter which request it belongs to
+    const uint32_t bin = ofs / MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+    if (bin >= static_cast<uint32_t>(_downloadData->bins.size())) {
+        qWarning() << "Received log offset greater than expected";
+        _downloadData->entry->setStatus(tr("Error"));
+        return;
+    }
+
+    if (!_downloadData->requestSampled && bin >= _downloadData->requestStartBin && bin < _downloadData->requestEndBin) {
+        _downloadData->requestSampled = true;
+        _addRoundTripSample(_downloadData->requestTimer.elapsed());
+    }
+    _timeoutBackoff = 1;
+
+    if (!_downloadData->bins.testBit(static_cast<int>(bin))) {
         if (_downloadData->file.pos() != ofs) {
             // Seek to correct position
             if (!_downloadData->file.seek(ofs)) {
                 qWarning() << "Error while seeking log file offset";
+                _downloadData->entry->setStatus(tr("Error"));
                 return;
             }
         }
 
-        //-- Write chunk to file
-        if(_downloadData->file.write((const char*)data, count)) {
-            _downloadData->written += count;
-            _downloadData->rate_bytes += count;
-            _updateDataRate();
-            result = true;
-            //-- reset retries
-            _retries = 0;
-            //-- Reset timer
-            _timer.start(timeout_time);
-            //-- Do we have it all?
-            if(_logComplete()) {
-                _downloadData->entry->setStatus(tr("Downloaded"));
-                //-- Check for more
-                _receivedAllData();
-            } else if (_chunkComplete()) {
-                _downloadData->advanceChunk();
-                _requestLogData(_downloadData->ID,
-                                _downloadData->current_chunk*kChunkSize,
-                                _downloadData->chunk_table.size()*MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
-            } else if (bin < _downloadData->chunk_table.size() - 1 && _downloadData->chunk_table.at(bin+1)) {
-                // Likely to be grabbing fragments and got to the end of a gap
-                _findMissingData();
-            }
-        } else {
+        //-- Write bin to file
+        if(!_downloadData->file.write((const char*)data, count)) {
             qWarning() << "Error while writing log file chunk";
+            _downloadData->entry->setStatus(tr("Error"));
+            return;
         }
-    } else {
-        qWarning() << "Received log offset greater than expected";
-    }
-    if(!result) {
-        _downloadData->entry->setStatus(tr("Error"));
-    }
-}
 
+        _downloadData->bins.setBit(static_cast<int>(bin));
+        _downloadData->binsReceived++;
+        _downloadData->written += count;
+        _downloadData->rate_bytes += count;
+        while (_downloadData->firstMissingBin < static_cast<uint32_t>(_downloadData->bins.size()) && _downloadData->bins.testBit(static_cast<int>(_downloadData->firstMissingBin))) {
+            _downloadData->firstMissingBin++;
+        }
+    }
+    _updateDataRate();
+    //-- reset retries
+    _retries = 0;
 
-//----------------------------------------------------------------------------------------
-bool
-LogDownloadController::_chunkComplete() const
-{
-    return _downloadData->chunkEquals(true);
-}
-
-//----------------------------------------------------------------------------------------
-bool
-LogDownloadController::_logComplete() const
-{
-    return _chunkComplete() && (_downloadData->current_chunk+1) == _downloadData->numChunks();
+    //-- Do we have it all?
+    if(_downloadData->complete()) {
+        qCDebug(LogDownloadLog) << "Downloaded" << _downloadData->filename << _downloadData->written << "bytes in" << _downloadData->downloadTimer.elapsed() << "ms"
+                                << "effective rate" << _downloadData->written / qMax(_downloadData->downloadTimer.elapsed() / 1000.0, 0.001) << "bytes/s"
+                                << "srtt" << _srttMilliseconds;
+        _downloadData->entry->setStatus(tr("Downloaded"));
+        //-- Check for more
+        _receivedAllData();
+    } else if (bin + 1 == _downloadData->requestEndBin) {
+        //-- Last bin of the active request, ask for whatever is still missing. Late data from earlier requests, or a lost
+        //-- last bin, is left to the timeout so stale packets can't trigger duplicate requests.
+        _requestMissingData();
+    } else {
+        //-- Reset timer
+        _timer.start(_dataTimeoutMilliseconds());
+    }
 }
 
 //----------------------------------------------------------------------------------------
@@ -407,25 +401,26 @@ LogDownloadController::_receivedAllData()
 {
     _timer.stop();
     //-- Anything queued up for download?
-    if(_prepareLogDownload()) {
-        //-- Request Log
-        _requestLogData(_downloadData->ID, 0, _downloadData->chunk_table.size()*MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
-        _timer.start(kTimeOutMilliseconds);
-    } else {
-        _resetSelection();
-        _setDownloading(false);
+    while(_prepareLogDownload()) {
+        if (!_downloadData->complete()) {
+            //-- Request Log
+            _requestMissingData();
+            return;
+        }
+        //-- Empty log, nothing to request
+        _downloadData->entry->setStatus(tr("Downloaded"));
     }
+    _resetSelection();
+    _setDownloading(false);
 }
 
 //----------------------------------------------------------------------------------------
 void
 LogDownloadController::_findMissingData()
 {
-    if (_logComplete()) {
+    if (_downloadData->complete()) {
          _receivedAllData();
          return;
-    } else if (_chunkComplete()) {
-        _downloadData->advanceChunk();
     }
 
     _retries++;
@@ -441,25 +436,67 @@ LogDownloadController::_findMissingData()
     }
 #endif
 
+    _timeoutBackoff = qMin(_timeoutBackoff * 2, kMaxTimeoutBackoff);
     _updateDataRate();
+    _requestMissingData();
+}
 
-    uint16_t start = 0, end = 0;
-    const int size = _downloadData->chunk_table.size();
-    for (; start < size; start++) {
-        if (!_downloadData->chunk_table.testBit(start)) {
-            break;
+//----------------------------------------------------------------------------------------
+/// Requests the first hole in the log. Vehicles only service one LOG_REQUEST_DATA at a time, so holes which are close
+/// together are coalesced into a single request of up to kWindowBins. Bins already received in between are resent
+/// and ignored, which is cheaper than a round trip for each hole.
+void
+LogDownloadController::_requestMissingData()
+{
+    const uint32_t numBins  = static_cast<uint32_t>(_downloadData->bins.size());
+    const uint32_t start    = _downloadData->firstMissingBin;
+    const uint32_t limit    = qMin(numBins, start + kWindowBins);
+    uint32_t lastMissing    = start;
+    for (uint32_t bin = start + 1; bin < limit; bin++) {
+        if (!_downloadData->bins.testBit(static_cast<int>(bin))) {
+            if (bin - lastMissing > kMaxHoleGapBins) {
+                break;
+            }
+            lastMissing = bin;
         }
     }
 
-    for (end = start; end < size; end++) {
-        if (_downloadData->chunk_table.testBit(end)) {
-            break;
-        }
+    _downloadData->requestStartBin  = start;
+    _downloadData->requestEndBin    = lastMissing + 1;
+    // Karn's algorithm: a resent request can't tell which request the data answers
+    _downloadData->requestSampled   = _timeoutBackoff > 1;
+    _downloadData->requestTimer.start();
+
+    _requestLogData(_downloadData->ID,
+                    start * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN,
+                    (_downloadData->requestEndBin - start) * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN,
+                    _retries);
+    _timer.start(_dataTimeoutMilliseconds());
+}
+
+//----------------------------------------------------------------------------------------
+void
+LogDownloadController::_addRoundTripSample(qint64 rttMilliseconds)
+{
+    // RFC 6298 smoothing
+    if (_srttMilliseconds < 0) {
+        _srttMilliseconds = rttMilliseconds;
+        _rttVarMilliseconds = rttMilliseconds / 2.0;
+    } else {
+        _rttVarMilliseconds = 0.75 * _rttVarMilliseconds + 0.25 * qAbs(_srttMilliseconds - rttMilliseconds);
+        _srttMilliseconds = 0.875 * _srttMilliseconds + 0.125 * rttMilliseconds;
     }
+}
 
-    const uint32_t pos = _downloadData->current_chunk*kChunkSize + start*MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN,
-                   len = (end - start)*MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
-    _requestLogData(_downloadData->ID, pos, len, _retries);
+//----------------------------------------------------------------------------------------
+int
+LogDownloadController::_dataTimeoutMilliseconds() const
+{
+    if (_srttMilliseconds < 0) {
+        return kTimeOutMilliseconds * _timeoutBackoff;
+    }
+    int timeout = qBound(kMinDataTimeOutMilliseconds, static_cast<int>(_srttMilliseconds + 4 * _rttVarMilliseconds), kMaxDataTimeOutMilliseconds);
+    return qMin(timeout * _timeoutBackoff, kMaxDataTimeOutMilliseconds);
 }
 
 //----------------------------------------------------------------------------------------
@@ -633,9 +670,10 @@ LogDownloadController::_prepareLogDownload()
         if(!_downloadData->file.resize(entry->size())) {
             qWarning() << "Failed to allocate space for log file:" <<  _downloadData->filename;
         } else {
-            _downloadData->current_chunk = 0;
-            _downloadData->chunk_table = QBitArray(_downloadData->chunkBins(), false);
+            _downloadData->bins = QBitArray(static_cast<int>(_downloadData->numBins()), false);
             _downloadData->elapsed.start();
+            _downloadData->downloadTimer.start();
+            _timeoutBackoff = 1;
             result = true;
         }
     }
@@ -145,13 +145,14 @@ private slots:
 
 private:
     bool _entriesComplete   ();
-    bool _chunkComplete     () const;
-    bool _logComplete       () const;
     void _findMissingEntries();
     void _receivedAllEntries();
     void _receivedAllData   ();
     void _resetSelection    (bool canceled = false);
     void _findMissingData   ();
+    void _requestMissingData();
+    void _addRoundTripSample(qint64 rttMilliseconds);
+    int  _dataTimeoutMilliseconds() const;
     void _requestLogList    (uint32_t start, uint32_t end);
     void _requestLogData    (uint16_t id, uint32_t offset, uint32_t count, int retryCount = 0);
     bool _prepareLogDownload();
@@ -170,6 +171,9 @@ private:
     bool                _downloadingLogs;
     int                 _retries;
     int                 _apmOneBased;
+    double              _srttMilliseconds;      ///< Smoothed LOG_REQUEST_DATA round trip time, -1 until the first sample
+    double              _rttVarMilliseconds;
+    int                 _timeoutBackoff;        ///< Doubled on each timeout, reset on any data
     QString             _downloadPath;
 };
 
@@ -25,8 +25,11 @@ private slots:
     //void cleanup(void) { _cleanup(); }
 
     void downloadTest(void);
+    void lossyDownloadTest(void);
 
 private:
+    void _downloadTest(uint32_t fileSize, int lossPct, int packetsPerTick, int latencyMsecs);
+
     // LogDownloadController signals
 
     enum {
@@ -38,7 +38,7 @@ QGCMAVLinkMessageField::addSeries(MAVLinkChartController* chart, QAbstractSeries
         _chart = chart;
         _pSeries = series;
         emit seriesChanged();
-        _dataIndex = 0;
+        _seriesBucketWidth = 0;
         _msg->updateFieldSelection();
     }
 }
@@ -48,9 +48,9 @@ void
 QGCMAVLinkMessageField::delSeries()
 {
     if(_pSeries) {
-        _values.clear();
+        _timeSeries.clear();
         QLineSeries* lineSeries = static_cast<QLineSeries*>(_pSeries);
-        lineSeries->replace(_values);
+        lineSeries->clear();
         _pSeries = nullptr;
         _chart   = nullptr;
         emit seriesChanged();
@@ -87,46 +87,20 @@ QGCMAVLinkMessageField::chartIndex()
 
 //-----------------------------------------------------------------------------
 void
-QGCMAVLinkMessageField::updateValue(QString newValue, qreal v)
+QGCMAVLinkMessageField::updateValue(const QString& newValue)
 {
     if(_value != newValue) {
         _value = newValue;
         emit valueChanged();
     }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCMAVLinkMessageField::appendSample(qreal v)
+{
     if(_pSeries && _chart) {
-        int count = _values.count();
-        //-- Arbitrary limit of 1 minute of data at 50Hz for now
-        if(count < (50 * 60)) {
-            QPointF p(QGC::bootTimeMilliseconds(), v);
-            _values.append(p);
-        } else {
-            if(_dataIndex >= count) _dataIndex = 0;
-            _values[_dataIndex].setX(QGC::bootTimeMilliseconds());
-            _values[_dataIndex].setY(v);
-            _dataIndex++;
-        }
-        //-- Auto Range
-        if(_chart->rangeYIndex() == 0) {
-            qreal vmin  = std::numeric_limits<qreal>::max();
-            qreal vmax  = std::numeric_limits<qreal>::min();
-            for(int i = 0; i < _values.count(); i++) {
-                qreal v = _values[i].y();
-                if(vmax < v) vmax = v;
-                if(vmin > v) vmin = v;
-            }
-            bool changed = false;
-            if(std::abs(_rangeMin - vmin) > 0.000001) {
-                _rangeMin = vmin;
-                changed = true;
-            }
-            if(std::abs(_rangeMax - vmax) > 0.000001) {
-                _rangeMax = vmax;
-                changed = true;
-            }
-            if(changed) {
-                _chart->updateYRange();
-            }
-        }
+        _timeSeries.append(QGC::bootTimeMilliseconds(), v);
     }
 }
 
@@ -134,18 +108,54 @@ QGCMAVLinkMessageField::updateValue(QString newValue, qreal v)
 void
 QGCMAVLinkMessageField::updateSeries()
 {
-    int count = _values.count();
-    if (count > 1) {
-        QList<QPointF> s;
-        s.reserve(count);
-        int idx = _dataIndex;
-        for(int i = 0; i < count; i++, idx++) {
-            if(idx >= count) idx = 0;
-            QPointF p(_values[idx]);
-            s.append(p);
+    if(!_pSeries || !_chart) {
+        return;
+    }
+    QLineSeries* lineSeries = static_cast<QLineSeries*>(_pSeries);
+    const double xMin           = _chart->rangeXMin().toMSecsSinceEpoch();
+    const double xMax           = _chart->rangeXMax().toMSecsSinceEpoch();
+    const double bucketWidth    = _chart->bucketWidth();
+    QList<QPointF> points;
+    if(std::abs(bucketWidth - _seriesBucketWidth) > 0.000001) {
+        //-- New series or time scale changed, rebuild the series
+        _seriesBucketWidth  = bucketWidth;
+        _seriesEndTime      = _timeSeries.decimate(MAVLinkTimeSeries::bucketStart(xMin, bucketWidth), xMax, bucketWidth, points);
+        lineSeries->replace(points);
+    } else {
+        //-- Only add the buckets completed since the last update and drop what scrolled out of view
+        _seriesEndTime = _timeSeries.decimate(_seriesEndTime, xMax, bucketWidth, points);
+        if(points.count()) {
+            lineSeries->append(points);
+        }
+        int expired = 0;
+        while(expired + 1 < lineSeries->count() && lineSeries->at(expired + 1).x() < xMin) {
+            expired++;
+        }
+        if(expired) {
+            lineSeries->removePoints(0, expired);
+        }
+    }
+    //-- Auto Range, only the (decimated) points in view need to be looked at
+    if(_chart->rangeYIndex() == 0 && lineSeries->count()) {
+        qreal vmin  = std::numeric_limits<qreal>::max();
+        qreal vmax  = std::numeric_limits<qreal>::lowest();
+        const QVector<QPointF> seriesPoints = lineSeries->pointsVector();
+        for(const QPointF& p : seriesPoints) {
+            if(vmax < p.y()) vmax = p.y();
+            if(vmin > p.y()) vmin = p.y();
+        }
+        bool changed = false;
+        if(std::abs(_rangeMin - vmin) > 0.000001) {
+            _rangeMin = vmin;
+            changed = true;
+        }
+        if(std::abs(_rangeMax - vmax) > 0.000001) {
+            _rangeMax = vmax;
+            changed = true;
+        }
+        if(changed) {
+            _chart->updateYRange();
         }
-        QLineSeries* lineSeries = static_cast<QLineSeries*>(_pSeries);
-        lineSeries->replace(s);
     }
 }
 
@@ -177,6 +187,7 @@ QGCMAVLinkMessage::QGCMAVLinkMessage(QObject *parent, mavlink_message_t* message
             case MAVLINK_TYPE_INT64_T:  type = QString("int64_t");  break;
         }
         QGCMAVLinkMessageField* f = new QGCMAVLinkMessageField(this, msgInfo->fields[i].name, type);
+        f->setSelectable(msgInfo->fields[i].type != MAVLINK_TYPE_CHAR);
         _fields.append(f);
     }
 }
@@ -215,13 +226,19 @@ QGCMAVLinkMessage::updateFreq()
     _messageHz = (0.2 * _messageHz) + (0.8 * msgCount);
     _lastCount = _count;
     emit freqChanged();
+    if(msgCount) {
+        emit countChanged();
+    }
 }
 
 void QGCMAVLinkMessage::setSelected(bool sel)
 {
     if (_selected != sel) {
         _selected = sel;
-        _updateFields();
+        if (_selected) {
+            _updateFields(false);
+            _displayDirty = false;
+        }
         emit selectedChanged();
     }
 }
@@ -233,14 +250,53 @@ QGCMAVLinkMessage::update(mavlink_message_t* message)
     _count++;
     _message = *message;
 
+    // Only charted fields need every sample. The displayed values of the selected message are decoded at display rate
+    // by updateDisplay and everything else only counts messages.
+    if (_fieldSelected) {
+        _updateFields(true);
+    }
     if (_selected) {
-        // Don't update field info unless selected to reduce perf hit of message processing
-        _updateFields();
+        _displayDirty = true;
     }
-    emit countChanged();
 }
 
-void QGCMAVLinkMessage::_updateFields(void)
+//-----------------------------------------------------------------------------
+void
+QGCMAVLinkMessage::updateDisplay()
+{
+    if (_displayDirty) {
+        _displayDirty = false;
+        _updateFields(false);
+        emit countChanged();
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Decodes the first value of a field and optionally its display string
+template<typename T>
+static qreal
+decodeFieldValue(const uint8_t* data, unsigned int arrayLength, QString* string)
+{
+    T value;
+    memcpy(&value, data, sizeof(T));
+    if (string) {
+        if (arrayLength > 0) {
+            QStringList values;
+            values.reserve(static_cast<int>(arrayLength));
+            for (unsigned int i = 0; i < arrayLength; ++i) {
+                T element;
+                memcpy(&element, data + (i * sizeof(T)), sizeof(T));
+                values.append(QString::number(element));
+            }
+            *string = values.join(QStringLiteral(", "));
+        } else {
+            *string = QString::number(value);
+        }
+    }
+    return static_cast<qreal>(value);
+}
+
+void QGCMAVLinkMessage::_updateFields(bool chartedOnly)
 {
     const mavlink_message_info_t* msgInfo = mavlink_get_message_info(&_message);
     if (!msgInfo) {
@@ -251,218 +307,72 @@ void QGCMAVLinkMessage::_updateFields(void)
         qWarning() << QStringLiteral("QGCMAVLinkMessage::update msgInfo field count mismatch msgid(%1)").arg(_message.msgid);
         return;
     }
-    uint8_t* m = reinterpret_cast<uint8_t*>(&_message.payload64[0]);
+    const uint8_t* m = reinterpret_cast<const uint8_t*>(&_message.payload64[0]);
     for (unsigned int i = 0; i < msgInfo->num_fields; ++i) {
         QGCMAVLinkMessageField* f = qobject_cast<QGCMAVLinkMessageField*>(_fields.get(static_cast<int>(i)));
-        if(f) {
-            const unsigned int offset = msgInfo->fields[i].wire_offset;
-            const unsigned int array_length = msgInfo->fields[i].array_length;
-            static const unsigned int array_buffer_length = (MAVLINK_MAX_PAYLOAD_LEN + MAVLINK_NUM_CHECKSUM_BYTES + 7);
-            switch (msgInfo->fields[i].type) {
-            case MAVLINK_TYPE_CHAR:
-                f->setSelectable(false);
-                if (array_length > 0) {
-                    char* str = reinterpret_cast<char*>(m + offset);
-                    // Enforce null termination
-                    str[array_length - 1] = '\0';
-                    QString v(str);
-                    f->updateValue(v, 0);
-                } else {
-                    // Single char
-                    char b = *(reinterpret_cast<char*>(m + offset));
-                    QString v(b);
-                    f->updateValue(v, 0);
-                }
-                break;
-            case MAVLINK_TYPE_UINT8_T:
-                if (array_length > 0) {
-                    uint8_t* nums = m + offset;
-                    QString tmp("%1, ");
-                    QString string;
-                    for (unsigned int j = 0; j < array_length - 1; ++j) {
-                        string += tmp.arg(nums[j]);
-                    }
-                    string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
-                } else {
-                    // Single value
-                    uint8_t u = *(m + offset);
-                    f->updateValue(QString::number(u), static_cast<qreal>(u));
-                }
-                break;
-            case MAVLINK_TYPE_INT8_T:
-                if (array_length > 0) {
-                    int8_t* nums = reinterpret_cast<int8_t*>(m + offset);
-                    QString tmp("%1, ");
-                    QString string;
-                    for (unsigned int j = 0; j < array_length - 1; ++j) {
-                        string += tmp.arg(nums[j]);
-                    }
-                    string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
-                } else {
-                    // Single value
-                    int8_t n = *(reinterpret_cast<int8_t*>(m + offset));
-                    f->updateValue(QString::number(n), static_cast<qreal>(n));
-                }
-                break;
-            case MAVLINK_TYPE_UINT16_T:
-                if (array_length > 0) {
-                    uint16_t nums[array_buffer_length / sizeof(uint16_t)];
-                    memcpy(nums, m + offset,  sizeof(uint16_t) * array_length);
-                    QString tmp("%1, ");
-                    QString string;
-                    for (unsigned int j = 0; j < array_length - 1; ++j) {
-                        string += tmp.arg(nums[j]);
-                    }
-                    string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
-                } else {
-                    // Single value
-                    uint16_t n;
-                    memcpy(&n, m + offset, sizeof(uint16_t));
-                    f->updateValue(QString::number(n), static_cast<qreal>(n));
-                }
-                break;
-            case MAVLINK_TYPE_INT16_T:
-                if (array_length > 0) {
-                    int16_t nums[array_buffer_length / sizeof(int16_t)];
-                    memcpy(nums, m + offset,  sizeof(int16_t) * array_length);
-                    QString tmp("%1, ");
-                    QString string;
-                    for (unsigned int j = 0; j < array_length - 1; ++j) {
-                        string += tmp.arg(nums[j]);
-                    }
-                    string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
-                } else {
-                    // Single value
-                    int16_t n;
-                    memcpy(&n, m + offset, sizeof(int16_t));
-                    f->updateValue(QString::number(n), static_cast<qreal>(n));
-                }
-                break;
-            case MAVLINK_TYPE_UINT32_T:
-                if (array_length > 0) {
-                    uint32_t nums[array_buffer_length / sizeof(uint32_t)];
-                    memcpy(nums, m + offset,  sizeof(uint32_t) * array_length);
-                    QString tmp("%1, ");
-                    QString string;
-                    for (unsigned int j = 0; j < array_length - 1; ++j) {
-                        string += tmp.arg(nums[j]);
-                    }
-                    string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
-                } else {
-                    // Single value
-                    uint32_t n;
-                    memcpy(&n, m + offset, sizeof(uint32_t));
-                    //-- Special case
-                    if(_message.msgid == MAVLINK_MSG_ID_SYSTEM_TIME) {
-                        QDateTime d = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(n),Qt::UTC,0);
-                        f->updateValue(d.toString("HH:mm:ss"), static_cast<qreal>(n));
-                    } else {
-                        f->updateValue(QString::number(n), static_cast<qreal>(n));
-                    }
-                }
-                break;
-            case MAVLINK_TYPE_INT32_T:
-                if (array_length > 0) {
-                    int32_t nums[array_buffer_length / sizeof(int32_t)];
-                    memcpy(nums, m + offset,  sizeof(int32_t) * array_length);
-                    QString tmp("%1, ");
-                    QString string;
-                    for (unsigned int j = 0; j < array_length - 1; ++j) {
-                        string += tmp.arg(nums[j]);
-                    }
-                    string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
-                } else {
-                    // Single value
-                    int32_t n;
-                    memcpy(&n, m + offset, sizeof(int32_t));
-                    f->updateValue(QString::number(n), static_cast<qreal>(n));
-                }
-                break;
-            case MAVLINK_TYPE_FLOAT:
-                if (array_length > 0) {
-                    float nums[array_buffer_length / sizeof(float)];
-                    memcpy(nums, m + offset,  sizeof(float) * array_length);
-                    QString tmp("%1, ");
-                    QString string;
-                    for (unsigned int j = 0; j < array_length - 1; ++j) {
-                       string += tmp.arg(static_cast<double>(nums[j]));
-                    }
-                    string += QString::number(static_cast<double>(nums[array_length - 1]));
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
-                } else {
-                    // Single value
-                    float fv;
-                    memcpy(&fv, m + offset, sizeof(float));
-                    f->updateValue(QString::number(static_cast<double>(fv)), static_cast<qreal>(fv));
-                }
-                break;
-            case MAVLINK_TYPE_DOUBLE:
-                if (array_length > 0) {
-                    double nums[array_buffer_length / sizeof(double)];
-                    memcpy(nums, m + offset,  sizeof(double) * array_length);
-                    QString tmp("%1, ");
-                    QString string;
-                    for (unsigned int j = 0; j < array_length - 1; ++j) {
-                        string += tmp.arg(nums[j]);
-                    }
-                    string += QString::number(static_cast<double>(nums[array_length - 1]));
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
-                } else {
-                    // Single value
-                    double d;
-                    memcpy(&d, m + offset, sizeof(double));
-                    f->updateValue(QString::number(d), static_cast<qreal>(d));
-                }
-                break;
-            case MAVLINK_TYPE_UINT64_T:
-                if (array_length > 0) {
-                    uint64_t nums[array_buffer_length / sizeof(uint64_t)];
-                    memcpy(nums, m + offset,  sizeof(uint64_t) * array_length);
-                    QString tmp("%1, ");
-                    QString string;
-                    for (unsigned int j = 0; j < array_length - 1; ++j) {
-                        string += tmp.arg(nums[j]);
-                    }
-                    string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
-                } else {
-                    // Single value
-                    uint64_t n;
-                    memcpy(&n, m + offset, sizeof(uint64_t));
-                    //-- Special case
-                    if(_message.msgid == MAVLINK_MSG_ID_SYSTEM_TIME) {
-                        QDateTime d = QDateTime::fromMSecsSinceEpoch(n/1000,Qt::UTC,0);
-                        f->updateValue(d.toString("yyyy MM dd HH:mm:ss"), static_cast<qreal>(n));
-                    } else {
-                        f->updateValue(QString::number(n), static_cast<qreal>(n));
-                    }
-                }
-                break;
-            case MAVLINK_TYPE_INT64_T:
-                if (array_length > 0) {
-                    int64_t nums[array_buffer_length / sizeof(int64_t)];
-                    memcpy(nums, m + offset,  sizeof(int64_t) * array_length);
-                    QString tmp("%1, ");
-                    QString string;
-                    for (unsigned int j = 0; j < array_length - 1; ++j) {
-                        string += tmp.arg(nums[j]);
-                    }
-                    string += QString::number(nums[array_length - 1]);
-                    f->updateValue(string, static_cast<qreal>(nums[0]));
-                } else {
-                    // Single value
-                    int64_t n;
-                    memcpy(&n, m + offset, sizeof(int64_t));
-                    f->updateValue(QString::number(n), static_cast<qreal>(n));
-                }
-                break;
+        if(!f || (chartedOnly && !f->selected())) {
+            continue;
+        }
+        const uint8_t*      data            = m + msgInfo->fields[i].wire_offset;
+        const unsigned int  array_length    = msgInfo->fields[i].array_length;
+        QString             string;
+        QString*            pString         = chartedOnly ? nullptr : &string;
+        qreal               value           = 0;
+        switch (msgInfo->fields[i].type) {
+        case MAVLINK_TYPE_CHAR:
+            if (pString) {
+                const char* str = reinterpret_cast<const char*>(data);
+                // Strings are not null terminated when they fill the field
+                string = array_length > 0 ? QString::fromLatin1(str, static_cast<int>(qstrnlen(str, array_length))) : QString(QChar(*str));
+            }
+            break;
+        case MAVLINK_TYPE_UINT8_T:
+            value = decodeFieldValue<uint8_t>(data, array_length, pString);
+            break;
+        case MAVLINK_TYPE_INT8_T:
+            value = decodeFieldValue<int8_t>(data, array_length, pString);
+            break;
+        case MAVLINK_TYPE_UINT16_T:
+            value = decodeFieldValue<uint16_t>(data, array_length, pString);
+            break;
+        case MAVLINK_TYPE_INT16_T:
+            value = decodeFieldValue<int16_t>(data, array_length, pString);
+            break;
+        case MAVLINK_TYPE_UINT32_T:
+            value = decodeFieldValue<uint32_t>(data, array_length, pString);
+            //-- Special case
+            if(pString && array_length == 0 && _message.msgid == MAVLINK_MSG_ID_SYSTEM_TIME) {
+                QDateTime d = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(value),Qt::UTC,0);
+                string = d.toString("HH:mm:ss");
             }
+            break;
+        case MAVLINK_TYPE_INT32_T:
+            value = decodeFieldValue<int32_t>(data, array_length, pString);
+            break;
+        case MAVLINK_TYPE_FLOAT:
+            value = decodeFieldValue<float>(data, array_length, pString);
+            break;
+        case MAVLINK_TYPE_DOUBLE:
+            value = decodeFieldValue<double>(data, array_length, pString);
+            break;
+        case MAVLINK_TYPE_UINT64_T:
+            value = decodeFieldValue<uint64_t>(data, array_length, pString);
+            //-- Special case
+            if(pString && array_length == 0 && _message.msgid == MAVLINK_MSG_ID_SYSTEM_TIME) {
+                uint64_t n;
+                memcpy(&n, data, sizeof(uint64_t));
+                QDateTime d = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(n/1000),Qt::UTC,0);
+                string = d.toString("yyyy MM dd HH:mm:ss");
+            }
+            break;
+        case MAVLINK_TYPE_INT64_T:
+            value = decodeFieldValue<int64_t>(data, array_length, pString);
+            break;
+        }
+        if(chartedOnly) {
+            f->appendSample(value);
+        } else {
+            f->updateValue(string);
         }
     }
 }
@@ -485,17 +395,27 @@ QGCMAVLinkSystem::~QGCMAVLinkSystem()
 QGCMAVLinkMessage*
 QGCMAVLinkSystem::findMessage(uint32_t id, uint8_t cid)
 {
-    for(int i = 0; i < _messages.count(); i++) {
-        QGCMAVLinkMessage* m = qobject_cast<QGCMAVLinkMessage*>(_messages.get(i));
-        if(m) {
-            if(m->id() == id && m->cid() == cid) {
-                return m;
-            }
-        }
+    return _messageMap.value(_messageKey(id, cid), nullptr);
+}
+
+//-----------------------------------------------------------------------------
+QGCMAVLinkMessage*
+QGCMAVLinkSystem::selectedMessage()
+{
+    if(_selected >= 0 && _selected < _messages.count()) {
+        return qobject_cast<QGCMAVLinkMessage*>(_messages.get(_selected));
     }
     return nullptr;
 }
 
+//-----------------------------------------------------------------------------
+void
+QGCMAVLinkSystem::clearMessages()
+{
+    _messageMap.clear();
+    _messages.clearAndDeleteContents();
+}
+
 //-----------------------------------------------------------------------------
 int
 QGCMAVLinkSystem::findMessage(QGCMAVLinkMessage* message)
@@ -562,6 +482,7 @@ QGCMAVLinkSystem::append(QGCMAVLinkMessage* message)
         message->setSelected(true);
     }
     _messages.append(message);
+    _messageMap[_messageKey(message->id(), message->cid())] = message;
     //-- Sort messages by id and then cid
     if (_messages.count() > 0) {
         _messages.beginReset();
@@ -644,13 +565,23 @@ MAVLinkChartController::updateXRange()
     }
 }
 
+//-----------------------------------------------------------------------------
+double
+MAVLinkChartController::bucketWidth()
+{
+    if(_rangeXIndex < static_cast<quint32>(_controller->timeScaleSt().count())) {
+        return static_cast<double>(_controller->timeScaleSt()[static_cast<int>(_rangeXIndex)]->timeScale) / maxBuckets;
+    }
+    return 1;
+}
+
 //-----------------------------------------------------------------------------
 void
 MAVLinkChartController::updateYRange()
 {
     if(_chartFields.count()) {
         qreal vmin  = std::numeric_limits<qreal>::max();
-        qreal vmax  = std::numeric_limits<qreal>::min();
+        qreal vmax  = std::numeric_limits<qreal>::lowest();
         for(int i = 0; i < _chartFields.count(); i++) {
             QObject* object = qvariant_cast<QObject*>(_chartFields.at(i));
             QGCMAVLinkMessageField* pField = qobject_cast<QGCMAVLinkMessageField*>(object);
@@ -733,6 +664,8 @@ MAVLinkInspectorController::MAVLinkInspectorController()
     connect(mavlinkProtocol, &MAVLinkProtocol::messageReceived, this, &MAVLinkInspectorController::_receiveMessage);
     connect(&_updateFrequencyTimer, &QTimer::timeout, this, &MAVLinkInspectorController::_refreshFrequency);
     _updateFrequencyTimer.start(1000);
+    connect(&_updateDisplayTimer, &QTimer::timeout, this, &MAVLinkInspectorController::_refreshDisplay);
+    _updateDisplayTimer.start(UPDATE_FREQUENCY);
     MultiVehicleManager *manager = qgcApp()->toolbox()->multiVehicleManager();
     connect(manager, &MultiVehicleManager::activeVehicleChanged, this, &MAVLinkInspectorController::_setActiveVehicle);
     _timeScaleSt.append(new TimeScale_st(this, tr("5 Sec"),   5 * 1000));
@@ -833,13 +766,26 @@ MAVLinkInspectorController::_refreshFrequency()
     }
 }
 
+//-----------------------------------------------------------------------------
+void
+MAVLinkInspectorController::_refreshDisplay()
+{
+    //-- Only the selected message of the active system is on screen
+    if(_activeSystem) {
+        QGCMAVLinkMessage* m = _activeSystem->selectedMessage();
+        if(m) {
+            m->updateDisplay();
+        }
+    }
+}
+
 //-----------------------------------------------------------------------------
 void
 MAVLinkInspectorController::_vehicleAdded(Vehicle* vehicle)
 {
     QGCMAVLinkSystem* v = _findVehicle(static_cast<uint8_t>(vehicle->id()));
     if(v) {
-        v->messages()->clearAndDeleteContents();
+        v->clearMessages();
     } else {
         v = new QGCMAVLinkSystem(this, static_cast<uint8_t>(vehicle->id()));
         _systems.append(v);
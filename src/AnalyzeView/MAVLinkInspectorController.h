@@ -14,6 +14,7 @@
 #pragma once
 
 #include "MAVLinkProtocol.h"
+#include "MAVLinkTimeSeries.h"
 #include "Vehicle.h"
 
 #include <QObject>
@@ -53,16 +54,20 @@ public:
     bool            selectable      () const{ return _selectable; }
     bool            selected        () { return _pSeries != nullptr; }
     QAbstractSeries*series          () { return _pSeries; }
-    QList<QPointF>* values          () { return &_values;}
     qreal           rangeMin        () const{ return _rangeMin; }
     qreal           rangeMax        () const{ return _rangeMax; }
     int             chartIndex      ();
 
     void            setSelectable   (bool sel);
-    void            updateValue     (QString newValue, qreal v);
+    void            updateValue     (const QString& newValue);
+
+    /// Adds a sample to the chart series, ignored if the field is not charted
+    void            appendSample    (qreal v);
 
     void            addSeries       (MAVLinkChartController* chart, QAbstractSeries* series);
     void            delSeries       ();
+
+    /// Brings the chart series up to date with the samples received since the last update
     void            updateSeries    ();
 
 signals:
@@ -75,14 +80,15 @@ private:
     QString     _name;
     QString     _value;
     bool        _selectable = true;
-    int         _dataIndex  = 0;
     qreal       _rangeMin   = 0;
     qreal       _rangeMax   = 0;
 
     QAbstractSeries*    _pSeries = nullptr;
     QGCMAVLinkMessage*  _msg     = nullptr;
     MAVLinkChartController*      _chart   = nullptr;
-    QList<QPointF>      _values;
+    MAVLinkTimeSeries   _timeSeries;
+    double              _seriesBucketWidth  = 0;    ///< Bucket width the series points were decimated with
+    double              _seriesEndTime      = 0;    ///< Start of the first bucket not yet in the series
 };
 
 //-----------------------------------------------------------------------------
@@ -113,7 +119,13 @@ public:
     bool                selected        () const{ return _selected; }
 
     void                updateFieldSelection();
+
+    /// Counts the message and decodes the charted fields. Field values are only decoded for display by updateDisplay.
     void                update          (mavlink_message_t* message);
+
+    /// Decodes the field values of the selected message if a new message arrived since the last call
+    void                updateDisplay   ();
+
     void                updateFreq      ();
     void                setSelected     (bool sel);
 
@@ -124,7 +136,7 @@ signals:
     void selectedChanged                ();
 
 private:
-    void _updateFields(void);
+    void _updateFields(bool chartedOnly);
 
     QmlObjectListModel  _fields;
     QString             _name;
@@ -134,6 +146,7 @@ private:
     mavlink_message_t   _message;
     bool                _fieldSelected  = false;
     bool                _selected       = false;
+    bool                _displayDirty   = false;    ///< Field values are older than the last message
 };
 
 //-----------------------------------------------------------------------------
@@ -159,7 +172,9 @@ public:
     void                setSelected     (int sel);
     QGCMAVLinkMessage*  findMessage     (uint32_t id, uint8_t cid);
     int                 findMessage     (QGCMAVLinkMessage* message);
+    QGCMAVLinkMessage*  selectedMessage ();
     void                append          (QGCMAVLinkMessage* message);
+    void                clearMessages   ();
 
 signals:
     void compIDsChanged                 ();
@@ -169,11 +184,14 @@ private:
     void _checkCompID                   (QGCMAVLinkMessage *message);
     void _resetSelection                ();
 
+    static quint32 _messageKey          (uint32_t id, uint8_t cid) { return (id << 8) | cid; }
+
 private:
     quint8              _id;
     QList<int>          _compIDs;
     QStringList         _compIDsStr;
     QmlObjectListModel  _messages;      //-- List of QGCMAVLinkMessage
+    QHash<quint32, QGCMAVLinkMessage*> _messageMap;    //-- Message lookup by id and cid
     int                 _selected = 0;
 };
 
@@ -213,6 +231,11 @@ public:
     void                    updateXRange        ();
     void                    updateYRange        ();
 
+    /// @return Width in msecs of the buckets the current time scale is decimated to
+    double                  bucketWidth         ();
+
+    static const int        maxBuckets          = 500;  ///< Each bucket contributes at most two points to a series
+
 signals:
     void chartFieldsChanged ();
     void rangeXMinChanged   ();
@@ -295,6 +318,7 @@ private slots:
     void _vehicleRemoved    (Vehicle* vehicle);
     void _setActiveVehicle  (Vehicle* vehicle);
     void _refreshFrequency  ();
+    void _refreshDisplay    ();
 
 private:
     QGCMAVLinkSystem* _findVehicle (uint8_t id);
@@ -307,6 +331,7 @@ private:
     QStringList         _rangeList;
     QGCMAVLinkSystem*   _activeSystem           = nullptr;
     QTimer              _updateFrequencyTimer;
+    QTimer              _updateDisplayTimer;
     QStringList         _systemNames;
     QmlObjectListModel  _systems;                           ///< List of QGCMAVLinkSystem
     QmlObjectListModel  _charts;                            ///< List of MAVLinkCharts
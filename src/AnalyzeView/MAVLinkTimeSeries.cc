@@ -0,0 +1,101 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkTimeSeries.h"
+
+#include <cmath>
+
+MAVLinkTimeSeries::MAVLinkTimeSeries(int capacity)
+    : _capacity(qMax(capacity, 2))
+{
+
+}
+
+void MAVLinkTimeSeries::append(double time, double value)
+{
+    if (_samples.count() < _capacity) {
+        _samples.append(QPointF(time, value));
+    } else {
+        _samples[_head] = QPointF(time, value);
+        _head = (_head + 1) % _capacity;
+    }
+}
+
+void MAVLinkTimeSeries::clear(void)
+{
+    _samples.clear();
+    _samples.squeeze();
+    _head = 0;
+}
+
+double MAVLinkTimeSeries::bucketStart(double time, double bucketWidth)
+{
+    return std::floor(time / bucketWidth) * bucketWidth;
+}
+
+int MAVLinkTimeSeries::_lowerBound(double time) const
+{
+    int first = 0;
+    int last = count();
+    while (first < last) {
+        int middle = first + (last - first) / 2;
+        if (at(middle).x() < time) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+    return first;
+}
+
+double MAVLinkTimeSeries::decimate(double startTime, double endTime, double bucketWidth, QList<QPointF>& points) const
+{
+    if (bucketWidth <= 0) {
+        return startTime;
+    }
+
+    // Buckets which start before the limit are complete
+    const double limit = bucketStart(endTime, bucketWidth);
+    if (limit <= startTime) {
+        return startTime;
+    }
+
+    const int sampleCount = count();
+    int index = _lowerBound(startTime);
+    while (index < sampleCount && at(index).x() < limit) {
+        const double bucketEnd = bucketStart(at(index).x(), bucketWidth) + bucketWidth;
+
+        int minIndex = index;
+        int maxIndex = index;
+        int next = index + 1;
+        for (; next < sampleCount && at(next).x() < bucketEnd; next++) {
+            if (at(next).y() < at(minIndex).y()) {
+                minIndex = next;
+            }
+            if (at(next).y() > at(maxIndex).y()) {
+                maxIndex = next;
+            }
+        }
+
+        if (next - index <= 2) {
+            for (int i=index; i<next; i++) {
+                points.append(at(i));
+            }
+        } else if (minIndex == maxIndex) {
+            points.append(at(minIndex));
+        } else {
+            points.append(at(qMin(minIndex, maxIndex)));
+            points.append(at(qMax(minIndex, maxIndex)));
+        }
+
+        index = next;
+    }
+
+    return limit;
+}
@@ -0,0 +1,58 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QVector>
+#include <QList>
+#include <QPointF>
+
+/// Fixed capacity store for a live time series such as a charted MAVLink Inspector field. Samples are kept in a ring
+/// buffer, once it is full each new sample replaces the oldest one so memory use is bounded at any message rate.
+///
+/// Chart points are produced for time buckets which are aligned to multiples of the bucket width. A bucket with more
+/// than two samples contributes its min and max sample, so spikes survive at any time scale. Since the buckets are
+/// aligned a completed bucket never changes, which lets a chart append only the buckets completed since its last
+/// refresh instead of replacing all of its points.
+class MAVLinkTimeSeries
+{
+public:
+    MAVLinkTimeSeries(int capacity = defaultCapacity);
+
+    /// Adds a sample, times must be ascending
+    void append(double time, double value);
+
+    /// Removes all samples and releases their memory
+    void clear(void);
+
+    int     count       (void) const { return _samples.count(); }
+    int     capacity    (void) const { return _capacity; }
+    bool    isEmpty     (void) const { return _samples.isEmpty(); }
+
+    /// @param index 0 is the oldest sample
+    const QPointF& at(int index) const { return _samples[(_head + index) % _samples.count()]; }
+
+    /// Appends the points for the buckets which start at or after startTime and are complete at endTime.
+    ///     @param startTime Start of the first bucket, must be a multiple of bucketWidth
+    ///     @param endTime Buckets which end after this time are left for a later call
+    /// @return Start of the first bucket which was not complete, pass as startTime to the next call
+    double decimate(double startTime, double endTime, double bucketWidth, QList<QPointF>& points) const;
+
+    /// @return Start of the bucket which contains time
+    static double bucketStart(double time, double bucketWidth);
+
+    static const int defaultCapacity = 16384;   ///< One minute of samples at over 250Hz
+
+private:
+    int _lowerBound(double time) const;
+
+    int                 _capacity;
+    int                 _head =     0;  ///< Index of the oldest sample once the buffer has wrapped
+    QVector<QPointF>    _samples;
+};
@@ -0,0 +1,93 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MAVLinkTimeSeriesTest.h"
+#include "MAVLinkTimeSeries.h"
+
+void MAVLinkTimeSeriesTest::_ringBuffer_test(void)
+{
+    MAVLinkTimeSeries timeSeries(4);
+    QVERIFY(timeSeries.isEmpty());
+
+    for (int i=0; i<3; i++) {
+        timeSeries.append(i, i * 10);
+    }
+    QCOMPARE(timeSeries.count(), 3);
+    QCOMPARE(timeSeries.at(0), QPointF(0, 0));
+
+    // Once full the oldest samples are replaced
+    for (int i=3; i<10; i++) {
+        timeSeries.append(i, i * 10);
+    }
+    QCOMPARE(timeSeries.count(), 4);
+    for (int i=0; i<4; i++) {
+        QCOMPARE(timeSeries.at(i), QPointF(6 + i, (6 + i) * 10));
+    }
+
+    timeSeries.clear();
+    QVERIFY(timeSeries.isEmpty());
+    QCOMPARE(timeSeries.count(), 0);
+}
+
+void MAVLinkTimeSeriesTest::_decimation_test(void)
+{
+    // 1kHz for 10 seconds with a single sample spike
+    const int   sampleCount =   10000;
+    const int   spikeIndex =    4321;
+    MAVLinkTimeSeries timeSeries(sampleCount);
+    for (int i=0; i<sampleCount; i++) {
+        timeSeries.append(i, i == spikeIndex ? 50 : std::sin(i * 0.01));
+    }
+
+    // Each bucket contributes at most its min and max and the spike survives
+    const double    bucketWidth = 100;
+    QList<QPointF>  points;
+    double          endTime = timeSeries.decimate(0, sampleCount, bucketWidth, points);
+    QCOMPARE(endTime, static_cast<double>(sampleCount));
+    QCOMPARE(points.count(), 2 * sampleCount / static_cast<int>(bucketWidth));
+    double maxValue = 0;
+    for (int i=0; i<points.count(); i++) {
+        maxValue = qMax(maxValue, points[i].y());
+        if (i > 0) {
+            QVERIFY(points[i].x() > points[i - 1].x());
+        }
+    }
+    QCOMPARE(maxValue, 50.0);
+
+    // Buckets with up to two samples are returned as is
+    points.clear();
+    timeSeries.decimate(1000, 1010, 2, points);
+    QCOMPARE(points.count(), 10);
+    QCOMPARE(points.first(), timeSeries.at(1000));
+    QCOMPARE(points.last(), timeSeries.at(1009));
+}
+
+void MAVLinkTimeSeriesTest::_incremental_test(void)
+{
+    // Points appended as buckets complete match decimating everything at once
+    const double        bucketWidth = 10;
+    MAVLinkTimeSeries   timeSeries;
+    QList<QPointF>      incrementalPoints;
+    double              endTime = 0;
+    for (int i=0; i<1000; i++) {
+        timeSeries.append(i * 0.7, std::cos(i * 0.05));
+        if (i % 37 == 0) {
+            endTime = timeSeries.decimate(endTime, i * 0.7, bucketWidth, incrementalPoints);
+        }
+    }
+    endTime = timeSeries.decimate(endTime, 1000, bucketWidth, incrementalPoints);
+
+    // Nothing is added for an incomplete bucket
+    QList<QPointF> points;
+    QCOMPARE(timeSeries.decimate(endTime, endTime + bucketWidth / 2, bucketWidth, points), endTime);
+    QVERIFY(points.isEmpty());
+
+    timeSeries.decimate(0, 1000, bucketWidth, points);
+    QCOMPARE(incrementalPoints, points);
+}
@@ -0,0 +1,449 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ULogReader.h"
+
+#include <algorithm>
+#include <limits>
+
+QGC_LOGGING_CATEGORY(ULogReaderLog, "ULogReaderLog")
+
+static const char kULogMagic[7] = { 'U', 'L', 'o', 'g', 0x01, 0x12, 0x35 };
+
+// A 32 bit process can't be expected to find more than this in one piece of its address space
+const qint64 ULogReader::defaultMaxMappedSize = sizeof(void*) > 4 ? std::numeric_limits<qint64>::max() : 256 * 1024 * 1024;
+
+ULogReader::~ULogReader()
+{
+    close();
+}
+
+bool ULogReader::open(const QString& fileName, QString& errorString)
+{
+    close();
+    errorString.clear();
+
+    _file.setFileName(fileName);
+    if (!_file.open(QIODevice::ReadOnly)) {
+        errorString = tr("Could not open log file %1").arg(fileName);
+        return false;
+    }
+
+    _size = _file.size();
+    if (_size < headerLength) {
+        errorString = tr("Could not detect ULog file header magic");
+        close();
+        return false;
+    }
+
+    if (_size <= _maxMappedSize) {
+        _data = _file.map(0, _size);
+        if (!_data) {
+            qCWarning(ULogReaderLog) << "Could not map whole log file, reading it in windows:" << _file.errorString();
+        }
+    }
+    _windowSize = qBound(static_cast<qint64>(_maxMessageLength), _maxMappedSize, _maxWindowSize);
+
+    const uchar* header = _bytes(0, headerLength);
+    if (!header) {
+        errorString = _readError(0);
+        close();
+        return false;
+    }
+    if (memcmp(header, kULogMagic, sizeof(kULogMagic)) != 0) {
+        errorString = tr("Could not detect ULog file header magic");
+        close();
+        return false;
+    }
+    memcpy(&_startTimestamp, header + 8, sizeof(_startTimestamp));
+
+    // Single pass over the file. Data messages are only indexed, their payload is not touched.
+    qint64 index = headerLength;
+    while (index + messageHeaderLength <= _size) {
+        const uchar* message = _bytes(index, messageHeaderLength);
+        if (!message) {
+            errorString = _readError(index);
+            close();
+            return false;
+        }
+        uint16_t msgSize;
+        memcpy(&msgSize, message, sizeof(msgSize));
+        uint8_t msgType = message[2];
+
+        if (index + messageHeaderLength + msgSize > _size) {
+            qCDebug(ULogReaderLog) << "ULog truncated at offset" << index;
+            break;
+        }
+
+        message = _bytes(index, messageHeaderLength + msgSize);
+        if (!message) {
+            errorString = _readError(index);
+            close();
+            return false;
+        }
+        const char* msg = reinterpret_cast<const char*>(message + messageHeaderLength);
+
+        switch (msgType) {
+        case MessageTypeFormat:
+            _parseFormat(msg, msgSize);
+            break;
+
+        case MessageTypeAddLogged:
+            if (msgSize > 3) {
+                uint16_t msgId;
+                memcpy(&msgId, msg + 1, sizeof(msgId));
+                const int       multiId =       static_cast<uint8_t>(msg[0]);
+                const QString   formatName =    QString::fromLatin1(msg + 3, static_cast<int>(qstrnlen(msg + 3, msgSize - 3)));
+
+                // A topic instance which is subscribed again, possibly with a new msg_id, continues its earlier subscription
+                int subscriptionIndex = -1;
+                for (int i=0; i<_subscriptions.count(); i++) {
+                    if (_subscriptions[i].formatName == formatName && _subscriptions[i].multiId == multiId) {
+                        subscriptionIndex = i;
+                        break;
+                    }
+                }
+                if (subscriptionIndex == -1) {
+                    Subscription subscription;
+                    subscription.formatName =   formatName;
+                    subscription.multiId =      multiId;
+                    subscriptionIndex = _subscriptions.count();
+                    _subscriptions.append(subscription);
+                }
+                _subscriptionIndices[msgId] = subscriptionIndex;
+            }
+            break;
+
+        case MessageTypeRemoveLogged:
+            // The msg_id may be reused for a different topic after this
+            if (msgSize >= 2) {
+                uint16_t msgId;
+                memcpy(&msgId, msg, sizeof(msgId));
+                _subscriptionIndices.remove(msgId);
+            }
+            break;
+
+        case MessageTypeData:
+            if (msgSize >= 2) {
+                uint16_t msgId;
+                memcpy(&msgId, msg, sizeof(msgId));
+                auto subscriptionIndex = _subscriptionIndices.constFind(msgId);
+                if (subscriptionIndex != _subscriptionIndices.constEnd()) {
+                    _subscriptions[*subscriptionIndex].messageOffsets.append(index);
+                }
+            }
+            break;
+
+        default:
+            break;
+        }
+
+        index += messageHeaderLength + msgSize;
+    }
+
+    // Formats may reference each other in any order, so offsets can only be calculated once all are known
+    for (Format& format: _formats) {
+        _resolveFormat(format, 0);
+    }
+
+    return true;
+}
+
+void ULogReader::close(void)
+{
+    if (_data) {
+        _file.unmap(const_cast<uchar*>(_data));
+        _data = nullptr;
+    }
+    _window.close();
+    _file.close();
+    _size = 0;
+    _startTimestamp = 0;
+    _formats.clear();
+    _subscriptions.clear();
+    _subscriptionIndices.clear();
+}
+
+const uchar* ULogReader::_bytes(qint64 offset, int length)
+{
+    return _data ? _data + offset : _window.bytes(_file.fileName(), _size, _windowSize, offset, length);
+}
+
+QString ULogReader::_readError(qint64 offset) const
+{
+    return tr("Could not read log file %1 at offset %2: %3").arg(_file.fileName()).arg(offset).arg(_window.errorString());
+}
+
+const uchar* ULogReader::Window::bytes(const QString& fileName, qint64 fileSize, qint64 windowSize, qint64 offset, int length)
+{
+    if (_start && offset >= _offset && offset + length <= _offset + _size) {
+        return _start + (offset - _offset);
+    }
+
+    _release();
+    if (!_file.isOpen()) {
+        _file.setFileName(fileName);
+        if (!_file.open(QIODevice::ReadOnly)) {
+            return nullptr;
+        }
+    }
+
+    // Windows only move forward while iterating, so the window starts at the requested bytes
+    _offset = offset;
+    _size = qMin(fileSize - offset, qMax(windowSize, static_cast<qint64>(length)));
+    _mapped = _file.map(_offset, _size);
+    if (_mapped) {
+        _start = _mapped;
+    } else {
+        _buffer.resize(static_cast<int>(_size));
+        if (!_file.seek(_offset) || _file.read(_buffer.data(), _size) != _size) {
+            _release();
+            return nullptr;
+        }
+        _start = reinterpret_cast<const uchar*>(_buffer.constData());
+    }
+
+    return _start;
+}
+
+void ULogReader::Window::_release(void)
+{
+    if (_mapped) {
+        _file.unmap(_mapped);
+        _mapped = nullptr;
+    }
+    _start = nullptr;
+    _size = 0;
+}
+
+void ULogReader::Window::close(void)
+{
+    _release();
+    _buffer.clear();
+    _file.close();
+}
+
+void ULogReader::_parseFormat(const char* data, int length)
+{
+    // Format: "message_name:type field_name;type[n] field_name;..."
+    QString format = QString::fromLatin1(data, static_cast<int>(qstrnlen(data, length)));
+    int separator = format.indexOf(':');
+    if (separator <= 0) {
+        return;
+    }
+
+    Format newFormat;
+    newFormat.name = format.left(separator);
+
+    const QStringList fieldDefinitions = format.mid(separator + 1).split(";", Qt::SkipEmptyParts);
+    for (const QString& fieldDefinition: fieldDefinitions) {
+        int space = fieldDefinition.indexOf(' ');
+        if (space == -1) {
+            continue;
+        }
+
+        Field field;
+        field.name =        fieldDefinition.mid(space + 1);
+        field.typeName =    fieldDefinition.left(space);
+        field.arraySize =   1;
+        field.offset =      -1;
+        field.size =        0;
+
+        int arrayStart = field.typeName.indexOf('[');
+        int arrayEnd = field.typeName.indexOf(']');
+        if (arrayStart != -1 && arrayEnd > arrayStart) {
+            field.arraySize = field.typeName.midRef(arrayStart + 1, arrayEnd - arrayStart - 1).toInt();
+            field.typeName.truncate(arrayStart);
+        }
+
+        newFormat.fields.append(field);
+    }
+
+    _formats[newFormat.name] = newFormat;
+}
+
+bool ULogReader::_resolveFormat(Format& format, int depth)
+{
+    if (format.paddedSize >= 0) {
+        return true;
+    }
+    if (depth > _maxFormatNesting) {
+        return false;
+    }
+
+    int offset = 0;
+    int loggedSize = 0;
+    for (Field& field: format.fields) {
+        int elementSize = _sizeOfBasicType(field.typeName);
+        if (elementSize == 0) {
+            auto nestedFormat = _formats.find(field.typeName);
+            if (nestedFormat == _formats.end() || !_resolveFormat(*nestedFormat, depth + 1)) {
+                qWarning() << "Unknown type in ULog : " << field.typeName << "in" << format.name;
+                return false;
+            }
+            elementSize = nestedFormat->paddedSize;
+        }
+
+        field.offset = offset;
+        field.size = elementSize * field.arraySize;
+        offset += field.size;
+
+        // Trailing padding is not logged
+        if (!field.name.startsWith(QLatin1String("_padding"))) {
+            loggedSize = offset;
+        }
+    }
+
+    // Padding only keeps the layout, it is never read
+    format.fields.erase(std::remove_if(format.fields.begin(), format.fields.end(), [](const Field& field) {
+        return field.name.startsWith(QLatin1String("_padding"));
+    }), format.fields.end());
+
+    format.paddedSize = offset;
+    format.size = loggedSize;
+
+    return true;
+}
+
+int ULogReader::_sizeOfBasicType(const QString& typeName)
+{
+    if (typeName == QLatin1String("int8_t") || typeName == QLatin1String("uint8_t")) {
+        return 1;
+
+    } else if (typeName == QLatin1String("int16_t") || typeName == QLatin1String("uint16_t")) {
+        return 2;
+
+    } else if (typeName == QLatin1String("int32_t") || typeName == QLatin1String("uint32_t")) {
+        return 4;
+
+    } else if (typeName == QLatin1String("int64_t") || typeName == QLatin1String("uint64_t")) {
+        return 8;
+
+    } else if (typeName == QLatin1String("float")) {
+        return 4;
+
+    } else if (typeName == QLatin1String("double")) {
+        return 8;
+
+    } else if (typeName == QLatin1String("char") || typeName == QLatin1String("bool")) {
+        return 1;
+    }
+
+    return 0;
+}
+
+QStringList ULogReader::topicNames(void) const
+{
+    QStringList names;
+    for (const Subscription& subscription: _subscriptions) {
+        if (!names.contains(subscription.formatName)) {
+            names.append(subscription.formatName);
+        }
+    }
+    names.sort();
+    return names;
+}
+
+QList<int> ULogReader::multiIds(const QString& topicName) const
+{
+    QList<int> ids;
+    for (const Subscription& subscription: _subscriptions) {
+        if (subscription.formatName == topicName && !ids.contains(subscription.multiId)) {
+            ids.append(subscription.multiId);
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+ULogReader::Topic ULogReader::topic(const QString& topicName, int multiId) const
+{
+    Topic topic;
+
+    auto format = _formats.constFind(topicName);
+    if (!isOpen() || format == _formats.constEnd() || format->size < 0) {
+        return topic;
+    }
+
+    for (const Subscription& subscription: _subscriptions) {
+        if (subscription.formatName == topicName && subscription.multiId == multiId) {
+            topic._reader =         this;
+            topic._format =         &format.value();
+            topic._subscription =   &subscription;
+            break;
+        }
+    }
+
+    return topic;
+}
+
+ULogReader::Topic::Topic(const Topic& other)
+    : _reader       (other._reader)
+    , _format       (other._format)
+    , _subscription (other._subscription)
+{
+
+}
+
+ULogReader::Topic& ULogReader::Topic::operator=(const Topic& other)
+{
+    _reader =       other._reader;
+    _format =       other._format;
+    _subscription = other._subscription;
+    _window.reset();
+    return *this;
+}
+
+const ULogReader::Field* ULogReader::Topic::field(const QString& fieldName) const
+{
+    if (_format) {
+        for (const Field& field: _format->fields) {
+            if (field.name == fieldName) {
+                return &field;
+            }
+        }
+    }
+    return nullptr;
+}
+
+int ULogReader::Topic::fieldOffset(const QString& fieldName) const
+{
+    const Field* fieldInfo = field(fieldName);
+    return fieldInfo ? fieldInfo->offset : -1;
+}
+
+const uchar* ULogReader::Topic::messagePayload(int messageIndex, int& size) const
+{
+    if (!_subscription || messageIndex < 0 || messageIndex >= _subscription->messageOffsets.count()) {
+        size = 0;
+        return nullptr;
+    }
+
+    // Message header followed by the msg_id, the indexing pass already checked the message is inside the file
+    const qint64 offset = _subscription->messageOffsets[messageIndex];
+    const uchar* message;
+    if (_reader->_data) {
+        message = _reader->_data + offset;
+    } else {
+        if (!_window) {
+            _window.reset(new Window);
+        }
+        // Reading the longest possible message saves a second lookup for the header, the window is larger anyway
+        message = _window->bytes(_reader->_file.fileName(), _reader->_size, _reader->_windowSize, offset, static_cast<int>(qMin(static_cast<qint64>(_maxMessageLength), _reader->_size - offset)));
+        if (!message) {
+            qCWarning(ULogReaderLog) << "Could not read log message at offset" << offset << _window->errorString();
+            size = 0;
+            return nullptr;
+        }
+    }
+    uint16_t msgSize;
+    memcpy(&msgSize, message, sizeof(msgSize));
+    size = msgSize - 2;
+    return message + messageHeaderLength + 2;
+}
@@ -0,0 +1,199 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "QGCLoggingCategory.h"
+
+#include <QFile>
+#include <QScopedPointer>
+#include <QMap>
+#include <QHash>
+#include <QVector>
+#include <QStringList>
+#include <QCoreApplication>
+
+#include <cstring>
+
+Q_DECLARE_LOGGING_CATEGORY(ULogReaderLog)
+
+/// Memory mapped ULog reader. The log is never copied into memory. A single pass over the mapped file indexes the message
+/// formats, the subscriptions and the file offset of every data message. After that any topic can be iterated with typed
+/// field access directly from the mapping, so multi-GB logs cost no more memory than the index itself.
+/// Where the whole file can't be mapped (32 bit systems such as Herelink run out of address space) the file is accessed
+/// through a window which is moved over it instead.
+class ULogReader
+{
+    Q_DECLARE_TR_FUNCTIONS(ULogReader)
+
+public:
+    ULogReader(void) = default;
+    ~ULogReader();
+
+    struct Field {
+        QString name;
+        QString typeName;   ///< Base type name without the array size, may be a nested format name
+        int     arraySize;  ///< 1 for non-array fields
+        int     offset;     ///< Byte offset from the start of the message payload (which starts with the timestamp)
+        int     size;       ///< Total size in bytes including all array elements
+    };
+
+    struct Format {
+        QString         name;
+        QList<Field>    fields;
+        int             size =          -1; ///< Logged size in bytes without trailing padding, -1 if the format could not be resolved
+        int             paddedSize =    -1; ///< Size in bytes including trailing padding, used when nested in another format
+    };
+
+private:
+    /// Part of the file mapped into memory, used when the whole file is not mapped. If even the window can't be mapped it is
+    /// read into a buffer instead.
+    class Window {
+    public:
+        ~Window() { close(); }
+
+        /// @return Pointer to length bytes at offset, nullptr if they could not be read (see errorString)
+        const uchar* bytes(const QString& fileName, qint64 fileSize, qint64 windowSize, qint64 offset, int length);
+        void close(void);
+
+        QString errorString(void) const { return _file.errorString(); }
+
+    private:
+        void _release(void);
+
+        QFile           _file;
+        uchar*          _mapped =   nullptr;
+        QByteArray      _buffer;
+        const uchar*    _start =    nullptr;
+        qint64          _offset =   0;
+        qint64          _size =     0;
+    };
+
+    /// All data for one instance of a topic. A topic which is removed and added again during the log keeps its earlier data.
+    struct Subscription {
+        QString             formatName;
+        int                 multiId;
+        QVector<qint64>     messageOffsets; ///< File offset of each data message header
+    };
+
+public:
+    /// Typed view of all data messages for a single subscription. Only valid while the reader stays open. A topic must not be
+    /// used from several threads at once, separate copies can.
+    class Topic {
+    public:
+        Topic(void) = default;
+        Topic(const Topic& other);
+        Topic& operator=(const Topic& other);
+
+        bool            isValid (void) const { return _subscription != nullptr; }
+        QString         name    (void) const { return _format ? _format->name : QString(); }
+        int             multiId (void) const { return _subscription ? _subscription->multiId : -1; }
+        int             count   (void) const { return _subscription ? _subscription->messageOffsets.count() : 0; }
+        const Format*   format  (void) const { return _format; }
+
+        /// @return Field description, nullptr if the topic has no such field
+        const Field* field(const QString& fieldName) const;
+
+        /// @return Offset of the field within the payload, -1 if the topic has no such field
+        int fieldOffset(const QString& fieldName) const;
+
+        /// Returns the value at the specified payload offset of a message. Returns a default constructed value if the offset
+        /// is -1 or the value does not fit into the logged message.
+        template<typename T>
+        T value(int messageIndex, int fieldOffset) const
+        {
+            T result{};
+            int size;
+            const uchar* payload = messagePayload(messageIndex, size);
+            if (payload && fieldOffset >= 0 && fieldOffset + static_cast<int>(sizeof(T)) <= size) {
+                memcpy(&result, payload + fieldOffset, sizeof(T));
+            }
+            return result;
+        }
+
+        /// @return Timestamp of a message in microseconds
+        quint64 timestamp(int messageIndex) const { return value<quint64>(messageIndex, 0); }
+
+        /// @return Pointer to the raw payload of a message in the mapping, nullptr for an invalid index or a read error. Only
+        ///         valid until the next message is read from this topic.
+        /// @param[out] size Payload size in bytes
+        const uchar* messagePayload(int messageIndex, int& size) const;
+
+    private:
+        friend class ULogReader;
+
+        const ULogReader*               _reader =       nullptr;
+        const Format*                   _format =       nullptr;
+        const Subscription*             _subscription = nullptr;
+        mutable QScopedPointer<Window>  _window;        ///< Only used if the reader did not map the whole file, not copied
+    };
+
+    /// Files larger than this are read through a window instead of being mapped as a whole. Takes effect on the next open.
+    void setMaxMappedSize(qint64 maxMappedSize) { _maxMappedSize = maxMappedSize; }
+
+    /// Maps the file and indexes it. A truncated last message (logging stopped by a power loss) is ignored.
+    /// @return false: failed, errorString set
+    bool open(const QString& fileName, QString& errorString);
+    void close(void);
+
+    bool        isOpen          (void) const { return _file.isOpen(); }
+    bool        isMapped        (void) const { return _data != nullptr; }  ///< true: whole file is mapped, false: read through a window
+    qint64      fileSize        (void) const { return _size; }
+    quint64     startTimestamp  (void) const { return _startTimestamp; }    ///< Log start in microseconds
+
+    const QMap<QString, Format>& formats(void) const { return _formats; }
+
+    /// @return Names of all topics which were subscribed to, sorted
+    QStringList topicNames(void) const;
+
+    /// @return Multi instance ids for a topic, sorted
+    QList<int> multiIds(const QString& topicName) const;
+
+    /// @return Topic view, invalid if the topic was not subscribed with this multi id
+    Topic topic(const QString& topicName, int multiId = 0) const;
+
+    static const int    headerLength =      16;
+    static const int    messageHeaderLength = 3;
+    static const qint64 defaultMaxMappedSize;
+
+private:
+    enum MessageType : uint8_t {
+        MessageTypeFormat =         'F',
+        MessageTypeData =           'D',
+        MessageTypeInfo =           'I',
+        MessageTypeParameter =      'P',
+        MessageTypeAddLogged =      'A',
+        MessageTypeRemoveLogged =   'R',
+        MessageTypeSync =           'S',
+        MessageTypeDropout =        'O',
+        MessageTypeLogging =        'L',
+        MessageTypeFlagBits =       'B',
+    };
+
+    const uchar*    _bytes              (qint64 offset, int length);
+    QString         _readError          (qint64 offset) const;
+    void            _parseFormat        (const char* data, int length);
+    bool            _resolveFormat      (Format& format, int depth);
+    static int      _sizeOfBasicType    (const QString& typeName);
+
+    static const int        _maxFormatNesting = 16;
+    static constexpr qint64 _maxWindowSize =    16 * 1024 * 1024;
+    static constexpr int    _maxMessageLength = messageHeaderLength + 0xffff;
+
+    QFile                       _file;
+    const uchar*                _data =             nullptr;    ///< Mapping of the whole file, nullptr if read through _window
+    Window                      _window;                        ///< Used by the indexing pass
+    qint64                      _windowSize =       _maxWindowSize;
+    qint64                      _maxMappedSize =    defaultMaxMappedSize;
+    qint64                      _size =             0;
+    quint64                     _startTimestamp =   0;
+    QMap<QString, Format>       _formats;
+    QList<Subscription>         _subscriptions;
+    QHash<int, int>             _subscriptionIndices;   ///< msg_id to index in _subscriptions, several msg_ids may share one
+};
@@ -0,0 +1,281 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ULogReaderTest.h"
+#include "ULogReader.h"
+#include "ULogParser.h"
+
+#include <QTemporaryDir>
+#include <QtEndian>
+
+static const int kCameraCaptureMsgId    = 3;
+static const int kSensorMsgId           = 7;
+
+QByteArray ULogReaderTest::_message(char msgType, const QByteArray& payload)
+{
+    QByteArray message(ULogReader::messageHeaderLength, 0);
+    qToLittleEndian<quint16>(static_cast<quint16>(payload.size()), message.data());
+    message[2] = msgType;
+    return message + payload;
+}
+
+QByteArray ULogReaderTest::_addLogged(int multiId, int msgId, const char* topicName)
+{
+    QByteArray payload(3, 0);
+    payload[0] = static_cast<char>(multiId);
+    qToLittleEndian<quint16>(static_cast<quint16>(msgId), payload.data() + 1);
+    return _message('A', payload + topicName);
+}
+
+QByteArray ULogReaderTest::_cameraCaptureData(int msgId, quint64 timestamp, quint32 seq, double lat, double lon)
+{
+    // Must match the camera_capture format in _testLog, trailing padding is not logged
+    QByteArray payload(2 + 8 + 4 + 8 + 8 + 4 + 8, 0);
+    char* p = payload.data();
+    qToLittleEndian<quint16>(static_cast<quint16>(msgId), p);           p += 2;
+    qToLittleEndian<quint64>(timestamp, p);                             p += 8;
+    qToLittleEndian<quint32>(seq, p);                                   p += 4;
+    memcpy(p, &lat, sizeof(lat));                                       p += 8;
+    memcpy(p, &lon, sizeof(lon));                                       p += 8;
+    float alt = 100.5f;
+    memcpy(p, &alt, sizeof(alt));                                       p += 4;
+    qToLittleEndian<quint64>(timestamp + 1000000, p);
+    return _message('D', payload);
+}
+
+/// Builds a ULog with a camera_capture topic and a multi instance sensor topic which uses a nested type
+QByteArray ULogReaderTest::_testLog(void)
+{
+    QByteArray log("ULog\x01\x12\x35\x01", 8);
+    QByteArray startTimestamp(8, 0);
+    qToLittleEndian<quint64>(1234, startTimestamp.data());
+    log += startTimestamp;
+
+    log += _message('F', "vec3:float x;float y;float z;uint8_t[4] _padding0;");
+    log += _message('F', "sensor:uint64_t timestamp;vec3[2] samples;uint8_t id;uint8_t[7] _padding0;");
+    log += _message('F', "camera_capture:uint64_t timestamp;uint32_t seq;double lat;double lon;float alt;uint64_t timestamp_utc;uint8_t[3] _padding0;");
+    log += _message('I', QByteArray("\x0b" "char[3] ver", 12) + "1.0");
+
+    log += _addLogged(0, kCameraCaptureMsgId, "camera_capture");
+    log += _addLogged(0, kSensorMsgId, "sensor");
+    log += _addLogged(1, kSensorMsgId + 1, "sensor");
+
+    for (int i=0; i<3; i++) {
+        log += _cameraCaptureData(kCameraCaptureMsgId, 1000000 * (i + 1), i, 47.0 + i, 8.0 + i);
+
+        for (int multiId=0; multiId<2; multiId++) {
+            QByteArray payload(2 + 8 + 2 * 16 + 1, 0);
+            qToLittleEndian<quint16>(static_cast<quint16>(kSensorMsgId + multiId), payload.data());
+            qToLittleEndian<quint64>(500 + i, payload.data() + 2);
+            float y = i * 10.0f + multiId;
+            // samples[1].y: nested elements keep their padding
+            memcpy(payload.data() + 2 + 8 + 16 + 4, &y, sizeof(y));
+            payload[payload.size() - 1] = static_cast<char>(multiId + 1);
+            log += _message('D', payload);
+        }
+    }
+
+    // Data for a msg id which was never subscribed is skipped
+    log += _message('D', QByteArray("\x63\x00" "12345678", 10));
+
+    return log;
+}
+
+void ULogReaderTest::_writeFile(const QString& fileName, const QByteArray& bytes)
+{
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QCOMPARE(file.write(bytes), static_cast<qint64>(bytes.size()));
+}
+
+void ULogReaderTest::_index_test(void)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QString logFile = tempDir.filePath(QStringLiteral("test.ulg"));
+    _writeFile(logFile, _testLog());
+
+    ULogReader reader;
+    QString errorString;
+    QVERIFY2(reader.open(logFile, errorString), qPrintable(errorString));
+    QCOMPARE(reader.startTimestamp(), static_cast<quint64>(1234));
+    QCOMPARE(reader.topicNames(), QStringList({ QStringLiteral("camera_capture"), QStringLiteral("sensor") }));
+    QCOMPARE(reader.multiIds(QStringLiteral("sensor")), QList<int>({ 0, 1 }));
+
+    // Padding is dropped from the field list, trailing padding does not count towards the logged size
+    const ULogReader::Format& vec3 = reader.formats()[QStringLiteral("vec3")];
+    QCOMPARE(vec3.fields.count(), 3);
+    QCOMPARE(vec3.size, 12);
+    QCOMPARE(vec3.paddedSize, 16);
+
+    ULogReader::Topic sensor = reader.topic(QStringLiteral("sensor"), 1);
+    QVERIFY(sensor.isValid());
+    QCOMPARE(sensor.count(), 3);
+    QCOMPARE(sensor.format()->size, 8 + 2 * 16 + 1);
+    QCOMPARE(sensor.field(QStringLiteral("samples"))->arraySize, 2);
+    QCOMPARE(sensor.field(QStringLiteral("samples"))->size, 32);
+    int idOffset = sensor.fieldOffset(QStringLiteral("id"));
+    QCOMPARE(idOffset, 40);
+    int sample1YOffset = sensor.fieldOffset(QStringLiteral("samples")) + vec3.paddedSize + vec3.fields[1].offset;
+    for (int i=0; i<sensor.count(); i++) {
+        QCOMPARE(sensor.timestamp(i), static_cast<quint64>(500 + i));
+        QCOMPARE(sensor.value<float>(i, sample1YOffset), i * 10.0f + 1);
+        QCOMPARE(sensor.value<uint8_t>(i, idOffset), static_cast<uint8_t>(2));
+    }
+
+    // Unknown fields and out of range reads return default values
+    QCOMPARE(sensor.fieldOffset(QStringLiteral("missing")), -1);
+    QCOMPARE(sensor.value<quint64>(0, -1), static_cast<quint64>(0));
+    QCOMPARE(sensor.value<quint64>(0, idOffset), static_cast<quint64>(0));
+    QCOMPARE(sensor.value<quint64>(sensor.count(), 0), static_cast<quint64>(0));
+
+    QVERIFY(!reader.topic(QStringLiteral("sensor"), 2).isValid());
+    QVERIFY(!reader.topic(QStringLiteral("vec3")).isValid());
+}
+
+void ULogReaderTest::_truncated_test(void)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    // Logging stopped in the middle of the last message
+    QByteArray log = _testLog() + _cameraCaptureData(kCameraCaptureMsgId, 9000000, 9, 1, 1);
+    log.chop(5);
+    QString logFile = tempDir.filePath(QStringLiteral("truncated.ulg"));
+    _writeFile(logFile, log);
+
+    ULogReader reader;
+    QString errorString;
+    QVERIFY(reader.open(logFile, errorString));
+    QCOMPARE(reader.topic(QStringLiteral("camera_capture")).count(), 3);
+
+    QString badFile = tempDir.filePath(QStringLiteral("bad.ulg"));
+    _writeFile(badFile, QByteArray(64, 'x'));
+    QVERIFY(!reader.open(badFile, errorString));
+    QVERIFY(!errorString.isEmpty());
+    QVERIFY(!reader.isOpen());
+}
+
+void ULogReaderTest::_cameraCapture_test(void)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    QString logFile = tempDir.filePath(QStringLiteral("camera.ulg"));
+    _writeFile(logFile, _testLog());
+
+    ULogParser parser;
+    QList<GeoTagWorker::cameraFeedbackPacket> cameraFeedback;
+    QString errorString;
+    QVERIFY2(parser.getTagsFromLog(logFile, cameraFeedback, errorString), qPrintable(errorString));
+    QCOMPARE(cameraFeedback.count(), 3);
+    for (int i=0; i<cameraFeedback.count(); i++) {
+        const GeoTagWorker::cameraFeedbackPacket& feedback = cameraFeedback[i];
+        QCOMPARE(feedback.timestamp, i + 1.0);
+        QCOMPARE(feedback.timestampUTC, i + 2.0);
+        QCOMPARE(feedback.imageSequence, static_cast<uint32_t>(i));
+        QCOMPARE(feedback.latitude, 47.0 + i);
+        QCOMPARE(feedback.longitude, 8.0 + i);
+        QCOMPARE(feedback.altitude, 100.5f);
+    }
+}
+
+void ULogReaderTest::_resubscribe_test(void)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    // camera_capture is removed and subscribed again with a new msg_id, the old msg_id is then reused by a second
+    // camera_capture instance
+    const int resubscribedMsgId = 20;
+    QByteArray removeLogged(2, 0);
+    qToLittleEndian<quint16>(static_cast<quint16>(kCameraCaptureMsgId), removeLogged.data());
+    QByteArray log = _testLog();
+    log += _message('R', removeLogged);
+    log += _cameraCaptureData(kCameraCaptureMsgId, 9000000, 99, 1, 1);   // No longer subscribed
+    log += _addLogged(0, resubscribedMsgId, "camera_capture");
+    log += _addLogged(1, kCameraCaptureMsgId, "camera_capture");
+    log += _cameraCaptureData(resubscribedMsgId, 4000000, 3, 50.0, 11.0);
+    log += _cameraCaptureData(kCameraCaptureMsgId, 5000000, 4, 51.0, 12.0);
+    QString logFile = tempDir.filePath(QStringLiteral("resubscribe.ulg"));
+    _writeFile(logFile, log);
+
+    ULogReader reader;
+    QString errorString;
+    QVERIFY2(reader.open(logFile, errorString), qPrintable(errorString));
+    QCOMPARE(reader.multiIds(QStringLiteral("camera_capture")), QList<int>({ 0, 1 }));
+
+    ULogReader::Topic instance0 = reader.topic(QStringLiteral("camera_capture"), 0);
+    int seqOffset = instance0.fieldOffset(QStringLiteral("seq"));
+    QCOMPARE(instance0.count(), 4);
+    for (int i=0; i<instance0.count(); i++) {
+        QCOMPARE(instance0.value<quint32>(i, seqOffset), static_cast<quint32>(i));
+    }
+
+    ULogReader::Topic instance1 = reader.topic(QStringLiteral("camera_capture"), 1);
+    QCOMPARE(instance1.count(), 1);
+    QCOMPARE(instance1.value<quint32>(0, seqOffset), static_cast<quint32>(4));
+
+    // Geotagging uses the captures of all instances
+    ULogParser parser;
+    QList<GeoTagWorker::cameraFeedbackPacket> cameraFeedback;
+    QVERIFY2(parser.getTagsFromLog(logFile, cameraFeedback, errorString), qPrintable(errorString));
+    QCOMPARE(cameraFeedback.count(), 5);
+    QCOMPARE(cameraFeedback.last().imageSequence, static_cast<uint32_t>(4));
+}
+
+void ULogReaderTest::_windowed_test(void)
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    // Enough captures to span several of the smallest windows
+    const int captureCount = 5000;
+    QByteArray log = _testLog();
+    for (int i=3; i<captureCount; i++) {
+        log += _cameraCaptureData(kCameraCaptureMsgId, 1000000 * (i + 1), i, 47.0, 8.0);
+    }
+    log += _message('D', QByteArray("\x07\x00" "1234", 6));   // Sensor message at the very end of the file
+    QString logFile = tempDir.filePath(QStringLiteral("windowed.ulg"));
+    _writeFile(logFile, log);
+
+    ULogReader reader;
+    reader.setMaxMappedSize(0);
+    QString errorString;
+    QVERIFY2(reader.open(logFile, errorString), qPrintable(errorString));
+    QVERIFY(reader.isOpen());
+    QVERIFY(!reader.isMapped());
+    QCOMPARE(reader.startTimestamp(), static_cast<quint64>(1234));
+    QCOMPARE(reader.topicNames(), QStringList({ QStringLiteral("camera_capture"), QStringLiteral("sensor") }));
+
+    // Topics read in an interleaved order each move their own window
+    ULogReader::Topic cameraCapture = reader.topic(QStringLiteral("camera_capture"));
+    ULogReader::Topic sensor = reader.topic(QStringLiteral("sensor"));
+    QCOMPARE(cameraCapture.count(), captureCount);
+    QCOMPARE(sensor.count(), 4);
+    int seqOffset = cameraCapture.fieldOffset(QStringLiteral("seq"));
+    for (int i=0; i<captureCount; i++) {
+        QCOMPARE(cameraCapture.value<quint32>(i, seqOffset), static_cast<quint32>(i));
+        QCOMPARE(cameraCapture.timestamp(i), static_cast<quint64>(1000000 * (i + 1)));
+        QCOMPARE(sensor.timestamp(i % 3), static_cast<quint64>(500 + i % 3));
+    }
+    int size;
+    QVERIFY(sensor.messagePayload(3, size));
+    QCOMPARE(size, 4);
+
+    // Copies don't share the window of the topic they were copied from
+    ULogReader::Topic copy = cameraCapture;
+    QCOMPARE(copy.value<quint32>(0, seqOffset), static_cast<quint32>(0));
+    QCOMPARE(cameraCapture.value<quint32>(captureCount - 1, seqOffset), static_cast<quint32>(captureCount - 1));
+    QCOMPARE(copy.value<quint32>(1, seqOffset), static_cast<quint32>(1));
+
+    reader.setMaxMappedSize(ULogReader::defaultMaxMappedSize);
+    QVERIFY2(reader.open(logFile, errorString), qPrintable(errorString));
+    QVERIFY(reader.isMapped());
+    QCOMPARE(reader.topic(QStringLiteral("camera_capture")).count(), captureCount);
+}
@@ -0,0 +1,31 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class ULogReaderTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _index_test(void);
+    void _truncated_test(void);
+    void _cameraCapture_test(void);
+    void _resubscribe_test(void);
+    void _windowed_test(void);
+
+private:
+    static QByteArray _message(char msgType, const QByteArray& payload);
+    static QByteArray _addLogged(int multiId, int msgId, const char* topicName);
+    static QByteArray _cameraCaptureData(int msgId, quint64 timestamp, quint32 seq, double lat, double lon);
+    static QByteArray _testLog(void);
+    static void _writeFile(const QString& fileName, const QByteArray& bytes);
+};
@@ -2069,6 +2069,7 @@ QGCCameraControl::_handleDefinitionFile(const QString &url)
             _modelName.toStdString().c_str(),
             ver,
             ext.toStdString().c_str());
+        _ftpURI = url;
         connect(_vehicle->ftpManager(), &FTPManager::downloadComplete, this, &QGCCameraControl::_ftpDownloadComplete);
         _vehicle->ftpManager()->download(_compID, url,
             qgcApp()->toolbox()->settingsManager()->appSettings()->parameterSavePath().toStdString().c_str(),
@@ -2146,8 +2147,13 @@ QGCCameraControl::_downloadFinished()
     //reply->deleteLater();
 }
 
-void QGCCameraControl::_ftpDownloadComplete(const QString& fileName, const QString& errorMsg)
+void QGCCameraControl::_ftpDownloadComplete(const QString& fileName, const QString& errorMsg, const QString& fromURI)
 {
+    if (fromURI != _ftpURI) {
+        // Some other download queued in FTPManager
+        return;
+    }
+
     qCDebug(CameraControlLog) << "FTP Download completed: " << fileName << ", " << errorMsg;
 
     disconnect(_vehicle->ftpManager(), &FTPManager::downloadComplete, this, &QGCCameraControl::_ftpDownloadComplete);
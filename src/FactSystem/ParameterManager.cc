@@ -29,6 +29,8 @@ QGC_LOGGING_CATEGORY(ParameterManagerVerbose1Log,           "ParameterManagerVer
 QGC_LOGGING_CATEGORY(ParameterManagerVerbose2Log,           "ParameterManagerVerbose2Log")
 QGC_LOGGING_CATEGORY(ParameterManagerDebugCacheFailureLog,  "ParameterManagerDebugCacheFailureLog") // Turn on to debug parameter cache crc misses
 
+const char* ParameterManager::_ftpParameterFileURI = "@PARAM/param.pck";
+
 const QHash<int, QString> _mavlinkCompIdHash {
     { MAV_COMP_ID_CAMERA,   "Camera1" },
     { MAV_COMP_ID_CAMERA2,  "Camera2" },
@@ -443,11 +445,16 @@ void ParameterManager::_factRawValueUpdated(const QVariant& rawValue)
     _factRawValueUpdateWorker(fact->componentId(), fact->name(), fact->type(), rawValue);
 }
 
-void ParameterManager::_ftpDownloadComplete(const QString& fileName, const QString& errorMsg)
+void ParameterManager::_ftpDownloadComplete(const QString& fileName, const QString& errorMsg, const QString& fromURI)
 {
     bool continueWithDefaultParameterdownload = true;
     bool immediateRetry = false;
 
+    if (fromURI != _ftpParameterFileURI) {
+        // Some other download queued in FTPManager
+        return;
+    }
+
     disconnect(_vehicle->ftpManager(), &FTPManager::downloadComplete, this, &ParameterManager::_ftpDownloadComplete);
     disconnect(_vehicle->ftpManager(), &FTPManager::commandProgress, this, &ParameterManager::_ftpDownloadProgress);
 
@@ -492,8 +499,11 @@ void ParameterManager::_ftpDownloadComplete(const QString& fileName, const QStri
 }
 
 
-void ParameterManager::_ftpDownloadProgress(float progress)
+void ParameterManager::_ftpDownloadProgress(float progress, const QString& uri)
 {
+    if (uri != _ftpParameterFileURI) {
+        return;
+    }
     qCDebug(ParameterManagerVerbose1Log) << "ParameterManager::_ftpDownloadProgress: " << progress;
     _setLoadProgress(static_cast<double>(progress));
     if (progress > 0.001)
@@ -526,7 +536,7 @@ void ParameterManager::refreshAllParameters(uint8_t componentId)
         FTPManager* ftpManager = _vehicle->ftpManager();
         connect(ftpManager, &FTPManager::downloadComplete, this, &ParameterManager::_ftpDownloadComplete);
         _waitingParamTimeoutTimer.stop();
-        if (ftpManager->download(MAV_COMP_ID_AUTOPILOT1, "@PARAM/param.pck",
+        if (ftpManager->download(MAV_COMP_ID_AUTOPILOT1, _ftpParameterFileURI,
                                  QStandardPaths::writableLocation(QStandardPaths::TempLocation),
                                  "", false /* No filesize check */)) {
             connect(ftpManager, &FTPManager::commandProgress, this, &ParameterManager::_ftpDownloadProgress);
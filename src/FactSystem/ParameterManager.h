@@ -126,8 +126,8 @@ private:
     bool    _fillIndexBatchQueue                (bool waitingParamTimeout);
     void    _updateProgressBar                  (void);
     void    _checkInitialLoadComplete           (void);
-    void    _ftpDownloadComplete                (const QString& fileName, const QString& errorMsg);
-    void    _ftpDownloadProgress                (float progress);
+    void    _ftpDownloadComplete                (const QString& fileName, const QString& errorMsg, const QString& fromURI);
+    void    _ftpDownloadProgress                (float progress, const QString& uri);
     bool    _parseParamFile                     (const QString& filename);
 
     static QVariant _stringToTypedVariant(const QString& string, FactMetaData::ValueType_t type, bool failOk = false);
@@ -166,6 +166,7 @@ private:
     int                 _initialRequestRetryCount;              ///< Current retry count for request list
     static const int    _maxInitialLoadRetrySingleParam = 5;    ///< Maximum retries for initial index based load of a single param
     static const int    _maxReadWriteRetry = 5;                 ///< Maximum retries read/write
+    static const char*  _ftpParameterFileURI;                   ///< Parameter file downloaded through FTP
     bool                _disableAllRetries;                     ///< true: Don't retry any requests (used for testing)
 
     bool        _indexBatchQueueActive; ///< true: we are actively batching re-requests for missing index base params, false: index based re-request has not yet started
@@ -238,6 +238,14 @@ public:
     ///     false: Do not send first item to vehicle, sequence numbers must be adjusted
     virtual bool sendHomePositionToVehicle(void);
 
+    /// Maximum number of MISSION_REQUEST_INT messages to have in flight while reading a plan. Values greater than 1 are
+    /// only valid for firmware which answers requests for any sequence number in any order.
+    virtual int missionReadRequestWindow(void) const { return 1; }
+
+    /// true: Mission, fence and rally point plans can be read from the vehicle at the same time. Only valid for firmware
+    /// which serves read requests of each plan type independently rather than through a single transaction.
+    virtual bool concurrentPlanReads(void) const { return false; }
+
     /// Returns the parameter set version info pulled from inside the meta data file. -1 if not found.
     /// Note: The implementation for this must not vary by vehicle type.
     /// Important: Only CompInfoParam code should use this method
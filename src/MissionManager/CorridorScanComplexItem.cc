@@ -192,7 +192,7 @@ void CorridorScanComplexItem::rotateEntryPoint(void)
         _entryPoint = 0;
     }
 
-    _rebuildTransects();
+    _scheduleRebuildTransects();
 }
 
 void CorridorScanComplexItem::_rebuildCorridorPolygon(void)
@@ -219,29 +219,36 @@ void CorridorScanComplexItem::_rebuildCorridorPolygon(void)
     _surveyAreaPolygon.appendVertices(rgCoord);
 }
 
-void CorridorScanComplexItem::_rebuildTransectsPhase1(void)
+CorridorScanComplexItem::TransectsBuilder_t CorridorScanComplexItem::_transectsBuilder(void)
 {
-    if (_ignoreRecalc) {
-        return;
-    }
+    TransectParams_t params;
+    params.polyline             = _corridorPolyline.coordinateList();
+    params.transectSpacing      = _calcTransectSpacing();
+    params.corridorWidth        = _corridorWidthFact.rawValue().toDouble();
+    params.transectCount        = _calcTransectCount();
+    params.entryPoint           = _entryPoint;
+    params.turnAroundDistance   = _turnAroundDistanceFact.rawValue().toDouble();
+
+    return [params](const std::atomic_bool& cancel) { return _buildTransects(params, cancel); };
+}
 
-    // If the transects are getting rebuilt then any previsouly loaded mission items are now invalid
-    if (_loadedMissionItemsParent) {
-        _loadedMissionItems.clear();
-        _loadedMissionItemsParent->deleteLater();
-        _loadedMissionItemsParent = nullptr;
-    }
+CorridorScanComplexItem::Transects_t CorridorScanComplexItem::_buildTransects(const TransectParams_t& params, const std::atomic_bool& cancel)
+{
+    Transects_t rgTransects;
 
-    double transectSpacing = _calcTransectSpacing();
-    double fullWidth = _corridorWidthFact.rawValue().toDouble();
+    double transectSpacing = params.transectSpacing;
+    double fullWidth = params.corridorWidth;
     double halfWidth = fullWidth / 2.0;
-    int transectCount = _calcTransectCount();
+    int transectCount = params.transectCount;
     double normalizedTransectPosition = transectSpacing / 2.0;
 
-    if (_corridorPolyline.count() >= 2) {
+    if (params.polyline.count() >= 2) {
         // First build up the transects all going the same direction
         //qDebug() << "_rebuildTransectsPhase1";
         for (int i=0; i<transectCount; i++) {
+            if (cancel) {
+                return rgTransects;
+            }
             //qDebug() << "start transect";
             double offsetDistance;
             if (transectCount == 1) {
@@ -254,7 +261,7 @@ void CorridorScanComplexItem::_rebuildTransectsPhase1(void)
 
             // Turn transect into CoordInfo transect
             QList<TransectStyleComplexItem::CoordInfo_t> transect;
-            QList<QGeoCoordinate> transectCoords = _corridorPolyline.offsetPolyline(offsetDistance);
+            QList<QGeoCoordinate> transectCoords = QGCMapPolyline::offsetPolyline(params.polyline, offsetDistance);
             for (int j=1; j<transectCoords.count() - 1; j++) {
                 TransectStyleComplexItem::CoordInfo_t coordInfo = { transectCoords[j], CoordTypeInterior };
                 transect.append(coordInfo);
@@ -265,9 +272,9 @@ void CorridorScanComplexItem::_rebuildTransectsPhase1(void)
             transect.append(coordInfo);
 
             // Extend the transect ends for turnaround
-            if (_hasTurnaround()) {
+            if (params.turnAroundDistance > 0) {
                 QGeoCoordinate turnaroundCoord;
-                double turnAroundDistance = _turnAroundDistanceFact.rawValue().toDouble();
+                double turnAroundDistance = params.turnAroundDistance;
 
                 double azimuth = transectCoords[0].azimuthTo(transectCoords[1]);
                 turnaroundCoord = transectCoords[0].atDistanceAndAzimuth(-turnAroundDistance, azimuth);
@@ -289,7 +296,7 @@ void CorridorScanComplexItem::_rebuildTransectsPhase1(void)
             }
 #endif
 
-            _transects.append(transect);
+            rgTransects.append(transect);
             normalizedTransectPosition += transectSpacing;
         }
 
@@ -301,7 +308,7 @@ void CorridorScanComplexItem::_rebuildTransectsPhase1(void)
 
         bool reverseTransects = false;
         bool reverseVertices = false;
-        switch (_entryPoint) {
+        switch (params.entryPoint) {
         case 0:
             reverseTransects = false;
             reverseVertices = false;
@@ -321,26 +328,26 @@ void CorridorScanComplexItem::_rebuildTransectsPhase1(void)
         }
         if (reverseTransects) {
             QList<QList<TransectStyleComplexItem::CoordInfo_t>> reversedTransects;
-            for (const QList<TransectStyleComplexItem::CoordInfo_t>& transect: _transects) {
+            for (const QList<TransectStyleComplexItem::CoordInfo_t>& transect: rgTransects) {
                 reversedTransects.prepend(transect);
             }
-            _transects = reversedTransects;
+            rgTransects = reversedTransects;
         }
         if (reverseVertices) {
-            for (int i=0; i<_transects.count(); i++) {
+            for (int i=0; i<rgTransects.count(); i++) {
                 QList<TransectStyleComplexItem::CoordInfo_t> reversedVertices;
-                for (const TransectStyleComplexItem::CoordInfo_t& vertex: _transects[i]) {
+                for (const TransectStyleComplexItem::CoordInfo_t& vertex: rgTransects[i]) {
                     reversedVertices.prepend(vertex);
                 }
-                _transects[i] = reversedVertices;
+                rgTransects[i] = reversedVertices;
             }
         }
 
         // Adjust to lawnmower pattern
         reverseVertices = false;
-        for (int i=0; i<_transects.count(); i++) {
+        for (int i=0; i<rgTransects.count(); i++) {
             // We must reverse the vertices for every other transect in order to make a lawnmower pattern
-            QList<TransectStyleComplexItem::CoordInfo_t> transectVertices = _transects[i];
+            QList<TransectStyleComplexItem::CoordInfo_t> transectVertices = rgTransects[i];
             if (reverseVertices) {
                 reverseVertices = false;
                 QList<TransectStyleComplexItem::CoordInfo_t> reversedVertices;
@@ -359,9 +366,11 @@ void CorridorScanComplexItem::_rebuildTransectsPhase1(void)
             } else {
                 reverseVertices = true;
             }
-            _transects[i] = transectVertices;
+            rgTransects[i] = transectVertices;
         }
     }
+
+    return rgTransects;
 }
 
 void CorridorScanComplexItem::_recalcCameraShots(void)
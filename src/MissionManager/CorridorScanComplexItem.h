@@ -68,10 +68,24 @@ private slots:
     void _updateWizardMode              (void);
 
     // Overrides from TransectStyleComplexItem
-    void _rebuildTransectsPhase1    (void) final;
     void _recalcCameraShots         (void) final;
 
 private:
+    /// Snapshot of everything needed to generate the transects, so they can be generated away from the main thread
+    typedef struct {
+        QList<QGeoCoordinate>   polyline;
+        double                  transectSpacing;
+        double                  corridorWidth;
+        int                     transectCount;
+        int                     entryPoint;
+        double                  turnAroundDistance;
+    } TransectParams_t;
+
+    // Overrides from TransectStyleComplexItem
+    TransectsBuilder_t _transectsBuilder(void) final;
+
+    static Transects_t _buildTransects(const TransectParams_t& params, const std::atomic_bool& cancel);
+
     double  _calcTransectSpacing    (void) const;
     int     _calcTransectCount      (void) const;
     void    _saveCommon             (QJsonObject& complexObject);
@@ -672,6 +672,7 @@ bool MissionController::_loadJsonMissionFileV1(const QJsonObject& json, QmlObjec
     }
 
     qCDebug(MissionControllerLog) << "Json load: simple item loop start simpleItemCount:ComplexItemCount" << itemArray.count() << surveyItems.count();
+    QList<QObject*> loadedItems;
     do {
         qCDebug(MissionControllerLog) << "Json load: simple item loop nextSimpleItemIndex:nextComplexItemIndex:nextSequenceNumber" << nextSimpleItemIndex << nextComplexItemIndex << nextSequenceNumber;
 
@@ -681,7 +682,7 @@ bool MissionController::_loadJsonMissionFileV1(const QJsonObject& json, QmlObjec
 
             if (complexItem->sequenceNumber() == nextSequenceNumber) {
                 qCDebug(MissionControllerLog) << "Json load: injecting complex item expectedSequence:actualSequence:" << nextSequenceNumber << complexItem->sequenceNumber();
-                visualItems->append(complexItem);
+                loadedItems.append(complexItem);
                 nextSequenceNumber = complexItem->lastSequenceNumber() + 1;
                 nextComplexItemIndex++;
                 continue;
@@ -693,6 +694,7 @@ bool MissionController::_loadJsonMissionFileV1(const QJsonObject& json, QmlObjec
             const QJsonValue& itemValue = itemArray[nextSimpleItemIndex++];
 
             if (!itemValue.isObject()) {
+                visualItems->append(loadedItems);
                 errorString = QStringLiteral("Mission item is not an object");
                 return false;
             }
@@ -709,12 +711,14 @@ bool MissionController::_loadJsonMissionFileV1(const QJsonObject& json, QmlObjec
                 }
                 qCDebug(MissionControllerLog) << "Json load: adding simple item expectedSequence:actualSequence" << nextSequenceNumber << item->sequenceNumber();
                 nextSequenceNumber = item->lastSequenceNumber() + 1;
-                visualItems->append(item);
+                loadedItems.append(item);
             } else {
+                visualItems->append(loadedItems);
                 return false;
             }
         }
     } while (nextSimpleItemIndex < itemArray.count() || nextComplexItemIndex < surveyItems.count());
+    visualItems->append(loadedItems);
 
     return true;
 }
@@ -780,10 +784,46 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
     visualItems->insert(0, settingsItem);
     qCDebug(MissionControllerLog) << "plannedHomePosition" << homeCoordinate;
 
-    // Read mission items
+    // Read mission items. They are collected and added to the model as a single insert once loaded rather than one model update per item.
 
+    QList<QObject*> loadedItems;
+    bool            itemsLoaded = _loadJsonMissionItemsV2(json[_jsonItemsKey].toArray(), settingsItem, loadedItems, errorString);
+    visualItems->append(loadedItems);
+    if (!itemsLoaded) {
+        return false;
+    }
+
+    // Fix up the DO_JUMP commands jump sequence number by finding the item with the matching doJumpId.
+    // The first item with a given doJumpId is the jump target.
+    QHash<int, int>             doJumpIdToSequenceNumber;
+    QList<SimpleMissionItem*>   doJumpItems;
+    for (int i=0; i<visualItems->count(); i++) {
+        if (visualItems->value<VisualMissionItem*>(i)->isSimpleItem()) {
+            SimpleMissionItem* simpleItem = visualItems->value<SimpleMissionItem*>(i);
+            int doJumpId = simpleItem->missionItem().doJumpId();
+            if (!doJumpIdToSequenceNumber.contains(doJumpId)) {
+                doJumpIdToSequenceNumber[doJumpId] = simpleItem->sequenceNumber();
+            }
+            if (simpleItem->command() == MAV_CMD_DO_JUMP) {
+                doJumpItems.append(simpleItem);
+            }
+        }
+    }
+    for (SimpleMissionItem* doJumpItem: doJumpItems) {
+        int findDoJumpId = static_cast<int>(doJumpItem->missionItem().param1());
+        if (!doJumpIdToSequenceNumber.contains(findDoJumpId)) {
+            errorString = tr("Could not find doJumpId: %1").arg(findDoJumpId);
+            return false;
+        }
+        doJumpItem->missionItem().setParam1(doJumpIdToSequenceNumber[findDoJumpId]);
+    }
+
+    return true;
+}
+
+bool MissionController::_loadJsonMissionItemsV2(const QJsonArray& rgMissionItems, MissionSettingsItem* settingsItem, QList<QObject*>& loadedItems, QString& errorString)
+{
     int nextSequenceNumber = 1; // Start with 1 since home is in 0
-    const QJsonArray rgMissionItems(json[_jsonItemsKey].toArray());
     for (int i=0; i<rgMissionItems.count(); i++) {
         // Convert to QJsonObject
         const QJsonValue& itemValue = rgMissionItems[i];
@@ -815,7 +855,7 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
                 }
                 qCDebug(MissionControllerLog) << "Loading simple item: nextSequenceNumber:command" << nextSequenceNumber << simpleItem->command();
                 nextSequenceNumber = simpleItem->lastSequenceNumber() + 1;
-                visualItems->append(simpleItem);
+                loadedItems.append(simpleItem);
             } else {
                 return false;
             }
@@ -836,7 +876,7 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
                 }
                 nextSequenceNumber = surveyItem->lastSequenceNumber() + 1;
                 qCDebug(MissionControllerLog) << "Survey load complete: nextSequenceNumber" << nextSequenceNumber;
-                visualItems->append(surveyItem);
+                loadedItems.append(surveyItem);
             } else if (complexItemType == FixedWingLandingComplexItem::jsonComplexItemTypeValue) {
                 qCDebug(MissionControllerLog) << "Loading Fixed Wing Landing Pattern: nextSequenceNumber" << nextSequenceNumber;
                 FixedWingLandingComplexItem* landingItem = new FixedWingLandingComplexItem(_masterController, _flyView);
@@ -845,7 +885,7 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
                 }
                 nextSequenceNumber = landingItem->lastSequenceNumber() + 1;
                 qCDebug(MissionControllerLog) << "FW Landing Pattern load complete: nextSequenceNumber" << nextSequenceNumber;
-                visualItems->append(landingItem);
+                loadedItems.append(landingItem);
             } else if (complexItemType == VTOLLandingComplexItem::jsonComplexItemTypeValue) {
                 qCDebug(MissionControllerLog) << "Loading VTOL Landing Pattern: nextSequenceNumber" << nextSequenceNumber;
                 VTOLLandingComplexItem* landingItem = new VTOLLandingComplexItem(_masterController, _flyView);
@@ -854,7 +894,7 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
                 }
                 nextSequenceNumber = landingItem->lastSequenceNumber() + 1;
                 qCDebug(MissionControllerLog) << "VTOL Landing Pattern load complete: nextSequenceNumber" << nextSequenceNumber;
-                visualItems->append(landingItem);
+                loadedItems.append(landingItem);
             } else if (complexItemType == StructureScanComplexItem::jsonComplexItemTypeValue) {
                 qCDebug(MissionControllerLog) << "Loading Structure Scan: nextSequenceNumber" << nextSequenceNumber;
                 StructureScanComplexItem* structureItem = new StructureScanComplexItem(_masterController, _flyView, QString() /* kmlFile */);
@@ -863,7 +903,7 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
                 }
                 nextSequenceNumber = structureItem->lastSequenceNumber() + 1;
                 qCDebug(MissionControllerLog) << "Structure Scan load complete: nextSequenceNumber" << nextSequenceNumber;
-                visualItems->append(structureItem);
+                loadedItems.append(structureItem);
             } else if (complexItemType == CorridorScanComplexItem::jsonComplexItemTypeValue) {
                 qCDebug(MissionControllerLog) << "Loading Corridor Scan: nextSequenceNumber" << nextSequenceNumber;
                 CorridorScanComplexItem* corridorItem = new CorridorScanComplexItem(_masterController, _flyView, QString() /* kmlFile */);
@@ -872,7 +912,7 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
                 }
                 nextSequenceNumber = corridorItem->lastSequenceNumber() + 1;
                 qCDebug(MissionControllerLog) << "Corridor Scan load complete: nextSequenceNumber" << nextSequenceNumber;
-                visualItems->append(corridorItem);
+                loadedItems.append(corridorItem);
             } else {
                 errorString = tr("Unsupported complex item type: %1").arg(complexItemType);
             }
@@ -882,31 +922,6 @@ bool MissionController::_loadJsonMissionFileV2(const QJsonObject& json, QmlObjec
         }
     }
 
-    // Fix up the DO_JUMP commands jump sequence number by finding the item with the matching doJumpId
-    for (int i=0; i<visualItems->count(); i++) {
-        if (visualItems->value<VisualMissionItem*>(i)->isSimpleItem()) {
-            SimpleMissionItem* doJumpItem = visualItems->value<SimpleMissionItem*>(i);
-            if (doJumpItem->command() == MAV_CMD_DO_JUMP) {
-                bool found = false;
-                int findDoJumpId = static_cast<int>(doJumpItem->missionItem().param1());
-                for (int j=0; j<visualItems->count(); j++) {
-                    if (visualItems->value<VisualMissionItem*>(j)->isSimpleItem()) {
-                        SimpleMissionItem* targetItem = visualItems->value<SimpleMissionItem*>(j);
-                        if (targetItem->missionItem().doJumpId() == findDoJumpId) {
-                            doJumpItem->missionItem().setParam1(targetItem->sequenceNumber());
-                            found = true;
-                            break;
-                        }
-                    }
-                }
-                if (!found) {
-                    errorString = tr("Could not find doJumpId: %1").arg(findDoJumpId);
-                    return false;
-                }
-            }
-        }
-    }
-
     return true;
 }
 
@@ -954,7 +969,8 @@ bool MissionController::_loadTextMissionFile(QTextStream& stream, QmlObjectListM
     }
 
     if (versionOk) {
-        MissionSettingsItem* settingsItem = _addMissionSettings(visualItems);
+        MissionSettingsItem*    settingsItem = _addMissionSettings(visualItems);
+        QList<QObject*>         loadedItems;
 
         while (!stream.atEnd()) {
             SimpleMissionItem* item = new SimpleMissionItem(_masterController, _flyView, true /* forLoad */);
@@ -969,14 +985,16 @@ bool MissionController::_loadTextMissionFile(QTextStream& stream, QmlObjectListM
                         item->deleteLater();
                         item = takeoffItem;
                     }
-                    visualItems->append(item);
+                    loadedItems.append(item);
                 }
                 firstItem = false;
             } else {
+                visualItems->append(loadedItems);
                 errorString = tr("The mission file is corrupted.");
                 return false;
             }
         }
+        visualItems->append(loadedItems);
     } else {
         errorString = tr("The mission file is not compatible with this version of %1.").arg(qgcApp()->applicationName());
         return false;
@@ -1123,19 +1141,19 @@ void MissionController::save(QJsonObject& json)
         visualItem->save(rgJsonMissionItems);
     }
 
-    // Mission settings has a special case for end mission action
+    // Mission settings has a special case for end mission action. Only the end action itself is needed here, so
+    // there is no need to convert the whole plan to MissionItems.
     if (settingsItem) {
         QList<MissionItem*> rgMissionItems;
+        VisualMissionItem*  lastVisualItem = _visualItems->value<VisualMissionItem*>(_visualItems->count() - 1);
 
-        if (_convertToMissionItems(_visualItems, rgMissionItems, this /* missionItemParent */)) {
+        if (settingsItem->addMissionEndAction(rgMissionItems, lastVisualItem->lastSequenceNumber() + 1, this /* missionItemParent */)) {
             QJsonObject saveObject;
             MissionItem* missionItem = rgMissionItems[rgMissionItems.count() - 1];
             missionItem->save(saveObject);
             rgJsonMissionItems.append(saveObject);
         }
-        for (int i=0; i<rgMissionItems.count(); i++) {
-            rgMissionItems[i]->deleteLater();
-        }
+        qDeleteAll(rgMissionItems);
     }
 
     json[_jsonItemsKey] = rgJsonMissionItems;
@@ -1193,11 +1211,13 @@ FlightPathSegment* MissionController::_createFlightPathSegmentWorker(VisualItemP
     connect(pair.second, &VisualMissionItem::coordinateChanged,     segment,    &FlightPathSegment::setCoordinate2);
     connect(pair.second, &VisualMissionItem::amslEntryAltChanged,   segment,    &FlightPathSegment::setCoord2AMSLAlt);
 
-    connect(pair.second, &VisualMissionItem::coordinateChanged,         this,       &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+    connect(pair.second, &VisualMissionItem::coordinateChanged,         this,       &MissionController::_recalcMissionFlightStatusFromSender);
 
+    // Flight status only needs recalculating from the first item of the pair onwards
+    VisualMissionItem* firstItem = pair.first;
     connect(segment,    &FlightPathSegment::totalDistanceChanged,       this,       &MissionController::recalcTerrainProfile,             Qt::QueuedConnection);
-    connect(segment,    &FlightPathSegment::coord1AMSLAltChanged,       this,       &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(segment,    &FlightPathSegment::coord2AMSLAltChanged,       this,       &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+    connect(segment,    &FlightPathSegment::coord1AMSLAltChanged,       this,       [this, firstItem]() { _recalcMissionFlightStatusFromItem(firstItem); });
+    connect(segment,    &FlightPathSegment::coord2AMSLAltChanged,       this,       [this, firstItem]() { _recalcMissionFlightStatusFromItem(firstItem); });
     connect(segment,    &FlightPathSegment::amslTerrainHeightsChanged,  this,       &MissionController::recalcTerrainProfile,             Qt::QueuedConnection);
     connect(segment,    &FlightPathSegment::terrainCollisionChanged,    this,       &MissionController::recalcTerrainProfile,             Qt::QueuedConnection);
 
@@ -1446,7 +1466,7 @@ void MissionController::_recalcFlightPathSegments(void)
     // Anything left in the old table is an obsolete line object that can go
     qDeleteAll(oldSegmentTable);
 
-    emit _recalcMissionFlightStatusSignal();
+    _recalcMissionFlightStatusFromStart();
 
     if (_waypointPath.count() == 0) {
         // MapPolyLine has a bug where if you change from a path which has elements to an empty path the line drawn
@@ -1523,42 +1543,95 @@ void MissionController::_addTimeDistance(bool vtolInHover, double hoverTime, dou
     }
 }
 
+void MissionController::_recalcMissionFlightStatusFromItem(VisualMissionItem* visualItem)
+{
+    int index = _visualItems->indexOf(visualItem);
+    if (index == -1) {
+        index = 0;
+    }
+    _flightStatusRecalcIndex = _flightStatusRecalcIndex == -1 ? index : qMin(_flightStatusRecalcIndex, index);
+    emit _recalcMissionFlightStatusSignal();
+}
+
+void MissionController::_recalcMissionFlightStatusFromSender(void)
+{
+    _recalcMissionFlightStatusFromItem(qobject_cast<VisualMissionItem*>(sender()));
+}
+
+void MissionController::_recalcMissionFlightStatusFromStart(void)
+{
+    _flightStatusRecalcIndex = 0;
+    emit _recalcMissionFlightStatusSignal();
+}
+
 void MissionController::_recalcMissionFlightStatus()
 {
     if (!_visualItems->count()) {
         return;
     }
 
+    // Changes to an item can only affect the flight status from that item onwards. So we resume the calculation from the
+    // checkpoint before the first changed item, as long as the items before it are still the ones the checkpoints were taken for.
+    int startIndex = qMax(_flightStatusRecalcIndex, 0);
+    _flightStatusRecalcIndex = -1;
+    if (startIndex >= _flightStatusCheckpoints.count() || startIndex >= _visualItems->count()) {
+        startIndex = 0;
+    }
+    for (int i=0; i<startIndex; i++) {
+        if (_flightStatusCheckpoints[i].item != _visualItems->get(i)) {
+            startIndex = 0;
+            break;
+        }
+    }
+    _flightStatusCheckpoints.resize(_visualItems->count());
+    _lastFlightStatusRecalcIndex = startIndex;
+
     bool                firstCoordinateItem =           true;
     VisualMissionItem*  lastFlyThroughVI =   qobject_cast<VisualMissionItem*>(_visualItems->get(0));
 
     bool homePositionValid = _settingsItem->coordinate().isValid();
 
-    qCDebug(MissionControllerLog) << "_recalcMissionFlightStatus";
+    qCDebug(MissionControllerLog) << "_recalcMissionFlightStatus startIndex" << startIndex;
 
     // If home position is valid we can calculate distances between all waypoints.
     // If home position is not valid we can only calculate distances between waypoints which are
     // both relative altitude.
 
-    // No values for first item
-    lastFlyThroughVI->setAltDifference(0);
-    lastFlyThroughVI->setAzimuth(0);
-    lastFlyThroughVI->setDistance(0);
-    lastFlyThroughVI->setDistanceFromStart(0);
-
-    _minAMSLAltitude = _maxAMSLAltitude = qQNaN();
-
-    _resetMissionFlightStatus();
-
     bool   linkStartToHome =            false;
     bool   foundRTL =                   false;
     double totalHorizontalDistance =    0;
+    double previousMinAMSLAltitude =    _minAMSLAltitude;
+    double previousMaxAMSLAltitude =    _maxAMSLAltitude;
 
-    for (int i=0; i<_visualItems->count(); i++) {
+    if (startIndex == 0) {
+        // No values for first item
+        lastFlyThroughVI->setAltDifference(0);
+        lastFlyThroughVI->setAzimuth(0);
+        lastFlyThroughVI->setDistance(0);
+        lastFlyThroughVI->setDistanceFromStart(0);
+
+        _minAMSLAltitude = _maxAMSLAltitude = qQNaN();
+
+        _resetMissionFlightStatus();
+    } else {
+        const FlightStatusCheckpoint_t& checkpoint = _flightStatusCheckpoints[startIndex];
+        _missionFlightStatus =      checkpoint.missionFlightStatus;
+        lastFlyThroughVI =          checkpoint.lastFlyThroughVI;
+        firstCoordinateItem =       checkpoint.firstCoordinateItem;
+        linkStartToHome =           checkpoint.linkStartToHome;
+        foundRTL =                  checkpoint.foundRTL;
+        totalHorizontalDistance =   checkpoint.totalHorizontalDistance;
+        _minAMSLAltitude =          checkpoint.minAMSLAltitude;
+        _maxAMSLAltitude =          checkpoint.maxAMSLAltitude;
+    }
+
+    for (int i=startIndex; i<_visualItems->count(); i++) {
         VisualMissionItem*  item =          qobject_cast<VisualMissionItem*>(_visualItems->get(i));
         SimpleMissionItem*  simpleItem =    qobject_cast<SimpleMissionItem*>(item);
         ComplexMissionItem* complexItem =   qobject_cast<ComplexMissionItem*>(item);
 
+        _flightStatusCheckpoints[i] = { item, _missionFlightStatus, lastFlyThroughVI, firstCoordinateItem, linkStartToHome, foundRTL, totalHorizontalDistance, _minAMSLAltitude, _maxAMSLAltitude };
+
         if (simpleItem && simpleItem->mavCommand() == MAV_CMD_NAV_RETURN_TO_LAUNCH) {
             foundRTL = true;
         }
@@ -1768,9 +1841,11 @@ void MissionController::_recalcMissionFlightStatus()
     emit minAMSLAltitudeChanged         (_minAMSLAltitude);
     emit maxAMSLAltitudeChanged         (_maxAMSLAltitude);
 
-    // Walk the list again calculating altitude percentages
+    // Walk the list again calculating altitude percentages. Items prior to the recalc only need updating if the altitude range changed.
+    auto sameAltitude = [](double altitude1, double altitude2) { return altitude1 == altitude2 || (qIsNaN(altitude1) && qIsNaN(altitude2)); };
+    int altPercentStartIndex = sameAltitude(_minAMSLAltitude, previousMinAMSLAltitude) && sameAltitude(_maxAMSLAltitude, previousMaxAMSLAltitude) ? startIndex : 0;
     double altRange = _maxAMSLAltitude - _minAMSLAltitude;
-    for (int i=0; i<_visualItems->count(); i++) {
+    for (int i=altPercentStartIndex; i<_visualItems->count(); i++) {
         VisualMissionItem* item = qobject_cast<VisualMissionItem*>(_visualItems->get(i));
 
         if (item->specifiesCoordinate()) {
@@ -1954,13 +2029,13 @@ void MissionController::_initVisualItem(VisualMissionItem* visualItem)
     setDirty(false);
 
     connect(visualItem, &VisualMissionItem::specifiesCoordinateChanged,                 this, &MissionController::_recalcFlightPathSegmentsSignal,  Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedFlightSpeedChanged,                this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedGimbalYawChanged,                  this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedGimbalPitchChanged,                this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedVehicleYawChanged,                 this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::terrainAltitudeChanged,                     this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::additionalTimeDelayChanged,                 this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::currentVTOLModeChanged,                     this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+    connect(visualItem, &VisualMissionItem::specifiedFlightSpeedChanged,                this, &MissionController::_recalcMissionFlightStatusFromSender);
+    connect(visualItem, &VisualMissionItem::specifiedGimbalYawChanged,                  this, &MissionController::_recalcMissionFlightStatusFromSender);
+    connect(visualItem, &VisualMissionItem::specifiedGimbalPitchChanged,                this, &MissionController::_recalcMissionFlightStatusFromSender);
+    connect(visualItem, &VisualMissionItem::specifiedVehicleYawChanged,                 this, &MissionController::_recalcMissionFlightStatusFromSender);
+    connect(visualItem, &VisualMissionItem::terrainAltitudeChanged,                     this, &MissionController::_recalcMissionFlightStatusFromSender);
+    connect(visualItem, &VisualMissionItem::additionalTimeDelayChanged,                 this, &MissionController::_recalcMissionFlightStatusFromSender);
+    connect(visualItem, &VisualMissionItem::currentVTOLModeChanged,                     this, &MissionController::_recalcMissionFlightStatusFromSender);
     connect(visualItem, &VisualMissionItem::lastSequenceNumberChanged,                  this, &MissionController::_recalcSequence);
 
     if (visualItem->isSimpleItem()) {
@@ -1974,10 +2049,10 @@ void MissionController::_initVisualItem(VisualMissionItem* visualItem)
     } else {
         ComplexMissionItem* complexItem = qobject_cast<ComplexMissionItem*>(visualItem);
         if (complexItem) {
-            connect(complexItem, &ComplexMissionItem::complexDistanceChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-            connect(complexItem, &ComplexMissionItem::greatestDistanceToChanged,    this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-            connect(complexItem, &ComplexMissionItem::minAMSLAltitudeChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-            connect(complexItem, &ComplexMissionItem::maxAMSLAltitudeChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+            connect(complexItem, &ComplexMissionItem::complexDistanceChanged,       this, &MissionController::_recalcMissionFlightStatusFromSender);
+            connect(complexItem, &ComplexMissionItem::greatestDistanceToChanged,    this, &MissionController::_recalcMissionFlightStatusFromSender);
+            connect(complexItem, &ComplexMissionItem::minAMSLAltitudeChanged,       this, &MissionController::_recalcMissionFlightStatusFromSender);
+            connect(complexItem, &ComplexMissionItem::maxAMSLAltitudeChanged,       this, &MissionController::_recalcMissionFlightStatusFromSender);
             connect(complexItem, &ComplexMissionItem::isIncompleteChanged,          this, &MissionController::_recalcFlightPathSegmentsSignal,  Qt::QueuedConnection);
         } else {
             qWarning() << "ComplexMissionItem not found";
@@ -2022,8 +2097,8 @@ void MissionController::_managerVehicleChanged(Vehicle* managerVehicle)
     connect(_missionManager, &MissionManager::lastCurrentIndexChanged,  this, &MissionController::resumeMissionIndexChanged);
     connect(_missionManager, &MissionManager::resumeMissionReady,       this, &MissionController::resumeMissionReady);
     connect(_missionManager, &MissionManager::resumeMissionUploadFail,  this, &MissionController::resumeMissionUploadFail);
-    connect(_managerVehicle, &Vehicle::defaultCruiseSpeedChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(_managerVehicle, &Vehicle::defaultHoverSpeedChanged,        this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+    connect(_managerVehicle, &Vehicle::defaultCruiseSpeedChanged,       this, &MissionController::_recalcMissionFlightStatusFromStart);
+    connect(_managerVehicle, &Vehicle::defaultHoverSpeedChanged,        this, &MissionController::_recalcMissionFlightStatusFromStart);
     connect(_managerVehicle, &Vehicle::vehicleTypeChanged,              this, &MissionController::complexMissionItemNamesChanged);
 
     emit complexMissionItemNamesChanged();
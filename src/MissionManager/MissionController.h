@@ -18,6 +18,7 @@
 #include "QGroundControlQmlGlobal.h"
 
 #include <QHash>
+#include <QJsonArray>
 
 class FlightPathSegment;
 class VisualMissionItem;
@@ -306,6 +307,8 @@ private slots:
     void _currentMissionIndexChanged            (int sequenceNumber);
     void _recalcFlightPathSegments              (void);
     void _recalcMissionFlightStatus             (void);
+    void _recalcMissionFlightStatusFromSender   (void);
+    void _recalcMissionFlightStatusFromStart    (void);
     void _updateContainsItems                   (void);
     void _progressPctChanged                    (double progressPct);
     void _visualItemsDirtyChanged               (bool dirty);
@@ -335,6 +338,7 @@ private:
     bool                    _loadJsonMissionFile                (const QByteArray& bytes, QmlObjectListModel* visualItems, QString& errorString);
     bool                    _loadJsonMissionFileV1              (const QJsonObject& json, QmlObjectListModel* visualItems, QString& errorString);
     bool                    _loadJsonMissionFileV2              (const QJsonObject& json, QmlObjectListModel* visualItems, QString& errorString);
+    bool                    _loadJsonMissionItemsV2             (const QJsonArray& rgMissionItems, MissionSettingsItem* settingsItem, QList<QObject*>& loadedItems, QString& errorString);
     bool                    _loadTextMissionFile                (QTextStream& stream, QmlObjectListModel* visualItems, QString& errorString);
     int                     _nextSequenceNumber                 (void);
     void                    _scanForAdditionalSettings          (QmlObjectListModel* visualItems, PlanMasterController* masterController);
@@ -354,6 +358,7 @@ private:
     FlightPathSegment*      _createFlightPathSegmentWorker      (VisualItemPair& pair, bool mavlinkTerrainFrame);
     void                    _allItemsRemoved                    (void);
     void                    _firstItemAdded                     (void);
+    void                    _recalcMissionFlightStatusFromItem  (VisualMissionItem* visualItem);
 
     static double           _calcDistanceToHome                 (VisualMissionItem* currentItem, VisualMissionItem* homeItem);
     static double           _normalizeLat                       (double lat);
@@ -399,6 +404,24 @@ private:
     double                      _maxAMSLAltitude =              0;
     bool                        _missionContainsVTOLTakeoff =   false;
 
+    /// State of the flight status calculation before each visual item. A change to one item only needs the calculation
+    /// resumed from that item's checkpoint, rather than rerun across the whole mission.
+    typedef struct {
+        VisualMissionItem*      item;
+        MissionFlightStatus_t   missionFlightStatus;
+        VisualMissionItem*      lastFlyThroughVI;
+        bool                    firstCoordinateItem;
+        bool                    linkStartToHome;
+        bool                    foundRTL;
+        double                  totalHorizontalDistance;
+        double                  minAMSLAltitude;
+        double                  maxAMSLAltitude;
+    } FlightStatusCheckpoint_t;
+
+    QVector<FlightStatusCheckpoint_t>   _flightStatusCheckpoints;
+    int                                 _flightStatusRecalcIndex =      -1; ///< First visual item index needing recalc, -1 if no item was specified (recalc all)
+    int                                 _lastFlightStatusRecalcIndex =  0;  ///< Index the last recalc resumed from
+
     QGroundControlQmlGlobal::AltMode _globalAltMode = QGroundControlQmlGlobal::AltitudeModeRelative;
 
     static const char*  _settingsGroup;
@@ -419,4 +442,6 @@ private:
     static const char*  _jsonComplexItemsKey;
 
     static const int    _missionFileVersion;
+
+    friend class MissionControllerTest;
 };
@@ -17,6 +17,8 @@
 #include "SettingsManager.h"
 #include "AppSettings.h"
 
+#include <QElapsedTimer>
+
 MissionControllerTest::MissionControllerTest(void)
 {
     
@@ -229,6 +231,114 @@ void MissionControllerTest::_testVehicleYawRecalc(void)
     }
 }
 
+void MissionControllerTest::_testIncrementalFlightStatus(void)
+{
+    _initForFirmwareType(MAV_AUTOPILOT_PX4);
+    _masterController->loadFromFile(":/unittest/800Waypoints.mission");
+    QTest::qWait(100); // Recalcs in MissionController are queued to remove dups. Allow return to main message loop.
+
+    QmlObjectListModel* visualItems = _missionController->visualItems();
+    QVERIFY(visualItems->count() > 800);
+
+    // Move a waypoint in the middle of the mission, as if dragged on the map
+    const int changedIndex = visualItems->count() / 2;
+    VisualMissionItem* changedItem = visualItems->value<VisualMissionItem*>(changedIndex);
+    changedItem->setCoordinate(changedItem->coordinate().atDistanceAndAzimuth(500, 90));
+
+    QElapsedTimer timer;
+    timer.start();
+    _missionController->_recalcMissionFlightStatus();
+    qint64 incrementalNsecs = timer.nsecsElapsed();
+    QVERIFY(_missionController->_lastFlightStatusRecalcIndex > 0);
+    QVERIFY(_missionController->_lastFlightStatusRecalcIndex <= changedIndex);
+
+    double          missionDistance = _missionController->missionDistance();
+    double          missionTime =     _missionController->missionTime();
+    QList<double>   distancesFromStart;
+    QList<double>   altPercents;
+    for (int i=0; i<visualItems->count(); i++) {
+        distancesFromStart.append(visualItems->value<VisualMissionItem*>(i)->distanceFromStart());
+        altPercents.append(visualItems->value<VisualMissionItem*>(i)->altPercent());
+    }
+
+    // Resuming part way through must give exactly the same results as recalculating everything
+    _missionController->_recalcMissionFlightStatusFromStart();
+    timer.restart();
+    _missionController->_recalcMissionFlightStatus();
+    qint64 fullNsecs = timer.nsecsElapsed();
+    QCOMPARE(_missionController->_lastFlightStatusRecalcIndex, 0);
+
+    QCOMPARE(_missionController->missionDistance(), missionDistance);
+    QCOMPARE(_missionController->missionTime(), missionTime);
+    for (int i=0; i<visualItems->count(); i++) {
+        QCOMPARE(visualItems->value<VisualMissionItem*>(i)->distanceFromStart(), distancesFromStart[i]);
+        QCOMPARE(visualItems->value<VisualMissionItem*>(i)->altPercent(), altPercents[i]);
+    }
+
+    qDebug() << "Flight status recalc of" << visualItems->count() << "items: incremental nsecs" << incrementalNsecs << "full nsecs" << fullNsecs;
+}
+
+void MissionControllerTest::_testLoadLargePlans(void)
+{
+    _initForFirmwareType(MAV_AUTOPILOT_PX4);
+
+    QElapsedTimer timer;
+    const QStringList missionFiles = { ":/unittest/100Waypoints.mission", ":/unittest/800Waypoints.mission" };
+    for (const QString& missionFile: missionFiles) {
+        timer.start();
+        _masterController->loadFromFile(missionFile);
+        qDebug() << "Load" << missionFile << "items" << _missionController->visualItems()->count() << "msecs" << timer.elapsed();
+        QVERIFY(_missionController->visualItems()->count() > 100);
+    }
+
+    // Generated plan with a DO_JUMP at the end. The doJumpIds are deliberately not the same as the sequence numbers.
+    const int       cWaypoints =        5000;
+    const int       cDoJumpIdOffset =   1000;
+    const int       jumpTargetIndex =   cWaypoints / 2;
+    QGeoCoordinate  homeCoordinate(47.3977, 8.5456, 500);
+    QJsonArray      rgJsonItems;
+    for (int i=0; i<=cWaypoints; i++) {
+        QJsonObject jsonItem;
+        jsonItem[VisualMissionItem::jsonTypeKey] =  VisualMissionItem::jsonTypeSimpleItemValue;
+        jsonItem["autoContinue"] =                  true;
+        jsonItem["doJumpId"] =                      i + cDoJumpIdOffset;
+        if (i == cWaypoints) {
+            jsonItem["command"] =   MAV_CMD_DO_JUMP;
+            jsonItem["frame"] =     MAV_FRAME_MISSION;
+            jsonItem["params"] =    QJsonArray({ jumpTargetIndex + cDoJumpIdOffset, 1, 0, 0, 0, 0, 0 });
+        } else {
+            QGeoCoordinate coord = homeCoordinate.atDistanceAndAzimuth(10 * i, (i % 2) ? 90 : 0);
+            jsonItem["command"] =   MAV_CMD_NAV_WAYPOINT;
+            jsonItem["frame"] =     MAV_FRAME_GLOBAL_RELATIVE_ALT;
+            jsonItem["params"] =    QJsonArray({ 0, 0, 0, 0, coord.latitude(), coord.longitude(), 50 });
+        }
+        rgJsonItems.append(jsonItem);
+    }
+    QJsonObject json;
+    json["firmwareType"] =          MAV_AUTOPILOT_PX4;
+    json["plannedHomePosition"] =   QJsonArray({ homeCoordinate.latitude(), homeCoordinate.longitude(), homeCoordinate.altitude() });
+    json["items"] =                 rgJsonItems;
+
+    QString errorString;
+    timer.restart();
+    QVERIFY(_missionController->load(json, errorString));
+    qDebug() << "Load generated plan items" << cWaypoints + 1 << "msecs" << timer.elapsed();
+    QVERIFY(errorString.isEmpty());
+
+    QmlObjectListModel* visualItems = _missionController->visualItems();
+    QCOMPARE(visualItems->count(), cWaypoints + 2);
+    SimpleMissionItem* doJumpItem = visualItems->value<SimpleMissionItem*>(visualItems->count() - 1);
+    QVERIFY(doJumpItem);
+    QCOMPARE(doJumpItem->command(), static_cast<int>(MAV_CMD_DO_JUMP));
+    QCOMPARE(static_cast<int>(doJumpItem->missionItem().param1()), visualItems->value<VisualMissionItem*>(jumpTargetIndex + 1)->sequenceNumber());
+
+    timer.restart();
+    QJsonObject savedJson;
+    _missionController->save(savedJson);
+    qDebug() << "Save generated plan msecs" << timer.elapsed();
+    QCOMPARE(savedJson["items"].toArray().count(), cWaypoints + 1);
+}
+
 void MissionControllerTest::_testLoadJsonSectionAvailable(void)
 {
     _initForFirmwareType(MAV_AUTOPILOT_PX4);
@@ -38,6 +38,8 @@ private slots:
     void _testGlobalAltMode             (void);
     void _testGimbalRecalc              (void);
     void _testVehicleYawRecalc          (void);
+    void _testIncrementalFlightStatus   (void);
+    void _testLoadLargePlans            (void);
 
 private:
 #if 0
@@ -153,6 +153,7 @@ private:
     friend class SurveyComplexItem;
     friend class SimpleMissionItem;
     friend class MissionController;
+    friend class MissionItemStore;
 #ifdef UNITTEST_BUILD
     friend class MissionItemTest;
 #endif
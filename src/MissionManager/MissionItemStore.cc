@@ -0,0 +1,133 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MissionItemStore.h"
+#include "MissionItem.h"
+#include "VisualMissionItem.h"
+
+#include <cmath>
+
+void MissionItemStore::clear(void)
+{
+    _commands.clear();
+    _frames.clear();
+    _autoContinue.clear();
+    for (QVector<double>& params: _params) {
+        params.clear();
+    }
+}
+
+void MissionItemStore::reserve(int count)
+{
+    _commands.reserve(count);
+    _frames.reserve(count);
+    _autoContinue.reserve(count);
+    for (QVector<double>& params: _params) {
+        params.reserve(count);
+    }
+}
+
+void MissionItemStore::append(MAV_CMD command, MAV_FRAME frame, double param1, double param2, double param3, double param4, double param5, double param6, double param7, bool autoContinue)
+{
+    _commands.append(static_cast<quint16>(command));
+    _frames.append(static_cast<quint8>(frame));
+    _autoContinue.append(autoContinue);
+    _params[0].append(param1);
+    _params[1].append(param2);
+    _params[2].append(param3);
+    _params[3].append(param4);
+    _params[4].append(param5);
+    _params[5].append(param6);
+    _params[6].append(param7);
+}
+
+void MissionItemStore::append(const MissionItem& missionItem)
+{
+    append(missionItem.command(),
+           missionItem.frame(),
+           missionItem.param1(),
+           missionItem.param2(),
+           missionItem.param3(),
+           missionItem.param4(),
+           missionItem.param5(),
+           missionItem.param6(),
+           missionItem.param7(),
+           missionItem.autoContinue());
+}
+
+QGeoCoordinate MissionItemStore::coordinate(int index) const
+{
+    // Must match MissionItem::coordinate
+    if (!std::isfinite(param5(index)) || !std::isfinite(param6(index))) {
+        return QGeoCoordinate();
+    }
+    return QGeoCoordinate(param5(index), param6(index), param7(index));
+}
+
+MissionItem* MissionItemStore::createMissionItem(int index, int sequenceNumber, QObject* parent) const
+{
+    return new MissionItem(sequenceNumber,
+                           command(index),
+                           frame(index),
+                           param1(index),
+                           param2(index),
+                           param3(index),
+                           param4(index),
+                           param5(index),
+                           param6(index),
+                           param7(index),
+                           autoContinue(index),
+                           false,           // isCurrentItem
+                           parent);
+}
+
+void MissionItemStore::appendMissionItems(QList<MissionItem*>& items, int firstSequenceNumber, QObject* missionItemParent) const
+{
+    items.reserve(items.count() + count());
+    for (int i=0; i<count(); i++) {
+        items.append(createMissionItem(i, firstSequenceNumber + i, missionItemParent));
+    }
+}
+
+void MissionItemStore::save(QJsonArray& missionItemsJsonArray, int firstSequenceNumber) const
+{
+    // Must match MissionItem::save
+    for (int i=0; i<count(); i++) {
+        QJsonObject json;
+
+        json[VisualMissionItem::jsonTypeKey] =      VisualMissionItem::jsonTypeSimpleItemValue;
+        json[MissionItem::_jsonFrameKey] =          frame(i);
+        json[MissionItem::_jsonCommandKey] =        command(i);
+        json[MissionItem::_jsonAutoContinueKey] =   autoContinue(i);
+        json[MissionItem::_jsonDoJumpIdKey] =       firstSequenceNumber + i;
+
+        QJsonArray rgParams =  { param1(i), param2(i), param3(i), param4(i), param5(i), param6(i), param7(i) };
+        json[MissionItem::_jsonParamsKey] = rgParams;
+
+        missionItemsJsonArray.append(json);
+    }
+}
+
+bool MissionItemStore::load(const QJsonArray& missionItemsJsonArray, QString& errorString)
+{
+    clear();
+    reserve(missionItemsJsonArray.count());
+
+    // A single MissionItem is used to validate and convert older formats for each entry
+    MissionItem missionItem;
+    for (const QJsonValue missionItemJson: missionItemsJsonArray) {
+        if (!missionItem.load(missionItemJson.toObject(), 0 /* sequenceNumber */, errorString)) {
+            clear();
+            return false;
+        }
+        append(missionItem);
+    }
+
+    return true;
+}
@@ -0,0 +1,67 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "QGCMAVLink.h"
+
+#include <QVector>
+#include <QJsonArray>
+#include <QGeoCoordinate>
+
+class MissionItem;
+
+/// Compact value type storage for a list of mission items. Complex items can generate tens of thousands of mission items which
+/// are never edited individually. Holding those as MissionItem objects costs a QObject plus a Fact for each value. Items are
+/// stored here as one array per field instead and MissionItem objects are only created when something actually needs them.
+class MissionItemStore
+{
+public:
+    MissionItemStore(void) = default;
+
+    int     count   (void) const { return _commands.count(); }
+    bool    isEmpty (void) const { return _commands.isEmpty(); }
+    void    clear   (void);
+    void    reserve (int count);
+
+    void append(MAV_CMD command, MAV_FRAME frame, double param1, double param2, double param3, double param4, double param5, double param6, double param7, bool autoContinue = true);
+    void append(const MissionItem& missionItem);
+
+    MAV_CMD         command     (int index) const { return static_cast<MAV_CMD>(_commands[index]); }
+    MAV_FRAME       frame       (int index) const { return static_cast<MAV_FRAME>(_frames[index]); }
+    bool            autoContinue(int index) const { return _autoContinue[index]; }
+    double          param1      (int index) const { return _params[0][index]; }
+    double          param2      (int index) const { return _params[1][index]; }
+    double          param3      (int index) const { return _params[2][index]; }
+    double          param4      (int index) const { return _params[3][index]; }
+    double          param5      (int index) const { return _params[4][index]; }
+    double          param6      (int index) const { return _params[5][index]; }
+    double          param7      (int index) const { return _params[6][index]; }
+    QGeoCoordinate  coordinate  (int index) const;
+
+    /// Creates a full MissionItem for the specified entry
+    ///     @param sequenceNumber Sequence number for the new item
+    ///     @param parent QObject parent for the new item
+    MissionItem* createMissionItem(int index, int sequenceNumber, QObject* parent) const;
+
+    /// Appends MissionItems for all entries to the list with ascending sequence numbers starting at firstSequenceNumber
+    void appendMissionItems(QList<MissionItem*>& items, int firstSequenceNumber, QObject* missionItemParent) const;
+
+    /// Saves all entries in the same format as MissionItem::save with ascending sequence numbers starting at firstSequenceNumber
+    void save(QJsonArray& missionItemsJsonArray, int firstSequenceNumber) const;
+
+    /// Loads entries from a json array in MissionItem::save format. Existing entries are replaced.
+    bool load(const QJsonArray& missionItemsJsonArray, QString& errorString);
+
+private:
+    QVector<quint16>    _commands;
+    QVector<quint8>     _frames;
+    QVector<bool>       _autoContinue;
+    QVector<double>     _params[7];
+};
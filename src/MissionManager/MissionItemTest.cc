@@ -12,9 +12,12 @@
 #include "LinkManager.h"
 #include "MultiVehicleManager.h"
 #include "MissionItem.h"
+#include "MissionItemStore.h"
 #include "SimpleMissionItem.h"
 #include "QGCApplication.h"
 
+#include <QJsonDocument>
+
 #if 0
 const MissionItemTest::TestCase_t MissionItemTest::_rgTestCases[] = {
     { "0\t0\t3\t16\t10\t20\t30\t40\t-10\t-20\t-30\t1\r\n",  { 0, QGeoCoordinate(-10.0, -20.0, -30.0), MAV_CMD_NAV_WAYPOINT,     10.0, 20.0, 30.0, 40.0, true, false, MAV_FRAME_GLOBAL_RELATIVE_ALT } },
@@ -543,3 +546,39 @@ QJsonObject MissionItemTest::_createV3Json(bool allNaNs)
 
     return jsonObject;
 }
+
+void MissionItemTest::_testStore(void)
+{
+    MissionItemStore    store;
+    QString             errorString;
+
+    // Load from the older formats as well, conversion is handled by MissionItem
+    QJsonArray jsonArray = { _createV1Json(), _createV2Json(), _createV3Json(false /* allNaNs */), _createV3Json(true /* allNaNs */) };
+    QVERIFY(store.load(jsonArray, errorString));
+    QCOMPARE(store.count(), jsonArray.count());
+
+    // Created items must match what MissionItem loads directly
+    for (int i=0; i<store.count(); i++) {
+        MissionItem* missionItem = store.createMissionItem(i, _seq, this);
+        _checkExpectedMissionItem(*missionItem, i == store.count() - 1 /* allNaNs */);
+        delete missionItem;
+    }
+
+    // Saved json must match MissionItem::save
+    QJsonArray savedArray;
+    store.save(savedArray, _seq);
+    QCOMPARE(savedArray.count(), store.count());
+    for (int i=0; i<store.count(); i++) {
+        MissionItem missionItem;
+        QVERIFY(missionItem.load(jsonArray[i].toObject(), _seq + i, errorString));
+        QJsonObject expectedObject;
+        missionItem.save(expectedObject);
+        // Compared as text since NaN params never compare equal
+        QCOMPARE(QJsonDocument(savedArray[i].toObject()).toJson(), QJsonDocument(expectedObject).toJson());
+    }
+
+    // Bad entries fail the whole load
+    jsonArray.append(QJsonObject());
+    QCOMPARE(store.load(jsonArray, errorString), false);
+    QCOMPARE(store.count(), 0);
+}
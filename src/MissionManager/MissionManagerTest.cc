@@ -12,6 +12,7 @@
 #include "LinkManager.h"
 #include "MultiVehicleManager.h"
 
+
 const MissionManagerTest::TestCase_t MissionManagerTest::_rgTestCases[] = {
     { "0\t0\t3\t16\t10\t20\t30\t40\t-10\t-20\t-30\t1\r\n",  { 0, QGeoCoordinate(-10.0, -20.0, -30.0), MAV_CMD_NAV_WAYPOINT,     10.0, 20.0, 30.0, 40.0, true, false, MAV_FRAME_GLOBAL_RELATIVE_ALT } },
     { "1\t0\t3\t17\t10\t20\t30\t40\t-10\t-20\t-30\t1\r\n",  { 1, QGeoCoordinate(-10.0, -20.0, -30.0), MAV_CMD_NAV_LOITER_UNLIM, 10.0, 20.0, 30.0, 40.0, true, false, MAV_FRAME_GLOBAL_RELATIVE_ALT } },
@@ -360,3 +361,89 @@ void MissionManagerTest::_testErrorAckFailureStrings(void)
     }
 
 }
+
+/// Writes a mission with the specified number of waypoints to the vehicle and reads it back
+void MissionManagerTest::_roundTripLargeMission(int itemCount)
+{
+    QList<MissionItem*> missionItems;
+
+    // First item is the home position which is not sent to PX4, so altitude is used to identify items on the way back
+    for (int i=0; i<itemCount; i++) {
+        missionItems.append(new MissionItem(i, MAV_CMD_NAV_WAYPOINT, MAV_FRAME_GLOBAL_RELATIVE_ALT, 0, 0, 0, 0, 47.0 + (i * 0.0001), 8.0, i, true, false, this));
+    }
+
+    _missionManager->writeMissionItems(missionItems);
+    QVERIFY(_multiSpyMissionManager->waitForSignalByIndex(sendCompleteSignalIndex, _missionManagerSignalWaitTime));
+    QCOMPARE(_multiSpyMissionManager->checkNoSignalByMask(errorSignalMask), true);
+    QCOMPARE(_multiSpyMissionManager->pullBoolFromSignalIndex(sendCompleteSignalIndex), false);
+    _multiSpyMissionManager->clearAllSignals();
+
+    _mockLink->missionItemHandler()->resetReadRequestStats();
+    _missionManager->loadFromVehicle();
+    QVERIFY(_multiSpyMissionManager->waitForSignalByIndex(newMissionItemsAvailableSignalIndex, _missionManagerSignalWaitTime));
+    QCOMPARE(_multiSpyMissionManager->checkNoSignalByMask(errorSignalMask), true);
+    _multiSpyMissionManager->clearAllSignals();
+
+    const QList<MissionItem*>& readItems = _missionManager->missionItems();
+    QCOMPARE(readItems.count(), itemCount - 1);
+    for (int i=0; i<readItems.count(); i++) {
+        QCOMPARE(readItems[i]->sequenceNumber(), i);
+        QCOMPARE(readItems[i]->param7(), static_cast<double>(i + 1));
+    }
+}
+
+void MissionManagerTest::_testPipelinedTransfers(void)
+{
+    _initForFirmwareType(MAV_AUTOPILOT_PX4);
+
+    const int                   cItems          = 200;
+    const int                   cItemsRead      = cItems - 1;   // Home position is not sent to PX4
+    const int                   latencyMsecs    = 20;
+    const int                   readWindow      = 8;
+    MockLinkMissionItemHandler* handler         = _mockLink->missionItemHandler();
+
+    _mockLink->setMissionItemLinkSimulation(latencyMsecs, 0 /* lossPct */);
+
+    // Strict request/response: each item is requested only once the previous one has arrived
+    _missionManager->setReadRequestWindowOverride(1);
+    _roundTripLargeMission(cItems);
+    QCOMPARE(handler->readRequestCount(), cItemsRead);
+    QCOMPARE(handler->maxReadRequestsInFlight(), 1);
+    QVERIFY(_missionManager->roundTripTimeMilliseconds() >= latencyMsecs / 2);
+
+    // Pipelined: several requests are outstanding at once but never more than the window
+    _missionManager->setReadRequestWindowOverride(readWindow);
+    _roundTripLargeMission(cItems);
+    QCOMPARE(handler->readRequestCount(), cItemsRead);
+    QVERIFY(handler->maxReadRequestsInFlight() > 1);
+    QVERIFY(handler->maxReadRequestsInFlight() <= readWindow);
+
+    // Items must still all arrive, in order, when messages are dropped in both directions. Lost items are requested again.
+    _mockLink->setMissionItemLinkSimulation(latencyMsecs, 5 /* lossPct */);
+    _roundTripLargeMission(cItems);
+    QVERIFY(handler->readRequestCount() > cItemsRead);
+}
+
+void MissionManagerTest::_testWriteLatencyAndLoss(void)
+{
+    _initForFirmwareType(MAV_AUTOPILOT_PX4);
+
+    const int                   cItems          = 200;
+    const int                   cItemsWritten   = cItems - 1;   // Home position is not sent to PX4
+    const int                   latencyMsecs    = 20;
+    MockLinkMissionItemHandler* handler         = _mockLink->missionItemHandler();
+
+    // Writes are driven by the vehicle: every item is sent in answer to its MISSION_REQUEST_INT and nothing is sent ahead,
+    // since PX4 and ArduPilot drop items they did not ask for
+    _mockLink->setMissionItemLinkSimulation(latencyMsecs, 0 /* lossPct */);
+    handler->resetWriteRequestStats();
+    _roundTripLargeMission(cItems);
+    QCOMPARE(handler->writeRequestCount(), cItemsWritten);
+    QCOMPARE(handler->unrequestedItemCount(), 0);
+
+    // Lost requests and items are recovered by the vehicle asking again, the plan still arrives complete and in order
+    _mockLink->setMissionItemLinkSimulation(latencyMsecs, 10 /* lossPct */);
+    handler->resetWriteRequestStats();
+    _roundTripLargeMission(cItems);
+    QVERIFY(handler->writeRequestCount() > cItemsWritten);
+}
@@ -32,6 +32,8 @@ private slots:
     void _testReadFailureHandlingPX4(void);
     //void _testReadFailureHandlingAPM(void);
     //void _testErrorAckFailureStrings(void);
+    void _testPipelinedTransfers(void);
+    void _testWriteLatencyAndLoss(void);
 
 private:
     void _testWriteFailureHandlingPX4(void);
@@ -43,6 +45,7 @@ private:
     void _writeItems(MockLinkMissionItemHandler::FailureMode_t failureMode, MAV_MISSION_RESULT failureAckResult, bool shouldFail);
     void _testWriteFailureHandlingWorker(void);
     void _testReadFailureHandlingWorker(void);
+    void _roundTripLargeMission(int itemCount);
     
     static const TestCase_t _rgTestCases[];
     static const size_t     _cTestCases;
@@ -15,6 +15,8 @@
 #include "MissionCommandTree.h"
 #include "MissionCommandUIInfo.h"
 
+#include <algorithm>
+
 QGC_LOGGING_CATEGORY(PlanManagerLog, "PlanManagerLog")
 
 PlanManager::PlanManager(Vehicle* vehicle, MAV_MISSION_TYPE planType)
@@ -27,11 +29,15 @@ PlanManager::PlanManager(Vehicle* vehicle, MAV_MISSION_TYPE planType)
     , _resumeMission            (false)
     , _lastMissionRequest       (-1)
     , _missionItemCountToRead   (-1)
+    , _readRequestWindow        (1)
+    , _lastItemSent             (-1)
+    , _lastItemSentTime         (0)
     , _currentMissionIndex      (-1)
     , _lastCurrentIndex         (-1)
 {
     _ackTimeoutTimer = new QTimer(this);
     _ackTimeoutTimer->setSingleShot(true);
+    _transferTimer.start();
 
     connect(_ackTimeoutTimer, &QTimer::timeout, this, &PlanManager::_ackTimeout);
 }
@@ -55,6 +61,8 @@ void PlanManager::_writeMissionItemsWorker(void)
         _itemIndicesToWrite << i;
     }
 
+    _lastItemSent = -1;
+
     _retryCount = 0;
     _setTransactionInProgress(TransactionWrite);
     _connectToMavlink();
@@ -195,8 +203,10 @@ void PlanManager::_ackTimeout(void)
             _finishTransaction(false);
         } else {
             _retryCount++;
+            // The link may be slower than the current round trip estimate, wait longer for the retries
+            _timeoutBackoff = qMin(_timeoutBackoff * 2, 64);
             qCDebug(PlanManagerLog) << tr("Retrying %1 MISSION_REQUEST retry Count").arg(_planTypeString()) << _retryCount;
-            _requestNextMissionItem();
+            _resendMissionItemRequests();
         }
         break;
     case AckMissionRequest:
@@ -247,7 +257,7 @@ void PlanManager::_startAckTimeout(AckType_t ack)
     switch (ack) {
     case AckMissionItem:
         // We are actively trying to get the mission item, so we don't want to wait as long.
-        _ackTimeoutTimer->setInterval(_retryTimeoutMilliseconds);
+        _ackTimeoutTimer->setInterval(_itemTimeoutMilliseconds());
         break;
     case AckNone:
         // FALLTHROUGH
@@ -258,7 +268,7 @@ void PlanManager::_startAckTimeout(AckType_t ack)
     case AckMissionClearAll:
         // FALLTHROUGH
     case AckGuidedItem:
-        _ackTimeoutTimer->setInterval(_ackTimeoutMilliseconds);
+        _ackTimeoutTimer->setInterval(qMax(_ackTimeoutMilliseconds, _itemTimeoutMilliseconds()));
         break;
     }
 
@@ -266,6 +276,37 @@ void PlanManager::_startAckTimeout(AckType_t ack)
     _ackTimeoutTimer->start();
 }
 
+/// Updates the smoothed round trip time and its variance from a new measurement (RFC 6298). Only responses to
+/// requests which were sent once may be measured, since a response to a resent request can't be matched to the
+/// send time.
+void PlanManager::_addRoundTripSample(qint64 sampleMilliseconds)
+{
+    double sample = static_cast<double>(sampleMilliseconds);
+
+    if (_srttMilliseconds < 0) {
+        _srttMilliseconds   = sample;
+        _rttVarMilliseconds = sample / 2.0;
+    } else {
+        _rttVarMilliseconds = (0.75 * _rttVarMilliseconds) + (0.25 * qAbs(_srttMilliseconds - sample));
+        _srttMilliseconds   = (0.875 * _srttMilliseconds) + (0.125 * sample);
+    }
+    _timeoutBackoff = 1;
+}
+
+/// @return Timeout to use when actively waiting on a response to an item request
+int PlanManager::_itemTimeoutMilliseconds(void) const
+{
+    int timeout = _retryTimeoutMilliseconds;
+
+    if (_srttMilliseconds >= 0) {
+        timeout = qMax(timeout, qRound(_srttMilliseconds + (4.0 * _rttVarMilliseconds)));
+    }
+    timeout = qMin(timeout, _maxAdaptiveTimeoutMilliseconds);
+
+    // Back off after timeouts, but don't wait longer than a passive ack timeout unless the link is already measured slower than that
+    return qMax(timeout, qMin(timeout * _timeoutBackoff, _ackTimeoutMilliseconds));
+}
+
 /// Checks the received ack against the expected ack. If they match the ack timeout timer will be stopped.
 /// @return true: received ack matches expected ack
 bool PlanManager::_checkForExpectedAck(AckType_t receivedAck)
@@ -340,10 +381,13 @@ void PlanManager::_handleMissionCount(const mavlink_message_t& message)
             _itemIndicesToRead << i;
         }
         _missionItemCountToRead = missionCount.count;
+        _readRequestWindow = qMax(1, _readRequestWindowOverride >= 0 ? _readRequestWindowOverride : _vehicle->firmwarePlugin()->missionReadRequestWindow());
+        _itemRequestTimes.clear();
         _requestNextMissionItem();
     }
 }
 
+/// Requests the next items to read such that up to _readRequestWindow requests are in flight
 void PlanManager::_requestNextMissionItem(void)
 {
     if (_itemIndicesToRead.count() == 0) {
@@ -351,7 +395,29 @@ void PlanManager::_requestNextMissionItem(void)
         return;
     }
 
-    qCDebug(PlanManagerLog) << QStringLiteral("_requestNextMissionItem %1 sequenceNumber:retry").arg(_planTypeString()) << _itemIndicesToRead[0] << _retryCount;
+    for (int i=0; i<_itemIndicesToRead.count() && _itemRequestTimes.count() < _readRequestWindow; i++) {
+        int sequenceNumber = _itemIndicesToRead[i];
+        if (!_itemRequestTimes.contains(sequenceNumber)) {
+            _itemRequestTimes[sequenceNumber] = _transferTimer.elapsed();
+            _sendMissionRequest(sequenceNumber);
+        }
+    }
+    _startAckTimeout(AckMissionItem);
+}
+
+/// Sends all requests which are in flight again after a timeout
+void PlanManager::_resendMissionItemRequests(void)
+{
+    for (auto iter = _itemRequestTimes.begin(); iter != _itemRequestTimes.end(); iter++) {
+        iter.value() = -1;
+        _sendMissionRequest(iter.key());
+    }
+    _requestNextMissionItem();
+}
+
+void PlanManager::_sendMissionRequest(int sequenceNumber)
+{
+    qCDebug(PlanManagerLog) << QStringLiteral("_sendMissionRequest %1 sequenceNumber:retry").arg(_planTypeString()) << sequenceNumber << _retryCount;
 
     WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
     if (!weakLink.expired()) {
@@ -364,11 +430,10 @@ void PlanManager::_requestNextMissionItem(void)
                                                   &message,
                                                   _vehicle->id(),
                                                   MAV_COMP_ID_AUTOPILOT1,
-                                                  _itemIndicesToRead[0],
+                                                  sequenceNumber,
                                                   _planType);
         _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), message);
     }
-    _startAckTimeout(AckMissionItem);
 }
 
 void PlanManager::_handleMissionItem(const mavlink_message_t& message)
@@ -439,6 +504,13 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message)
     if (_itemIndicesToRead.contains(seq)) {
         _itemIndicesToRead.removeOne(seq);
 
+        // Items which were not requested individually or were requested more than once can't be timed
+        qint64 requestTime = _itemRequestTimes.value(seq, -1);
+        _itemRequestTimes.remove(seq);
+        if (requestTime >= 0) {
+            _addRoundTripSample(_transferTimer.elapsed() - requestTime);
+        }
+
         MissionItem* item = new MissionItem(seq,
                                             command,
                                             frame,
@@ -458,7 +530,11 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message)
             item->setParam1((int)item->param1() + 1);
         }
 
-        _missionItems.append(item);
+        // With multiple requests in flight items can arrive out of order, keep the list in sequence order
+        auto insertPos = std::lower_bound(_missionItems.begin(), _missionItems.end(), seq, [](const MissionItem* missionItem, int sequenceNumber) {
+            return missionItem->sequenceNumber() < sequenceNumber;
+        });
+        _missionItems.insert(insertPos, item);
     } else {
         qCDebug(PlanManagerLog) << QStringLiteral("_handleMissionItem %1 mission item received item index which was not requested, disregrarding:").arg(_planTypeString()) << seq;
         // We have to put the ack timeout back since it was removed above
@@ -466,7 +542,7 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message)
         return;
     }
 
-    emit progressPct((double)seq / (double)_missionItemCountToRead);
+    emit progressPct((double)(_missionItemCountToRead - _itemIndicesToRead.count()) / (double)_missionItemCountToRead);
     
     _retryCount = 0;
     if (_itemIndicesToRead.count() == 0) {
@@ -479,6 +555,7 @@ void PlanManager::_handleMissionItem(const mavlink_message_t& message)
 void PlanManager::_clearMissionItems(void)
 {
     _itemIndicesToRead.clear();
+    _itemRequestTimes.clear();
     _clearAndDeleteMissionItems();
 }
 
@@ -513,15 +590,30 @@ void PlanManager::_handleMissionRequest(const mavlink_message_t& message)
 
     emit progressPct((double)missionRequestSeq / (double)_writeMissionItems.count());
 
+    if (_lastItemSent >= 0 && missionRequestSeq == _lastItemSent + 1) {
+        _addRoundTripSample(_transferTimer.elapsed() - _lastItemSentTime);
+    }
+    _lastItemSent = -1;
+
     _lastMissionRequest = missionRequestSeq;
+
     if (!_itemIndicesToWrite.contains(missionRequestSeq)) {
         qCDebug(PlanManagerLog) << QStringLiteral("_handleMissionRequest %1 sequence number requested which has already been sent, sending again:").arg(_planTypeString()) << missionRequestSeq;
     } else {
         _itemIndicesToWrite.removeOne(missionRequestSeq);
+        // Only items sent once are timed, the request following a resent item can't be matched to a send time
+        _lastItemSent = missionRequestSeq;
+        _lastItemSentTime = _transferTimer.elapsed();
     }
-    
-    MissionItem* item = _writeMissionItems[missionRequestSeq];
-    qCDebug(PlanManagerLog) << QStringLiteral("_handleMissionRequest %1 sequenceNumber:command").arg(_planTypeString()) << missionRequestSeq << item->command();
+
+    _sendMissionItem(missionRequestSeq);
+    _startAckTimeout(AckMissionRequest);
+}
+
+void PlanManager::_sendMissionItem(int sequenceNumber)
+{
+    MissionItem* item = _writeMissionItems[sequenceNumber];
+    qCDebug(PlanManagerLog) << QStringLiteral("_sendMissionItem %1 sequenceNumber:command").arg(_planTypeString()) << sequenceNumber << item->command();
 
     WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
     if (!weakLink.expired()) {
@@ -534,10 +626,10 @@ void PlanManager::_handleMissionRequest(const mavlink_message_t& message)
                                                &messageOut,
                                                _vehicle->id(),
                                                MAV_COMP_ID_AUTOPILOT1,
-                                               missionRequestSeq,
+                                               sequenceNumber,
                                                item->frame(),
                                                item->command(),
-                                               missionRequestSeq == 0,
+                                               sequenceNumber == 0,
                                                item->autoContinue(),
                                                item->param1(),
                                                item->param2(),
@@ -549,7 +641,6 @@ void PlanManager::_handleMissionRequest(const mavlink_message_t& message)
                                                _planType);
         _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), messageOut);
     }
-    _startAckTimeout(AckMissionRequest);
 }
 
 void PlanManager::_handleMissionAck(const mavlink_message_t& message)
@@ -808,6 +899,7 @@ void PlanManager::_finishTransaction(bool success, bool apmGuidedItemWrite)
 
     _itemIndicesToRead.clear();
     _itemIndicesToWrite.clear();
+    _itemRequestTimes.clear();
 
     // First thing we do is clear the transaction. This way inProgesss is off when we signal transaction complete.
     TransactionType_t currentTransactionType = _transactionInProgress;
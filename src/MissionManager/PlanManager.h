@@ -12,6 +12,8 @@
 #include <QObject>
 #include <QLoggingCategory>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QMap>
 
 #include "MissionItem.h"
 #include "QGCMAVLink.h"
@@ -56,6 +58,13 @@ public:
     ///     Signals removeAllComplete when done
     void removeAll(void);
 
+    /// Overrides the firmware plugin read request window, mainly for unit tests. Pass -1 to go back to the firmware plugin value.
+    ///     @param readRequestWindow Maximum number of MISSION_REQUEST_INT in flight during a read
+    void setReadRequestWindowOverride(int readRequestWindow) { _readRequestWindowOverride = readRequestWindow; }
+
+    /// Smoothed round trip time measured during transfers, -1 if no measurement is available yet
+    int roundTripTimeMilliseconds(void) const { return _srttMilliseconds < 0 ? -1 : qRound(_srttMilliseconds); }
+
     /// Error codes returned in error signal
     typedef enum {
         InternalError,
@@ -75,6 +84,8 @@ public:
     // When actively retrying to request mission items, use a shorter timeout instead.
     static const int _retryTimeoutMilliseconds = 250;
     static const int _maxRetryCount = 5;
+    // Upper bound for timeouts which are adjusted from the measured round trip time
+    static const int _maxAdaptiveTimeoutMilliseconds = 5000;
 
 signals:
     void newMissionItemsAvailable   (bool removeAllRequested);
@@ -117,6 +128,11 @@ protected:
     void _handleMissionRequest(const mavlink_message_t& message);
     void _handleMissionAck(const mavlink_message_t& message);
     void _requestNextMissionItem(void);
+    void _resendMissionItemRequests(void);
+    void _sendMissionRequest(int sequenceNumber);
+    void _sendMissionItem(int sequenceNumber);
+    void _addRoundTripSample(qint64 sampleMilliseconds);
+    int  _itemTimeoutMilliseconds(void) const;
     void _clearMissionItems(void);
     void _sendError(ErrorCode_t errorCode, const QString& errorMsg);
     QString _ackTypeToString(AckType_t ackType);
@@ -145,9 +161,18 @@ protected:
     TransactionType_t   _transactionInProgress;
     bool                _resumeMission;
     QList<int>          _itemIndicesToWrite;    ///< List of mission items which still need to be written to vehicle
-    QList<int>          _itemIndicesToRead;     ///< List of mission items which still need to be requested from vehicle
+    QList<int>          _itemIndicesToRead;     ///< List of mission items which still need to be received from vehicle
     int                 _lastMissionRequest;    ///< Index of item last requested by MISSION_REQUEST
     int                 _missionItemCountToRead;///< Count of all mission items to read
+    int                 _readRequestWindow;     ///< Maximum number of MISSION_REQUEST_INT in flight during a read
+    int                 _readRequestWindowOverride = -1;
+    QMap<int, qint64>   _itemRequestTimes;      ///< Read requests in flight: sequence number -> _transferTimer time sent, -1 if resent
+    int                 _lastItemSent;          ///< Sequence number of last item sent in response to a request, -1 if resent
+    qint64              _lastItemSentTime;      ///< _transferTimer time when _lastItemSent was sent
+    QElapsedTimer       _transferTimer;
+    double              _srttMilliseconds =     -1;
+    double              _rttVarMilliseconds =   0;
+    int                 _timeoutBackoff =       1;  ///< Multiplier applied to the item timeout after consecutive timeouts
 
     QList<MissionItem*> _missionItems;          ///< Set of mission items on vehicle
     QList<MissionItem*> _writeMissionItems;     ///< Set of mission items currently being written to vehicle
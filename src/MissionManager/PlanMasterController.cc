@@ -20,6 +20,10 @@
 #include "StructureScanPlanCreator.h"
 #include "CorridorScanPlanCreator.h"
 #include "BlankPlanCreator.h"
+#include "OfflineMapsSettings.h"
+#include "FlightMapSettings.h"
+#include "ComplexMissionItem.h"
+#include "RallyPoint.h"
 
 #include <QDomDocument>
 #include <QJsonDocument>
@@ -73,6 +77,9 @@ void PlanMasterController::_commonInit(void)
     connect(&_geoFenceController,   &GeoFenceController::syncInProgressChanged,     this, &PlanMasterController::syncInProgressChanged);
     connect(&_rallyPointController, &RallyPointController::syncInProgressChanged,   this, &PlanMasterController::syncInProgressChanged);
 
+    // Rally points load last, once they are in the controller the whole plan from the vehicle is known
+    connect(&_rallyPointController, &RallyPointController::loadComplete,            this, &PlanMasterController::_autoPrefetchTiles);
+
     // Offline vehicle can change firmware/vehicle type
     connect(_controllerVehicle,     &Vehicle::vehicleTypeChanged,                   this, &PlanMasterController::_updatePlanCreatorsList);
 }
@@ -257,6 +264,7 @@ void PlanMasterController::_loadGeoFenceComplete(void)
             qCDebug(PlanMasterControllerLog) << "PlanMasterController::_loadMissionComplete Rally Points not supported skipping";
             _rallyPointController.removeAll();
             _loadRallyPointsComplete();
+            _autoPrefetchTiles();
         }
         setDirty(false);
     }
@@ -269,6 +277,7 @@ void PlanMasterController::_loadRallyPointsComplete(void)
 
 void PlanMasterController::_sendMissionComplete(void)
 {
+    _autoPrefetchTiles();
     if (_sendGeoFence) {
         _sendGeoFence = false;
         _sendRallyPoints = true;
@@ -403,6 +412,7 @@ void PlanMasterController::loadFromFile(const QString& filename)
     }
 
     if(success){
+        _autoPrefetchTiles();
         _currentPlanFile = QString::asprintf("%s/%s.%s", fileInfo.path().toLocal8Bit().data(), fileInfo.completeBaseName().toLocal8Bit().data(), AppSettings::planFileExtension);
     } else {
         _currentPlanFile.clear();
@@ -540,6 +550,59 @@ bool PlanMasterController::dirty(void) const
     return _missionController.dirty() || _geoFenceController.dirty() || _rallyPointController.dirty();
 }
 
+void PlanMasterController::prefetchTiles(void)
+{
+    SettingsManager*        settingsManager = qgcApp()->toolbox()->settingsManager();
+    OfflineMapsSettings*    offlineMaps     = settingsManager->offlineMapsSettings();
+    FlightMapSettings*      flightMap       = settingsManager->flightMapSettings();
+
+    QList<QGeoCoordinate>   path;
+    QmlObjectListModel*     visualItems = _missionController.visualItems();
+    for (int i=0; i<visualItems->count(); i++) {
+        VisualMissionItem* item = visualItems->value<VisualMissionItem*>(i);
+        if (!item->specifiesCoordinate()) {
+            continue;
+        }
+        ComplexMissionItem* complexItem = qobject_cast<ComplexMissionItem*>(item);
+        if (complexItem) {
+            // The flight path inside a complex item is covered by its area
+            QGCGeoBoundingCube* boundingCube = complexItem->boundingCube();
+            if (boundingCube->isValid()) {
+                _tilePrefetcher.addArea(QGeoRectangle(boundingCube->pointNW, boundingCube->pointSE), complexItem->coordinate().altitude());
+            }
+            path.append(complexItem->coordinate());
+            QGeoCoordinate exitCoordinate = complexItem->exitCoordinate();
+            exitCoordinate.setAltitude(complexItem->coordinate().altitude());
+            path.append(exitCoordinate);
+        } else if (item->isStandaloneCoordinate()) {
+            _tilePrefetcher.addPath({ item->coordinate() });
+        } else {
+            path.append(item->coordinate());
+        }
+    }
+    _tilePrefetcher.addPath(path);
+
+    QmlObjectListModel* rallyPoints = _rallyPointController.points();
+    for (int i=0; i<rallyPoints->count(); i++) {
+        _tilePrefetcher.addPath({ rallyPoints->value<RallyPoint*>(i)->coordinate() });
+    }
+
+    _tilePrefetcher.setBuffer(offlineMaps->missionPrefetchBuffer()->rawValue().toDouble());
+    _tilePrefetcher.setZoomRange(offlineMaps->minZoomLevelDownload()->rawValue().toInt(), offlineMaps->maxZoomLevelDownload()->rawValue().toInt());
+    _tilePrefetcher.setMaxTiles(offlineMaps->maxTilesForDownload()->rawValue().toUInt());
+    _tilePrefetcher.start(flightMap->mapProvider()->rawValue().toString() + QStringLiteral(" ") + flightMap->mapType()->rawValue().toString());
+}
+
+void PlanMasterController::_autoPrefetchTiles(void)
+{
+    // The Fly View controllers follow the vehicle plan on every connect, prefetching is left to the Plan View
+    if (_flyView || qgcApp()->runningUnitTests() || !qgcApp()->toolbox()->settingsManager()->offlineMapsSettings()->missionPrefetch()->rawValue().toBool()) {
+        return;
+    }
+    qCDebug(PlanMasterControllerLog) << "PlanMasterController::_autoPrefetchTiles";
+    prefetchTiles();
+}
+
 void PlanMasterController::setDirty(bool dirty)
 {
     _missionController.setDirty(dirty);
@@ -291,8 +291,8 @@ void SimpleMissionItem::save(QJsonArray&  missionItems)
             }
         }
         missionItems.append(saveObject);
-        item->deleteLater();
     }
+    qDeleteAll(items);
 }
 
 bool SimpleMissionItem::load(QTextStream &loadStream)
@@ -20,6 +20,10 @@
 
 #include <QPolygonF>
 
+#include <functional>
+#include <numeric>
+#include <set>
+
 QGC_LOGGING_CATEGORY(SurveyComplexItemLog, "SurveyComplexItemLog")
 
 const QString SurveyComplexItem::name(SurveyComplexItem::tr("Survey"));
@@ -96,10 +100,10 @@ SurveyComplexItem::SurveyComplexItem(PlanMasterController* masterController, boo
     connect(&_splitConcavePolygonsFact, &Fact::valueChanged,                        this, &SurveyComplexItem::_setDirty);
     connect(this,                       &SurveyComplexItem::refly90DegreesChanged,  this, &SurveyComplexItem::_setDirty);
 
-    connect(&_gridAngleFact,            &Fact::valueChanged,                        this, &SurveyComplexItem::_rebuildTransects);
-    connect(&_flyAlternateTransectsFact,&Fact::valueChanged,                        this, &SurveyComplexItem::_rebuildTransects);
-    connect(&_splitConcavePolygonsFact, &Fact::valueChanged,                        this, &SurveyComplexItem::_rebuildTransects);
-    connect(this,                       &SurveyComplexItem::refly90DegreesChanged,  this, &SurveyComplexItem::_rebuildTransects);
+    connect(&_gridAngleFact,            &Fact::valueChanged,                        this, &SurveyComplexItem::_scheduleRebuildTransects);
+    connect(&_flyAlternateTransectsFact,&Fact::valueChanged,                        this, &SurveyComplexItem::_scheduleRebuildTransects);
+    connect(&_splitConcavePolygonsFact, &Fact::valueChanged,                        this, &SurveyComplexItem::_scheduleRebuildTransects);
+    connect(this,                       &SurveyComplexItem::refly90DegreesChanged,  this, &SurveyComplexItem::_scheduleRebuildTransects);
 
     connect(&_surveyAreaPolygon,        &QGCMapPolygon::isValidChanged,             this, &SurveyComplexItem::_updateWizardMode);
     connect(&_surveyAreaPolygon,        &QGCMapPolygon::traceModeChanged,           this, &SurveyComplexItem::_updateWizardMode);
@@ -469,7 +473,7 @@ bool SurveyComplexItem::_gridAngleIsNorthSouthTransects()
     return gridAngle < 45.0 || (gridAngle > 360.0 - 45.0) || (gridAngle > 90.0 + 45.0 && gridAngle < 270.0 - 45.0);
 }
 
-void SurveyComplexItem::_adjustTransectsToEntryPointLocation(QList<QList<QGeoCoordinate>>& transects)
+void SurveyComplexItem::_adjustTransectsToEntryPointLocation(int entryPoint, QList<QList<QGeoCoordinate>>& transects)
 {
     if (transects.count() == 0) {
         return;
@@ -478,10 +482,10 @@ void SurveyComplexItem::_adjustTransectsToEntryPointLocation(QList<QList<QGeoCoo
     bool reversePoints = false;
     bool reverseTransects = false;
 
-    if (_entryPoint == EntryLocationBottomLeft || _entryPoint == EntryLocationBottomRight) {
+    if (entryPoint == EntryLocationBottomLeft || entryPoint == EntryLocationBottomRight) {
         reversePoints = true;
     }
-    if (_entryPoint == EntryLocationTopRight || _entryPoint == EntryLocationBottomRight) {
+    if (entryPoint == EntryLocationTopRight || entryPoint == EntryLocationBottomRight) {
         reverseTransects = true;
     }
 
@@ -494,7 +498,7 @@ void SurveyComplexItem::_adjustTransectsToEntryPointLocation(QList<QList<QGeoCoo
         _reverseTransectOrder(transects);
     }
 
-    qCDebug(SurveyComplexItemLog) << "_adjustTransectsToEntryPointLocation Modified entry point:entryLocation" << transects.first().first() << _entryPoint;
+    qCDebug(SurveyComplexItemLog) << "_adjustTransectsToEntryPointLocation Modified entry point:entryLocation" << transects.first().first() << entryPoint;
 }
 
 QPointF SurveyComplexItem::_rotatePoint(const QPointF& point, const QPointF& origin, double angle)
@@ -569,48 +573,91 @@ void SurveyComplexItem::_intersectLinesWithRect(const QList<QLineF>& lineList, c
     }
 }
 
+/// Intersects the transect lines with the polygon. The lines are all parallel, so sweeping across them in order of their
+/// offset means each line is only tested against the polygon edges which span it, rather than against every edge.
 void SurveyComplexItem::_intersectLinesWithPolygon(const QList<QLineF>& lineList, const QPolygonF& polygon, QList<QLineF>& resultLines)
 {
     resultLines.clear();
 
-    for (int i=0; i<lineList.count(); i++) {
-        const QLineF& line = lineList[i];
-        QList<QPointF> intersections;
+    if (lineList.isEmpty() || polygon.count() < 2 || lineList.first().length() == 0) {
+        return;
+    }
 
-        // Intersect the line with all the polygon edges
-        for (int j=0; j<polygon.count()-1; j++) {
+    const QLineF    unitLine    = lineList.first().unitVector();
+    const QPointF   direction   (unitLine.dx(), unitLine.dy());
+    const QPointF   normal      (-direction.y(), direction.x());
+    const double    tolerance   = 1e-6;
+
+    // Edge table sorted by the lowest offset each edge reaches
+    typedef struct {
+        int     index;
+        double  minOffset;
+        double  maxOffset;
+    } EdgeSpan_t;
+    QVector<EdgeSpan_t> edges;
+    edges.reserve(polygon.count() - 1);
+    for (int j=0; j<polygon.count()-1; j++) {
+        double offset1 = QPointF::dotProduct(polygon[j], normal);
+        double offset2 = QPointF::dotProduct(polygon[j+1], normal);
+        edges.append({ j, qMin(offset1, offset2), qMax(offset1, offset2) });
+    }
+    std::sort(edges.begin(), edges.end(), [](const EdgeSpan_t& a, const EdgeSpan_t& b) { return a.minOffset < b.minOffset; });
+
+    QVector<int> lineOrder(lineList.count());
+    std::iota(lineOrder.begin(), lineOrder.end(), 0);
+    std::sort(lineOrder.begin(), lineOrder.end(), [&lineList, &normal](int a, int b) {
+        return QPointF::dotProduct(lineList[a].p1(), normal) < QPointF::dotProduct(lineList[b].p1(), normal);
+    });
+
+    QVector<QLineF>     clippedLines(lineList.count());
+    QVector<bool>       clipped(lineList.count(), false);
+    QVector<EdgeSpan_t> activeEdges;
+    int                 nextEdge = 0;
+    for (int lineIndex: lineOrder) {
+        const QLineF&   line        = lineList[lineIndex];
+        const double    lineOffset  = QPointF::dotProduct(line.p1(), normal);
+
+        while (nextEdge < edges.count() && edges[nextEdge].minOffset <= lineOffset + tolerance) {
+            activeEdges.append(edges[nextEdge++]);
+        }
+        activeEdges.erase(std::remove_if(activeEdges.begin(), activeEdges.end(), [lineOffset, tolerance](const EdgeSpan_t& edge) {
+            return edge.maxOffset < lineOffset - tolerance;
+        }), activeEdges.end());
+
+        // All intersections lie along the line, so the two which are furthest apart are the extremes along its direction.
+        // The transect starts from whichever of them comes first in the polygon edge order.
+        int     minEdge = -1;
+        int     maxEdge = -1;
+        double  minAlong = 0;
+        double  maxAlong = 0;
+        QPointF minPoint;
+        QPointF maxPoint;
+        for (const EdgeSpan_t& edge: activeEdges) {
             QPointF intersectPoint;
-            QLineF polygonLine = QLineF(polygon[j], polygon[j+1]);
-
-            auto intersect = line.intersects(polygonLine, &intersectPoint);
-            if (intersect == QLineF::BoundedIntersection) {
-                if (!intersections.contains(intersectPoint)) {
-                    intersections.append(intersectPoint);
-                }
+            if (line.intersects(QLineF(polygon[edge.index], polygon[edge.index + 1]), &intersectPoint) != QLineF::BoundedIntersection) {
+                continue;
             }
-        }
-
-        // We now have one or more intersection points all along the same line. Find the two
-        // which are furthest away from each other to form the transect.
-        if (intersections.count() > 1) {
-            QPointF firstPoint;
-            QPointF secondPoint;
-            double currentMaxDistance = 0;
-
-            for (int i=0; i<intersections.count(); i++) {
-                for (int j=0; j<intersections.count(); j++) {
-                    QLineF lineTest(intersections[i], intersections[j]);
-                    \
-                    double newMaxDistance = lineTest.length();
-                    if (newMaxDistance > currentMaxDistance) {
-                        firstPoint = intersections[i];
-                        secondPoint = intersections[j];
-                        currentMaxDistance = newMaxDistance;
-                    }
-                }
+            double along = QPointF::dotProduct(intersectPoint, direction);
+            if (minEdge == -1 || along < minAlong || (along == minAlong && edge.index < minEdge)) {
+                minEdge = edge.index;
+                minAlong = along;
+                minPoint = intersectPoint;
             }
+            if (maxEdge == -1 || along > maxAlong || (along == maxAlong && edge.index < maxEdge)) {
+                maxEdge = edge.index;
+                maxAlong = along;
+                maxPoint = intersectPoint;
+            }
+        }
+        if (minEdge != -1 && minPoint != maxPoint) {
+            clippedLines[lineIndex] = minEdge < maxEdge ? QLineF(minPoint, maxPoint) : QLineF(maxPoint, minPoint);
+            clipped[lineIndex] = true;
+        }
+    }
 
-            resultLines += QLineF(firstPoint, secondPoint);
+    for (int i=0; i<lineList.count(); i++) {
+        if (clipped[i]) {
+            resultLines += clippedLines[i];
         }
     }
 }
@@ -670,48 +717,57 @@ double SurveyComplexItem::_turnaroundDistance(void) const
     return _turnAroundDistanceFact.rawValue().toDouble();
 }
 
-void SurveyComplexItem::_rebuildTransectsPhase1(void)
+SurveyComplexItem::TransectsBuilder_t SurveyComplexItem::_transectsBuilder(void)
 {
-    bool split = splitConcavePolygons()->rawValue().toBool();
-	if (split) {
-		_rebuildTransectsPhase1WorkerSplitPolygons(false /* refly */);
-	} else {
-		_rebuildTransectsPhase1WorkerSinglePolygon(false /* refly */);
-	}
-    if (_refly90DegreesFact.rawValue().toBool()) {
-    	if (split) {
-    		_rebuildTransectsPhase1WorkerSplitPolygons(true /* refly */);
-    	} else {
-    		_rebuildTransectsPhase1WorkerSinglePolygon(true /* refly */);
-    	}
-    }
+    TransectParams_t params;
+    params.polygon                  = _surveyAreaPolygon.coordinateList();
+    params.gridAngle                = _gridAngleFact.rawValue().toDouble();
+    params.gridSpacing              = _cameraCalc.adjustedFootprintSide()->rawValue().toDouble();
+    params.entryPoint               = _entryPoint;
+    params.flyAlternateTransects    = _flyAlternateTransectsFact.rawValue().toBool();
+    params.splitConcavePolygons     = _splitConcavePolygonsFact.rawValue().toBool();
+    params.refly90Degrees           = _refly90DegreesFact.rawValue().toBool();
+    params.hoverAndCapture          = triggerCamera() && hoverAndCaptureEnabled();
+    params.triggerDistance          = triggerDistance();
+    params.turnAroundDistance       = _turnAroundDistanceFact.rawValue().toDouble();
+
+    return [params](const std::atomic_bool& cancel) { return _buildTransects(params, cancel); };
 }
 
-void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
+SurveyComplexItem::Transects_t SurveyComplexItem::_buildTransects(const TransectParams_t& params, const std::atomic_bool& cancel)
 {
-    if (_ignoreRecalc) {
-        return;
-    }
+    Transects_t transects;
 
-    // If the transects are getting rebuilt then any previously loaded mission items are now invalid
-    if (_loadedMissionItemsParent) {
-        _loadedMissionItems.clear();
-        _loadedMissionItemsParent->deleteLater();
-        _loadedMissionItemsParent = nullptr;
+    if (params.splitConcavePolygons) {
+        _rebuildTransectsPhase1WorkerSplitPolygons(params, false /* refly */, cancel, transects);
+    } else {
+        _rebuildTransectsPhase1WorkerSinglePolygon(params, false /* refly */, cancel, transects);
+    }
+    if (params.refly90Degrees && !cancel) {
+        if (params.splitConcavePolygons) {
+            _rebuildTransectsPhase1WorkerSplitPolygons(params, true /* refly */, cancel, transects);
+        } else {
+            _rebuildTransectsPhase1WorkerSinglePolygon(params, true /* refly */, cancel, transects);
+        }
     }
 
-    if (_surveyAreaPolygon.count() < 3) {
+    return transects;
+}
+
+void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(const TransectParams_t& params, bool refly, const std::atomic_bool& cancel, Transects_t& rgTransects)
+{
+    if (params.polygon.count() < 3) {
         return;
     }
 
     // Convert polygon to NED
 
     QList<QPointF> polygonPoints;
-    QGeoCoordinate tangentOrigin = _surveyAreaPolygon.pathModel().value<QGCQGeoCoordinate*>(0)->coordinate();
-    qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 Convert polygon to NED - _surveyAreaPolygon.count():tangentOrigin" << _surveyAreaPolygon.count() << tangentOrigin;
-    for (int i=0; i<_surveyAreaPolygon.count(); i++) {
+    QGeoCoordinate tangentOrigin = params.polygon[0];
+    qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 Convert polygon to NED - polygon.count():tangentOrigin" << params.polygon.count() << tangentOrigin;
+    for (int i=0; i<params.polygon.count(); i++) {
         double y, x, down;
-        QGeoCoordinate vertex = _surveyAreaPolygon.pathModel().value<QGCQGeoCoordinate*>(i)->coordinate();
+        QGeoCoordinate vertex = params.polygon[i];
         if (i == 0) {
             // This avoids a nan calculation that comes out of convertGeoToNed
             x = y = 0;
@@ -724,8 +780,8 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
 
     // Generate transects
 
-    double gridAngle = _gridAngleFact.rawValue().toDouble();
-    double gridSpacing = _cameraCalc.adjustedFootprintSide()->rawValue().toDouble();
+    double gridAngle = params.gridAngle;
+    double gridSpacing = params.gridSpacing;
     if (gridSpacing < 0.5) {
         // We can't let gridSpacing get too small otherwise we will end up with too many transects.
         // So we limit to 0.5 meter spacing as min and set to huge value which will cause a single
@@ -785,7 +841,6 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
     //      Create a single transect which goes through the center of the polygon
     //      Intersect it with the polygon
     if (intersectLines.count() < 2) {
-        _surveyAreaPolygon.center();
         QLineF firstLine = lineList.first();
         QPointF lineCenter = firstLine.pointAt(0.5);
         QPointF centerOffset = boundingCenter - lineCenter;
@@ -804,6 +859,9 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
     // Convert from NED to Geo
     QList<QList<QGeoCoordinate>> transects;
     for (const QLineF& line : resultLines) {
+        if (cancel) {
+            return;
+        }
         QGeoCoordinate          coord;
         QList<QGeoCoordinate>   transect;
 
@@ -815,13 +873,13 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
         transects.append(transect);
     }
 
-    _adjustTransectsToEntryPointLocation(transects);
+    _adjustTransectsToEntryPointLocation(params.entryPoint, transects);
 
     if (refly) {
-        _optimizeTransectsForShortestDistance(_transects.last().last().coord, transects);
+        _optimizeTransectsForShortestDistance(rgTransects.last().last().coord, transects);
     }
 
-    if (_flyAlternateTransectsFact.rawValue().toBool()) {
+    if (params.flyAlternateTransects) {
         QList<QList<QGeoCoordinate>> alternatingTransects;
         for (int i=0; i<transects.count(); i++) {
             if (!(i & 1)) {
@@ -854,8 +912,11 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
         transects[i] = transectVertices;
     }
 
-    // Convert to CoordInfo transects and append to _transects
+    // Convert to CoordInfo transects and append to transects
     for (const QList<QGeoCoordinate>& transect : transects) {
+        if (cancel) {
+            return;
+        }
         QGeoCoordinate                                  coord;
         QList<TransectStyleComplexItem::CoordInfo_t>    coordInfoTransect;
         TransectStyleComplexItem::CoordInfo_t           coordInfo;
@@ -866,14 +927,14 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
         coordInfoTransect.append(coordInfo);
 
         // For hover and capture we need points for each camera location within the transect
-        if (triggerCamera() && hoverAndCaptureEnabled()) {
+        if (params.hoverAndCapture) {
             double transectLength = transect[0].distanceTo(transect[1]);
             double transectAzimuth = transect[0].azimuthTo(transect[1]);
-            if (triggerDistance() < transectLength) {
-                int cInnerHoverPoints = static_cast<int>(floor(transectLength / triggerDistance()));
+            if (params.triggerDistance < transectLength) {
+                int cInnerHoverPoints = static_cast<int>(floor(transectLength / params.triggerDistance));
                 qCDebug(SurveyComplexItemLog) << "cInnerHoverPoints" << cInnerHoverPoints;
                 for (int i=0; i<cInnerHoverPoints; i++) {
-                    QGeoCoordinate hoverCoord = transect[0].atDistanceAndAzimuth(triggerDistance() * (i + 1), transectAzimuth);
+                    QGeoCoordinate hoverCoord = transect[0].atDistanceAndAzimuth(params.triggerDistance * (i + 1), transectAzimuth);
                     TransectStyleComplexItem::CoordInfo_t coordInfo = { hoverCoord, CoordTypeInteriorHoverTrigger };
                     coordInfoTransect.insert(1 + i, coordInfo);
                 }
@@ -881,9 +942,9 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
         }
 
         // Extend the transect ends for turnaround
-        if (_hasTurnaround()) {
+        if (params.turnAroundDistance > 0) {
             QGeoCoordinate turnaroundCoord;
-            double turnAroundDistance = _turnAroundDistanceFact.rawValue().toDouble();
+            double turnAroundDistance = params.turnAroundDistance;
 
             double azimuth = transect[0].azimuthTo(transect[1]);
             turnaroundCoord = transect[0].atDistanceAndAzimuth(-turnAroundDistance, azimuth);
@@ -898,36 +959,25 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
             coordInfoTransect.append(coordInfo);
         }
 
-        _transects.append(coordInfoTransect);
+        rgTransects.append(coordInfoTransect);
     }
 }
 
 
-void SurveyComplexItem::_rebuildTransectsPhase1WorkerSplitPolygons(bool refly)
+void SurveyComplexItem::_rebuildTransectsPhase1WorkerSplitPolygons(const TransectParams_t& params, bool refly, const std::atomic_bool& cancel, Transects_t& rgTransects)
 {
-    if (_ignoreRecalc) {
-        return;
-    }
-
-    // If the transects are getting rebuilt then any previously loaded mission items are now invalid
-    if (_loadedMissionItemsParent) {
-        _loadedMissionItems.clear();
-        _loadedMissionItemsParent->deleteLater();
-        _loadedMissionItemsParent = nullptr;
-    }
-
-    if (_surveyAreaPolygon.count() < 3) {
+    if (params.polygon.count() < 3) {
         return;
     }
 
     // Convert polygon to NED
 
     QList<QPointF> polygonPoints;
-    QGeoCoordinate tangentOrigin = _surveyAreaPolygon.pathModel().value<QGCQGeoCoordinate*>(0)->coordinate();
-    qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 Convert polygon to NED - _surveyAreaPolygon.count():tangentOrigin" << _surveyAreaPolygon.count() << tangentOrigin;
-    for (int i=0; i<_surveyAreaPolygon.count(); i++) {
+    QGeoCoordinate tangentOrigin = params.polygon[0];
+    qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 Convert polygon to NED - polygon.count():tangentOrigin" << params.polygon.count() << tangentOrigin;
+    for (int i=0; i<params.polygon.count(); i++) {
         double y, x, down;
-        QGeoCoordinate vertex = _surveyAreaPolygon.pathModel().value<QGCQGeoCoordinate*>(i)->coordinate();
+        QGeoCoordinate vertex = params.polygon[i];
         if (i == 0) {
             // This avoids a nan calculation that comes out of convertGeoToNed
             x = y = 0;
@@ -951,6 +1001,9 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSplitPolygons(bool refly)
 
     // iterate over polygons
     for (auto p = polygons.begin(); p != polygons.end(); ++p) {
+        if (cancel) {
+            return;
+        }
         QPointF* vMatch = nullptr;
         // find matching vertex in previous polygon
         if (p != polygons.begin()) {
@@ -974,11 +1027,410 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSplitPolygons(bool refly)
         // TODO figure out tangent origin
         // TODO improve selection of entry points
 //        qCDebug(SurveyComplexItemLog) << "Transects from polynom p " << p;
-        _rebuildTransectsFromPolygon(refly, *p, tangentOrigin, vMatch);
+        _rebuildTransectsFromPolygon(params, refly, *p, tangentOrigin, vMatch, cancel, rgTransects);
     }
 }
 
 void SurveyComplexItem::_PolygonDecomposeConvex(const QPolygonF& polygon, QList<QPolygonF>& decomposedPolygons)
+{
+    // Keil's algorithm gives the fewest pieces, but its cost grows exponentially with the vertex count
+    if (polygon.size() <= _keilMaxVertices) {
+        _PolygonDecomposeConvexKeil(polygon, decomposedPolygons);
+    } else {
+        _PolygonDecomposeConvexHertelMehlhorn(polygon, decomposedPolygons);
+    }
+}
+
+/// Hertel-Mehlhorn decomposition: triangulate through a monotone partition in O(n log n), then remove every diagonal whose end
+/// points stay convex without it. Gives at most four times the minimum number of pieces.
+void SurveyComplexItem::_PolygonDecomposeConvexHertelMehlhorn(const QPolygonF& polygon, QList<QPolygonF>& decomposedPolygons)
+{
+    // Work with a counter clockwise copy without repeated or collinear vertices, they make the sweeps degenerate and
+    // never change the convexity of the pieces
+    auto collinear = [](const QPointF& p1, const QPointF& p2, const QPointF& p3) {
+        QPointF a = p2 - p1;
+        QPointF b = p3 - p2;
+        return qAbs(_ccw(QPointF(0, 0), a, b)) <= 1e-9 * sqrt(QPointF::dotProduct(a, a) * QPointF::dotProduct(b, b));
+    };
+    QPolygonF ccwPolygon;
+    for (const QPointF& vertex: polygon) {
+        if (!ccwPolygon.isEmpty() && ccwPolygon.last() == vertex) {
+            continue;
+        }
+        ccwPolygon << vertex;
+        while (ccwPolygon.count() > 2 && collinear(ccwPolygon[ccwPolygon.count() - 3], ccwPolygon[ccwPolygon.count() - 2], ccwPolygon.last())) {
+            ccwPolygon.remove(ccwPolygon.count() - 2);
+        }
+    }
+    bool removed = true;
+    while (removed && ccwPolygon.count() > 2) {
+        removed = false;
+        if (ccwPolygon.first() == ccwPolygon.last() || collinear(ccwPolygon[ccwPolygon.count() - 2], ccwPolygon.last(), ccwPolygon.first())) {
+            ccwPolygon.removeLast();
+            removed = true;
+        } else if (collinear(ccwPolygon.last(), ccwPolygon.first(), ccwPolygon[1])) {
+            ccwPolygon.removeFirst();
+            removed = true;
+        }
+    }
+    const int n = ccwPolygon.count();
+    if (n < 4) {
+        decomposedPolygons << polygon;
+        return;
+    }
+    double polygonArea = 0;
+    for (int i=0; i<n; i++) {
+        polygonArea += _ccw(QPointF(0, 0), ccwPolygon[i], ccwPolygon[(i + 1) % n]) / 2.0;
+    }
+    const bool reversed = polygonArea < 0;
+    if (reversed) {
+        std::reverse(ccwPolygon.begin(), ccwPolygon.end());
+        polygonArea = -polygonArea;
+    }
+
+    // The sweeps order vertices by y. A slight rotation keeps axis aligned edges from producing ties.
+    const double sweepRotation = 0.0123;
+    QPolygonF sweepPolygon;
+    for (const QPointF& vertex: ccwPolygon) {
+        sweepPolygon << QPointF(vertex.x() * cos(sweepRotation) - vertex.y() * sin(sweepRotation), vertex.x() * sin(sweepRotation) + vertex.y() * cos(sweepRotation));
+    }
+
+    // Planar graph of polygon edges plus diagonals
+    QVector<QList<int>> neighbors(n);
+    for (int i=0; i<n; i++) {
+        neighbors[i] << (i + 1) % n << (i + n - 1) % n;
+    }
+    QList<QPair<int, int>> diagonals;
+    auto addDiagonals = [&neighbors, &diagonals](const QList<QPair<int, int>>& newDiagonals) {
+        for (const QPair<int, int>& diagonal: newDiagonals) {
+            if (diagonal.first != diagonal.second && !neighbors[diagonal.first].contains(diagonal.second)) {
+                neighbors[diagonal.first] << diagonal.second;
+                neighbors[diagonal.second] << diagonal.first;
+                diagonals << diagonal;
+            }
+        }
+    };
+
+    QList<QPair<int, int>> newDiagonals;
+    if (!_PolygonMonotoneDiagonals(sweepPolygon, newDiagonals)) {
+        qCWarning(SurveyComplexItemLog) << "_PolygonDecomposeConvexHertelMehlhorn monotone partition failed";
+        decomposedPolygons << polygon;
+        return;
+    }
+    addDiagonals(newDiagonals);
+    newDiagonals.clear();
+    _PolygonSortNeighbors(ccwPolygon, neighbors);
+    for (const QList<int>& monotonePiece: _PolygonFaces(ccwPolygon, neighbors)) {
+        _PolygonTriangulateMonotone(sweepPolygon, monotonePiece, newDiagonals);
+    }
+    addDiagonals(newDiagonals);
+    _PolygonSortNeighbors(ccwPolygon, neighbors);
+
+    // A diagonal can go if the angle it splits at each end is no more than 180 degrees
+    auto convexWithout = [&neighbors, &ccwPolygon](int vertex, int other) {
+        const QList<int>& around = neighbors[vertex];
+        int index = around.indexOf(other);
+        int before = around[(index + around.count() - 1) % around.count()];
+        int after = around[(index + 1) % around.count()];
+        const QPointF& v = ccwPolygon[vertex];
+        QPointF a = ccwPolygon[before] - v;
+        QPointF b = ccwPolygon[after] - v;
+        return _ccw(QPointF(0, 0), a, b) >= -1e-9 * qMax(1.0, sqrt(QPointF::dotProduct(a, a) * QPointF::dotProduct(b, b)));
+    };
+    for (const QPair<int, int>& diagonal: diagonals) {
+        if (convexWithout(diagonal.first, diagonal.second) && convexWithout(diagonal.second, diagonal.first)) {
+            neighbors[diagonal.first].removeOne(diagonal.second);
+            neighbors[diagonal.second].removeOne(diagonal.first);
+        }
+    }
+
+    // Check the pieces before using them, degenerate input (such as a self intersecting polygon) can defeat the sweeps
+    QList<QList<int>> pieces = _PolygonFaces(ccwPolygon, neighbors);
+    double piecesArea = 0;
+    bool valid = true;
+    for (const QList<int>& piece: pieces) {
+        for (int i=0; i<piece.count(); i++) {
+            const QPointF& p1 = ccwPolygon[piece[i]];
+            const QPointF& p2 = ccwPolygon[piece[(i + 1) % piece.count()]];
+            const QPointF& p3 = ccwPolygon[piece[(i + 2) % piece.count()]];
+            piecesArea += _ccw(QPointF(0, 0), p1, p2) / 2.0;
+            if (_ccw(p1, p2, p3) < -1e-6 * qMax(1.0, polygonArea)) {
+                valid = false;
+            }
+        }
+    }
+    if (!valid || qAbs(piecesArea - polygonArea) > 1e-6 * qMax(1.0, polygonArea)) {
+        qCWarning(SurveyComplexItemLog) << "_PolygonDecomposeConvexHertelMehlhorn invalid decomposition, polygon not split";
+        decomposedPolygons << polygon;
+        return;
+    }
+
+    // Output the pieces depth first across shared diagonals, so consecutive pieces tend to share a vertex
+    QVector<QPair<quint64, int>> pieceEdges;
+    for (int i=0; i<pieces.count(); i++) {
+        const QList<int>& piece = pieces[i];
+        for (int j=0; j<piece.count(); j++) {
+            quint64 a = static_cast<quint64>(piece[j]);
+            quint64 b = static_cast<quint64>(piece[(j + 1) % piece.count()]);
+            pieceEdges.append(qMakePair(a < b ? (a << 32) | b : (b << 32) | a, i));
+        }
+    }
+    std::sort(pieceEdges.begin(), pieceEdges.end());
+    QVector<QList<int>> adjacentPieces(pieces.count());
+    for (int i=1; i<pieceEdges.count(); i++) {
+        if (pieceEdges[i].first == pieceEdges[i - 1].first) {
+            adjacentPieces[pieceEdges[i].second] << pieceEdges[i - 1].second;
+            adjacentPieces[pieceEdges[i - 1].second] << pieceEdges[i].second;
+        }
+    }
+    QVector<bool> output(pieces.count(), false);
+    QList<int> stack { 0 };
+    while (!stack.isEmpty()) {
+        int pieceIndex = stack.takeLast();
+        if (output[pieceIndex]) {
+            continue;
+        }
+        output[pieceIndex] = true;
+        QPolygonF piecePolygon;
+        for (int vertex: pieces[pieceIndex]) {
+            piecePolygon << ccwPolygon[vertex];
+        }
+        if (reversed) {
+            std::reverse(piecePolygon.begin(), piecePolygon.end());
+        }
+        decomposedPolygons << piecePolygon;
+        for (int i=adjacentPieces[pieceIndex].count()-1; i>=0; i--) {
+            stack << adjacentPieces[pieceIndex][i];
+        }
+    }
+}
+
+/// Sorts the neighbors of each vertex counter clockwise around it
+void SurveyComplexItem::_PolygonSortNeighbors(const QPolygonF& polygon, QVector<QList<int>>& neighbors)
+{
+    for (int vertex=0; vertex<polygon.count(); vertex++) {
+        const QPointF& v = polygon[vertex];
+        std::sort(neighbors[vertex].begin(), neighbors[vertex].end(), [&polygon, &v](int a, int b) {
+            return atan2(polygon[a].y() - v.y(), polygon[a].x() - v.x()) < atan2(polygon[b].y() - v.y(), polygon[b].x() - v.x());
+        });
+    }
+}
+
+/// Returns the faces of the planar graph inside the polygon as counter clockwise vertex lists. Neighbors must be sorted.
+QList<QList<int>> SurveyComplexItem::_PolygonFaces(const QPolygonF& polygon, const QVector<QList<int>>& neighbors)
+{
+    const int n = polygon.count();
+    QVector<QVector<bool>> visited(n);
+    for (int vertex=0; vertex<n; vertex++) {
+        visited[vertex].fill(false, neighbors[vertex].count());
+    }
+
+    QList<QList<int>> faces;
+    for (int start=0; start<n; start++) {
+        for (int startIndex=0; startIndex<neighbors[start].count(); startIndex++) {
+            // Reversed polygon edges bound the outside of the polygon
+            if (visited[start][startIndex] || neighbors[start][startIndex] == (start + n - 1) % n) {
+                continue;
+            }
+            // Walk the face on the left of each edge: turn to the next neighbor clockwise at each vertex
+            QList<int> face;
+            int vertex = start;
+            int index = startIndex;
+            while (!visited[vertex][index]) {
+                visited[vertex][index] = true;
+                face << vertex;
+                int next = neighbors[vertex][index];
+                const QList<int>& around = neighbors[next];
+                index = (around.indexOf(vertex) + around.count() - 1) % around.count();
+                vertex = next;
+            }
+            faces << face;
+        }
+    }
+
+    return faces;
+}
+
+/// Returns the diagonals which split a counter clockwise polygon into y-monotone pieces. Plane sweep from de Berg et al,
+/// Computational Geometry chapter 3. Returns false if the polygon is too degenerate for the sweep.
+bool SurveyComplexItem::_PolygonMonotoneDiagonals(const QPolygonF& polygon, QList<QPair<int, int>>& diagonals)
+{
+    enum VertexType {
+        StartVertex,
+        EndVertex,
+        SplitVertex,
+        MergeVertex,
+        RegularVertex
+    };
+
+    const int n = polygon.count();
+    auto above = [&polygon](int a, int b) {
+        return polygon[a].y() > polygon[b].y() || (polygon[a].y() == polygon[b].y() && polygon[a].x() < polygon[b].x());
+    };
+
+    QVector<VertexType> vertexTypes(n);
+    for (int vertex=0; vertex<n; vertex++) {
+        int prev = (vertex + n - 1) % n;
+        int next = (vertex + 1) % n;
+        bool convex = _ccw(polygon[prev], polygon[vertex], polygon[next]) > 0;
+        if (above(vertex, prev) && above(vertex, next)) {
+            vertexTypes[vertex] = convex ? StartVertex : SplitVertex;
+        } else if (above(prev, vertex) && above(next, vertex)) {
+            vertexTypes[vertex] = convex ? EndVertex : MergeVertex;
+        } else {
+            vertexTypes[vertex] = RegularVertex;
+        }
+    }
+
+    QVector<int> sweepOrder(n);
+    std::iota(sweepOrder.begin(), sweepOrder.end(), 0);
+    std::sort(sweepOrder.begin(), sweepOrder.end(), above);
+
+    // Sweep status holds the edges (edge i runs from vertex i to i + 1) with the polygon interior to their right, ordered by
+    // where they cross the sweep line. Edge -1 is a probe at the current vertex, used to find the edge directly to its left.
+    double sweepY = 0;
+    double probeX = 0;
+    auto sweepX = [&polygon, &sweepY, &probeX, n](int edge) {
+        if (edge < 0) {
+            return probeX;
+        }
+        const QPointF& upper = polygon[edge];
+        const QPointF& lower = polygon[(edge + 1) % n];
+        if (upper.y() == lower.y()) {
+            return upper.x();
+        }
+        return upper.x() + (sweepY - upper.y()) * (lower.x() - upper.x()) / (lower.y() - upper.y());
+    };
+    typedef std::set<int, std::function<bool(int, int)>> SweepStatus_t;
+    SweepStatus_t status([&sweepX](int a, int b) {
+        double xA = sweepX(a);
+        double xB = sweepX(b);
+        return xA != xB ? xA < xB : a < b;
+    });
+    QVector<SweepStatus_t::iterator>    statusEntries(n);
+    QVector<bool>                       inStatus(n, false);
+    QVector<int>                        helper(n, -1);
+
+    auto insertEdge = [&](int edge, int helperVertex) {
+        statusEntries[edge] = status.insert(edge).first;
+        inStatus[edge] = true;
+        helper[edge] = helperVertex;
+    };
+    auto removeEdge = [&](int edge, int vertex) {
+        if (!inStatus[edge]) {
+            return false;
+        }
+        if (vertexTypes[helper[edge]] == MergeVertex) {
+            diagonals.append(qMakePair(vertex, helper[edge]));
+        }
+        status.erase(statusEntries[edge]);
+        inStatus[edge] = false;
+        return true;
+    };
+    auto updateLeftEdge = [&](int vertex, bool alwaysConnect) {
+        probeX = polygon[vertex].x();
+        auto entry = status.lower_bound(-1);
+        if (entry == status.begin()) {
+            return false;
+        }
+        int edge = *--entry;
+        if (alwaysConnect || vertexTypes[helper[edge]] == MergeVertex) {
+            diagonals.append(qMakePair(vertex, helper[edge]));
+        }
+        helper[edge] = vertex;
+        return true;
+    };
+
+    for (int vertex: sweepOrder) {
+        sweepY = polygon[vertex].y();
+        int prevEdge = (vertex + n - 1) % n;
+        bool ok = true;
+        switch (vertexTypes[vertex]) {
+        case StartVertex:
+            insertEdge(vertex, vertex);
+            break;
+        case EndVertex:
+            ok = removeEdge(prevEdge, vertex);
+            break;
+        case SplitVertex:
+            ok = updateLeftEdge(vertex, true);
+            insertEdge(vertex, vertex);
+            break;
+        case MergeVertex:
+            ok = removeEdge(prevEdge, vertex) && updateLeftEdge(vertex, false);
+            break;
+        case RegularVertex:
+            if (above(prevEdge, vertex)) {
+                // Interior is to the right of this vertex
+                ok = removeEdge(prevEdge, vertex);
+                insertEdge(vertex, vertex);
+            } else {
+                ok = updateLeftEdge(vertex, false);
+            }
+            break;
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/// Adds the diagonals which triangulate a y-monotone piece of the polygon, given as counter clockwise vertex indices
+void SurveyComplexItem::_PolygonTriangulateMonotone(const QPolygonF& polygon, const QList<int>& piece, QList<QPair<int, int>>& diagonals)
+{
+    const int count = piece.count();
+    if (count < 4) {
+        return;
+    }
+
+    auto above = [&polygon, &piece](int a, int b) {
+        const QPointF& pointA = polygon[piece[a]];
+        const QPointF& pointB = polygon[piece[b]];
+        return pointA.y() > pointB.y() || (pointA.y() == pointB.y() && pointA.x() < pointB.x());
+    };
+    auto point = [&polygon, &piece](int index) { return polygon[piece[index]]; };
+
+    QVector<int> sweepOrder(count);
+    std::iota(sweepOrder.begin(), sweepOrder.end(), 0);
+    std::sort(sweepOrder.begin(), sweepOrder.end(), above);
+
+    // Counter clockwise from the top vertex runs down the left chain
+    QVector<bool> leftChain(count, false);
+    for (int i=sweepOrder.first(); i!=sweepOrder.last(); i=(i + 1) % count) {
+        leftChain[i] = true;
+    }
+
+    QVector<int> stack { sweepOrder[0], sweepOrder[1] };
+    for (int j=2; j<count-1; j++) {
+        int current = sweepOrder[j];
+        if (leftChain[current] != leftChain[stack.last()]) {
+            while (stack.count() > 1) {
+                diagonals.append(qMakePair(piece[current], piece[stack.takeLast()]));
+            }
+            stack.clear();
+            stack << sweepOrder[j - 1] << current;
+        } else {
+            int last = stack.takeLast();
+            while (!stack.isEmpty()) {
+                int candidate = stack.last();
+                bool inside = leftChain[current] ? _ccw(point(candidate), point(last), point(current)) > 0 : _ccw(point(current), point(last), point(candidate)) > 0;
+                if (!inside) {
+                    break;
+                }
+                diagonals.append(qMakePair(piece[current], piece[candidate]));
+                last = stack.takeLast();
+            }
+            stack << last << current;
+        }
+    }
+    for (int i=1; i<stack.count()-1; i++) {
+        diagonals.append(qMakePair(piece[sweepOrder.last()], piece[stack[i]]));
+    }
+}
+
+void SurveyComplexItem::_PolygonDecomposeConvexKeil(const QPolygonF& polygon, QList<QPolygonF>& decomposedPolygons)
 {
 	// this follows "Mark Keil's Algorithm" https://mpen.ca/406/keil
     int decompSize = std::numeric_limits<int>::max();
@@ -1042,10 +1494,10 @@ void SurveyComplexItem::_PolygonDecomposeConvex(const QPolygonF& polygon, QList<
 
             // recursion
             QList<QPolygonF> polyLeftDecomposed{};
-            _PolygonDecomposeConvex(polyLeft, polyLeftDecomposed);
+            _PolygonDecomposeConvexKeil(polyLeft, polyLeftDecomposed);
 
             QList<QPolygonF> polyRightDecomposed{};
-            _PolygonDecomposeConvex(polyRight, polyRightDecomposed);
+            _PolygonDecomposeConvexKeil(polyRight, polyRightDecomposed);
 
             // compositon
             auto subSize = polyLeftDecomposed.size() + polyRightDecomposed.size();
@@ -1126,12 +1578,12 @@ bool SurveyComplexItem::_VertexIsReflex(const QPolygonF& polygon, const QPointF*
 }
 
 
-void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF& polygon, const QGeoCoordinate& tangentOrigin, const QPointF* const transitionPoint)
+void SurveyComplexItem::_rebuildTransectsFromPolygon(const TransectParams_t& params, bool refly, const QPolygonF& polygon, const QGeoCoordinate& tangentOrigin, const QPointF* const transitionPoint, const std::atomic_bool& cancel, Transects_t& rgTransects)
 {
     // Generate transects
 
-    double gridAngle = _gridAngleFact.rawValue().toDouble();
-    double gridSpacing = _cameraCalc.adjustedFootprintSide()->rawValue().toDouble();
+    double gridAngle = params.gridAngle;
+    double gridSpacing = params.gridSpacing;
 
     gridAngle = _clampGridAngle90(gridAngle);
     gridAngle += refly ? 90 : 0;
@@ -1179,7 +1631,6 @@ void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF
     //      Create a single transect which goes through the center of the polygon
     //      Intersect it with the polygon
     if (intersectLines.count() < 2) {
-        _surveyAreaPolygon.center();
         QLineF firstLine = lineList.first();
         QPointF lineCenter = firstLine.pointAt(0.5);
         QPointF centerOffset = boundingCenter - lineCenter;
@@ -1208,6 +1659,9 @@ void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF
     }
 
     for (const QLineF& line: resultLines) {
+        if (cancel) {
+            return;
+        }
         QList<QGeoCoordinate>   transect;
         QGeoCoordinate          coord;
 
@@ -1219,13 +1673,13 @@ void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF
         transects.append(transect);
     }
 
-    _adjustTransectsToEntryPointLocation(transects);
+    _adjustTransectsToEntryPointLocation(params.entryPoint, transects);
 
     if (refly) {
-        _optimizeTransectsForShortestDistance(_transects.last().last().coord, transects);
+        _optimizeTransectsForShortestDistance(rgTransects.last().last().coord, transects);
     }
 
-    if (_flyAlternateTransectsFact.rawValue().toBool()) {
+    if (params.flyAlternateTransects) {
         QList<QList<QGeoCoordinate>> alternatingTransects;
         for (int i=0; i<transects.count(); i++) {
             if (!(i & 1)) {
@@ -1258,8 +1712,11 @@ void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF
         transects[i] = transectVertices;
     }
 
-    // Convert to CoordInfo transects and append to _transects
+    // Convert to CoordInfo transects and append to transects
     for (const QList<QGeoCoordinate>& transect: transects) {
+        if (cancel) {
+            return;
+        }
         QGeoCoordinate                                  coord;
         QList<TransectStyleComplexItem::CoordInfo_t>    coordInfoTransect;
         TransectStyleComplexItem::CoordInfo_t           coordInfo;
@@ -1270,14 +1727,14 @@ void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF
         coordInfoTransect.append(coordInfo);
 
         // For hover and capture we need points for each camera location within the transect
-        if (triggerCamera() && hoverAndCaptureEnabled()) {
+        if (params.hoverAndCapture) {
             double transectLength = transect[0].distanceTo(transect[1]);
             double transectAzimuth = transect[0].azimuthTo(transect[1]);
-            if (triggerDistance() < transectLength) {
-                int cInnerHoverPoints = static_cast<int>(floor(transectLength / triggerDistance()));
+            if (params.triggerDistance < transectLength) {
+                int cInnerHoverPoints = static_cast<int>(floor(transectLength / params.triggerDistance));
                 qCDebug(SurveyComplexItemLog) << "cInnerHoverPoints" << cInnerHoverPoints;
                 for (int i=0; i<cInnerHoverPoints; i++) {
-                    QGeoCoordinate hoverCoord = transect[0].atDistanceAndAzimuth(triggerDistance() * (i + 1), transectAzimuth);
+                    QGeoCoordinate hoverCoord = transect[0].atDistanceAndAzimuth(params.triggerDistance * (i + 1), transectAzimuth);
                     TransectStyleComplexItem::CoordInfo_t coordInfo = { hoverCoord, CoordTypeInteriorHoverTrigger };
                     coordInfoTransect.insert(1 + i, coordInfo);
                 }
@@ -1285,9 +1742,9 @@ void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF
         }
 
         // Extend the transect ends for turnaround
-        if (_hasTurnaround()) {
+        if (params.turnAroundDistance > 0) {
             QGeoCoordinate turnaroundCoord;
-            double turnAroundDistance = _turnAroundDistanceFact.rawValue().toDouble();
+            double turnAroundDistance = params.turnAroundDistance;
 
             double azimuth = transect[0].azimuthTo(transect[1]);
             turnaroundCoord = transect[0].atDistanceAndAzimuth(-turnAroundDistance, azimuth);
@@ -1302,9 +1759,9 @@ void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF
             coordInfoTransect.append(coordInfo);
         }
 
-        _transects.append(coordInfoTransect);
+        rgTransects.append(coordInfoTransect);
     }
-    qCDebug(SurveyComplexItemLog) << "_transects.size() " << _transects.size();
+    qCDebug(SurveyComplexItemLog) << "transects.size() " << rgTransects.size();
 }
 
 void SurveyComplexItem::_recalcCameraShots(void)
@@ -1319,26 +1776,26 @@ void SurveyComplexItem::_recalcCameraShots(void)
         } else {
             _cameraShots = 0;
 
-            if (_loadedMissionItemsParent) {
+            if (_loadedMissionItems.count()) {
                 // We have to do it the hard way based on the mission items themselves
                 if (hoverAndCaptureEnabled()) {
                     // Count the number of camera triggers in the mission items
-                    for (const MissionItem* missionItem: _loadedMissionItems) {
-                        _cameraShots += missionItem->command() == MAV_CMD_IMAGE_START_CAPTURE ? 1 : 0;
+                    for (int i=0; i<_loadedMissionItems.count(); i++) {
+                        _cameraShots += _loadedMissionItems.command(i) == MAV_CMD_IMAGE_START_CAPTURE ? 1 : 0;
                     }
                 } else {
                     bool waitingForTriggerStop = false;
                     QGeoCoordinate distanceStartCoord;
                     QGeoCoordinate distanceEndCoord;
-                    for (const MissionItem* missionItem: _loadedMissionItems) {
-                        if (missionItem->command() == MAV_CMD_NAV_WAYPOINT) {
+                    for (int i=0; i<_loadedMissionItems.count(); i++) {
+                        if (_loadedMissionItems.command(i) == MAV_CMD_NAV_WAYPOINT) {
                             if (waitingForTriggerStop) {
-                                distanceEndCoord = QGeoCoordinate(missionItem->param5(), missionItem->param6());
+                                distanceEndCoord = QGeoCoordinate(_loadedMissionItems.param5(i), _loadedMissionItems.param6(i));
                             } else {
-                                distanceStartCoord = QGeoCoordinate(missionItem->param5(), missionItem->param6());
+                                distanceStartCoord = QGeoCoordinate(_loadedMissionItems.param5(i), _loadedMissionItems.param6(i));
                             }
-                        } else if (missionItem->command() == MAV_CMD_DO_SET_CAM_TRIGG_DIST) {
-                            if (missionItem->param1() > 0) {
+                        } else if (_loadedMissionItems.command(i) == MAV_CMD_DO_SET_CAM_TRIGG_DIST) {
+                            if (_loadedMissionItems.param1(i) > 0) {
                                 // Trigger start
                                 waitingForTriggerStop = true;
                             } else {
@@ -1385,7 +1842,7 @@ void SurveyComplexItem::rotateEntryPoint(void)
         _entryPoint++;
     }
 
-    _rebuildTransects();
+    _scheduleRebuildTransects();
 
     setDirty(true);
 }
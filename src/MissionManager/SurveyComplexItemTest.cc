@@ -11,6 +11,10 @@
 #include "QGCApplication.h"
 #include "JsonHelper.h"
 
+#include <QElapsedTimer>
+#include <QPolygonF>
+#include <QtMath>
+
 SurveyComplexItemTest::SurveyComplexItemTest(void)
 {
     _rgSurveySignals[surveyVisualTransectPointsChangedIndex] =    SIGNAL(visualTransectPointsChanged());
@@ -354,3 +358,76 @@ void SurveyComplexItemTest::_testHoverCaptureItemGeneration(void)
     _testItemGenerationWorker(false /* imagesInTurnaround */, true /* hasTurnaround */, true /* useConditionGate */, expectedCommands);
     _testItemGenerationWorker(false /* imagesInTurnaround */, true /* hasTurnaround */, false /* useConditionGate */, expectedCommands);
 }
+
+void SurveyComplexItemTest::_testDecomposeWorker(const QString& name, const QPolygonF& polygon)
+{
+    auto signedArea = [](const QPolygonF& polygon) {
+        double area = 0;
+        for (int i=0; i<polygon.count(); i++) {
+            area += SurveyComplexItem::_ccw(QPointF(0, 0), polygon[i], polygon[(i + 1) % polygon.count()]) / 2.0;
+        }
+        return area;
+    };
+
+    QElapsedTimer timer;
+    timer.start();
+    QList<QPolygonF> decomposedPolygons;
+    SurveyComplexItem::_PolygonDecomposeConvex(polygon, decomposedPolygons);
+    qDebug() << name << "vertices" << polygon.count() << "pieces" << decomposedPolygons.count() << "msecs" << timer.elapsed();
+
+    // Every piece must be convex, with the same winding as the polygon, and the pieces must cover the polygon exactly
+    const double polygonArea = signedArea(polygon);
+    double piecesArea = 0;
+    QVERIFY(decomposedPolygons.count() > 1);
+    for (const QPolygonF& piece: decomposedPolygons) {
+        piecesArea += signedArea(piece);
+        for (int i=0; i<piece.count(); i++) {
+            double turn = SurveyComplexItem::_ccw(piece[i], piece[(i + 1) % piece.count()], piece[(i + 2) % piece.count()]);
+            QVERIFY(turn * polygonArea >= -1e-6 * qAbs(polygonArea));
+        }
+    }
+    QVERIFY(qAbs(piecesArea - polygonArea) < 1e-6 * qAbs(polygonArea));
+}
+
+void SurveyComplexItemTest::_testDecomposeLargePolygons(void)
+{
+    // Field boundaries traced from imagery have hundreds to thousands of vertices, far beyond what Keil's algorithm can split
+
+    // Comb: strip fields separated by hedges, all joined along one edge
+    const int       teethCount  = 200;
+    const double    toothWidth  = 10;
+    QPolygonF comb;
+    comb << QPointF(0, 0) << QPointF(teethCount * 2 * toothWidth, 0);
+    for (int i=teethCount-1; i>=0; i--) {
+        double x = i * 2 * toothWidth;
+        comb << QPointF(x + toothWidth, 50) << QPointF(x + toothWidth, 150) << QPointF(x, 150) << QPointF(x, 50);
+    }
+    _testDecomposeWorker("Comb", comb);
+
+    // Noisy circle: hand digitized boundary, clockwise like most traced polygons
+    const int vertexCount = 2000;
+    QPolygonF noisyCircle;
+    for (int i=0; i<vertexCount; i++) {
+        double angle = -2.0 * M_PI * i / vertexCount;
+        double radius = 1000.0 * (1.0 + 0.1 * qSin(i * 7.3) * qCos(i * 1.7));
+        noisyCircle << QPointF(radius * qCos(angle), radius * qSin(angle));
+    }
+    _testDecomposeWorker("Noisy circle", noisyCircle);
+}
+
+void SurveyComplexItemTest::_testLargePolygonTransects(void)
+{
+    const int vertexCount = 1000;
+    QList<QGeoCoordinate> vertices;
+    for (int i=0; i<vertexCount; i++) {
+        double radius = 400.0 * (1.0 + 0.1 * qSin(i * 7.3) * qCos(i * 1.7));
+        vertices.append(_polyVertices[0].atDistanceAndAzimuth(radius, 360.0 * i / vertexCount));
+    }
+
+    _surveyItem->splitConcavePolygons()->setRawValue(true);
+    _mapPolygon->clear();
+    _mapPolygon->appendVertices(vertices);
+
+    QVERIFY(_surveyItem->_transectCount() > 0);
+    qDebug() << "Transects" << _surveyItem->_transectCount() << "build msecs" << _surveyItem->transectBuildMsecs() << "apply msecs" << _surveyItem->transectApplyMsecs();
+}
@@ -22,6 +22,8 @@
 #include "MissionCommandUIInfo.h"
 
 #include <QPolygonF>
+#include <QElapsedTimer>
+#include <QtConcurrent>
 
 QGC_LOGGING_CATEGORY(TransectStyleComplexItemLog, "TransectStyleComplexItemLog")
 
@@ -59,22 +61,29 @@ TransectStyleComplexItem::TransectStyleComplexItem(PlanMasterController* masterC
     _terrainPolyPathQueryTimer.setSingleShot(true);
     connect(&_terrainPolyPathQueryTimer, &QTimer::timeout, this, &TransectStyleComplexItem::_reallyQueryTransectsPathHeightInfo);
 
+    // Transects are generated on a worker thread so editing large surveys doesn't stall the ui. Unit tests expect changes to be reflected immediately.
+    _asyncTransectRebuild = !qgcApp()->runningUnitTests();
+    _rebuildTransectsTimer.setInterval(_rebuildTransectsDelayMsecs);
+    _rebuildTransectsTimer.setSingleShot(true);
+    connect(&_rebuildTransectsTimer,    &QTimer::timeout,                               this, &TransectStyleComplexItem::_startTransectsBuild);
+    connect(&_transectsBuildWatcher,    &QFutureWatcher<TransectsBuild_t>::finished,    this, &TransectStyleComplexItem::_transectsBuildFinished);
+
     // The follow is used to compress multiple recalc calls in a row to into a single call.
     connect(this, &TransectStyleComplexItem::_updateFlightPathSegmentsSignal, this, &TransectStyleComplexItem::_updateFlightPathSegmentsDontCallDirectly,   Qt::QueuedConnection);
     qgcApp()->addCompressedSignal(QMetaMethod::fromSignal(&TransectStyleComplexItem::_updateFlightPathSegmentsSignal));
 
-    connect(&_turnAroundDistanceFact,                   &Fact::valueChanged,                this, &TransectStyleComplexItem::_rebuildTransects);
-    connect(&_hoverAndCaptureFact,                      &Fact::valueChanged,                this, &TransectStyleComplexItem::_rebuildTransects);
-    connect(&_refly90DegreesFact,                       &Fact::valueChanged,                this, &TransectStyleComplexItem::_rebuildTransects);
-    connect(&_terrainAdjustMaxClimbRateFact,            &Fact::valueChanged,                this, &TransectStyleComplexItem::_rebuildTransects);
-    connect(&_terrainAdjustMaxDescentRateFact,          &Fact::valueChanged,                this, &TransectStyleComplexItem::_rebuildTransects);
-    connect(&_terrainAdjustToleranceFact,               &Fact::valueChanged,                this, &TransectStyleComplexItem::_rebuildTransects);
-    connect(&_surveyAreaPolygon,                        &QGCMapPolygon::pathChanged,        this, &TransectStyleComplexItem::_rebuildTransects);
-    connect(&_cameraTriggerInTurnAroundFact,            &Fact::valueChanged,                this, &TransectStyleComplexItem::_rebuildTransects);
-    connect(_cameraCalc.adjustedFootprintSide(),        &Fact::valueChanged,                this, &TransectStyleComplexItem::_rebuildTransects);
-    connect(_cameraCalc.adjustedFootprintFrontal(),     &Fact::valueChanged,                this, &TransectStyleComplexItem::_rebuildTransects);
-    connect(_cameraCalc.distanceToSurface(),            &Fact::rawValueChanged,             this, &TransectStyleComplexItem::_rebuildTransects);
-    connect(&_cameraCalc,                               &CameraCalc::distanceModeChanged,   this, &TransectStyleComplexItem::_rebuildTransects);
+    connect(&_turnAroundDistanceFact,                   &Fact::valueChanged,                this, &TransectStyleComplexItem::_scheduleRebuildTransects);
+    connect(&_hoverAndCaptureFact,                      &Fact::valueChanged,                this, &TransectStyleComplexItem::_scheduleRebuildTransects);
+    connect(&_refly90DegreesFact,                       &Fact::valueChanged,                this, &TransectStyleComplexItem::_scheduleRebuildTransects);
+    connect(&_terrainAdjustMaxClimbRateFact,            &Fact::valueChanged,                this, &TransectStyleComplexItem::_scheduleRebuildTransects);
+    connect(&_terrainAdjustMaxDescentRateFact,          &Fact::valueChanged,                this, &TransectStyleComplexItem::_scheduleRebuildTransects);
+    connect(&_terrainAdjustToleranceFact,               &Fact::valueChanged,                this, &TransectStyleComplexItem::_scheduleRebuildTransects);
+    connect(&_surveyAreaPolygon,                        &QGCMapPolygon::pathChanged,        this, &TransectStyleComplexItem::_scheduleRebuildTransects);
+    connect(&_cameraTriggerInTurnAroundFact,            &Fact::valueChanged,                this, &TransectStyleComplexItem::_scheduleRebuildTransects);
+    connect(_cameraCalc.adjustedFootprintSide(),        &Fact::valueChanged,                this, &TransectStyleComplexItem::_scheduleRebuildTransects);
+    connect(_cameraCalc.adjustedFootprintFrontal(),     &Fact::valueChanged,                this, &TransectStyleComplexItem::_scheduleRebuildTransects);
+    connect(_cameraCalc.distanceToSurface(),            &Fact::rawValueChanged,             this, &TransectStyleComplexItem::_scheduleRebuildTransects);
+    connect(&_cameraCalc,                               &CameraCalc::distanceModeChanged,   this, &TransectStyleComplexItem::_scheduleRebuildTransects);
 
     connect(&_turnAroundDistanceFact,                   &Fact::valueChanged,            this, &TransectStyleComplexItem::complexDistanceChanged);
     connect(&_hoverAndCaptureFact,                      &Fact::valueChanged,            this, &TransectStyleComplexItem::complexDistanceChanged);
@@ -146,6 +155,8 @@ void TransectStyleComplexItem::setDirty(bool dirty)
 
 void TransectStyleComplexItem::_save(QJsonObject& complexObject)
 {
+    _flushScheduledRebuild();
+
     QJsonObject innerObject;
 
     innerObject[JsonHelper::jsonVersionKey] =       2;
@@ -174,15 +185,7 @@ void TransectStyleComplexItem::_save(QJsonObject& complexObject)
 
     // Save the interal mission items
     QJsonArray  missionItemsJsonArray;
-    QObject* missionItemParent = new QObject();
-    QList<MissionItem*> missionItems;
-    appendMissionItems(missionItems, missionItemParent);
-    for (const MissionItem* missionItem: missionItems) {
-        QJsonObject missionItemJsonObject;
-        missionItem->save(missionItemJsonObject);
-        missionItemsJsonArray.append(missionItemJsonObject);
-    }
-    missionItemParent->deleteLater();
+    _currentMissionItems().save(missionItemsJsonArray, _sequenceNumber);
     innerObject[_jsonItemsKey] = missionItemsJsonArray;
 
     complexObject[_jsonTransectStyleComplexItemKey] = innerObject;
@@ -259,16 +262,8 @@ bool TransectStyleComplexItem::_load(const QJsonObject& complexObject, bool forP
         _isIncomplete = false;
 
         // Load generated mission items
-        _loadedMissionItemsParent = new QObject(this);
-        QJsonArray missionItemsJsonArray = innerObject[_jsonItemsKey].toArray();
-        for (const QJsonValue missionItemJson: missionItemsJsonArray) {
-            MissionItem* missionItem = new MissionItem(_loadedMissionItemsParent);
-            if (!missionItem->load(missionItemJson.toObject(), 0 /* sequenceNumber */, errorString)) {
-                _loadedMissionItemsParent->deleteLater();
-                _loadedMissionItemsParent = nullptr;
-                return false;
-            }
-            _loadedMissionItems.append(missionItem);
+        if (!_loadedMissionItems.load(innerObject[_jsonItemsKey].toArray(), errorString)) {
+            return false;
         }
     }
 
@@ -312,11 +307,11 @@ bool TransectStyleComplexItem::_load(const QJsonObject& complexObject, bool forP
             _minAMSLAltitude = qQNaN();
             _maxAMSLAltitude = qQNaN();
             MissionCommandTree* commandTree = qgcApp()->toolbox()->missionCommandTree();
-            for (const MissionItem* missionItem: _loadedMissionItems) {
-                const MissionCommandUIInfo* uiInfo = commandTree->getUIInfo(_controllerVehicle, QGCMAVLink::VehicleClassGeneric, missionItem->command());
+            for (int i=0; i<_loadedMissionItems.count(); i++) {
+                const MissionCommandUIInfo* uiInfo = commandTree->getUIInfo(_controllerVehicle, QGCMAVLink::VehicleClassGeneric, _loadedMissionItems.command(i));
                 if (uiInfo && uiInfo->specifiesCoordinate() && !uiInfo->isStandaloneCoordinate()) {
-                    _minAMSLAltitude = std::fmin(_minAMSLAltitude, missionItem->param7());
-                    _maxAMSLAltitude = std::fmax(_maxAMSLAltitude, missionItem->param7());
+                    _minAMSLAltitude = std::fmin(_minAMSLAltitude, _loadedMissionItems.param7(i));
+                    _maxAMSLAltitude = std::fmax(_maxAMSLAltitude, _loadedMissionItems.param7(i));
                 }
             }
         }
@@ -407,18 +402,137 @@ void TransectStyleComplexItem::_rebuildTransects(void)
         return;
     }
 
-    _transects.clear();
+    // Anything scheduled or running in the background was built from older inputs
+    _rebuildTransectsTimer.stop();
+    _transectsBuildPending = false;
+    _transectsBuildGeneration++;
+    _cancelTransectsBuild();
+
+    QElapsedTimer buildTimer;
+    buildTimer.start();
+    std::atomic_bool neverCancel(false);
+    Transects_t transects = _transectsBuilder()(neverCancel);
+    _publishTransects(transects, static_cast<int>(buildTimer.elapsed()));
+    _setTransectsBuilding(_transectsBuildWatcher.isRunning());
+}
+
+void TransectStyleComplexItem::_scheduleRebuildTransects(void)
+{
+    if (_ignoreRecalc) {
+        return;
+    }
+    if (!_asyncTransectRebuild) {
+        _rebuildTransects();
+        return;
+    }
+
+    // Restarting the timer coalesces a burst of changes into a single build
+    _rebuildTransectsTimer.start();
+    _setTransectsBuilding(true);
+}
+
+void TransectStyleComplexItem::_startTransectsBuild(void)
+{
+    if (_ignoreRecalc) {
+        _setTransectsBuilding(_transectsBuildWatcher.isRunning());
+        return;
+    }
+    if (_transectsBuildWatcher.isRunning()) {
+        // The running build is already stale. Stop it and start again from the latest inputs once it completes.
+        _transectsBuildPending = true;
+        _cancelTransectsBuild();
+        return;
+    }
+
+    _transectsBuildPending = false;
+    int generation = ++_transectsBuildGeneration;
+    _runningBuildGeneration = generation;
+    std::shared_ptr<std::atomic_bool> cancel = std::make_shared<std::atomic_bool>(false);
+    _runningBuildCancel = cancel;
+    TransectsBuilder_t builder = _transectsBuilder();
+    _transectsBuildWatcher.setFuture(QtConcurrent::run([builder, generation, cancel]() {
+        QElapsedTimer buildTimer;
+        buildTimer.start();
+        TransectsBuild_t build;
+        build.transects     = builder(*cancel);
+        build.generation    = generation;
+        build.buildMsecs    = static_cast<int>(buildTimer.elapsed());
+        build.cancelled     = *cancel;
+        return build;
+    }));
+}
+
+void TransectStyleComplexItem::_cancelTransectsBuild(void)
+{
+    if (_runningBuildCancel) {
+        *_runningBuildCancel = true;
+        _runningBuildCancel.reset();
+    }
+}
+
+void TransectStyleComplexItem::_transectsBuildFinished(void)
+{
+    TransectsBuild_t build = _transectsBuildWatcher.result();
+    _runningBuildCancel.reset();
+
+    if (build.cancelled || build.generation != _transectsBuildGeneration || _transectsBuildPending || _ignoreRecalc) {
+        qCDebug(TransectStyleComplexItemLog) << "Discarding stale transects build" << build.generation << _transectsBuildGeneration;
+    } else {
+        _publishTransects(build.transects, build.buildMsecs);
+    }
+
+    if (_transectsBuildPending) {
+        _startTransectsBuild();
+    } else {
+        _setTransectsBuilding(_rebuildTransectsTimer.isActive());
+    }
+}
+
+/// Makes sure the transects reflect the latest inputs before they are used for something other than display
+void TransectStyleComplexItem::_flushScheduledRebuild(void)
+{
+    bool currentBuildRunning = _transectsBuildWatcher.isRunning() && _runningBuildGeneration == _transectsBuildGeneration;
+    if (_rebuildTransectsTimer.isActive() || _transectsBuildPending || currentBuildRunning) {
+        _rebuildTransects();
+    }
+}
+
+void TransectStyleComplexItem::_setTransectsBuilding(bool building)
+{
+    if (_transectsBuilding != building) {
+        _transectsBuilding = building;
+        emit transectsBuildingChanged();
+    }
+}
+
+/// Replaces the transects with a newly built set and updates everything derived from them in a single step
+void TransectStyleComplexItem::_publishTransects(const Transects_t& transects, int buildMsecs)
+{
+    QElapsedTimer applyTimer;
+    applyTimer.start();
+
+    // Any previously loaded mission items were generated from older inputs
+    _loadedMissionItems.clear();
+
+    _transects = transects;
     _rgPathHeightInfo.clear();
     _rgFlightPathCoordInfo.clear();
+    _rebuildTransectsPhase2();
 
-    _rebuildTransectsPhase1();
+    _transectBuildMsecs = buildMsecs;
+    _transectApplyMsecs = static_cast<int>(applyTimer.elapsed());
+    qCDebug(TransectStyleComplexItemLog) << "Transects rebuilt - count:buildMsecs:applyMsecs" << _transects.count() << _transectBuildMsecs << _transectApplyMsecs;
+    emit transectTimingsChanged();
+}
 
+void TransectStyleComplexItem::_rebuildTransectsPhase2(void)
+{
     _minAMSLAltitude = _maxAMSLAltitude = qQNaN();
 
     switch (_cameraCalc.distanceMode()) {
     case QGroundControlQmlGlobal::AltitudeModeMixed:
     case QGroundControlQmlGlobal::AltitudeModeNone:
-        qCWarning(TransectStyleComplexItemLog) << "Internal Error: _rebuildTransects - invalid _cameraCalc.distanceMode()" << _cameraCalc.distanceMode();
+        qCWarning(TransectStyleComplexItemLog) << "Internal Error: _rebuildTransectsPhase2 - invalid _cameraCalc.distanceMode()" << _cameraCalc.distanceMode();
         return;
     case QGroundControlQmlGlobal::AltitudeModeRelative:
     case QGroundControlQmlGlobal::AltitudeModeAbsolute:
@@ -532,13 +646,13 @@ void TransectStyleComplexItem::_updateFlightPathSegmentsDontCallDirectly(void)
             // Build segments from loaded mission item data
             QGeoCoordinate prevCoord = QGeoCoordinate();
             double prevAlt = 0;
-            for (const MissionItem* missionItem: _loadedMissionItems) {
-                if (missionItem->command() == MAV_CMD_NAV_WAYPOINT || missionItem->command() == MAV_CMD_CONDITION_GATE) {
+            for (int i=0; i<_loadedMissionItems.count(); i++) {
+                if (_loadedMissionItems.command(i) == MAV_CMD_NAV_WAYPOINT || _loadedMissionItems.command(i) == MAV_CMD_CONDITION_GATE) {
                     if (prevCoord.isValid()) {
-                        _appendFlightPathSegment(FlightPathSegment::SegmentTypeGeneric, prevCoord, prevAlt, missionItem->coordinate(), missionItem->param7());
+                        _appendFlightPathSegment(FlightPathSegment::SegmentTypeGeneric, prevCoord, prevAlt, _loadedMissionItems.coordinate(i), _loadedMissionItems.param7(i));
                     }
-                    prevCoord = missionItem->coordinate();
-                    prevAlt = missionItem->param7();
+                    prevCoord = _loadedMissionItems.coordinate(i);
+                    prevAlt = _loadedMissionItems.param7(i);
                 }
             }
         } else {
@@ -624,11 +738,11 @@ void TransectStyleComplexItem::_queryMissionItemCoordHeights(void)
 
     // We need terrain heights below each mission item we fly through which is terrain frame
     MissionCommandTree* commandTree = qgcApp()->toolbox()->missionCommandTree();
-    for (const MissionItem* missionItem: _loadedMissionItems) {
-        if (missionItem->frame() == MAV_FRAME_GLOBAL_TERRAIN_ALT) {
-            const MissionCommandUIInfo* uiInfo = commandTree->getUIInfo(_controllerVehicle, QGCMAVLink::VehicleClassGeneric, missionItem->command());
+    for (int i=0; i<_loadedMissionItems.count(); i++) {
+        if (_loadedMissionItems.frame(i) == MAV_FRAME_GLOBAL_TERRAIN_ALT) {
+            const MissionCommandUIInfo* uiInfo = commandTree->getUIInfo(_controllerVehicle, QGCMAVLink::VehicleClassGeneric, _loadedMissionItems.command(i));
             if (uiInfo && uiInfo->specifiesCoordinate() && !uiInfo->isStandaloneCoordinate()) {
-                _rgFlyThroughMissionItemCoords.append(missionItem->coordinate());
+                _rgFlyThroughMissionItemCoords.append(_loadedMissionItems.coordinate(i));
             }
         }
     }
@@ -1049,7 +1163,7 @@ int TransectStyleComplexItem::lastSequenceNumber(void) const
         int                         itemCount   = 0;
         BuildMissionItemsState_t    buildState  = _buildMissionItemsState();
 
-        // Important Note: This code should match the logic in _buildAndAppendMissionItems
+        // Important Note: This code should match the logic in _buildMissionItems
         for (int coordIndex=0; coordIndex<_rgFlightPathCoordInfo.count(); coordIndex++) {
             const CoordInfo_t& coordInfo = _rgFlightPathCoordInfo[coordIndex];
             switch (coordInfo.coordType) {
@@ -1127,93 +1241,82 @@ void TransectStyleComplexItem::_handleHoverAndCaptureEnabled(QVariant enabled)
 }
 
 void TransectStyleComplexItem::appendMissionItems(QList<MissionItem*>& items, QObject* missionItemParent)
+{
+    _flushScheduledRebuild();
+
+    _currentMissionItems().appendMissionItems(items, _sequenceNumber, missionItemParent);
+}
+
+MissionItemStore TransectStyleComplexItem::_currentMissionItems(void)
 {
     if (_loadedMissionItems.count()) {
         // We have mission items from the loaded plan, use those
-        _appendLoadedMissionItems(items, missionItemParent);
+        return _loadedMissionItems;
     } else {
         // Build the mission items on the fly
-        _buildAndAppendMissionItems(items, missionItemParent);
+        MissionItemStore items;
+        _buildMissionItems(items);
+        return items;
     }
 }
 
-void TransectStyleComplexItem::_appendWaypoint(QList<MissionItem*>& items, QObject* missionItemParent, int& seqNum, MAV_FRAME mavFrame, float holdTime, const QGeoCoordinate& coordinate)
+void TransectStyleComplexItem::_appendWaypoint(MissionItemStore& items, MAV_FRAME mavFrame, float holdTime, const QGeoCoordinate& coordinate)
 {
     double altitude = _cameraCalc.distanceMode() == QGroundControlQmlGlobal::AltitudeModeCalcAboveTerrain ? coordinate.altitude() : _cameraCalc.distanceToSurface()->rawValue().toDouble();
 
-    MissionItem* item = new MissionItem(seqNum++,
-                                        MAV_CMD_NAV_WAYPOINT,
-                                        mavFrame,
-                                        holdTime,
-                                        0.0,                                         // No acceptance radius specified
-                                        0.0,                                         // Pass through waypoint
-                                        std::numeric_limits<double>::quiet_NaN(),    // Yaw unchanged
-                                        coordinate.latitude(),
-                                        coordinate.longitude(),
-                                        altitude,
-                                        true,                                        // autoContinue
-                                        false,                                       // isCurrentItem
-                                        missionItemParent);
-    items.append(item);
+    items.append(MAV_CMD_NAV_WAYPOINT,
+                 mavFrame,
+                 holdTime,
+                 0.0,                                         // No acceptance radius specified
+                 0.0,                                         // Pass through waypoint
+                 std::numeric_limits<double>::quiet_NaN(),    // Yaw unchanged
+                 coordinate.latitude(),
+                 coordinate.longitude(),
+                 altitude);
 }
 
-void TransectStyleComplexItem::_appendSinglePhotoCapture(QList<MissionItem*>& items, QObject* missionItemParent, int& seqNum)
+void TransectStyleComplexItem::_appendSinglePhotoCapture(MissionItemStore& items)
 {
-    MissionItem* item = new MissionItem(seqNum++,
-                                        MAV_CMD_IMAGE_START_CAPTURE,
-                                        MAV_FRAME_MISSION,
-                                        0,                                   // Reserved (Set to 0)
-                                        0,                                   // Interval (none)
-                                        1,                                   // Take 1 photo
-                                        qQNaN(), qQNaN(), qQNaN(), qQNaN(),  // param 4-7 reserved
-                                        true,                                // autoContinue
-                                        false,                               // isCurrentItem
-                                        missionItemParent);
-    items.append(item);
+    items.append(MAV_CMD_IMAGE_START_CAPTURE,
+                 MAV_FRAME_MISSION,
+                 0,                                   // Reserved (Set to 0)
+                 0,                                   // Interval (none)
+                 1,                                   // Take 1 photo
+                 qQNaN(), qQNaN(), qQNaN(), qQNaN()); // param 4-7 reserved
 }
 
-void TransectStyleComplexItem::_appendConditionGate(QList<MissionItem*>& items, QObject* missionItemParent, int& seqNum, MAV_FRAME mavFrame, const QGeoCoordinate& coordinate)
+void TransectStyleComplexItem::_appendConditionGate(MissionItemStore& items, MAV_FRAME mavFrame, const QGeoCoordinate& coordinate)
 {
     double altitude = _cameraCalc.distanceMode() == QGroundControlQmlGlobal::AltitudeModeCalcAboveTerrain ? coordinate.altitude() : _cameraCalc.distanceToSurface()->rawValue().toDouble();
 
-    MissionItem* item = new MissionItem(seqNum++,
-                                        MAV_CMD_CONDITION_GATE,
-                                        mavFrame,
-                                        0,                                           // Gate is orthogonal to path
-                                        1,                                           // Use altitude
-                                        0, 0,                                        // Param 3-4 ignored
-                                        coordinate.latitude(),
-                                        coordinate.longitude(),
-                                        altitude,
-                                        true,                                        // autoContinue
-                                        false,                                       // isCurrentItem
-                                        missionItemParent);
-    items.append(item);
+    items.append(MAV_CMD_CONDITION_GATE,
+                 mavFrame,
+                 0,                                           // Gate is orthogonal to path
+                 1,                                           // Use altitude
+                 0, 0,                                        // Param 3-4 ignored
+                 coordinate.latitude(),
+                 coordinate.longitude(),
+                 altitude);
 }
 
-void TransectStyleComplexItem::_appendCameraTriggerDistance(QList<MissionItem*>& items, QObject* missionItemParent, int& seqNum, float triggerDistance)
+void TransectStyleComplexItem::_appendCameraTriggerDistance(MissionItemStore& items, float triggerDistance)
 {
-    MissionItem* item = new MissionItem(seqNum++,
-                                        MAV_CMD_DO_SET_CAM_TRIGG_DIST,
-                                        MAV_FRAME_MISSION,
-                                        triggerDistance,
-                                        0,                              // shutter integration (ignore)
-                                        1,                              // 1 - trigger one image immediately, both and entry and exit to get full coverage
-                                        0, 0, 0, 0,                     // param 4-7 unused
-                                        true,                           // autoContinue
-                                        false,                          // isCurrentItem
-                                        missionItemParent);
-    items.append(item);
+    items.append(MAV_CMD_DO_SET_CAM_TRIGG_DIST,
+                 MAV_FRAME_MISSION,
+                 triggerDistance,
+                 0,                              // shutter integration (ignore)
+                 1,                              // 1 - trigger one image immediately, both and entry and exit to get full coverage
+                 0, 0, 0, 0);                    // param 4-7 unused
 }
 
-void TransectStyleComplexItem::_appendCameraTriggerDistanceUpdatePoint(QList<MissionItem*>& items, QObject* missionItemParent, int& seqNum, MAV_FRAME mavFrame, const QGeoCoordinate& coordinate, bool useConditionGate, float triggerDistance)
+void TransectStyleComplexItem::_appendCameraTriggerDistanceUpdatePoint(MissionItemStore& items, MAV_FRAME mavFrame, const QGeoCoordinate& coordinate, bool useConditionGate, float triggerDistance)
 {
     if (useConditionGate) {
-        _appendConditionGate(items, missionItemParent, seqNum, mavFrame, coordinate);
+        _appendConditionGate(items, mavFrame, coordinate);
     } else {
-        _appendWaypoint(items, missionItemParent, seqNum, mavFrame, 0 /* holdTime */, coordinate);
+        _appendWaypoint(items, mavFrame, 0 /* holdTime */, coordinate);
     }
-    _appendCameraTriggerDistance(items, missionItemParent, seqNum, triggerDistance);
+    _appendCameraTriggerDistance(items, triggerDistance);
 }
 
 TransectStyleComplexItem::BuildMissionItemsState_t TransectStyleComplexItem::_buildMissionItemsState(void) const
@@ -1230,13 +1333,12 @@ TransectStyleComplexItem::BuildMissionItemsState_t TransectStyleComplexItem::_bu
     return state;
 }
 
-void TransectStyleComplexItem::_buildAndAppendMissionItems(QList<MissionItem*>& items, QObject* missionItemParent)
+void TransectStyleComplexItem::_buildMissionItems(MissionItemStore& items)
 {
-    int                         seqNum      = _sequenceNumber;
     BuildMissionItemsState_t    buildState  = _buildMissionItemsState();
     MAV_FRAME                   mavFrame;
 
-    qCDebug(TransectStyleComplexItemLog) << "_buildAndAppendMissionItems";
+    qCDebug(TransectStyleComplexItemLog) << "_buildMissionItems";
 
     switch (_cameraCalc.distanceMode()) {
     case QGroundControlQmlGlobal::AltitudeModeRelative:
@@ -1251,7 +1353,7 @@ void TransectStyleComplexItem::_buildAndAppendMissionItems(QList<MissionItem*>&
         break;
     case QGroundControlQmlGlobal::AltitudeModeMixed:
     case QGroundControlQmlGlobal::AltitudeModeNone:
-        qCWarning(TransectStyleComplexItemLog) << "Internal Error: _buildAndAppendMissionItems incorrect _cameraCalc.distanceMode" << _cameraCalc.distanceMode();
+        qCWarning(TransectStyleComplexItemLog) << "Internal Error: _buildMissionItems incorrect _cameraCalc.distanceMode" << _cameraCalc.distanceMode();
         mavFrame = MAV_FRAME_GLOBAL_RELATIVE_ALT;
         break;
     }
@@ -1262,71 +1364,58 @@ void TransectStyleComplexItem::_buildAndAppendMissionItems(QList<MissionItem*>&
         switch (coordInfo.coordType) {
         case CoordTypeInterior:
         case CoordTypeInteriorTerrainAdded:
-            _appendWaypoint(items, missionItemParent, seqNum, mavFrame, 0 /* holdTime */, coordInfo.coord);
+            _appendWaypoint(items, mavFrame, 0 /* holdTime */, coordInfo.coord);
             break;
         case CoordTypeTurnaround:
         {
             bool firstEntryTurnaround   = coordIndex == 0;
             bool lastExitTurnaround     = coordIndex == _rgFlightPathCoordInfo.count() - 1;
             if (buildState.addTriggerAtFirstAndLastPoint && (firstEntryTurnaround || lastExitTurnaround)) {
-                _appendCameraTriggerDistanceUpdatePoint(items, missionItemParent, seqNum, mavFrame, coordInfo.coord, buildState.useConditionGate, firstEntryTurnaround ? triggerDistance() : 0);
+                _appendCameraTriggerDistanceUpdatePoint(items, mavFrame, coordInfo.coord, buildState.useConditionGate, firstEntryTurnaround ? triggerDistance() : 0);
             } else {
-                _appendWaypoint(items, missionItemParent, seqNum, mavFrame, 0 /* holdTime */, coordInfo.coord);
+                _appendWaypoint(items, mavFrame, 0 /* holdTime */, coordInfo.coord);
             }
         }
             break;
         case CoordTypeInteriorHoverTrigger:
-            _appendWaypoint(items, missionItemParent, seqNum, mavFrame, _hoverAndCaptureDelaySeconds, coordInfo.coord);
-            _appendSinglePhotoCapture(items, missionItemParent, seqNum);
+            _appendWaypoint(items, mavFrame, _hoverAndCaptureDelaySeconds, coordInfo.coord);
+            _appendSinglePhotoCapture(items);
             break;
         case CoordTypeSurveyEntry:
             if (triggerCamera()) {
                 if (hoverAndCaptureEnabled()) {
-                    _appendWaypoint(items, missionItemParent, seqNum, mavFrame, _hoverAndCaptureDelaySeconds, coordInfo.coord);
-                    _appendSinglePhotoCapture(items, missionItemParent, seqNum);
+                    _appendWaypoint(items, mavFrame, _hoverAndCaptureDelaySeconds, coordInfo.coord);
+                    _appendSinglePhotoCapture(items);
                 } else {
                     // We always add a trigger start to survey entry. Even for imagesInTurnaround = true. This allows you to resume a mission and refly a transect
-                    _appendCameraTriggerDistanceUpdatePoint(items, missionItemParent, seqNum, mavFrame, coordInfo.coord, buildState.useConditionGate, triggerDistance());
+                    _appendCameraTriggerDistanceUpdatePoint(items, mavFrame, coordInfo.coord, buildState.useConditionGate, triggerDistance());
                 }
             } else {
-                _appendWaypoint(items, missionItemParent, seqNum, mavFrame, 0 /* holdTime */, coordInfo.coord);
+                _appendWaypoint(items, mavFrame, 0 /* holdTime */, coordInfo.coord);
             }
             break;
         case CoordTypeSurveyExit:
             bool lastSurveyExit = coordIndex == _rgFlightPathCoordInfo.count() - 1;
             if (triggerCamera()) {
                 if (hoverAndCaptureEnabled()) {
-                    _appendWaypoint(items, missionItemParent, seqNum, mavFrame, _hoverAndCaptureDelaySeconds, coordInfo.coord);
-                    _appendSinglePhotoCapture(items, missionItemParent, seqNum);
+                    _appendWaypoint(items, mavFrame, _hoverAndCaptureDelaySeconds, coordInfo.coord);
+                    _appendSinglePhotoCapture(items);
                 } else if (buildState.addTriggerAtFirstAndLastPoint && !buildState.hasTurnarounds && lastSurveyExit) {
-                    _appendCameraTriggerDistanceUpdatePoint(items, missionItemParent, seqNum, mavFrame, coordInfo.coord, buildState.useConditionGate, 0 /* triggerDistance */);
+                    _appendCameraTriggerDistanceUpdatePoint(items, mavFrame, coordInfo.coord, buildState.useConditionGate, 0 /* triggerDistance */);
                 } else if (buildState.imagesInTurnaround) {
-                    _appendWaypoint(items, missionItemParent, seqNum, mavFrame, 0 /* holdTime */, coordInfo.coord);
+                    _appendWaypoint(items, mavFrame, 0 /* holdTime */, coordInfo.coord);
                 } else {
                     // If we get this far it means the camera is triggering start/stop for each transect
-                    _appendCameraTriggerDistanceUpdatePoint(items, missionItemParent, seqNum, mavFrame, coordInfo.coord, buildState.useConditionGate, 0 /* triggerDistance */);
+                    _appendCameraTriggerDistanceUpdatePoint(items, mavFrame, coordInfo.coord, buildState.useConditionGate, 0 /* triggerDistance */);
                 }
             } else {
-                _appendWaypoint(items, missionItemParent, seqNum, mavFrame, 0 /* holdTime */, coordInfo.coord);
+                _appendWaypoint(items, mavFrame, 0 /* holdTime */, coordInfo.coord);
             }
             break;
         }
     }
 }
 
-void TransectStyleComplexItem::_appendLoadedMissionItems(QList<MissionItem*>& items, QObject* missionItemParent)
-{
-    qCDebug(TransectStyleComplexItemLog) << "_appendLoadedMissionItems";
-
-    int seqNum = _sequenceNumber;
-
-    for (const MissionItem* loadedMissionItem: _loadedMissionItems) {
-        MissionItem* item = new MissionItem(*loadedMissionItem, missionItemParent);
-        item->setSequenceNumber(seqNum++);
-        items.append(item);
-    }
-}
-
 void TransectStyleComplexItem::addKMLVisuals(KMLPlanDomDocument& domDocument)
 {
     // We add the survey area polygon as a Placemark
@@ -1366,16 +1455,15 @@ double TransectStyleComplexItem::amslEntryAlt(void) const
             // The first item might not be a waypoint we have to find it.
             MissionCommandTree* commandTree = qgcApp()->toolbox()->missionCommandTree();
             for (int i=0; i<_loadedMissionItems.count(); i++) {
-                MissionItem* item = _loadedMissionItems[i];
-                const MissionCommandUIInfo* uiInfo = commandTree->getUIInfo(_controllerVehicle, QGCMAVLink::VehicleClassGeneric, item->command());
+                const MissionCommandUIInfo* uiInfo = commandTree->getUIInfo(_controllerVehicle, QGCMAVLink::VehicleClassGeneric, _loadedMissionItems.command(i));
                 if (uiInfo && uiInfo->specifiesCoordinate() && !uiInfo->isStandaloneCoordinate()) {
                     if (_cameraCalc.distanceMode() == QGroundControlQmlGlobal::AltitudeModeCalcAboveTerrain) {
                         // AltitudeModeCalcAboveTerrain has AMSL alt in param 7
-                        alt = item->param7();
+                        alt = _loadedMissionItems.param7(i);
                     } else {
                         // AltitudeModeTerrainFrame has terrain frame relative alt in param 7. So we need terrain heights to calc AMSL.
                         if (_rgPathHeightInfo.count()) {
-                            alt = item->param7() + _rgPathHeightInfo.first().heights.first();
+                            alt = _loadedMissionItems.param7(i) + _rgPathHeightInfo.first().heights.first();
                         }
                     }
                     break;
@@ -1411,16 +1499,15 @@ double TransectStyleComplexItem::amslExitAlt(void) const
             // The last item might not be a waypoint we have to find it.
             MissionCommandTree* commandTree = qgcApp()->toolbox()->missionCommandTree();
             for (int i=_loadedMissionItems.count()-1; i>0; i--) {
-                MissionItem* item = _loadedMissionItems[i];
-                const MissionCommandUIInfo* uiInfo = commandTree->getUIInfo(_controllerVehicle, QGCMAVLink::VehicleClassGeneric, item->command());
+                const MissionCommandUIInfo* uiInfo = commandTree->getUIInfo(_controllerVehicle, QGCMAVLink::VehicleClassGeneric, _loadedMissionItems.command(i));
                 if (uiInfo && uiInfo->specifiesCoordinate() && !uiInfo->isStandaloneCoordinate()) {
                     if (_cameraCalc.distanceMode() == QGroundControlQmlGlobal::AltitudeModeCalcAboveTerrain) {
                         // AltitudeModeCalcAboveTerrain has AMSL alt in param 7
-                        alt = item->param7();
+                        alt = _loadedMissionItems.param7(i);
                     } else {
                         // AltitudeModeTerrainFrame has terrain frame relative alt in param 7. So we need terrain heights to calc AMSL.
                         if (_rgPathHeightInfo.count()) {
-                            alt = item->param7() + _rgPathHeightInfo.last().heights.last();
+                            alt = _loadedMissionItems.param7(i) + _rgPathHeightInfo.last().heights.last();
                         }
                     }
                     break;
@@ -11,6 +11,7 @@
 
 #include "ComplexMissionItem.h"
 #include "MissionItem.h"
+#include "MissionItemStore.h"
 #include "SettingsFact.h"
 #include "QGCLoggingCategory.h"
 #include "QGCMapPolyline.h"
@@ -18,6 +19,13 @@
 #include "CameraCalc.h"
 #include "TerrainQuery.h"
 
+#include <QTimer>
+#include <QFutureWatcher>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
 Q_DECLARE_LOGGING_CATEGORY(TransectStyleComplexItemLog)
 
 class PlanMasterController;
@@ -41,6 +49,9 @@ public:
     Q_PROPERTY(double           coveredArea                 READ coveredArea                                        NOTIFY coveredAreaChanged)
     Q_PROPERTY(bool             hoverAndCaptureAllowed      READ hoverAndCaptureAllowed                             CONSTANT)
     Q_PROPERTY(QVariantList     visualTransectPoints        READ visualTransectPoints                               NOTIFY visualTransectPointsChanged)
+    Q_PROPERTY(bool             transectsBuilding           READ transectsBuilding                                  NOTIFY transectsBuildingChanged)
+    Q_PROPERTY(int              transectBuildMsecs          READ transectBuildMsecs                                 NOTIFY transectTimingsChanged)  ///< Time taken to generate the transects on the worker thread
+    Q_PROPERTY(int              transectApplyMsecs          READ transectApplyMsecs                                 NOTIFY transectTimingsChanged)  ///< Time taken to publish the transects on the main thread
 
     Q_PROPERTY(Fact*            terrainAdjustTolerance      READ terrainAdjustTolerance                             CONSTANT)
     Q_PROPERTY(Fact*            terrainAdjustMaxDescentRate READ terrainAdjustMaxDescentRate                        CONSTANT)
@@ -63,6 +74,9 @@ public:
     int             cameraShots             (void) const { return _cameraShots; }
     double          coveredArea             (void) const;
     bool            hoverAndCaptureAllowed  (void) const;
+    bool            transectsBuilding       (void) const { return _transectsBuilding; }
+    int             transectBuildMsecs      (void) const { return _transectBuildMsecs; }
+    int             transectApplyMsecs      (void) const { return _transectApplyMsecs; }
 
     virtual double  timeBetweenShots        (void) { return 0; } // Most be overridden. Implementation here is needed for unit testing.
 
@@ -72,6 +86,7 @@ public:
 
     // Used internally only by unit tests
     int _transectCount(void) const { return _transects.count(); }
+    void _setAsyncTransectRebuild(bool async) { _asyncTransectRebuild = async; }
 
     // Overrides from ComplexMissionItem
     int     lastSequenceNumber  (void) const final;
@@ -124,6 +139,8 @@ signals:
     void timeBetweenShotsChanged        (void);
     void visualTransectPointsChanged    (void);
     void coveredAreaChanged             (void);
+    void transectsBuildingChanged       (void);
+    void transectTimingsChanged         (void);
     void _updateFlightPathSegmentsSignal(void);
 
 protected slots:
@@ -132,10 +149,10 @@ protected slots:
     void _updateCoordinateAltitudes         (void);
     void _polyPathTerrainData               (bool success, const QList<TerrainPathQuery::PathHeightInfo_t>& rgPathHeightInfo);
     void _missionItemCoordTerrainData       (bool success, QList<double> heights);
-    void _rebuildTransects                  (void);
+    void _rebuildTransects                  (void);     ///< Rebuilds the transects immediately
+    void _scheduleRebuildTransects          (void);     ///< Rebuilds the transects in the background once changes settle
 
 protected:
-    virtual void _rebuildTransectsPhase1    (void) = 0; ///< Rebuilds the _transects array
     virtual void _recalcCameraShots         (void) = 0;
 
     void    _save                           (QJsonObject& saveObject);
@@ -145,13 +162,13 @@ protected:
     double  _triggerDistance                (void) const;
     bool    _hasTurnaround                  (void) const;
     double  _turnAroundDistance             (void) const;
-    void    _appendWaypoint                 (QList<MissionItem*>& items, QObject* missionItemParent, int& seqNum, MAV_FRAME mavFrame, float holdTime, const QGeoCoordinate& coordinate);
-    void    _appendSinglePhotoCapture       (QList<MissionItem*>& items, QObject* missionItemParent, int& seqNum);
-    void    _appendConditionGate            (QList<MissionItem*>& items, QObject* missionItemParent, int& seqNum, MAV_FRAME mavFrame, const QGeoCoordinate& coordinate);
-    void    _appendCameraTriggerDistance    (QList<MissionItem*>& items, QObject* missionItemParent, int& seqNum, float triggerDistance);
-    void    _appendCameraTriggerDistanceUpdatePoint(QList<MissionItem*>& items, QObject* missionItemParent, int& seqNum, MAV_FRAME mavFrame, const QGeoCoordinate& coordinate, bool useConditionGate, float triggerDistance);
-    void    _buildAndAppendMissionItems     (QList<MissionItem*>& items, QObject* missionItemParent);
-    void    _appendLoadedMissionItems       (QList<MissionItem*>& items, QObject* missionItemParent);
+    void    _appendWaypoint                 (MissionItemStore& items, MAV_FRAME mavFrame, float holdTime, const QGeoCoordinate& coordinate);
+    void    _appendSinglePhotoCapture       (MissionItemStore& items);
+    void    _appendConditionGate            (MissionItemStore& items, MAV_FRAME mavFrame, const QGeoCoordinate& coordinate);
+    void    _appendCameraTriggerDistance    (MissionItemStore& items, float triggerDistance);
+    void    _appendCameraTriggerDistanceUpdatePoint(MissionItemStore& items, MAV_FRAME mavFrame, const QGeoCoordinate& coordinate, bool useConditionGate, float triggerDistance);
+    void    _buildMissionItems              (MissionItemStore& items);
+    MissionItemStore _currentMissionItems   (void);     ///< Loaded mission items if available, otherwise built from the flight path
     void    _recalcComplexDistance          (void);
 
     int                 _sequenceNumber = 0;
@@ -173,8 +190,16 @@ protected:
         CoordType       coordType;
     } CoordInfo_t;
 
+    typedef QList<QList<CoordInfo_t>>                               Transects_t;
+    typedef std::function<Transects_t(const std::atomic_bool& cancel)> TransectsBuilder_t;
+
+    /// Captures the current inputs to transect generation and returns a function which builds the transects from them.
+    /// Called on the main thread. The returned function may be run on a worker thread so it must only use what it captured.
+    /// It should check cancel between transects and return early once it is set, the partial result is discarded.
+    virtual TransectsBuilder_t _transectsBuilder(void) = 0;
+
     QVariantList                                _visualTransectPoints;                          ///< Used to draw the flight path visuals on the screen
-    QList<QList<CoordInfo_t>>                   _transects;
+    Transects_t                                 _transects;
     QList<TerrainPathQuery::PathHeightInfo_t>   _rgPathHeightInfo;                              ///< Path height for each segment includes turn segments
     QList<QGeoCoordinate>                       _rgFlyThroughMissionItemCoords;
     QList<double>                               _rgFlyThroughMissionItemCoordsTerrainHeights;
@@ -189,8 +214,7 @@ protected:
     double          _minAMSLAltitude =  qQNaN();
     double          _maxAMSLAltitude =  qQNaN();
 
-    QObject*            _loadedMissionItemsParent = nullptr;	///< Parent for all items in _loadedMissionItems for simpler delete
-    QList<MissionItem*> _loadedMissionItems;                    ///< Mission items loaded from plan file
+    MissionItemStore    _loadedMissionItems;                    ///< Mission items loaded from plan file
 
     QMap<QString, FactMetaData*> _metaDataMap;
 
@@ -218,8 +242,17 @@ private slots:
     void _updateFlightPathSegmentsDontCallDirectly  (void);
     void _segmentTerrainCollisionChanged            (bool terrainCollision) final;
     void _distanceModeChanged                       (int distanceMode);
+    void _startTransectsBuild                       (void);
+    void _transectsBuildFinished                    (void);
 
 private:
+    typedef struct {
+        Transects_t transects;
+        int         generation;
+        int         buildMsecs;
+        bool        cancelled;
+    } TransectsBuild_t;
+
     typedef struct {
         bool imagesInTurnaround;
         bool hasTurnarounds;
@@ -239,11 +272,29 @@ private:
     double  _altitudeBetweenCoords                                          (const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord, double percentTowardsTo);
     int     _maxPathHeight                                                  (const TerrainPathQuery::PathHeightInfo_t& pathHeightInfo, int fromIndex, int toIndex, double& maxHeight);
     BuildMissionItemsState_t _buildMissionItemsState                        (void) const;
+    void    _publishTransects                                               (const Transects_t& transects, int buildMsecs);
+    void    _rebuildTransectsPhase2                                         (void);
+    void    _flushScheduledRebuild                                          (void);
+    void    _setTransectsBuilding                                           (bool building);
+    void    _cancelTransectsBuild                                           (void);
 
     TerrainPolyPathQuery*       _currentTerrainPolyPathQuery        = nullptr;
     TerrainAtCoordinateQuery*   _currentTerrainAtCoordinateQuery    = nullptr;
     QTimer                      _terrainPolyPathQueryTimer;
 
+    QTimer                              _rebuildTransectsTimer;         ///< Coalesces bursts of changes (e.g. polygon drags) into a single rebuild
+    QFutureWatcher<TransectsBuild_t>    _transectsBuildWatcher;
+    int                                 _transectsBuildGeneration = 0;  ///< Builds started before the latest rebuild request are stale
+    int                                 _runningBuildGeneration =   0;
+    std::shared_ptr<std::atomic_bool>   _runningBuildCancel;            ///< Set to stop the running build early once it is stale
+    bool                                _transectsBuildPending =    false;
+    bool                                _transectsBuilding =        false;
+    bool                                _asyncTransectRebuild;
+    int                                 _transectBuildMsecs =       0;
+    int                                 _transectApplyMsecs =       0;
+
+    static const int _rebuildTransectsDelayMsecs = 30;
+
     // Deprecated json keys
     static const char* _jsonTerrainFollowKeyDeprecated;
 };
@@ -11,6 +11,9 @@
 #include "QGCApplication.h"
 #include "QGroundControlQmlGlobal.h"
 
+#include <QElapsedTimer>
+#include <QThread>
+
 TransectStyleComplexItemTest::TransectStyleComplexItemTest(void)
 {
 }
@@ -227,11 +230,73 @@ void TransectStyleComplexItemTest::_testFollowTerrain(void)
     }
 }
 
+void TransectStyleComplexItemTest::_testBackgroundRebuild(void)
+{
+    auto lastSequenceNumberChangedMask = _multiSpy->signalNameToMask(SIGNAL(lastSequenceNumberChanged));
+
+    _transectStyleItem->_setAsyncTransectRebuild(true);
+    _transectStyleItem->rebuildTransectsPhase1Called = false;
+    _transectStyleItem->recalcCameraShotsCalled = false;
+    _multiSpy->clearAllSignals();
+
+    // A burst of changes should be coalesced into a single build which is published once complete
+    QSignalSpy timingsSpy(_transectStyleItem, &TransectStyleComplexItem::transectTimingsChanged);
+    changeFactValue(_transectStyleItem->turnAroundDistance());
+    changeFactValue(_transectStyleItem->refly90Degrees());
+    _transectStyleItem->adjustSurveAreaPolygon();
+    QVERIFY(_transectStyleItem->transectsBuilding());
+    QVERIFY(!_transectStyleItem->rebuildTransectsPhase1Called);
+    QVERIFY(!_multiSpy->checkSignalsByMask(lastSequenceNumberChangedMask));
+
+    QVERIFY(QTest::qWaitFor([&]() { return !_transectStyleItem->transectsBuilding(); }, 2000));
+    QCOMPARE(timingsSpy.count(), 1);
+    QVERIFY(_transectStyleItem->rebuildTransectsPhase1Called);
+    QVERIFY(_transectStyleItem->recalcCameraShotsCalled);
+    QVERIFY(_multiSpy->checkSignalsByMask(lastSequenceNumberChangedMask));
+    QCOMPARE(_transectStyleItem->_transectCount(), 1);
+    QCOMPARE(_transectStyleItem->coordinate().latitude(), _transectStyleItem->surveyAreaPolygon()->vertexCoordinate(0).latitude());
+
+    // Mission items must reflect a change which is still waiting to be built
+    _transectStyleItem->rebuildTransectsPhase1Called = false;
+    _transectStyleItem->adjustSurveAreaPolygon();
+    QVERIFY(_transectStyleItem->transectsBuilding());
+    QList<MissionItem*> rgItems;
+    _transectStyleItem->appendMissionItems(rgItems, this);
+    QVERIFY(_transectStyleItem->rebuildTransectsPhase1Called);
+    QCOMPARE(_transectStyleItem->coordinate().latitude(), _transectStyleItem->surveyAreaPolygon()->vertexCoordinate(0).latitude());
+    QVERIFY(QTest::qWaitFor([&]() { return !_transectStyleItem->transectsBuilding(); }, 2000));
+}
+
+void TransectStyleComplexItemTest::_testCancelStaleRebuild(void)
+{
+    _transectStyleItem->_setAsyncTransectRebuild(true);
+    _transectStyleItem->startedBuilds = 0;
+    _transectStyleItem->cancelledBuilds = 0;
+    QSignalSpy timingsSpy(_transectStyleItem, &TransectStyleComplexItem::transectTimingsChanged);
+
+    // Hold the first build in the background until it is cancelled
+    _transectStyleItem->holdBuilds = true;
+    _transectStyleItem->adjustSurveAreaPolygon();
+    QVERIFY(QTest::qWaitFor([&]() { return _transectStyleItem->startedBuilds == 1; }, 2000));
+    _transectStyleItem->holdBuilds = false;
+
+    // A newer change stops the stale build, only the build from the latest inputs is published
+    _transectStyleItem->adjustSurveAreaPolygon();
+    QVERIFY(QTest::qWaitFor([&]() { return !_transectStyleItem->transectsBuilding(); }, 2000));
+    QCOMPARE(_transectStyleItem->cancelledBuilds.load(), 1);
+    QCOMPARE(_transectStyleItem->startedBuilds.load(), 2);
+    QCOMPARE(timingsSpy.count(), 1);
+    QCOMPARE(_transectStyleItem->coordinate().latitude(), _transectStyleItem->surveyAreaPolygon()->vertexCoordinate(0).latitude());
+}
+
 TestTransectStyleItem::TestTransectStyleItem(PlanMasterController* masterController)
     : TransectStyleComplexItem      (masterController, false /* flyView */, QStringLiteral("UnitTestTransect"))
     , rebuildTransectsPhase1Called  (false)
     , recalcComplexDistanceCalled   (false)
     , recalcCameraShotsCalled       (false)
+    , holdBuilds                    (false)
+    , startedBuilds                 (0)
+    , cancelledBuilds               (0)
 {
     // We use a 100m by 100m square test polygon
     const double edgeDistance = 100;
@@ -241,19 +306,36 @@ TestTransectStyleItem::TestTransectStyleItem(PlanMasterController* masterControl
     surveyAreaPolygon()->appendVertex(surveyAreaPolygon()->vertexCoordinate(2).atDistanceAndAzimuth(edgeDistance, -90.0));
 }
 
-void TestTransectStyleItem::_rebuildTransectsPhase1(void)
+TestTransectStyleItem::TransectsBuilder_t TestTransectStyleItem::_transectsBuilder(void)
 {
     rebuildTransectsPhase1Called = true;
 
-    _transects.clear();
-    if (_surveyAreaPolygon.count() < 3) {
-        return;
-    }
-
-    _transects.append(QList<TransectStyleComplexItem::CoordInfo_t>{
-        {surveyAreaPolygon()->vertexCoordinate(0), CoordTypeSurveyEntry},
-        {surveyAreaPolygon()->vertexCoordinate(2), CoordTypeSurveyExit}}
-    );
+    QList<QGeoCoordinate>   polygon         = _surveyAreaPolygon.coordinateList();
+    std::atomic_bool*       hold            = &holdBuilds;
+    std::atomic_int*        started         = &startedBuilds;
+    std::atomic_int*        cancelled       = &cancelledBuilds;
+    return [polygon, hold, started, cancelled](const std::atomic_bool& cancel) {
+        (*started)++;
+        if (*hold) {
+            QElapsedTimer timer;
+            timer.start();
+            while (!cancel && timer.elapsed() < 2000) {
+                QThread::msleep(1);
+            }
+        }
+        Transects_t transects;
+        if (cancel) {
+            (*cancelled)++;
+            return transects;
+        }
+        if (polygon.count() >= 3) {
+            transects.append(QList<TransectStyleComplexItem::CoordInfo_t>{
+                {polygon[0], CoordTypeSurveyEntry},
+                {polygon[2], CoordTypeSurveyExit}}
+            );
+        }
+        return transects;
+    };
 }
 
 void TestTransectStyleItem::_recalcCameraShots(void)
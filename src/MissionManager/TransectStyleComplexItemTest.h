@@ -35,6 +35,8 @@ private slots:
     void _testDistanceSignalling(void);
     void _testAltitudes         (void);
     void _testFollowTerrain     (void);
+    void _testBackgroundRebuild (void);
+    void _testCancelStaleRebuild(void);
 
 private:
     MultiSignalSpyV2*       _multiSpy =             nullptr;
@@ -64,8 +66,15 @@ public:
     bool recalcComplexDistanceCalled;
     bool recalcCameraShotsCalled;
 
+    std::atomic_bool    holdBuilds;         ///< Builds started while set wait until they are cancelled
+    std::atomic_int     startedBuilds;
+    std::atomic_int     cancelledBuilds;
+
 private slots:
     // Overrides from TransectStyleComplexItem
-    void _rebuildTransectsPhase1    (void) final;
     void _recalcCameraShots         (void) final;
+
+private:
+    // Overrides from TransectStyleComplexItem
+    TransectsBuilder_t _transectsBuilder(void) final;
 };
@@ -50,6 +50,9 @@ Item {
     property bool   _batteryInfoAvailable:      _batteryChangePoint >= 0 || _batteriesRequired >= 0
     property real   _controllerProgressPct:     _controllerValid ? _planMasterController.missionController.progressPct : 0
     property bool   _syncInProgress:            _controllerValid ? _planMasterController.missionController.syncInProgress : false
+    property var    _tilePrefetcher:            _controllerValid ? _planMasterController.tilePrefetcher : null
+    property bool   _prefetchRunning:           _tilePrefetcher ? _tilePrefetcher.running : false
+    property bool   _prefetchStarted:           _tilePrefetcher ? _tilePrefetcher.tileCount > 0 : false
     property real   _gradient:                  _currentMissionItemValid && _currentMissionItem.distance > 0 ?
                                                     (_currentItemIsVTOLTakeoff ?
                                                          0 :
@@ -65,6 +68,7 @@ Item {
     property string _missionMaxTelemetryText:   isNaN(_missionMaxTelemetry) ?   "-.-" : QGroundControl.unitsConversion.metersToAppSettingsHorizontalDistanceUnits(_missionMaxTelemetry).toFixed(0) + " " + QGroundControl.unitsConversion.appSettingsHorizontalDistanceUnitsString
     property string _batteryChangePointText:    _batteryChangePoint < 0 ?       qsTr("N/A") : _batteryChangePoint
     property string _batteriesRequiredText:     _batteriesRequired < 0 ?        qsTr("N/A") : _batteriesRequired
+    property string _prefetchProgressText:      _prefetchRunning ?              (_tilePrefetcher.progress * 100).toFixed(0) + "%" : qsTr("Done")
 
     readonly property real _margins: ScreenTools.defaultFontPixelWidth
 
@@ -126,7 +130,7 @@ Item {
         anchors.leftMargin:     _margins
         anchors.left:           parent.left
         columnSpacing:          0
-        columns:                4
+        columns:                5
 
         GridLayout {
             columns:                8
@@ -241,6 +245,53 @@ Item {
             Item { width: 1; height: 1 }
         }
 
+        // Tiles prefetched for the plan, saved is what was already in the cache and did not need downloading
+        GridLayout {
+            columns:                5
+            rowSpacing:             _rowSpacing
+            columnSpacing:          _labelToValueSpacing
+            Layout.alignment:       Qt.AlignVCenter | Qt.AlignHCenter
+            visible:                _prefetchStarted
+
+            QGCLabel {
+                text:               qsTr("Map Tiles")
+                Layout.columnSpan:  5
+                font.pointSize:     ScreenTools.smallFontPointSize
+            }
+
+            QGCLabel { text: qsTr("Prefetch:"); font.pointSize: _dataFontSize; }
+            QGCLabel {
+                text:                   _prefetchProgressText
+                font.pointSize:         _dataFontSize
+                Layout.minimumWidth:    _mediumValueWidth
+            }
+
+            Item { width: 1; height: 1 }
+
+            QGCLabel { text: qsTr("Saved:"); font.pointSize: _dataFontSize; }
+            QGCLabel {
+                text:                   _tilePrefetcher ? _tilePrefetcher.cachedSizeStr : ""
+                font.pointSize:         _dataFontSize
+                Layout.minimumWidth:    _largeValueWidth
+            }
+
+            QGCLabel { text: qsTr("Errors:"); font.pointSize: _dataFontSize; }
+            QGCLabel {
+                text:                   _tilePrefetcher ? _tilePrefetcher.errorCount : ""
+                font.pointSize:         _dataFontSize
+                Layout.minimumWidth:    _mediumValueWidth
+            }
+
+            Item { width: 1; height: 1 }
+
+            QGCLabel { text: qsTr("Downloaded:"); font.pointSize: _dataFontSize; }
+            QGCLabel {
+                text:                   _tilePrefetcher ? _tilePrefetcher.downloadedSizeStr : ""
+                font.pointSize:         _dataFontSize
+                Layout.minimumWidth:    _largeValueWidth
+            }
+        }
+
         QGCButton {
             id:          uploadButton
             text:        _controllerDirty ? qsTr("Upload Required") : qsTr("Upload")
@@ -67,6 +67,7 @@
 #include "VideoReceiver.h"
 #include "LogDownloadController.h"
 #if !defined(QGC_DISABLE_MAVLINK_INSPECTOR)
+#include "LogAnalysisController.h"
 #include "MAVLinkInspectorController.h"
 #endif
 #include "HorizontalFactValueGrid.h"
@@ -135,6 +136,7 @@
 #endif
 
 #include "QGCMapEngine.h"
+#include "QGCTilePrefetcher.h"
 
 class FinishVideoInitialization : public QRunnable
 {
@@ -473,6 +475,7 @@ void QGCApplication::_initCommon()
     qmlRegisterUncreatableType<MissionController>       (kQGCControllers,                   1, 0, "MissionController",          kRefOnly);
     qmlRegisterUncreatableType<GeoFenceController>      (kQGCControllers,                   1, 0, "GeoFenceController",         kRefOnly);
     qmlRegisterUncreatableType<RallyPointController>    (kQGCControllers,                   1, 0, "RallyPointController",       kRefOnly);
+    qmlRegisterUncreatableType<QGCTilePrefetcher>       (kQGCControllers,                   1, 0, "QGCTilePrefetcher",          kRefOnly);
 
     qmlRegisterUncreatableType<MissionItem>         (kQGroundControl,                       1, 0, "MissionItem",                kRefOnly);
     qmlRegisterUncreatableType<VisualMissionItem>   (kQGroundControl,                       1, 0, "VisualMissionItem",          kRefOnly);
@@ -532,6 +535,7 @@ void QGCApplication::_initCommon()
     qmlRegisterType<GeoTagController>               (kQGCControllers,                       1, 0, "GeoTagController");
     qmlRegisterType<MavlinkConsoleController>       (kQGCControllers,                       1, 0, "MavlinkConsoleController");
 #if !defined(QGC_DISABLE_MAVLINK_INSPECTOR)
+    qmlRegisterType<LogAnalysisController>          (kQGCControllers,                       1, 0, "LogAnalysisController");
     qmlRegisterType<MAVLinkInspectorController>     (kQGCControllers,                       1, 0, "MAVLinkInspectorController");
 #endif
 
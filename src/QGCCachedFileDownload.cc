@@ -22,7 +22,7 @@ QGCCachedFileDownload::QGCCachedFileDownload(QObject* parent, const QString& cac
 
 bool QGCCachedFileDownload::download(const QString& url, int maxCacheAgeSec)
 {
-    _downloadFromNetwork = false;
+    _networkDownloads.remove(url);
     // Check cache
     QNetworkCacheMetaData metadata = _diskCache->metaData(url);
     if (metadata.isValid() && metadata.attributes().contains(QNetworkRequest::Attribute::User)) {
@@ -36,7 +36,7 @@ bool QGCCachedFileDownload::download(const QString& url, int maxCacheAgeSec)
         if (expired) {
             // Force network download, as Qt would still use the cache otherwise (w/o checking the remote)
             auto attributes = QVector{qMakePair(QNetworkRequest::CacheLoadControlAttribute, QVariant{QNetworkRequest::AlwaysNetwork})};
-            _downloadFromNetwork = true;
+            _networkDownloads.insert(url);
             return _fileDownload->download(url, attributes);
         }
 
@@ -60,8 +60,7 @@ void QGCCachedFileDownload::onDownloadCompleted(QString remoteFile, QString loca
     }
 
     // If we forced network download, but it failed, try again with the cache
-    if (_downloadFromNetwork && !errorMsg.isEmpty()) {
-        _downloadFromNetwork = false;
+    if (_networkDownloads.remove(remoteFile) && !errorMsg.isEmpty()) {
         if (!_fileDownload->download(remoteFile)) {
             emit downloadComplete(remoteFile, localFile, errorMsg);
         }
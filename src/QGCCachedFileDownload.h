@@ -12,6 +12,7 @@
 #include "QGCFileDownload.h"
 
 #include <QNetworkDiskCache>
+#include <QSet>
 
 class QGCCachedFileDownload : public QObject
 {
@@ -35,5 +36,5 @@ private:
 
     QGCFileDownload* _fileDownload;
     QNetworkDiskCache* _diskCache;
-    bool _downloadFromNetwork{false};
+    QSet<QString> _networkDownloads;    ///< Urls with a forced network download, multiple downloads can be active at once
 };
@@ -14,6 +14,9 @@
 #include <QStandardPaths>
 #include <QNetworkProxy>
 
+// Several downloads can be in flight at once, so each reply carries the url it was originally requested with
+static const char* kOriginalRemoteFileProperty = "qgcOriginalRemoteFile";
+
 QGCFileDownload::QGCFileDownload(QObject* parent)
     : QNetworkAccessManager(parent)
 {
@@ -61,6 +64,7 @@ bool QGCFileDownload::download(const QString& remoteFile, const QVector<QPair<QN
     }
 
     setIgnoreSSLErrorsIfNeeded(*networkReply);
+    networkReply->setProperty(kOriginalRemoteFileProperty, _originalRemoteFile);
 
     connect(networkReply, &QNetworkReply::downloadProgress, this, &QGCFileDownload::downloadProgress);
     connect(networkReply, &QNetworkReply::finished, this, &QGCFileDownload::_downloadFinished);
@@ -71,6 +75,7 @@ bool QGCFileDownload::download(const QString& remoteFile, const QVector<QPair<QN
 void QGCFileDownload::_downloadFinished(void)
 {
     QNetworkReply* reply = qobject_cast<QNetworkReply*>(QObject::sender());
+    const QString originalRemoteFile = reply->property(kOriginalRemoteFileProperty).toString();
 
     // When an error occurs or the user cancels the download, we still end up here. So bail out in
     // those cases.
@@ -83,6 +88,7 @@ void QGCFileDownload::_downloadFinished(void)
     QVariant redirectionTarget = reply->attribute(QNetworkRequest::RedirectionTargetAttribute);
     if (!redirectionTarget.isNull()) {
         QUrl redirectUrl = reply->url().resolved(redirectionTarget.toUrl());
+        _originalRemoteFile = originalRemoteFile;
         download(redirectUrl.toString(), _requestAttributes, true /* redirect */);
         reply->deleteLater();
         return;
@@ -106,7 +112,7 @@ void QGCFileDownload::_downloadFinished(void)
     if (downloadFilename.isEmpty()) {
         downloadFilename = QStandardPaths::writableLocation(QStandardPaths::DownloadLocation);
         if (downloadFilename.isEmpty()) {
-            emit downloadComplete(_originalRemoteFile, QString(), tr("Unabled to find writable download location. Tried downloads and temp directory."));
+            emit downloadComplete(originalRemoteFile, QString(), tr("Unabled to find writable download location. Tried downloads and temp directory."));
             return;
         }
     }
@@ -116,18 +122,18 @@ void QGCFileDownload::_downloadFinished(void)
         // Store downloaded file in download location
         QFile file(downloadFilename);
         if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
-            emit downloadComplete(_originalRemoteFile, downloadFilename, tr("Could not save downloaded file to %1. Error: %2").arg(downloadFilename).arg(file.errorString()));
+            emit downloadComplete(originalRemoteFile, downloadFilename, tr("Could not save downloaded file to %1. Error: %2").arg(downloadFilename).arg(file.errorString()));
             return;
         }
 
         file.write(reply->readAll());
         file.close();
 
-        emit downloadComplete(_originalRemoteFile, downloadFilename, QString());
+        emit downloadComplete(originalRemoteFile, downloadFilename, QString());
     } else {
         QString errorMsg = "Internal error";
         qWarning() << errorMsg;
-        emit downloadComplete(_originalRemoteFile, downloadFilename, errorMsg);
+        emit downloadComplete(originalRemoteFile, downloadFilename, errorMsg);
     }
 
     reply->deleteLater();
@@ -148,7 +154,8 @@ void QGCFileDownload::_downloadError(QNetworkReply::NetworkError code)
         errorMsg = tr("Error during download. Error: %1").arg(code);
     }
 
-    emit downloadComplete(_originalRemoteFile, QString(), errorMsg);
+    QNetworkReply* reply = qobject_cast<QNetworkReply*>(QObject::sender());
+    emit downloadComplete(reply->property(kOriginalRemoteFileProperty).toString(), QString(), errorMsg);
 }
 
 void QGCFileDownload::setIgnoreSSLErrorsIfNeeded(QNetworkReply& networkReply)
@@ -209,6 +209,9 @@ void QmlObjectListModel::insert(int i, QList<QObject*> objects)
     if (i < 0 || i > _objectList.count()) {
         qWarning() << "Invalid index index:count" << i << _objectList.count();
     }
+    if (objects.isEmpty()) {
+        return;
+    }
 
     int j = i;
     for (QObject* object: objects) {
@@ -67,6 +67,7 @@ destroyMapEngine()
 //-----------------------------------------------------------------------------
 QGCMapEngine::QGCMapEngine()
     : _urlFactory(new UrlFactory())
+    , _tileDownloadScheduler(new QGCTileDownloadScheduler(this))
 #ifdef WE_ARE_KOSHER
     //-- TODO: Get proper version
     #if defined Q_OS_MAC
@@ -94,6 +95,7 @@ QGCMapEngine::QGCMapEngine()
     qRegisterMetaType<QGCMapTask::TaskType>();
     qRegisterMetaType<QGCTile>();
     qRegisterMetaType<QList<QGCTile*>>();
+    qRegisterMetaType<QList<quint64>>();
     connect(&_worker, &QGCCacheWorker::updateTotals,   this, &QGCMapEngine::_updateTotals);
     connect(&_worker, &QGCCacheWorker::internetStatus, this, &QGCMapEngine::_internetStatus);
 }
@@ -202,43 +204,78 @@ QGCMapEngine::addTask(QGCMapTask* task)
 void
 QGCMapEngine::cacheTile(const QString& type, int x, int y, int z, const QByteArray& image, const QString &format, qulonglong set)
 {
-    QString hash = getTileHash(type, x, y, z);
-    cacheTile(type, hash, image, format, set);
+    cacheTile(type, getTileKey(type, x, y, z), image, format, set);
 }
 
 //-----------------------------------------------------------------------------
 void
-QGCMapEngine::cacheTile(const QString& type, const QString& hash, const QByteArray& image, const QString& format, qulonglong set)
+QGCMapEngine::cacheTile(const QString& type, quint64 key, const QByteArray& image, const QString& format, qulonglong set)
 {
     AppSettings* appSettings = qgcApp()->toolbox()->settingsManager()->appSettings();
     //-- If we are allowed to persist data, save tile to cache
     if(!appSettings->disableAllPersistence()->rawValue().toBool()) {
-        QGCSaveTileTask* task = new QGCSaveTileTask(new QGCCacheTile(hash, image, format, type, set));
+        QGCSaveTileTask* task = new QGCSaveTileTask(new QGCCacheTile(key, image, format, type, set));
         _worker.enqueueTask(task);
     }
 }
 
 //-----------------------------------------------------------------------------
-QString
-QGCMapEngine::getTileHash(const QString& type, int x, int y, int z)
+//-- Tile keys are laid out as | 16 bit provider code | 47 bit tile index |, where the tile index numbers all tiles
+//   of all zoom levels (up to MAX_MAP_ZOOM) consecutively, from zoom level 0 up.
+//   Elevation providers use a flat lat/lon grid whose x and y do not depend on the zoom level and exceed the quadtree
+//   range of a low zoom level (36000 columns at z=1), so their index is | y | 16 bit x | instead.
+static const int kElevationTileXBits = 16;
+
+quint64
+QGCMapEngine::getTileKey(const QString& type, int x, int y, int z)
 {
-    return QString::asprintf("%010d%08d%08d%03d", getQGCMapEngine()->urlFactory()->getIdFromType(type), x, y, z);
+    UrlFactory* urlFactory = getQGCMapEngine()->urlFactory();
+    quint64 index;
+    if(urlFactory->isElevation(type)) {
+        Q_ASSERT(x >= 0 && x < (1 << kElevationTileXBits));
+        index = (static_cast<quint64>(y) << kElevationTileXBits) | static_cast<quint64>(x);
+    } else {
+        const quint64 zoomOffset = ((Q_UINT64_C(1) << (2 * z)) - 1) / 3;
+        index = zoomOffset + (static_cast<quint64>(y) << z) + static_cast<quint64>(x);
+    }
+    return (static_cast<quint64>(urlFactory->getCodeFromType(type)) << 47) | index;
+}
+
+//-----------------------------------------------------------------------------
+bool
+QGCMapEngine::getTileFromKey(quint64 key, int& x, int& y, int& z)
+{
+    const quint64 index = key & ((Q_UINT64_C(1) << 47) - 1);
+    if(getQGCMapEngine()->urlFactory()->isElevation(getQGCMapEngine()->tileKeyToType(key))) {
+        x = static_cast<int>(index & ((Q_UINT64_C(1) << kElevationTileXBits) - 1));
+        y = static_cast<int>(index >> kElevationTileXBits);
+        z = 1;
+        return true;
+    }
+    for(z = 0; z <= MAX_MAP_ZOOM; z++) {
+        const quint64 zoomOffset = ((Q_UINT64_C(1) << (2 * z)) - 1) / 3;
+        if(index < zoomOffset + (Q_UINT64_C(1) << (2 * z))) {
+            const quint64 tile = index - zoomOffset;
+            y = static_cast<int>(tile >> z);
+            x = static_cast<int>(tile & ((Q_UINT64_C(1) << z) - 1));
+            return true;
+        }
+    }
+    return false;
 }
 
 //-----------------------------------------------------------------------------
 QString
-QGCMapEngine::hashToType(const QString& hash)
+QGCMapEngine::tileKeyToType(quint64 key)
 {
-    QString type = hash.mid(0,10);
-    return urlFactory()->getTypeFromId(type.toInt());
+    return urlFactory()->getTypeFromCode(static_cast<quint16>(key >> 47));
 }
 
 //-----------------------------------------------------------------------------
 	QGCFetchTileTask*
 QGCMapEngine::createFetchTileTask(const QString& type, int x, int y, int z)
 {
-	QString hash = getTileHash(type, x, y, z);
-	QGCFetchTileTask* task = new QGCFetchTileTask(hash);
+	QGCFetchTileTask* task = new QGCFetchTileTask(getTileKey(type, x, y, z));
 	return task;
 }
 
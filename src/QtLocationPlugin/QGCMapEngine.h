@@ -24,6 +24,7 @@
 #include "QGCMapUrlEngine.h"
 #include "QGCMapEngineData.h"
 #include "QGCTileCacheWorker.h"
+#include "QGCTileDownloadScheduler.h"
 
 
 //-----------------------------------------------------------------------------
@@ -37,12 +38,12 @@ public:
     void                        init                ();
     void                        addTask             (QGCMapTask *task);
     void                        cacheTile           (const QString& type, int x, int y, int z, const QByteArray& image, const QString& format, qulonglong set = UINT64_MAX);
-    void                        cacheTile           (const QString& type, const QString& hash, const QByteArray& image, const QString& format, qulonglong set = UINT64_MAX);
+    void                        cacheTile           (const QString& type, quint64 key, const QByteArray& image, const QString& format, qulonglong set = UINT64_MAX);
     QGCFetchTileTask*           createFetchTileTask (const QString& type, int x, int y, int z);
     QStringList                 getMapNameList      ();
     const QString               userAgent           () { return _userAgent; }
     void                        setUserAgent        (const QString& ua) { _userAgent = ua; }
-    QString                     hashToType          (const QString& hash);
+    QString                     tileKeyToType       (quint64 key);
     quint32                     getMaxDiskCache     ();
     void                        setMaxDiskCache     (quint32 size);
     quint32                     getMaxMemCache      ();
@@ -54,10 +55,12 @@ public:
     bool                        isInternetActive    () const{ return _isInternetActive; }
 
     UrlFactory*                 urlFactory          () { return _urlFactory; }
+    QGCTileDownloadScheduler*   tileDownloadScheduler() { return _tileDownloadScheduler; }
 
     //-- Tile Math
     static QGCTileSet           getTileCount        (int zoom, double topleftLon, double topleftLat, double bottomRightLon, double bottomRightLat, const QString& mapType);
-    static QString              getTileHash         (const QString& type, int x, int y, int z);
+    static quint64              getTileKey          (const QString& type, int x, int y, int z);
+    static bool                 getTileFromKey      (quint64 key, int& x, int& y, int& z);
     static QString              getTypeFromName     (const QString& name);
     static QString              bigSizeToString     (quint64 size);
     static QString              storageFreeSizeToString(quint64 size_MB);
@@ -83,6 +86,7 @@ private:
     QString                 _cachePath;
     QString                 _cacheFile;
     UrlFactory*             _urlFactory;
+    QGCTileDownloadScheduler* _tileDownloadScheduler;
     QString                 _userAgent;
     quint32                 _maxDiskCache;
     quint32                 _maxMemCache;
@@ -37,6 +37,7 @@ public:
         , _y(0)
         , _z(0)
         , _set(UINT64_MAX)
+        , _key(0)
         , _type("Invalid")
     {
     }
@@ -52,14 +53,14 @@ public:
     int                 y           () const { return _y; }
     int                 z           () const { return _z; }
     qulonglong          set         () const { return _set;  }
-    const QString       hash        () const { return _hash; }
+    quint64             key         () const { return _key; }
     QString type        () const { return _type; }
 
     void                setX        (int x) { _x = x; }
     void                setY        (int y) { _y = y; }
     void                setZ        (int z) { _z = z; }
     void                setTileSet  (qulonglong set) { _set = set;  }
-    void                setHash     (const QString& hash) { _hash = hash; }
+    void                setKey      (quint64 key) { _key = key; }
     void                setType     (QString type) { _type = type; }
 
 private:
@@ -67,7 +68,7 @@ private:
     int         _y;
     int         _z;
     qulonglong  _set;
-    QString     _hash;
+    quint64     _key;
     QString _type;
 };
 
@@ -76,27 +77,27 @@ class QGCCacheTile : public QObject
 {
     Q_OBJECT
 public:
-    QGCCacheTile    (const QString& hash, const QByteArray& img, const QString& format, const QString& type, qulonglong set = UINT64_MAX)
+    QGCCacheTile    (quint64 key, const QByteArray& img, const QString& format, const QString& type, qulonglong set = UINT64_MAX)
         : _set(set)
-        , _hash(hash)
+        , _key(key)
         , _img(img)
         , _format(format)
         , _type(type)
     {
     }
-    QGCCacheTile    (const QString hash, qulonglong set)
+    QGCCacheTile    (quint64 key, qulonglong set)
         : _set(set)
-        , _hash(hash)
+        , _key(key)
     {
     }
     qulonglong          set     () const{ return _set;   }
-    QString             hash    () { return _hash;  }
+    quint64             key     () const{ return _key;   }
     QByteArray          img     () { return _img;   }
     QString             format  () { return _format;}
     QString type    () { return _type; }
 private:
     qulonglong  _set;
-    QString     _hash;
+    quint64     _key;
     QByteArray  _img;
     QString     _format;
     QString _type;
@@ -122,7 +123,8 @@ public:
         taskPruneCache,
         taskReset,
         taskExport,
-        taskImport
+        taskImport,
+        taskFindMissingTiles
     };
 
     QGCMapTask(TaskType type)
@@ -208,9 +210,9 @@ class QGCFetchTileTask : public QGCMapTask
 {
     Q_OBJECT
 public:
-    QGCFetchTileTask(const QString hash)
+    QGCFetchTileTask(quint64 key)
         : QGCMapTask(QGCMapTask::taskFetchTile)
-        , _hash(hash)
+        , _key(key)
     {}
 
     ~QGCFetchTileTask()
@@ -222,13 +224,13 @@ public:
         emit tileFetched(tile);
     }
 
-    QString         hash() { return _hash; }
+    quint64         key() const{ return _key; }
 
 signals:
     void            tileFetched     (QGCCacheTile* tile);
 
 private:
-    QString         _hash;
+    quint64         _key;
 };
 
 //-----------------------------------------------------------------------------
@@ -285,21 +287,49 @@ class QGCUpdateTileDownloadStateTask : public QGCMapTask
 {
     Q_OBJECT
 public:
-    QGCUpdateTileDownloadStateTask(qulonglong setID, QGCTile::TyleState state, const QString& hash)
+    //-- Pass as key to update the state of all tiles of the set
+    static const quint64 kAllTiles = UINT64_MAX;
+
+    QGCUpdateTileDownloadStateTask(qulonglong setID, QGCTile::TyleState state, quint64 key)
         : QGCMapTask(QGCMapTask::taskUpdateTileDownloadState)
         , _setID(setID)
         , _state(state)
-        , _hash(hash)
+        , _key(key)
     {}
 
-    QString             hash    () { return _hash; }
+    quint64             key     () const{ return _key; }
     qulonglong          setID   () const{ return _setID; }
     QGCTile::TyleState  state   () { return _state; }
 
 private:
     qulonglong          _setID;
     QGCTile::TyleState  _state;
-    QString             _hash;
+    quint64             _key;
+};
+
+//-----------------------------------------------------------------------------
+class QGCFindMissingTilesTask : public QGCMapTask
+{
+    Q_OBJECT
+public:
+    QGCFindMissingTilesTask(const QList<quint64>& keys)
+        : QGCMapTask(QGCMapTask::taskFindMissingTiles)
+        , _keys(keys)
+    {}
+
+    const QList<quint64>& keys() const{ return _keys; }
+
+    void setMissingTilesFound(QList<quint64> missingKeys, quint64 cachedSize)
+    {
+        emit missingTilesFound(missingKeys, cachedSize);
+    }
+
+signals:
+    //-- cachedSize is the total size of the tiles which are already in the cache
+    void            missingTilesFound   (QList<quint64> missingKeys, quint64 cachedSize);
+
+private:
+    QList<quint64>  _keys;
 };
 
 //-----------------------------------------------------------------------------
@@ -430,10 +460,11 @@ class QGCImportTileTask : public QGCMapTask
 {
     Q_OBJECT
 public:
-    QGCImportTileTask(QString path, bool replace)
+    QGCImportTileTask(QString path, bool replace, QString mapType = QString())
         : QGCMapTask(QGCMapTask::taskImport)
         , _path(path)
         , _replace(replace)
+        , _mapType(mapType)
     {}
 
     ~QGCImportTileTask()
@@ -442,6 +473,7 @@ public:
 
     QString                    path     () { return _path; }
     bool                       replace  () const{ return _replace; }
+    QString                    mapType  () { return _mapType; }
 
     void setImportCompleted()
     {
@@ -456,6 +488,7 @@ public:
 private:
     QString                     _path;
     bool                        _replace;
+    QString                     _mapType;
 
 signals:
     void actionCompleted        ();
@@ -19,7 +19,6 @@
 #include "QGCMapEngine.h"
 #include "QGCMapTileSet.h"
 #include "QGCMapEngineManager.h"
-#include "QGCFileDownload.h"
 #include "TerrainTile.h"
 
 #include <QSettings>
@@ -49,7 +48,6 @@ QGCCachedTileSet::QGCCachedTileSet(const QString& name)
     , _downloading(false)
     , _id(0)
     , _type("Invalid")
-    , _networkManager(nullptr)
     , _errorCount(0)
     , _noMoreTiles(false)
     , _batchRequested(false)
@@ -62,8 +60,8 @@ QGCCachedTileSet::QGCCachedTileSet(const QString& name)
 //-----------------------------------------------------------------------------
 QGCCachedTileSet::~QGCCachedTileSet()
 {
-    delete _networkManager;
-    _networkManager = nullptr;
+    qDeleteAll(_downloads);
+    _downloads.clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -155,7 +153,7 @@ void
 QGCCachedTileSet::resumeDownloadTask()
 {
     //-- Reset and download error flag (for all tiles)
-    QGCUpdateTileDownloadStateTask* task = new QGCUpdateTileDownloadStateTask(_id, QGCTile::StatePending, "*");
+    QGCUpdateTileDownloadStateTask* task = new QGCUpdateTileDownloadStateTask(_id, QGCTile::StatePending, QGCUpdateTileDownloadStateTask::kAllTiles);
     getQGCMapEngine()->addTask(task);
     //-- Start download
     createDownloadTask();
@@ -184,10 +182,6 @@ QGCCachedTileSet::_tileListFetched(QList<QGCTile *> tiles)
         _doneWithDownload();
         return;
     }
-    //-- If this is the first time, create Network Manager
-    if (!_networkManager) {
-        _networkManager = new QNetworkAccessManager(this);
-    }
     //-- Add tiles to the list
     _tilesToDownload += tiles;
     //-- Kick downloads
@@ -235,28 +229,16 @@ void QGCCachedTileSet::_prepareDownload()
         }
         return;
     }
-    //-- Prepare queue (QNetworkAccessManager has a limit for concurrent downloads)
-    for(int i = _replies.count(); i < QGCMapEngine::concurrentDownloads(_type); i++) {
+    //-- Only keep a provider's worth of tiles in the shared scheduler so other tile sets and the visible map aren't starved
+    QGCTileDownloadScheduler* scheduler = getQGCMapEngine()->tileDownloadScheduler();
+    for(int i = _downloads.count(); i < QGCMapEngine::concurrentDownloads(_type); i++) {
         if(_tilesToDownload.count()) {
             QGCTile* tile = _tilesToDownload.first();
             _tilesToDownload.removeFirst();
-            QNetworkRequest request = getQGCMapEngine()->urlFactory()->getTileURL(tile->type(), tile->x(), tile->y(), tile->z(), _networkManager);
-            request.setAttribute(QNetworkRequest::User, tile->hash());
-#if !defined(__mobile__)
-            QNetworkProxy proxy = _networkManager->proxy();
-            QNetworkProxy tProxy;
-            tProxy.setType(QNetworkProxy::DefaultProxy);
-            _networkManager->setProxy(tProxy);
-#endif
-            QNetworkReply* reply = _networkManager->get(request);
-            reply->setParent(0);
-            QGCFileDownload::setIgnoreSSLErrorsIfNeeded(*reply);
-            connect(reply, &QNetworkReply::finished, this, &QGCCachedTileSet::_networkReplyFinished);
-            connect(reply, &QNetworkReply::errorOccurred, this, &QGCCachedTileSet::_networkReplyError);
-            _replies.insert(tile->hash(), reply);
-#if !defined(__mobile__)
-            _networkManager->setProxy(proxy);
-#endif
+            QNetworkRequest request = getQGCMapEngine()->urlFactory()->getTileURL(tile->type(), tile->x(), tile->y(), tile->z(), scheduler->networkManager());
+            QGCTileDownload* download = scheduler->download(tile->type(), tile->key(), request, QGCTileDownloadScheduler::PriorityBulk);
+            connect(download, &QGCTileDownload::finished, this, &QGCCachedTileSet::_tileDownloadFinished);
+            _downloads.insert(tile->key(), download);
             delete tile;
             //-- Refill queue if running low
             if(!_batchRequested && !_noMoreTiles && _tilesToDownload.count() < (QGCMapEngine::concurrentDownloads(_type) * 10)) {
@@ -269,90 +251,58 @@ void QGCCachedTileSet::_prepareDownload()
 
 //-----------------------------------------------------------------------------
 void
-QGCCachedTileSet::_networkReplyFinished()
+QGCCachedTileSet::_tileDownloadFinished(QByteArray image, QNetworkReply::NetworkError error, QString errorString)
 {
-    //-- Figure out which reply this is
-    QNetworkReply* reply = qobject_cast<QNetworkReply*>(QObject::sender());
-    if(!reply) {
-        qWarning() << "QGCMapEngineManager::networkReplyFinished() NULL Reply";
+    //-- Figure out which download this is
+    QGCTileDownload* download = qobject_cast<QGCTileDownload*>(QObject::sender());
+    if(!download) {
+        qWarning() << "QGCCachedTileSet::_tileDownloadFinished() NULL Download";
         return;
     }
-    if (reply->error() == QNetworkReply::NoError) {
-        //-- Get tile hash
-        const QString hash = reply->request().attribute(QNetworkRequest::User).toString();
-        if(!hash.isEmpty()) {
-            if(_replies.contains(hash)) {
-                _replies.remove(hash);
-            } else {
-                qWarning() << "QGCMapEngineManager::networkReplyFinished() Reply not in list: " << hash;
-            }
-            qCDebug(QGCCachedTileSetLog) << "Tile fetched" << hash;
-            QByteArray image = reply->readAll();
-            QString type = getQGCMapEngine()->hashToType(hash);
-            if (type == UrlFactory::kCopernicusElevationProviderKey) {
-                image = TerrainTile::serializeFromAirMapJson(image);
-            }
-            QString format = getQGCMapEngine()->urlFactory()->getImageFormat(type, image);
-            if(!format.isEmpty()) {
-                //-- Cache tile
-                getQGCMapEngine()->cacheTile(type, hash, image, format, _id);
-                QGCUpdateTileDownloadStateTask* task = new QGCUpdateTileDownloadStateTask(_id, QGCTile::StateComplete, hash);
-                getQGCMapEngine()->addTask(task);
-                //-- Updated cached (downloaded) data
-                _savedTileSize += image.size();
-                _savedTileCount++;
-                emit savedTileSizeChanged();
-                emit savedTileCountChanged();
-                //-- Update estimate
-                if(_savedTileCount % 10 == 0) {
-                    quint32 avg = _savedTileSize / _savedTileCount;
-                    _totalTileSize  = avg * _totalTileCount;
-                    _uniqueTileSize = avg * _uniqueTileCount;
-                    emit totalTilesSizeChanged();
-                    emit uniqueTileSizeChanged();
-                }
-            }
-            //-- Setup a new download
-            _prepareDownload();
-        } else {
-            qWarning() << "QGCMapEngineManager::networkReplyFinished() Empty Hash";
-        }
+    download->deleteLater();
+    const quint64 key = download->key();
+    if(!_downloads.remove(key)) {
+        qWarning() << "QGCCachedTileSet::_tileDownloadFinished() Download not in list: " << key;
     }
-    reply->deleteLater();
-}
-
-//-----------------------------------------------------------------------------
-void
-QGCCachedTileSet::_networkReplyError(QNetworkReply::NetworkError error)
-{
-    //-- Figure out which reply this is
-    QNetworkReply* reply = qobject_cast<QNetworkReply*>(QObject::sender());
-    if (!reply) {
-        return;
-    }
-    //-- Update error count
-    _errorCount++;
-    emit errorCountChanged();
-    //-- Get tile hash
-    QString hash = reply->request().attribute(QNetworkRequest::User).toString();
-    qCDebug(QGCCachedTileSetLog) << "Error fetching tile" << reply->errorString();
-    if(!hash.isEmpty()) {
-        if(_replies.contains(hash)) {
-            _replies.remove(hash);
-        } else {
-            qWarning() << "QGCMapEngineManager::networkReplyError() Reply not in list: " << hash;
+    if (error == QNetworkReply::NoError) {
+        qCDebug(QGCCachedTileSetLog) << "Tile fetched" << key;
+        QString type = getQGCMapEngine()->tileKeyToType(key);
+        if (type == UrlFactory::kCopernicusElevationProviderKey) {
+            image = TerrainTile::serializeFromAirMapJson(image);
         }
+        QString format = getQGCMapEngine()->urlFactory()->getImageFormat(type, image);
+        if(!format.isEmpty()) {
+            //-- Cache tile
+            getQGCMapEngine()->cacheTile(type, key, image, format, _id);
+            QGCUpdateTileDownloadStateTask* task = new QGCUpdateTileDownloadStateTask(_id, QGCTile::StateComplete, key);
+            getQGCMapEngine()->addTask(task);
+            //-- Updated cached (downloaded) data
+            _savedTileSize += image.size();
+            _savedTileCount++;
+            emit savedTileSizeChanged();
+            emit savedTileCountChanged();
+            //-- Update estimate
+            if(_savedTileCount % 10 == 0) {
+                quint32 avg = _savedTileSize / _savedTileCount;
+                _totalTileSize  = avg * _totalTileCount;
+                _uniqueTileSize = avg * _uniqueTileCount;
+                emit totalTilesSizeChanged();
+                emit uniqueTileSizeChanged();
+            }
+        }
+    } else {
+        //-- Update error count
+        _errorCount++;
+        emit errorCountChanged();
+        qCDebug(QGCCachedTileSetLog) << "Error fetching tile" << errorString;
         if (error != QNetworkReply::OperationCanceledError) {
-            qWarning() << "QGCMapEngineManager::networkReplyError() Error:" << reply->errorString();
+            qWarning() << "QGCCachedTileSet::_tileDownloadFinished() Error:" << errorString;
         }
-        QGCUpdateTileDownloadStateTask* task = new QGCUpdateTileDownloadStateTask(_id, QGCTile::StateError, hash);
+        QGCUpdateTileDownloadStateTask* task = new QGCUpdateTileDownloadStateTask(_id, QGCTile::StateError, key);
         getQGCMapEngine()->addTask(task);
-    } else {
-        qWarning() << "QGCMapEngineManager::networkReplyError() Empty Hash";
     }
     //-- Setup a new download
     _prepareDownload();
-    reply->deleteLater();
 }
 
 //-----------------------------------------------------------------------------
@@ -32,6 +32,7 @@
 Q_DECLARE_LOGGING_CATEGORY(QGCCachedTileSetLog)
 
 class QGCTile;
+class QGCTileDownload;
 class QGCMapEngineManager;
 
 //-----------------------------------------------------------------------------
@@ -151,8 +152,7 @@ signals:
 
 private slots:
     void _tileListFetched               (QList<QGCTile*> tiles);
-    void _networkReplyFinished          ();
-    void _networkReplyError             (QNetworkReply::NetworkError error);
+    void _tileDownloadFinished          (QByteArray image, QNetworkReply::NetworkError error, QString errorString);
 
 private:
     void        _prepareDownload        ();
@@ -179,8 +179,7 @@ private:
     QDateTime   _creationDate;
     quint64     _id;
     QString _type;
-    QNetworkAccessManager*  _networkManager;
-    QHash<QString, QNetworkReply*> _replies;
+    QHash<quint64, QGCTileDownload*> _downloads;
     quint32     _errorCount;
     //-- Tile download
     QList<QGCTile *> _tilesToDownload;
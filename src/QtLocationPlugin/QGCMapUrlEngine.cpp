@@ -89,10 +89,20 @@ UrlFactory::UrlFactory() : _timeout(5 * 1000) {
     _providersTable["LINZ Basemap"] = new LINZBasemapMapProvider(this);
 
     _providersTable["CustomURL Custom"] = new CustomURLMapProvider(this);
+
+    const QStringList types = _providersTable.keys();
+    for (const QString& type : types) {
+        registerProvider(type, _providersTable[type]);
+    }
 }
 
 void UrlFactory::registerProvider(QString name, MapProvider* provider) {
     _providersTable[name] = provider;
+    quint16 code = getCodeFromType(name);
+    if (_providerCodes.contains(code) && _providerCodes[code] != name) {
+        qWarning() << "UrlFactory::registerProvider code collision" << name << _providerCodes[code];
+    }
+    _providerCodes[code] = name;
 }
 
 //-----------------------------------------------------------------------------
@@ -186,6 +196,27 @@ UrlFactory::getIdFromType(const QString& type)
     return (int)(qHash(type)>>1);
 }
 
+//-----------------------------------------------------------------------------
+// Unlike getIdFromType() this is stable across platforms and Qt versions, it is
+// used as part of the tile keys persisted in the tile cache.
+quint16
+UrlFactory::getCodeFromType(const QString& type)
+{
+    const QByteArray name = type.toUtf8();
+    return qChecksum(name.constData(), static_cast<uint>(name.length()));
+}
+
+//-----------------------------------------------------------------------------
+QString
+UrlFactory::getTypeFromCode(quint16 code)
+{
+    QString type = _providerCodes.value(code);
+    if (type.isEmpty()) {
+        qCDebug(QGCMapUrlEngineLog) << "getTypeFromCode : code not found" << code;
+    }
+    return type;
+}
+
 //-----------------------------------------------------------------------------
 int
 UrlFactory::long2tileX(const QString& mapType, double lon, int z)
@@ -211,3 +242,8 @@ UrlFactory::getTileCount(int zoom, double topleftLon, double topleftLat, double
 bool UrlFactory::isElevation(int mapId){
     return _providersTable[getTypeFromId(mapId)]->_isElevationProvider();
 }
+
+bool UrlFactory::isElevation(const QString& type){
+    MapProvider* provider = _providersTable.value(type, nullptr);
+    return provider && provider->_isElevationProvider();
+}
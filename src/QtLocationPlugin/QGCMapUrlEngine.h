@@ -50,6 +50,8 @@ public:
 
     int getIdFromType(const QString& type);
     QString getTypeFromId(int id);
+    quint16 getCodeFromType(const QString& type);
+    QString getTypeFromCode(quint16 code);
     MapProvider* getMapProviderFromId(int id);
 
     QGCTileSet getTileCount(int zoom, double topleftLon, double topleftLat,
@@ -57,10 +59,12 @@ public:
                             const QString& mapType);
 
     bool isElevation(int mapId);
+    bool isElevation(const QString& type);
 
   private:
     int             _timeout;
     QHash<QString, MapProvider*> _providersTable;
+    QHash<quint16, QString> _providerCodes;
     void registerProvider(QString Name, MapProvider* provider);
 
 };
@@ -22,10 +22,13 @@
 #include <QVariant>
 #include <QtSql/QSqlQuery>
 #include <QSqlError>
+#include <QSqlRecord>
 #include <QDebug>
 #include <QDateTime>
 #include <QApplication>
 #include <QFile>
+#include <QFileInfo>
+#include <QtMath>
 #include <QSettings>
 
 #include "time.h"
@@ -33,6 +36,8 @@
 static const char*      kDefaultSet     = "Default Tile Set";
 static const QString    kSession        = QStringLiteral("QGeoTileWorkerSession");
 static const QString    kExportSession  = QStringLiteral("QGeoTileExportSession");
+static const char*      kMBTilesExtension = ".mbtiles";
+static const char*      kMBTilesMapType = "qgc_map_type";
 
 QGC_LOGGING_CATEGORY(QGCTileCacheLog, "QGCTileCacheLog")
 
@@ -41,6 +46,91 @@ QGC_LOGGING_CATEGORY(QGCTileCacheLog, "QGCTileCacheLog")
 #define LONG_TIMEOUT        5
 #define SHORT_TIMEOUT       2
 
+//-- Maximum number of cached tiles written within a single transaction
+
+#define MAX_WRITE_BATCH     256
+
+//-- Maximum number of tile hits collected before their access time is written
+
+#define MAX_ACCESS_BATCH    512
+
+//-- Number of least recently used tiles evicted per statement when pruning
+
+#define PRUNE_BATCH         128
+
+//-- Statements which run once per tile are prepared once and reused
+
+enum {
+    kInsertTileQuery,
+    kInsertSetTileQuery,
+    kFindTileQuery,
+    kGetTileQuery,
+    kInsertTileDownloadQuery,
+    kUpdateTileDownloadStateQuery,
+    kTileSetsQuery,
+};
+
+static const char* kPreparedQueries[] = {
+    "INSERT INTO Tiles(tileKey, format, tile, size, type, date, access) VALUES(?, ?, ?, ?, ?, ?, ?)",
+    "INSERT INTO SetTiles(tileID, setID) VALUES(?, ?)",
+    "SELECT tileID, size FROM Tiles WHERE tileKey = ?",
+    "SELECT tile, format, type, tileID FROM Tiles WHERE tileKey = ?",
+    "INSERT OR IGNORE INTO TilesDownload(setID, tileKey, type, x, y, z, state) VALUES(?, ?, ?, ?, ?, ?, ?)",
+    "UPDATE TilesDownload SET state = ? WHERE setID = ? AND tileKey = ?",
+    "SELECT setID FROM SetTiles WHERE tileID = ?",
+};
+
+//-- Tables holding tile keys, the table name is an argument so they can also be created while migrating older caches
+
+static const char* kCreateTilesTable =
+    "CREATE TABLE IF NOT EXISTS %1 ("
+    "tileID INTEGER PRIMARY KEY NOT NULL, "
+    "tileKey INTEGER NOT NULL UNIQUE, "
+    "format TEXT NOT NULL, "
+    "tile BLOB NULL, "
+    "size INTEGER, "
+    "type INTEGER, "
+    "date INTEGER DEFAULT 0, "
+    "access INTEGER DEFAULT 0)";
+
+static const char* kCreateTilesDownloadTable =
+    "CREATE TABLE IF NOT EXISTS %1 ("
+    "setID INTEGER, "
+    "tileKey INTEGER NOT NULL UNIQUE, "
+    "type INTEGER, "
+    "x INTEGER, "
+    "y INTEGER, "
+    "z INTEGER, "
+    "state INTEGER DEFAULT 0)";
+
+//-----------------------------------------------------------------------------
+//-- Converts the string hash ("%010d%08d%08d%03d" of map id, x, y, z) used by older caches into a tile key.
+//   Returns 0 if the map type is no longer known.
+static quint64
+tileKeyFromHash(const QString& hash)
+{
+    const QString type = getQGCMapEngine()->urlFactory()->getTypeFromId(hash.mid(0, 10).toInt());
+    if(type.isEmpty() || hash.length() != 29) {
+        return 0;
+    }
+    return QGCMapEngine::getTileKey(type, hash.mid(10, 8).toInt(), hash.mid(18, 8).toInt(), hash.mid(26, 3).toInt());
+}
+
+//-----------------------------------------------------------------------------
+static bool
+tableHasColumn(QSqlDatabase& db, const QString& table, const QString& column)
+{
+    QSqlQuery query(db);
+    if(query.exec(QString("PRAGMA table_info(%1)").arg(table))) {
+        while(query.next()) {
+            if(query.value("name").toString() == column) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 //-----------------------------------------------------------------------------
 QGCCacheWorker::QGCCacheWorker()
     : _db(nullptr)
@@ -54,6 +144,7 @@ QGCCacheWorker::QGCCacheWorker()
     , _lastUpdate(0)
     , _updateTimeout(SHORT_TIMEOUT)
     , _hostLookupID(0)
+    , _writeBatchCount(0)
 {
 }
 
@@ -119,6 +210,9 @@ QGCCacheWorker::run()
         _connectDB();
     }
     _deleteBingNoTileTiles();
+    if(_valid) {
+        _loadTotals();
+    }
     QMutexLocker lock(&_taskQueueMutex);
     while(true) {
         QGCMapTask* task;
@@ -127,11 +221,25 @@ QGCCacheWorker::run()
 
             // Don't need the lock while running the task.
             lock.unlock();
+            //-- Consecutive tile saves are grouped into a single transaction. Anything else runs outside of it.
+            if(task->type() != QGCMapTask::taskCacheTile) {
+                _commitWriteBatch();
+            }
             _runTask(task);
             lock.relock();
             task->deleteLater();
             //-- Check for update timeout
             size_t count = static_cast<size_t>(_taskQueue.count());
+            if(!count || _writeBatchCount >= MAX_WRITE_BATCH) {
+                lock.unlock();
+                _commitWriteBatch();
+                lock.relock();
+            }
+            if(!count || _accessedTiles.count() >= MAX_ACCESS_BATCH) {
+                lock.unlock();
+                _updateTileAccess();
+                lock.relock();
+            }
             if(count > 100) {
                 _updateTimeout = LONG_TIMEOUT;
             } else if(count < 25) {
@@ -157,6 +265,7 @@ QGCCacheWorker::run()
         }
     }
     lock.unlock();
+    _commitWriteBatch();
     _disconnectDB();
 }
 
@@ -203,6 +312,9 @@ QGCCacheWorker::_runTask(QGCMapTask *task)
         case QGCMapTask::taskImport:
             _importSets(task);
             return;
+        case QGCMapTask::taskFindMissingTiles:
+            _findMissingTiles(task);
+            return;
         case QGCMapTask::taskTestInternet:
             _testInternet();
             return;
@@ -232,13 +344,13 @@ QGCCacheWorker::_deleteBingNoTileTiles()
     QSqlQuery query(*_db);
     QString s;
     //-- Select tiles in default set only, sorted by oldest.
-    s = QString("SELECT tileID, tile, hash FROM Tiles WHERE LENGTH(tile) = %1").arg(noTileBytes.count());
+    s = QString("SELECT tileID, tile, tileKey FROM Tiles WHERE LENGTH(tile) = %1").arg(noTileBytes.count());
     QList<quint64> idsToDelete;
     if (query.exec(s)) {
         while(query.next()) {
             if (query.value(1).toByteArray() == noTileBytes) {
                 idsToDelete.append(query.value(0).toULongLong());
-                qCDebug(QGCTileCacheLog) << "_deleteBingNoTileTiles HASH:" << query.value(2).toString();
+                qCDebug(QGCTileCacheLog) << "_deleteBingNoTileTiles KEY:" << query.value(2).toULongLong();
             }
         }
         for (const quint64 tileId: idsToDelete) {
@@ -290,23 +402,32 @@ QGCCacheWorker::_saveTile(QGCMapTask *mtask)
 {
     if(_valid) {
         QGCSaveTileTask* task = static_cast<QGCSaveTileTask*>(mtask);
-        QSqlQuery query(*_db);
-        query.prepare("INSERT INTO Tiles(hash, format, tile, size, type, date) VALUES(?, ?, ?, ?, ?, ?)");
-        query.addBindValue(task->tile()->hash());
-        query.addBindValue(task->tile()->format());
-        query.addBindValue(task->tile()->img());
-        query.addBindValue(task->tile()->img().size());
-        query.addBindValue(task->tile()->type());
-        query.addBindValue(QDateTime::currentDateTime().toSecsSinceEpoch());
-        if(query.exec()) {
-            quint64 tileID = query.lastInsertId().toULongLong();
+        QSqlQuery* query    = _preparedQuery(kInsertTileQuery);
+        QSqlQuery* setQuery = _preparedQuery(kInsertSetTileQuery);
+        if(!query || !setQuery) {
+            qWarning() << "Map Cache SQL error (saveTile() prepare)";
+            return;
+        }
+        _beginWriteBatch();
+        query->bindValue(0, task->tile()->key());
+        query->bindValue(1, task->tile()->format());
+        query->bindValue(2, task->tile()->img());
+        query->bindValue(3, task->tile()->img().size());
+        query->bindValue(4, task->tile()->type());
+        const qint64 now = QDateTime::currentDateTime().toSecsSinceEpoch();
+        query->bindValue(5, now);
+        query->bindValue(6, now);
+        if(query->exec()) {
+            quint64 tileID = query->lastInsertId().toULongLong();
             quint64 setID = task->tile()->set() == UINT64_MAX ? _getDefaultTileSet() : task->tile()->set();
-            QString s = QString("INSERT INTO SetTiles(tileID, setID) VALUES(%1, %2)").arg(tileID).arg(setID);
-            query.prepare(s);
-            if(!query.exec()) {
-                qWarning() << "Map Cache SQL error (add tile into SetTiles):" << query.lastError().text();
+            setQuery->bindValue(0, tileID);
+            setQuery->bindValue(1, setID);
+            if(!setQuery->exec()) {
+                qWarning() << "Map Cache SQL error (add tile into SetTiles):" << setQuery->lastError().text();
+            } else {
+                _newTileAdded(setID, static_cast<quint64>(task->tile()->img().size()));
             }
-            qCDebug(QGCTileCacheLog) << "_saveTile() HASH:" << task->tile()->hash();
+            qCDebug(QGCTileCacheLog) << "_saveTile() KEY:" << task->tile()->key();
         } else {
             //-- Tile was already there.
             //   QtLocation some times requests the same tile twice in a row. The first is saved, the second is already there.
@@ -325,21 +446,25 @@ QGCCacheWorker::_getTile(QGCMapTask* mtask)
     }
     bool found = false;
     QGCFetchTileTask* task = static_cast<QGCFetchTileTask*>(mtask);
-    QSqlQuery query(*_db);
-    QString s = QString("SELECT tile, format, type FROM Tiles WHERE hash = \"%1\"").arg(task->hash());
-    if(query.exec(s)) {
-        if(query.next()) {
-            const QByteArray& arrray   = query.value(0).toByteArray();
-            const QString& format  = query.value(1).toString();
-            QString type = getQGCMapEngine()->urlFactory()->getTypeFromId(query.value(2).toInt());
-            qCDebug(QGCTileCacheLog) << "_getTile() (Found in DB) HASH:" << task->hash();
-            QGCCacheTile* tile = new QGCCacheTile(task->hash(), arrray, format, type);
+    QSqlQuery* query = _preparedQuery(kGetTileQuery);
+    if(query) {
+        query->bindValue(0, task->key());
+        if(query->exec() && query->next()) {
+            const QByteArray arrray = query->value(0).toByteArray();
+            const QString format    = query->value(1).toString();
+            QString type = getQGCMapEngine()->urlFactory()->getTypeFromId(query->value(2).toInt());
+            _accessedTiles.insert(query->value(3).toULongLong());
+            query->finish();
+            qCDebug(QGCTileCacheLog) << "_getTile() (Found in DB) KEY:" << task->key();
+            QGCCacheTile* tile = new QGCCacheTile(task->key(), arrray, format, type);
             task->setTileFetched(tile);
             found = true;
+        } else {
+            query->finish();
         }
     }
     if(!found) {
-        qCDebug(QGCTileCacheLog) << "_getTile() (NOT in DB) HASH:" << task->hash();
+        qCDebug(QGCTileCacheLog) << "_getTile() (NOT in DB) KEY:" << task->key();
         task->setError("Tile not in cache database");
     }
 }
@@ -393,86 +518,153 @@ QGCCacheWorker::_updateSetTotals(QGCCachedTileSet* set)
         set->setTotalTileSize(_defaultSize);
         return;
     }
-    QSqlQuery subquery(*_db);
-    QString sq = QString("SELECT COUNT(size), SUM(size) FROM Tiles A INNER JOIN SetTiles B on A.tileID = B.tileID WHERE B.setID = %1").arg(set->id());
-    qCDebug(QGCTileCacheLog) << "_updateSetTotals(): " << sq;
-    if(subquery.exec(sq)) {
-        if(subquery.next()) {
-            set->setSavedTileCount(subquery.value(0).toUInt());
-            set->setSavedTileSize(subquery.value(1).toULongLong());
-            qCDebug(QGCTileCacheLog) << "Set" << set->id() << "Totals:" << set->savedTileCount() << " " << set->savedTileSize() << "Expected: " << set->totalTileCount() << " " << set->totalTilesSize();
-            //-- Update (estimated) size
-            quint64 avg = getQGCMapEngine()->urlFactory()->averageSizeForType(set->type());
-            if(set->totalTileCount() <= set->savedTileCount()) {
-                //-- We're done so the saved size is the total size
-                set->setTotalTileSize(set->savedTileSize());
-            } else {
-                //-- Otherwise we need to estimate it.
-                if(set->savedTileCount() > 10 && set->savedTileSize()) {
-                    avg = set->savedTileSize() / set->savedTileCount();
-                }
-                set->setTotalTileSize(avg * set->totalTileCount());
-            }
-            //-- Now figure out the count for tiles unique to this set
-            quint32 ucount = 0;
-            quint64 usize  = 0;
-            sq = QString("SELECT COUNT(size), SUM(size) FROM Tiles WHERE tileID IN (SELECT A.tileID FROM SetTiles A join SetTiles B on A.tileID = B.tileID WHERE B.setID = %1 GROUP by A.tileID HAVING COUNT(A.tileID) = 1)").arg(set->id());
-            if(subquery.exec(sq)) {
-                if(subquery.next()) {
-                    //-- This is only accurate when all tiles are downloaded
-                    ucount = subquery.value(0).toUInt();
-                    usize  = subquery.value(1).toULongLong();
-                }
-            }
-            //-- If we haven't downloaded it all, estimate size of unique tiles
-            quint32 expectedUcount = set->totalTileCount() - set->savedTileCount();
-            if(!ucount) {
-                usize = expectedUcount * avg;
-            } else {
-                expectedUcount = ucount;
-            }
-            set->setUniqueTileCount(expectedUcount);
-            set->setUniqueTileSize(usize);
+    const SetTotals_t setTotals = _setTotals.value(set->id());
+    set->setSavedTileCount(setTotals.count);
+    set->setSavedTileSize(setTotals.size);
+    qCDebug(QGCTileCacheLog) << "Set" << set->id() << "Totals:" << set->savedTileCount() << " " << set->savedTileSize() << "Expected: " << set->totalTileCount() << " " << set->totalTilesSize();
+    //-- Update (estimated) size
+    quint64 avg = getQGCMapEngine()->urlFactory()->averageSizeForType(set->type());
+    if(set->totalTileCount() <= set->savedTileCount()) {
+        //-- We're done so the saved size is the total size
+        set->setTotalTileSize(set->savedTileSize());
+    } else {
+        //-- Otherwise we need to estimate it.
+        if(set->savedTileCount() > 10 && set->savedTileSize()) {
+            avg = set->savedTileSize() / set->savedTileCount();
         }
+        set->setTotalTileSize(avg * set->totalTileCount());
     }
+    //-- Now figure out the count for tiles unique to this set
+    //   This is only accurate when all tiles are downloaded
+    quint32 ucount = setTotals.uniqueCount;
+    quint64 usize  = setTotals.uniqueSize;
+    //-- If we haven't downloaded it all, estimate size of unique tiles
+    quint32 expectedUcount = set->totalTileCount() - set->savedTileCount();
+    if(!ucount) {
+        usize = expectedUcount * avg;
+    } else {
+        expectedUcount = ucount;
+    }
+    set->setUniqueTileCount(expectedUcount);
+    set->setUniqueTileSize(usize);
 }
 
 //-----------------------------------------------------------------------------
 void
 QGCCacheWorker::_updateTotals()
 {
+    const SetTotals_t defaultTotals = _setTotals.value(_getDefaultTileSet());
+    _defaultCount = defaultTotals.uniqueCount;
+    _defaultSize  = defaultTotals.uniqueSize;
+    emit updateTotals(_totalCount, _totalSize, _defaultCount, _defaultSize);
+    _lastUpdate = time(nullptr);
+}
+
+//-----------------------------------------------------------------------------
+//-- Totals are computed once from the database when it is opened. From then on they are kept up to date as tiles
+//   are added and removed, such that reporting them does not require scanning the Tiles and SetTiles tables.
+void
+QGCCacheWorker::_loadTotals()
+{
+    _totalCount = 0;
+    _totalSize  = 0;
+    _setTotals.clear();
     QSqlQuery query(*_db);
-    QString s;
-    s = QString("SELECT COUNT(size), SUM(size) FROM Tiles");
-    qCDebug(QGCTileCacheLog) << "_updateTotals(): " << s;
+    QString s = QString("SELECT COUNT(size), SUM(size) FROM Tiles");
+    qCDebug(QGCTileCacheLog) << "_loadTotals(): " << s;
+    if(query.exec(s) && query.next()) {
+        _totalCount = query.value(0).toUInt();
+        _totalSize  = query.value(1).toULongLong();
+    }
+    s = QString("SELECT B.setID, COUNT(A.size), SUM(A.size) FROM Tiles A INNER JOIN SetTiles B ON A.tileID = B.tileID GROUP BY B.setID");
+    qCDebug(QGCTileCacheLog) << "_loadTotals(): " << s;
     if(query.exec(s)) {
-        if(query.next()) {
-            _totalCount = query.value(0).toUInt();
-            _totalSize  = query.value(1).toULongLong();
+        while(query.next()) {
+            SetTotals_t& setTotals = _setTotals[query.value(0).toULongLong()];
+            setTotals.count = query.value(1).toUInt();
+            setTotals.size  = query.value(2).toULongLong();
         }
     }
-    s = QString("SELECT COUNT(size), SUM(size) FROM Tiles WHERE tileID IN (SELECT A.tileID FROM SetTiles A join SetTiles B on A.tileID = B.tileID WHERE B.setID = %1 GROUP by A.tileID HAVING COUNT(A.tileID) = 1)").arg(_getDefaultTileSet());
-    qCDebug(QGCTileCacheLog) << "_updateTotals(): " << s;
+    s = QString("SELECT B.setID, COUNT(A.size), SUM(A.size) FROM Tiles A INNER JOIN SetTiles B ON A.tileID = B.tileID WHERE A.tileID IN (SELECT tileID FROM SetTiles GROUP BY tileID HAVING COUNT(tileID) = 1) GROUP BY B.setID");
+    qCDebug(QGCTileCacheLog) << "_loadTotals(): " << s;
     if(query.exec(s)) {
-        if(query.next()) {
-            _defaultCount = query.value(0).toUInt();
-            _defaultSize  = query.value(1).toULongLong();
+        while(query.next()) {
+            SetTotals_t& setTotals = _setTotals[query.value(0).toULongLong()];
+            setTotals.uniqueCount = query.value(1).toUInt();
+            setTotals.uniqueSize  = query.value(2).toULongLong();
         }
     }
-    emit updateTotals(_totalCount, _totalSize, _defaultCount, _defaultSize);
-    _lastUpdate = time(nullptr);
 }
 
 //-----------------------------------------------------------------------------
-quint64 QGCCacheWorker::_findTile(const QString hash)
+//-- A tile which was not in the cache before has been added to a set. It is unique to that set.
+void
+QGCCacheWorker::_newTileAdded(quint64 setID, quint64 size)
+{
+    _totalCount++;
+    _totalSize += size;
+    SetTotals_t& setTotals = _setTotals[setID];
+    setTotals.count++;
+    setTotals.size += size;
+    setTotals.uniqueCount++;
+    setTotals.uniqueSize += size;
+}
+
+//-----------------------------------------------------------------------------
+//-- An already cached tile is about to be added to another set. Must be called before SetTiles is updated.
+void
+QGCCacheWorker::_sharedTileAdded(quint64 tileID, quint64 setID, quint64 size)
+{
+    QSqlQuery* query = _preparedQuery(kTileSetsQuery);
+    if(query) {
+        query->bindValue(0, tileID);
+        if(query->exec()) {
+            QList<quint64> owners;
+            while(query->next()) {
+                owners.append(query->value(0).toULongLong());
+            }
+            if(owners.count() == 1 && owners[0] != setID) {
+                //-- Tile was unique to its only owner until now
+                SetTotals_t& ownerTotals = _setTotals[owners[0]];
+                ownerTotals.uniqueCount--;
+                ownerTotals.uniqueSize -= size;
+            }
+        }
+        query->finish();
+    }
+    SetTotals_t& setTotals = _setTotals[setID];
+    setTotals.count++;
+    setTotals.size += size;
+}
+
+//-----------------------------------------------------------------------------
+//-- A tile unique to the given set has been removed from the cache
+void
+QGCCacheWorker::_uniqueTileRemoved(quint64 setID, quint64 size)
+{
+    _totalCount--;
+    _totalSize -= size;
+    SetTotals_t& setTotals = _setTotals[setID];
+    setTotals.count--;
+    setTotals.size -= size;
+    setTotals.uniqueCount--;
+    setTotals.uniqueSize -= size;
+}
+
+//-----------------------------------------------------------------------------
+quint64 QGCCacheWorker::_findTile(quint64 key, quint64* size)
 {
     quint64 tileID = 0;
-    QSqlQuery query(*_db);
-    QString s = QString("SELECT tileID FROM Tiles WHERE hash = \"%1\"").arg(hash);
-    if(query.exec(s)) {
-        if(query.next()) {
-            tileID = query.value(0).toULongLong();
+    QSqlQuery* query = _preparedQuery(kFindTileQuery);
+    if(query) {
+        query->bindValue(0, key);
+        if(query->exec() && query->next()) {
+            tileID = query->value(0).toULongLong();
+            if(size) {
+                *size = query->value(1).toULongLong();
+            }
         }
+        query->finish();
     }
     return tileID;
 }
@@ -507,41 +699,51 @@ QGCCacheWorker::_createTileSet(QGCMapTask *mtask)
             quint64 setID = query.lastInsertId().toULongLong();
             task->tileSet()->setId(setID);
             //-- Prepare Download List
+            QSqlQuery* downloadQuery    = _preparedQuery(kInsertTileDownloadQuery);
+            QSqlQuery* setTileQuery     = _preparedQuery(kInsertSetTileQuery);
+            if(!downloadQuery || !setTileQuery) {
+                mtask->setError("Error creating tile set download list");
+                return;
+            }
             _db->transaction();
             for(int z = task->tileSet()->minZoom(); z <= task->tileSet()->maxZoom(); z++) {
                 QGCTileSet set = QGCMapEngine::getTileCount(z,
                     task->tileSet()->topleftLon(), task->tileSet()->topleftLat(),
                     task->tileSet()->bottomRightLon(), task->tileSet()->bottomRightLat(), task->tileSet()->type());
                 QString type = task->tileSet()->type();
+                int typeId = getQGCMapEngine()->urlFactory()->getIdFromType(type);
                 for(int x = set.tileX0; x <= set.tileX1; x++) {
                     for(int y = set.tileY0; y <= set.tileY1; y++) {
                         //-- See if tile is already downloaded
-                        QString hash = QGCMapEngine::getTileHash(type, x, y, z);
-                        quint64 tileID = _findTile(hash);
+                        quint64 key = QGCMapEngine::getTileKey(type, x, y, z);
+                        quint64 tileSize = 0;
+                        quint64 tileID = _findTile(key, &tileSize);
                         if(!tileID) {
                             //-- Set to download
-                            query.prepare("INSERT OR IGNORE INTO TilesDownload(setID, hash, type, x, y, z, state) VALUES(?, ?, ?, ?, ? ,? ,?)");
-                            query.addBindValue(setID);
-                            query.addBindValue(hash);
-                            query.addBindValue(getQGCMapEngine()->urlFactory()->getIdFromType(type));
-                            query.addBindValue(x);
-                            query.addBindValue(y);
-                            query.addBindValue(z);
-                            query.addBindValue(0);
-                            if(!query.exec()) {
-                                qWarning() << "Map Cache SQL error (add tile into TilesDownload):" << query.lastError().text();
+                            downloadQuery->bindValue(0, setID);
+                            downloadQuery->bindValue(1, key);
+                            downloadQuery->bindValue(2, typeId);
+                            downloadQuery->bindValue(3, x);
+                            downloadQuery->bindValue(4, y);
+                            downloadQuery->bindValue(5, z);
+                            downloadQuery->bindValue(6, 0);
+                            if(!downloadQuery->exec()) {
+                                qWarning() << "Map Cache SQL error (add tile into TilesDownload):" << downloadQuery->lastError().text();
+                                _db->rollback();
+                                _loadTotals();
                                 mtask->setError("Error creating tile set download list");
                                 return;
                             } else
                                 actual_count++;
                         } else {
                             //-- Tile already in the database. No need to dowload.
-                            QString s = QString("INSERT OR IGNORE INTO SetTiles(tileID, setID) VALUES(%1, %2)").arg(tileID).arg(setID);
-                            query.prepare(s);
-                            if(!query.exec()) {
-                                qWarning() << "Map Cache SQL error (add tile into SetTiles):" << query.lastError().text();
+                            _sharedTileAdded(tileID, setID, tileSize);
+                            setTileQuery->bindValue(0, tileID);
+                            setTileQuery->bindValue(1, setID);
+                            if(!setTileQuery->exec()) {
+                                qWarning() << "Map Cache SQL error (add tile into SetTiles):" << setTileQuery->lastError().text();
                             }
-                            qCDebug(QGCTileCacheLog) << "_createTileSet() Already Cached HASH:" << hash;
+                            qCDebug(QGCTileCacheLog) << "_createTileSet() Already Cached KEY:" << key;
                         }
                     }
                 }
@@ -556,6 +758,31 @@ QGCCacheWorker::_createTileSet(QGCMapTask *mtask)
     mtask->setError("Error saving tile set");
 }
 
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_findMissingTiles(QGCMapTask* mtask)
+{
+    if(!_testTask(mtask)) {
+        return;
+    }
+    QGCFindMissingTilesTask* task = static_cast<QGCFindMissingTilesTask*>(mtask);
+    QList<quint64> missingKeys;
+    quint64 cachedSize = 0;
+    for(const quint64 key: task->keys()) {
+        quint64 size = 0;
+        const quint64 tileID = _findTile(key, &size);
+        if(tileID) {
+            //-- Counts as a use so tiles wanted for a plan are the last to be pruned
+            _accessedTiles.insert(tileID);
+            cachedSize += size;
+        } else {
+            missingKeys.append(key);
+        }
+    }
+    qCDebug(QGCTileCacheLog) << "_findMissingTiles() missing" << missingKeys.count() << "of" << task->keys().count();
+    task->setMissingTilesFound(missingKeys, cachedSize);
+}
+
 //-----------------------------------------------------------------------------
 void
 QGCCacheWorker::_getTileDownloadList(QGCMapTask* mtask)
@@ -566,22 +793,30 @@ QGCCacheWorker::_getTileDownloadList(QGCMapTask* mtask)
     QList<QGCTile*> tiles;
     QGCGetTileDownloadListTask* task = static_cast<QGCGetTileDownloadListTask*>(mtask);
     QSqlQuery query(*_db);
-    QString s = QString("SELECT hash, type, x, y, z FROM TilesDownload WHERE setID = %1 AND state = 0 LIMIT %2").arg(task->setID()).arg(task->count());
+    QString s = QString("SELECT tileKey, type, x, y, z FROM TilesDownload WHERE setID = %1 AND state = 0 LIMIT %2").arg(task->setID()).arg(task->count());
     if(query.exec(s)) {
         while(query.next()) {
             QGCTile* tile = new QGCTile;
-            tile->setHash(query.value("hash").toString());
+            tile->setKey(query.value("tileKey").toULongLong());
             tile->setType(getQGCMapEngine()->urlFactory()->getTypeFromId(query.value("type").toInt()));
             tile->setX(query.value("x").toInt());
             tile->setY(query.value("y").toInt());
             tile->setZ(query.value("z").toInt());
             tiles.append(tile);
         }
-        for(int i = 0; i < tiles.size(); i++) {
-            s = QString("UPDATE TilesDownload SET state = %1 WHERE setID = %2 and hash = \"%3\"").arg(static_cast<int>(QGCTile::StateDownloading)).arg(task->setID()).arg(tiles[i]->hash());
-            if(!query.exec(s)) {
-                qWarning() << "Map Cache SQL error (set TilesDownload state):" << query.lastError().text();
+        query.finish();
+        QSqlQuery* updateQuery = _preparedQuery(kUpdateTileDownloadStateQuery);
+        if(updateQuery) {
+            _db->transaction();
+            for(int i = 0; i < tiles.size(); i++) {
+                updateQuery->bindValue(0, static_cast<int>(QGCTile::StateDownloading));
+                updateQuery->bindValue(1, task->setID());
+                updateQuery->bindValue(2, tiles[i]->key());
+                if(!updateQuery->exec()) {
+                    qWarning() << "Map Cache SQL error (set TilesDownload state):" << updateQuery->lastError().text();
+                }
             }
+            _db->commit();
         }
     }
     task->setTileListFetched(tiles);
@@ -598,12 +833,12 @@ QGCCacheWorker::_updateTileDownloadState(QGCMapTask* mtask)
     QSqlQuery query(*_db);
     QString s;
     if(task->state() == QGCTile::StateComplete) {
-        s = QString("DELETE FROM TilesDownload WHERE setID = %1 AND hash = \"%2\"").arg(task->setID()).arg(task->hash());
+        s = QString("DELETE FROM TilesDownload WHERE setID = %1 AND tileKey = %2").arg(task->setID()).arg(task->key());
     } else {
-        if(task->hash() == "*") {
+        if(task->key() == QGCUpdateTileDownloadStateTask::kAllTiles) {
             s = QString("UPDATE TilesDownload SET state = %1 WHERE setID = %2").arg(static_cast<int>(task->state())).arg(task->setID());
         } else {
-            s = QString("UPDATE TilesDownload SET state = %1 WHERE setID = %2 AND hash = \"%3\"").arg(static_cast<int>(task->state())).arg(task->setID()).arg(task->hash());
+            s = QString("UPDATE TilesDownload SET state = %1 WHERE setID = %2 AND tileKey = %3").arg(static_cast<int>(task->state())).arg(task->setID()).arg(task->key());
         }
     }
     if(!query.exec(s)) {
@@ -619,26 +854,50 @@ QGCCacheWorker::_pruneCache(QGCMapTask* mtask)
         return;
     }
     QGCPruneCacheTask* task = static_cast<QGCPruneCacheTask*>(mtask);
+    //-- Make sure recent hits are taken into account before picking what to evict
+    _updateTileAccess();
+    const quint64 defaultSet = _getDefaultTileSet();
     QSqlQuery query(*_db);
-    QString s;
-    //-- Select tiles in default set only, sorted by oldest.
-    s = QString("SELECT tileID, size, hash FROM Tiles WHERE tileID IN (SELECT A.tileID FROM SetTiles A join SetTiles B on A.tileID = B.tileID WHERE B.setID = %1 GROUP by A.tileID HAVING COUNT(A.tileID) = 1) ORDER BY DATE ASC LIMIT 128").arg(_getDefaultTileSet());
+    //-- Walk the access index from the least recently used tile, skipping tiles also owned by other sets
+    QString s = QString("SELECT T.tileID, T.size FROM Tiles T WHERE "
+                        "EXISTS (SELECT 1 FROM SetTiles S WHERE S.tileID = T.tileID AND S.setID = %1) AND "
+                        "NOT EXISTS (SELECT 1 FROM SetTiles S WHERE S.tileID = T.tileID AND S.setID != %1) "
+                        "ORDER BY T.access ASC LIMIT %2").arg(defaultSet).arg(PRUNE_BATCH);
     qint64 amount = (qint64)task->amount();
-    QList<quint64> tlist;
-    if(query.exec(s)) {
-        while(query.next() && amount >= 0) {
-            tlist << query.value(0).toULongLong();
-            amount -= query.value(1).toULongLong();
-            qCDebug(QGCTileCacheLog) << "_pruneCache() HASH:" << query.value(2).toString();
+    while(amount > 0) {
+        if(!query.exec(s)) {
+            qWarning() << "Map Cache SQL error (select tiles to prune):" << query.lastError().text();
+            break;
         }
-        while(tlist.count()) {
-            s = QString("DELETE FROM Tiles WHERE tileID = %1").arg(tlist[0]);
-            tlist.removeFirst();
-            if(!query.exec(s))
-                break;
+        QStringList         tileIDs;
+        QList<quint64>      sizes;
+        while(amount > 0 && query.next()) {
+            tileIDs << query.value(0).toString();
+            sizes   << query.value(1).toULongLong();
+            amount  -= query.value(1).toLongLong();
+        }
+        query.finish();
+        if(tileIDs.isEmpty()) {
+            break;
+        }
+        const QString idList = tileIDs.join(",");
+        _db->transaction();
+        if(!query.exec(QString("DELETE FROM Tiles WHERE tileID IN (%1)").arg(idList)) ||
+           !query.exec(QString("DELETE FROM SetTiles WHERE tileID IN (%1)").arg(idList))) {
+            qWarning() << "Map Cache SQL error (prune tiles):" << query.lastError().text();
+            _db->rollback();
+            break;
+        }
+        _db->commit();
+        for(quint64 size: sizes) {
+            _uniqueTileRemoved(defaultSet, size);
+        }
+        qCDebug(QGCTileCacheLog) << "_pruneCache() evicted:" << tileIDs.count();
+        if(tileIDs.count() < PRUNE_BATCH) {
+            break;
         }
-        task->setPruned();
     }
+    task->setPruned();
 }
 
 //-----------------------------------------------------------------------------
@@ -659,6 +918,19 @@ QGCCacheWorker::_deleteTileSet(qulonglong id)
 {
     QSqlQuery query(*_db);
     QString s;
+    //-- Tiles shared by this set and exactly one other set become unique to that other set
+    s = QString("SELECT B.setID, COUNT(T.size), SUM(T.size) FROM SetTiles A JOIN SetTiles B ON A.tileID = B.tileID AND B.setID != A.setID JOIN Tiles T ON T.tileID = A.tileID "
+                "WHERE A.setID = %1 AND A.tileID IN (SELECT tileID FROM SetTiles GROUP BY tileID HAVING COUNT(tileID) = 2) GROUP BY B.setID").arg(id);
+    if(query.exec(s)) {
+        while(query.next()) {
+            SetTotals_t& setTotals = _setTotals[query.value(0).toULongLong()];
+            setTotals.uniqueCount += query.value(1).toUInt();
+            setTotals.uniqueSize  += query.value(2).toULongLong();
+        }
+    }
+    const SetTotals_t setTotals = _setTotals.take(id);
+    _totalCount -= setTotals.uniqueCount;
+    _totalSize  -= setTotals.uniqueSize;
     //-- Only delete tiles unique to this set
     s = QString("DELETE FROM Tiles WHERE tileID IN (SELECT A.tileID FROM SetTiles A JOIN SetTiles B ON A.tileID = B.tileID WHERE B.setID = %1 GROUP BY A.tileID HAVING COUNT(A.tileID) = 1)").arg(id);
     query.exec(s);
@@ -695,6 +967,16 @@ QGCCacheWorker::_resetCacheDatabase(QGCMapTask* mtask)
         return;
     }
     QGCResetTask* task = static_cast<QGCResetTask*>(mtask);
+    _resetDB();
+    task->setResetCompleted();
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_resetDB()
+{
+    _accessedTiles.clear();
+    _clearPreparedQueries();
     QSqlQuery query(*_db);
     QString s;
     s = QString("DROP TABLE Tiles");
@@ -706,7 +988,7 @@ QGCCacheWorker::_resetCacheDatabase(QGCMapTask* mtask)
     s = QString("DROP TABLE TilesDownload");
     query.exec(s);
     _valid = _createDB(*_db);
-    task->setResetCompleted();
+    _loadTotals();
 }
 
 //-----------------------------------------------------------------------------
@@ -717,6 +999,11 @@ QGCCacheWorker::_importSets(QGCMapTask* mtask)
         return;
     }
     QGCImportTileTask* task = static_cast<QGCImportTileTask*>(mtask);
+    if(task->path().endsWith(kMBTilesExtension, Qt::CaseInsensitive)) {
+        _importMBTiles(task);
+        task->setImportCompleted();
+        return;
+    }
     //-- If replacing, simply copy over it
     if(task->replace()) {
         //-- Close and delete old database
@@ -730,6 +1017,7 @@ QGCCacheWorker::_importSets(QGCMapTask* mtask)
         if(_valid) {
             task->setProgress(50);
             _connectDB();
+            _loadTotals();
         }
         task->setProgress(100);
     } else {
@@ -810,32 +1098,46 @@ QGCCacheWorker::_importSets(QGCMapTask* mtask)
                         }
                         //-- Find set tiles
                         QSqlQuery cQuery(*_db);
+                        QSqlQuery* insertTileQuery      = _preparedQuery(kInsertTileQuery);
+                        QSqlQuery* insertSetTileQuery   = _preparedQuery(kInsertSetTileQuery);
+                        if(!insertTileQuery || !insertSetTileQuery) {
+                            task->setError("Error adding imported tile set to database");
+                            break;
+                        }
                         QSqlQuery subQuery(*dbImport);
                         QString sb = QString("SELECT * FROM Tiles WHERE tileID IN (SELECT A.tileID FROM SetTiles A JOIN SetTiles B ON A.tileID = B.tileID WHERE B.setID = %1 GROUP BY A.tileID HAVING COUNT(A.tileID) = 1)").arg(setID);
                         if(subQuery.exec(sb)) {
                             quint64 tilesFound = 0;
                             quint64 tilesSaved = 0;
+                            //-- Sets exported before tiles were keyed by integer still carry the string hash
+                            const bool legacyKeys = subQuery.record().indexOf("tileKey") < 0;
                             _db->transaction();
                             while(subQuery.next()) {
                                 tilesFound++;
-                                QString hash    = subQuery.value("hash").toString();
+                                quint64 key     = legacyKeys ? tileKeyFromHash(subQuery.value("hash").toString()) : subQuery.value("tileKey").toULongLong();
+                                if(!key) {
+                                    continue;
+                                }
                                 QString format  = subQuery.value("format").toString();
                                 QByteArray img  = subQuery.value("tile").toByteArray();
                                 int type        = subQuery.value("type").toInt();
                                 //-- Save tile
-                                cQuery.prepare("INSERT INTO Tiles(hash, format, tile, size, type, date) VALUES(?, ?, ?, ?, ?, ?)");
-                                cQuery.addBindValue(hash);
-                                cQuery.addBindValue(format);
-                                cQuery.addBindValue(img);
-                                cQuery.addBindValue(img.size());
-                                cQuery.addBindValue(type);
-                                cQuery.addBindValue(QDateTime::currentDateTime().toSecsSinceEpoch());
-                                if(cQuery.exec()) {
+                                insertTileQuery->bindValue(0, key);
+                                insertTileQuery->bindValue(1, format);
+                                insertTileQuery->bindValue(2, img);
+                                insertTileQuery->bindValue(3, img.size());
+                                insertTileQuery->bindValue(4, type);
+                                const qint64 now = QDateTime::currentDateTime().toSecsSinceEpoch();
+                                insertTileQuery->bindValue(5, now);
+                                insertTileQuery->bindValue(6, now);
+                                if(insertTileQuery->exec()) {
                                     tilesSaved++;
-                                    quint64 importTileID = cQuery.lastInsertId().toULongLong();
-                                    QString s = QString("INSERT INTO SetTiles(tileID, setID) VALUES(%1, %2)").arg(importTileID).arg(insertSetID);
-                                    cQuery.prepare(s);
-                                    cQuery.exec();
+                                    quint64 importTileID = insertTileQuery->lastInsertId().toULongLong();
+                                    insertSetTileQuery->bindValue(0, importTileID);
+                                    insertSetTileQuery->bindValue(1, insertSetID);
+                                    if(insertSetTileQuery->exec()) {
+                                        _newTileAdded(insertSetID, static_cast<quint64>(img.size()));
+                                    }
                                     currentCount++;
                                     if(tileCount) {
                                         int progress = (int)((double)currentCount / (double)tileCount * 100.0);
@@ -850,14 +1152,8 @@ QGCCacheWorker::_importSets(QGCMapTask* mtask)
                             _db->commit();
                             if(tilesSaved) {
                                 //-- Update tile count (if any added)
-                                s = QString("SELECT COUNT(size) FROM Tiles A INNER JOIN SetTiles B on A.tileID = B.tileID WHERE B.setID = %1").arg(insertSetID);
-                                if(cQuery.exec(s)) {
-                                    if(cQuery.next()) {
-                                        quint64 count  = cQuery.value(0).toULongLong();
-                                        s = QString("UPDATE TileSets SET numTiles = %1 WHERE setID = %2").arg(count).arg(insertSetID);
-                                        cQuery.exec(s);
-                                    }
-                                }
+                                s = QString("UPDATE TileSets SET numTiles = %1 WHERE setID = %2").arg(_setTotals.value(insertSetID).count).arg(insertSetID);
+                                cQuery.exec(s);
                             }
                             qint64 uniqueTiles = tilesFound - tilesSaved;
                             if((quint64)uniqueTiles < tileCount) {
@@ -899,6 +1195,11 @@ QGCCacheWorker::_exportSets(QGCMapTask* mtask)
     //-- Delete target if it exists
     QFile file(task->path());
     file.remove();
+    if(task->path().endsWith(kMBTilesExtension, Qt::CaseInsensitive)) {
+        _exportMBTiles(task);
+        task->setExportCompleted();
+        return;
+    }
     //-- Create exported database
     QScopedPointer<QSqlDatabase> dbExport(new QSqlDatabase(QSqlDatabase::addDatabase("QSQLITE", kExportSession)));
     dbExport->setDatabaseName(task->path());
@@ -958,13 +1259,13 @@ QGCCacheWorker::_exportSets(QGCMapTask* mtask)
                             QSqlQuery subQuery(*_db);
                             if(subQuery.exec(s)) {
                                 if(subQuery.next()) {
-                                    QString hash    = subQuery.value("hash").toString();
+                                    quint64 key     = subQuery.value("tileKey").toULongLong();
                                     QString format  = subQuery.value("format").toString();
                                     QByteArray img  = subQuery.value("tile").toByteArray();
                                     int type        = subQuery.value("type").toInt();
                                     //-- Save tile
-                                    exportQuery.prepare("INSERT INTO Tiles(hash, format, tile, size, type, date) VALUES(?, ?, ?, ?, ?, ?)");
-                                    exportQuery.addBindValue(hash);
+                                    exportQuery.prepare("INSERT INTO Tiles(tileKey, format, tile, size, type, date) VALUES(?, ?, ?, ?, ?, ?)");
+                                    exportQuery.addBindValue(key);
                                     exportQuery.addBindValue(format);
                                     exportQuery.addBindValue(img);
                                     exportQuery.addBindValue(img.size());
@@ -997,6 +1298,289 @@ QGCCacheWorker::_exportSets(QGCMapTask* mtask)
     task->setExportCompleted();
 }
 
+//-----------------------------------------------------------------------------
+//-- MBTiles (https://github.com/mapbox/mbtiles-spec) hold a single tile pyramid of one map type. Tiles of the selected
+//   sets are streamed into it with a single query and a single transaction. Rows are numbered bottom up (TMS).
+void
+QGCCacheWorker::_exportMBTiles(QGCMapTask* mtask)
+{
+    QGCExportTileTask* task = static_cast<QGCExportTileTask*>(mtask);
+    QString     mapType;
+    QStringList setIDs;
+    QStringList names;
+    for(QGCCachedTileSet* set: task->sets()) {
+        setIDs << QString::number(set->id());
+        if(set->defaultSet()) {
+            continue;
+        }
+        names << set->name();
+        if(mapType.isEmpty()) {
+            mapType = set->type();
+        } else if(mapType != set->type()) {
+            task->setError("MBTiles export requires tile sets of a single map type");
+            return;
+        }
+    }
+    if(mapType.isEmpty()) {
+        task->setError("MBTiles export requires a tile set with a map type");
+        return;
+    }
+    //-- All tiles of a map type share the provider code in the upper bits of their key
+    const quint64 firstKey = QGCMapEngine::getTileKey(mapType, 0, 0, 0);
+    const quint64 lastKey  = firstKey + (Q_UINT64_C(1) << 47);
+    const QString where = QString("FROM Tiles WHERE tileKey >= %1 AND tileKey < %2 AND tileID IN (SELECT tileID FROM SetTiles WHERE setID IN (%3))").arg(firstKey).arg(lastKey).arg(setIDs.join(","));
+    QSqlQuery query(*_db);
+    quint64 tileCount = 0;
+    if(query.exec(QString("SELECT COUNT(tileID) %1").arg(where)) && query.next()) {
+        tileCount = query.value(0).toULongLong();
+    }
+    query.finish();
+    if(!tileCount) {
+        task->setError("No tiles to export");
+        return;
+    }
+    QScopedPointer<QSqlDatabase> dbExport(new QSqlDatabase(QSqlDatabase::addDatabase("QSQLITE", kExportSession)));
+    dbExport->setDatabaseName(task->path());
+    if (dbExport->open()) {
+        QSqlQuery exportQuery(*dbExport);
+        exportQuery.exec("PRAGMA journal_mode=OFF");
+        exportQuery.exec("PRAGMA synchronous=OFF");
+        if(!exportQuery.exec("CREATE TABLE metadata (name TEXT, value TEXT)") ||
+           !exportQuery.exec("CREATE UNIQUE INDEX name ON metadata (name)") ||
+           !exportQuery.exec("CREATE TABLE tiles (zoom_level INTEGER, tile_column INTEGER, tile_row INTEGER, tile_data BLOB)") ||
+           !exportQuery.exec("CREATE UNIQUE INDEX tile_index ON tiles (zoom_level, tile_column, tile_row)") ||
+           !exportQuery.prepare("INSERT INTO tiles(zoom_level, tile_column, tile_row, tile_data) VALUES(?, ?, ?, ?)")) {
+            qWarning() << "Map Cache SQL error (create MBTiles database):" << exportQuery.lastError().text();
+            task->setError("Error creating export database");
+        } else {
+            QString format;
+            int     minZoom         = static_cast<int>(MAX_MAP_ZOOM);
+            int     maxZoom         = 0;
+            double  west            = 180.0;
+            double  east            = -180.0;
+            double  south           = 90.0;
+            double  north           = -90.0;
+            quint64 currentCount    = 0;
+            int     lastProgress    = -1;
+            query.setForwardOnly(true);
+            if(query.exec(QString("SELECT tileKey, format, tile %1").arg(where))) {
+                dbExport->transaction();
+                while(query.next()) {
+                    int x, y, z;
+                    if(!QGCMapEngine::getTileFromKey(query.value(0).toULongLong(), x, y, z)) {
+                        continue;
+                    }
+                    if(format.isEmpty()) {
+                        format = query.value(1).toString();
+                    }
+                    const double tiles = static_cast<double>(1 << z);
+                    minZoom = qMin(minZoom, z);
+                    maxZoom = qMax(maxZoom, z);
+                    west    = qMin(west,  x / tiles * 360.0 - 180.0);
+                    east    = qMax(east,  (x + 1) / tiles * 360.0 - 180.0);
+                    north   = qMax(north, qRadiansToDegrees(qAtan(sinh(M_PI * (1.0 - 2.0 * y / tiles)))));
+                    south   = qMin(south, qRadiansToDegrees(qAtan(sinh(M_PI * (1.0 - 2.0 * (y + 1) / tiles)))));
+                    exportQuery.bindValue(0, z);
+                    exportQuery.bindValue(1, x);
+                    exportQuery.bindValue(2, (1 << z) - 1 - y);
+                    exportQuery.bindValue(3, query.value(2));
+                    if(!exportQuery.exec()) {
+                        qWarning() << "Map Cache SQL error (export MBTiles tile):" << exportQuery.lastError().text();
+                    }
+                    int progress = static_cast<int>(++currentCount * 100 / tileCount);
+                    if(lastProgress != progress) {
+                        lastProgress = progress;
+                        task->setProgress(progress);
+                    }
+                }
+                QList<QPair<QString, QString>> metadata;
+                metadata << qMakePair(QString("name"),          names.join(", "))
+                         << qMakePair(QString("type"),          QString("baselayer"))
+                         << qMakePair(QString("version"),       QString("1.1"))
+                         << qMakePair(QString("description"),   QString("%1 tiles exported by %2").arg(mapType).arg(QCoreApplication::applicationName()))
+                         << qMakePair(QString("format"),        format)
+                         << qMakePair(QString("bounds"),        QString("%1,%2,%3,%4").arg(west, 0, 'f', 7).arg(south, 0, 'f', 7).arg(east, 0, 'f', 7).arg(north, 0, 'f', 7))
+                         << qMakePair(QString("minzoom"),       QString::number(minZoom))
+                         << qMakePair(QString("maxzoom"),       QString::number(maxZoom))
+                         << qMakePair(QString(kMBTilesMapType), mapType);
+                exportQuery.prepare("INSERT INTO metadata(name, value) VALUES(?, ?)");
+                for(const auto& entry: metadata) {
+                    exportQuery.bindValue(0, entry.first);
+                    exportQuery.bindValue(1, entry.second);
+                    exportQuery.exec();
+                }
+                dbExport->commit();
+            } else {
+                qWarning() << "Map Cache SQL error (select tiles to export):" << query.lastError().text();
+                task->setError("Error reading tiles to export");
+            }
+        }
+    } else {
+        qCritical() << "Map Cache SQL error (create export database):" << dbExport->lastError();
+        task->setError("Error opening export database");
+    }
+    dbExport.reset();
+    QSqlDatabase::removeDatabase(kExportSession);
+}
+
+//-----------------------------------------------------------------------------
+//-- The tiles of an MBTiles file become a new tile set. Files written by QGC record their map type as qgc_map_type,
+//   which takes precedence. Files from other tools don't, their tiles are stored as the map type given by the task,
+//   or as the map type the standard name metadata refers to.
+void
+QGCCacheWorker::_importMBTiles(QGCMapTask* mtask)
+{
+    QGCImportTileTask* task = static_cast<QGCImportTileTask*>(mtask);
+    QScopedPointer<QSqlDatabase> dbImport(new QSqlDatabase(QSqlDatabase::addDatabase("QSQLITE", kExportSession)));
+    dbImport->setDatabaseName(task->path());
+    dbImport->setConnectOptions("QSQLITE_OPEN_READONLY");
+    if (dbImport->open()) {
+        QSqlQuery query(*dbImport);
+        QHash<QString, QString> metadata;
+        if(query.exec("SELECT name, value FROM metadata")) {
+            while(query.next()) {
+                metadata[query.value(0).toString()] = query.value(1).toString();
+            }
+        }
+        UrlFactory* urlFactory = getQGCMapEngine()->urlFactory();
+        auto isKnownType = [urlFactory](const QString& type) {
+            return !type.isEmpty() && urlFactory->getTypeFromCode(urlFactory->getCodeFromType(type)) == type;
+        };
+        QString mapType;
+        for(const QString& type: { metadata.value(kMBTilesMapType), task->mapType(), metadata.value("name") }) {
+            if(isKnownType(type)) {
+                mapType = type;
+                break;
+            }
+        }
+        quint64 tileCount   = 0;
+        int     minZoom     = metadata.value("minzoom", "-1").toInt();
+        int     maxZoom     = metadata.value("maxzoom", "-1").toInt();
+        if(query.exec("SELECT COUNT(*), MIN(zoom_level), MAX(zoom_level) FROM tiles") && query.next()) {
+            tileCount = query.value(0).toULongLong();
+            if(minZoom < 0 || maxZoom < 0) {
+                minZoom = query.value(1).toInt();
+                maxZoom = query.value(2).toInt();
+            }
+        }
+        query.finish();
+        if(mapType.isEmpty()) {
+            task->setError("Unknown map type for MBTiles import");
+        } else if(!tileCount) {
+            task->setError("No tiles in imported database");
+        } else {
+            if(task->replace()) {
+                _resetDB();
+            }
+            //-- Bounds are "west,south,east,north"
+            const QStringList bounds = metadata.value("bounds").split(",");
+            double west = 0.0, south = 0.0, east = 0.0, north = 0.0;
+            if(bounds.count() == 4) {
+                west    = bounds[0].toDouble();
+                south   = bounds[1].toDouble();
+                east    = bounds[2].toDouble();
+                north   = bounds[3].toDouble();
+            }
+            QString name = metadata.value("name", QFileInfo(task->path()).completeBaseName());
+            quint64 setID;
+            if(_findTileSetID(name, setID)) {
+                int testCount = 0;
+                while (true) {
+                    auto testName = QString::asprintf("%s %02d", name.toLatin1().data(), ++testCount);
+                    if(!_findTileSetID(testName, setID) || testCount > 99) {
+                        name = testName;
+                        break;
+                    }
+                }
+            }
+            QSqlQuery cQuery(*_db);
+            cQuery.prepare("INSERT INTO TileSets("
+                "name, typeStr, topleftLat, topleftLon, bottomRightLat, bottomRightLon, minZoom, maxZoom, type, numTiles, defaultSet, date"
+                ") VALUES(?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+            cQuery.addBindValue(name);
+            cQuery.addBindValue(mapType);
+            cQuery.addBindValue(north);
+            cQuery.addBindValue(west);
+            cQuery.addBindValue(south);
+            cQuery.addBindValue(east);
+            cQuery.addBindValue(minZoom);
+            cQuery.addBindValue(maxZoom);
+            cQuery.addBindValue(urlFactory->getIdFromType(mapType));
+            cQuery.addBindValue(tileCount);
+            cQuery.addBindValue(0);
+            cQuery.addBindValue(QDateTime::currentDateTime().toSecsSinceEpoch());
+            QSqlQuery* insertTileQuery      = _preparedQuery(kInsertTileQuery);
+            QSqlQuery* insertSetTileQuery   = _preparedQuery(kInsertSetTileQuery);
+            if(!cQuery.exec() || !insertTileQuery || !insertSetTileQuery) {
+                qWarning() << "Map Cache SQL error (add MBTiles tile set):" << cQuery.lastError().text();
+                task->setError("Error adding imported tile set to database");
+            } else {
+                setID = cQuery.lastInsertId().toULongLong();
+                const int       typeId          = urlFactory->getIdFromType(mapType);
+                const QString   metadataFormat  = metadata.value("format");
+                const qint64    now             = QDateTime::currentDateTime().toSecsSinceEpoch();
+                quint64         currentCount    = 0;
+                int             lastProgress    = -1;
+                query.setForwardOnly(true);
+                if(query.exec("SELECT zoom_level, tile_column, tile_row, tile_data FROM tiles")) {
+                    _db->transaction();
+                    while(query.next()) {
+                        const int z = query.value(0).toInt();
+                        const int x = query.value(1).toInt();
+                        const int y = (1 << z) - 1 - query.value(2).toInt();
+                        const QByteArray img    = query.value(3).toByteArray();
+                        const quint64 key       = QGCMapEngine::getTileKey(mapType, x, y, z);
+                        QString format = urlFactory->getImageFormat(mapType, img);
+                        if(format.isEmpty()) {
+                            format = metadataFormat;
+                        }
+                        insertTileQuery->bindValue(0, key);
+                        insertTileQuery->bindValue(1, format);
+                        insertTileQuery->bindValue(2, img);
+                        insertTileQuery->bindValue(3, img.size());
+                        insertTileQuery->bindValue(4, typeId);
+                        insertTileQuery->bindValue(5, now);
+                        insertTileQuery->bindValue(6, now);
+                        quint64 tileID = 0;
+                        if(insertTileQuery->exec()) {
+                            tileID = insertTileQuery->lastInsertId().toULongLong();
+                            _newTileAdded(setID, static_cast<quint64>(img.size()));
+                        } else {
+                            //-- Already cached, share it with the new set
+                            quint64 tileSize = 0;
+                            tileID = _findTile(key, &tileSize);
+                            if(tileID) {
+                                _sharedTileAdded(tileID, setID, tileSize);
+                            }
+                        }
+                        if(tileID) {
+                            insertSetTileQuery->bindValue(0, tileID);
+                            insertSetTileQuery->bindValue(1, setID);
+                            if(!insertSetTileQuery->exec()) {
+                                qWarning() << "Map Cache SQL error (add tile into SetTiles):" << insertSetTileQuery->lastError().text();
+                            }
+                        }
+                        int progress = static_cast<int>(++currentCount * 100 / tileCount);
+                        if(lastProgress != progress) {
+                            lastProgress = progress;
+                            task->setProgress(progress);
+                        }
+                    }
+                    _db->commit();
+                    cQuery.exec(QString("UPDATE TileSets SET numTiles = %1 WHERE setID = %2").arg(_setTotals.value(setID).count).arg(setID));
+                } else {
+                    qWarning() << "Map Cache SQL error (select MBTiles tiles):" << query.lastError().text();
+                    task->setError("Error reading imported tiles");
+                }
+            }
+        }
+    } else {
+        task->setError("Error opening import database");
+    }
+    dbImport.reset();
+    QSqlDatabase::removeDatabase(kExportSession);
+}
+
 //-----------------------------------------------------------------------------
 bool QGCCacheWorker::_testTask(QGCMapTask* mtask)
 {
@@ -1041,6 +1625,14 @@ QGCCacheWorker::_connectDB()
     _db->setDatabaseName(_databasePath);
     _db->setConnectOptions("QSQLITE_ENABLE_SHARED_CACHE");
     _valid = _db->open();
+    if(_valid) {
+        //-- Write ahead logging keeps tile lookups from blocking behind write bursts and makes commits cheap
+        QSqlQuery query(*_db);
+        if(!query.exec("PRAGMA journal_mode=WAL")) {
+            qCWarning(QGCTileCacheLog) << "Map Cache SQL error (enable WAL):" << query.lastError().text();
+        }
+        query.exec("PRAGMA synchronous=NORMAL");
+    }
     return _valid;
 }
 
@@ -1049,20 +1641,13 @@ bool
 QGCCacheWorker::_createDB(QSqlDatabase& db, bool createDefault)
 {
     bool res = false;
+    _migrateDB(db);
     QSqlQuery query(db);
-    if(!query.exec(
-        "CREATE TABLE IF NOT EXISTS Tiles ("
-        "tileID INTEGER PRIMARY KEY NOT NULL, "
-        "hash TEXT NOT NULL UNIQUE, "
-        "format TEXT NOT NULL, "
-        "tile BLOB NULL, "
-        "size INTEGER, "
-        "type INTEGER, "
-        "date INTEGER DEFAULT 0)"))
+    if(!query.exec(QString(kCreateTilesTable).arg("Tiles")))
     {
         qWarning() << "Map Cache SQL error (create Tiles db):" << query.lastError().text();
     } else {
-        query.exec("CREATE INDEX IF NOT EXISTS hash ON Tiles ( hash, size, type ) ");
+        query.exec("CREATE INDEX IF NOT EXISTS TilesAccess ON Tiles ( access ) ");
              
         if(!query.exec(
             "CREATE TABLE IF NOT EXISTS TileSets ("
@@ -1089,15 +1674,9 @@ QGCCacheWorker::_createDB(QSqlDatabase& db, bool createDefault)
             {
                 qWarning() << "Map Cache SQL error (create SetTiles db):" << query.lastError().text();
             } else {
-                if(!query.exec(
-                    "CREATE TABLE IF NOT EXISTS TilesDownload ("
-                    "setID INTEGER, "
-                    "hash TEXT NOT NULL UNIQUE, "
-                    "type INTEGER, "
-                    "x INTEGER, "
-                    "y INTEGER, "
-                    "z INTEGER, "
-                    "state INTEGER DEFAULT 0)"))
+                query.exec("CREATE INDEX IF NOT EXISTS SetTilesTileID ON SetTiles ( tileID ) ");
+                query.exec("CREATE INDEX IF NOT EXISTS SetTilesSetID ON SetTiles ( setID ) ");
+                if(!query.exec(QString(kCreateTilesDownloadTable).arg("TilesDownload")))
                 {
                     qWarning() << "Map Cache SQL error (create TilesDownload db):" << query.lastError().text();
                 } else {
@@ -1132,16 +1711,163 @@ QGCCacheWorker::_createDB(QSqlDatabase& db, bool createDefault)
     return res;
 }
 
+//-----------------------------------------------------------------------------
+//-- Caches created before tiles were keyed by integer identify tiles by a string hash. Their Tiles and TilesDownload
+//   tables are rewritten with the equivalent tile keys, keeping tile IDs such that SetTiles remains valid.
+void
+QGCCacheWorker::_migrateDB(QSqlDatabase& db)
+{
+    const bool migrateTiles     = tableHasColumn(db, "Tiles", "hash");
+    const bool migrateDownloads = tableHasColumn(db, "TilesDownload", "hash");
+    if(!migrateTiles && !migrateDownloads) {
+        return;
+    }
+    qCDebug(QGCTileCacheLog) << "Migrating map cache to integer tile keys";
+    bool ok = true;
+    QSqlQuery query(db);
+    query.setForwardOnly(true);
+    QSqlQuery insertQuery(db);
+    db.transaction();
+    if(migrateTiles) {
+        const QString access = tableHasColumn(db, "Tiles", "access") ? "access" : "date";
+        ok = query.exec(QString(kCreateTilesTable).arg("TilesMigration")) &&
+             insertQuery.prepare("INSERT INTO TilesMigration(tileID, tileKey, format, tile, size, type, date, access) VALUES(?, ?, ?, ?, ?, ?, ?, ?)") &&
+             query.exec(QString("SELECT tileID, hash, format, tile, size, type, date, %1 FROM Tiles").arg(access));
+        while(ok && query.next()) {
+            const quint64 key = tileKeyFromHash(query.value(1).toString());
+            if(!key) {
+                continue;
+            }
+            insertQuery.bindValue(0, query.value(0));
+            insertQuery.bindValue(1, key);
+            for(int i = 2; i < 8; i++) {
+                insertQuery.bindValue(i, query.value(i));
+            }
+            //-- Ignore duplicates, the old hash was not unique across map types with colliding ids
+            insertQuery.exec();
+        }
+        query.finish();
+        ok = ok &&
+             query.exec("DROP TABLE Tiles") &&
+             query.exec("ALTER TABLE TilesMigration RENAME TO Tiles") &&
+             query.exec("DELETE FROM SetTiles WHERE tileID NOT IN (SELECT tileID FROM Tiles)");
+    }
+    if(ok && migrateDownloads) {
+        ok = query.exec(QString(kCreateTilesDownloadTable).arg("TilesDownloadMigration")) &&
+             insertQuery.prepare("INSERT OR IGNORE INTO TilesDownloadMigration(setID, tileKey, type, x, y, z, state) VALUES(?, ?, ?, ?, ?, ?, ?)") &&
+             query.exec("SELECT setID, type, x, y, z, state FROM TilesDownload");
+        while(ok && query.next()) {
+            const QString type = getQGCMapEngine()->urlFactory()->getTypeFromId(query.value(1).toInt());
+            if(type.isEmpty()) {
+                continue;
+            }
+            insertQuery.bindValue(0, query.value(0));
+            insertQuery.bindValue(1, QGCMapEngine::getTileKey(type, query.value(2).toInt(), query.value(3).toInt(), query.value(4).toInt()));
+            for(int i = 1; i < 6; i++) {
+                insertQuery.bindValue(i + 1, query.value(i));
+            }
+            insertQuery.exec();
+        }
+        query.finish();
+        ok = ok &&
+             query.exec("DROP TABLE TilesDownload") &&
+             query.exec("ALTER TABLE TilesDownloadMigration RENAME TO TilesDownload");
+    }
+    if(ok) {
+        db.commit();
+    } else {
+        //-- Start over with an empty cache rather than keep one which can't be used
+        qWarning() << "Map Cache SQL error (migrate tile keys):" << query.lastError().text() << insertQuery.lastError().text();
+        db.rollback();
+        query.exec("DROP TABLE IF EXISTS Tiles");
+        query.exec("DROP TABLE IF EXISTS SetTiles");
+        query.exec("DROP TABLE IF EXISTS TilesDownload");
+    }
+}
+
 //-----------------------------------------------------------------------------
 void
 QGCCacheWorker::_disconnectDB()
 {
+    _updateTileAccess();
+    _clearPreparedQueries();
     if (_db) {
         _db.reset();
         QSqlDatabase::removeDatabase(kSession);
     }
 }
 
+//-----------------------------------------------------------------------------
+QSqlQuery*
+QGCCacheWorker::_preparedQuery(int queryId)
+{
+    QSqlQuery* query = _preparedQueries.value(queryId, nullptr);
+    if(!query && _db) {
+        query = new QSqlQuery(*_db);
+        if(!query->prepare(kPreparedQueries[queryId])) {
+            qWarning() << "Map Cache SQL error (prepare):" << kPreparedQueries[queryId] << query->lastError().text();
+            delete query;
+            return nullptr;
+        }
+        _preparedQueries[queryId] = query;
+    }
+    return query;
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_clearPreparedQueries()
+{
+    _commitWriteBatch();
+    qDeleteAll(_preparedQueries);
+    _preparedQueries.clear();
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_beginWriteBatch()
+{
+    if(!_writeBatchCount++) {
+        _db->transaction();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCCacheWorker::_commitWriteBatch()
+{
+    if(_writeBatchCount) {
+        if(!_db->commit()) {
+            qWarning() << "Map Cache SQL error (commit tile batch):" << _db->lastError().text();
+        }
+        qCDebug(QGCTileCacheLog) << "_commitWriteBatch() tiles:" << _writeBatchCount;
+        _writeBatchCount = 0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+//-- Cache hits only record the tile in memory. Their access time is written here for all of them in one statement.
+void
+QGCCacheWorker::_updateTileAccess()
+{
+    if(_accessedTiles.isEmpty() || !_db) {
+        return;
+    }
+    _commitWriteBatch();
+    QStringList tileIDs;
+    tileIDs.reserve(_accessedTiles.count());
+    for(quint64 tileID: _accessedTiles) {
+        tileIDs << QString::number(tileID);
+    }
+    _accessedTiles.clear();
+    QSqlQuery query(*_db);
+    QString s = QString("UPDATE Tiles SET access = %1 WHERE tileID IN (%2)").arg(QDateTime::currentDateTime().toSecsSinceEpoch()).arg(tileIDs.join(","));
+    if(!query.exec(s)) {
+        qWarning() << "Map Cache SQL error (update tile access):" << query.lastError().text();
+    }
+    qCDebug(QGCTileCacheLog) << "_updateTileAccess() tiles:" << tileIDs.count();
+}
+
 //-----------------------------------------------------------------------------
 void
 QGCCacheWorker::_testInternet()
@@ -26,6 +26,9 @@
 #include <QWaitCondition>
 #include <QMutexLocker>
 #include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+#include <QHash>
+#include <QSet>
 #include <QHostInfo>
 
 #include "QGCLoggingCategory.h"
@@ -61,6 +64,7 @@ private:
     void        _getTileSets            (QGCMapTask* mtask);
     void        _createTileSet          (QGCMapTask* mtask);
     void        _getTileDownloadList    (QGCMapTask* mtask);
+    void        _findMissingTiles       (QGCMapTask* mtask);
     void        _updateTileDownloadState(QGCMapTask* mtask);
     void        _deleteTileSet          (QGCMapTask* mtask);
     void        _renameTileSet          (QGCMapTask* mtask);
@@ -68,17 +72,32 @@ private:
     void        _pruneCache             (QGCMapTask* mtask);
     void        _exportSets             (QGCMapTask* mtask);
     void        _importSets             (QGCMapTask* mtask);
+    void        _exportMBTiles          (QGCMapTask* mtask);
+    void        _importMBTiles          (QGCMapTask* mtask);
     bool        _testTask               (QGCMapTask* mtask);
     void        _testInternet           ();
     void        _deleteBingNoTileTiles  ();
 
-    quint64     _findTile               (const QString hash);
+    void        _beginWriteBatch        ();
+    void        _commitWriteBatch       ();
+    void        _updateTileAccess       ();
+    QSqlQuery*  _preparedQuery          (int queryId);
+    void        _clearPreparedQueries   ();
+
+    void        _loadTotals             ();
+    void        _newTileAdded           (quint64 setID, quint64 size);
+    void        _sharedTileAdded        (quint64 tileID, quint64 setID, quint64 size);
+    void        _uniqueTileRemoved      (quint64 setID, quint64 size);
+
+    quint64     _findTile               (quint64 key, quint64* size = nullptr);
     bool        _findTileSetID          (const QString name, quint64& setID);
     void        _updateSetTotals        (QGCCachedTileSet* set);
     bool        _init                   ();
     bool        _connectDB              ();
     bool        _createDB               (QSqlDatabase& db, bool createDefault = true);
+    void        _migrateDB              (QSqlDatabase& db);
     void        _disconnectDB           ();
+    void        _resetDB                ();
     quint64     _getDefaultTileSet      ();
     void        _updateTotals           ();
     void        _deleteTileSet          (qulonglong id);
@@ -88,6 +107,13 @@ signals:
     void        internetStatus          (bool active);
 
 private:
+    typedef struct {
+        quint32 count       = 0;
+        quint64 size        = 0;
+        quint32 uniqueCount = 0;
+        quint64 uniqueSize  = 0;
+    } SetTotals_t;
+
     QQueue<QGCMapTask*>             _taskQueue;
     QMutex                          _taskQueueMutex;
     QWaitCondition                  _waitc;
@@ -103,6 +129,10 @@ private:
     time_t                          _lastUpdate;
     int                             _updateTimeout;
     int                             _hostLookupID;
+    int                             _writeBatchCount;
+    QHash<int, QSqlQuery*>          _preparedQueries;
+    QHash<quint64, SetTotals_t>     _setTotals;
+    QSet<quint64>                   _accessedTiles;
 };
 
 #endif // QGC_TILE_CACHE_WORKER_H
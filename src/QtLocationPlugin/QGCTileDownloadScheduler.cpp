@@ -0,0 +1,293 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file
+ *   @brief Map Tile Download Scheduler
+ *
+ */
+
+#include "QGCTileDownloadScheduler.h"
+#include "QGCMapEngine.h"
+#include "QGCFileDownload.h"
+
+#include <QNetworkAccessManager>
+#include <QNetworkProxy>
+
+QGC_LOGGING_CATEGORY(QGCTileDownloadSchedulerLog, "QGCTileDownloadSchedulerLog")
+
+static const double kLatencyAverageWeight = 0.1;
+
+//-----------------------------------------------------------------------------
+QGCTileDownload::QGCTileDownload(QGCTileDownloadScheduler* scheduler, quint64 key)
+    : _scheduler(scheduler)
+    , _key(key)
+{
+
+}
+
+//-----------------------------------------------------------------------------
+QGCTileDownload::~QGCTileDownload()
+{
+    cancel();
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCTileDownload::cancel()
+{
+    if (_scheduler) {
+        _scheduler->_cancel(this);
+    }
+}
+
+//-----------------------------------------------------------------------------
+QGCTileDownloadScheduler::QGCTileDownloadScheduler(QObject* parent)
+    : QObject(parent)
+    , _networkManager(nullptr)
+{
+    for (int i = 0; i < PriorityCount; i++) {
+        _averageLatencyMsecs[i] = 0;
+    }
+    _rateLimitTimer.setSingleShot(true);
+    connect(&_rateLimitTimer, &QTimer::timeout, this, &QGCTileDownloadScheduler::_dispatch);
+    _clock.start();
+}
+
+//-----------------------------------------------------------------------------
+QGCTileDownloadScheduler::~QGCTileDownloadScheduler()
+{
+    for (Download_t* download: _downloads) {
+        for (QGCTileDownload* handle: download->handles) {
+            handle->_scheduler = nullptr;
+        }
+        if (download->reply) {
+            disconnect(download->reply, nullptr, this, nullptr);
+            download->reply->abort();
+        }
+        delete download;
+    }
+}
+
+//-----------------------------------------------------------------------------
+QNetworkAccessManager*
+QGCTileDownloadScheduler::networkManager()
+{
+    if (!_networkManager) {
+        _networkManager = new QNetworkAccessManager(this);
+    }
+    return _networkManager;
+}
+
+//-----------------------------------------------------------------------------
+QGCTileDownload*
+QGCTileDownloadScheduler::download(const QString& type, quint64 key, const QNetworkRequest& request, Priority priority)
+{
+    QGCTileDownload* handle = new QGCTileDownload(this, key);
+    Download_t* download = _downloads.value(key, nullptr);
+    if (download) {
+        qCDebug(QGCTileDownloadSchedulerLog) << "Sharing pending download" << key << "priority" << priority;
+        download->handles.append(handle);
+        if (priority < download->priority) {
+            if (!download->reply) {
+                _queues[download->priority].removeOne(download);
+                _queues[priority].append(download);
+            }
+            download->priority = priority;
+        }
+    } else {
+        download = new Download_t;
+        download->key       = key;
+        download->type      = type;
+        download->request   = request;
+        download->priority  = priority;
+        download->reply     = nullptr;
+        download->handles.append(handle);
+        download->requestTime.start();
+        _downloads.insert(key, download);
+        _queues[priority].append(download);
+    }
+    _dispatch();
+    emit queueDepthChanged();
+    return handle;
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCTileDownloadScheduler::setMaxConcurrent(const QString& type, int maxConcurrent)
+{
+    _provider(type).maxConcurrent = qMax(1, maxConcurrent);
+    _dispatch();
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCTileDownloadScheduler::setMaxRequestsPerSecond(const QString& type, int maxRequestsPerSecond)
+{
+    _provider(type).maxRequestsPerSecond = qMax(0, maxRequestsPerSecond);
+    _dispatch();
+}
+
+//-----------------------------------------------------------------------------
+QGCTileDownloadScheduler::Provider_t&
+QGCTileDownloadScheduler::_provider(const QString& type)
+{
+    auto iter = _providers.find(type);
+    if (iter == _providers.end()) {
+        Provider_t provider;
+        provider.maxConcurrent          = QGCMapEngine::concurrentDownloads(type);
+        provider.maxRequestsPerSecond   = 0;
+        provider.inFlight               = 0;
+        iter = _providers.insert(type, provider);
+    }
+    return *iter;
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCTileDownloadScheduler::_dispatch()
+{
+    _rateLimitTimer.stop();
+    const qint64 now = _clock.elapsed();
+    qint64 nextStartMsecs = -1;
+    for (int priority = 0; priority < PriorityCount; priority++) {
+        QList<Download_t*>& queue = _queues[priority];
+        int i = 0;
+        while (i < queue.count()) {
+            Download_t* download = queue[i];
+            Provider_t& provider = _provider(download->type);
+            //-- Keep a slot free for the visible map so it never waits behind a tile set download
+            const int maxConcurrent = priority == PriorityViewport ? provider.maxConcurrent : qMax(1, provider.maxConcurrent - 1);
+            if (provider.inFlight >= maxConcurrent) {
+                i++;
+                continue;
+            }
+            if (provider.maxRequestsPerSecond > 0) {
+                while (!provider.recentStarts.isEmpty() && now - provider.recentStarts.first() >= 1000) {
+                    provider.recentStarts.removeFirst();
+                }
+                if (provider.recentStarts.count() >= provider.maxRequestsPerSecond) {
+                    const qint64 waitMsecs = 1000 - (now - provider.recentStarts.first());
+                    nextStartMsecs = nextStartMsecs < 0 ? waitMsecs : qMin(nextStartMsecs, waitMsecs);
+                    i++;
+                    continue;
+                }
+                provider.recentStarts.append(now);
+            }
+            queue.removeAt(i);
+            _start(download);
+        }
+    }
+    if (nextStartMsecs >= 0) {
+        _rateLimitTimer.start(static_cast<int>(nextStartMsecs));
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCTileDownloadScheduler::_start(Download_t* download)
+{
+    QNetworkAccessManager* manager = networkManager();
+#if !defined(__mobile__)
+    QNetworkProxy proxy = manager->proxy();
+    QNetworkProxy tProxy;
+    tProxy.setType(QNetworkProxy::DefaultProxy);
+    manager->setProxy(tProxy);
+#endif
+    QNetworkReply* reply = manager->get(download->request);
+    QGCFileDownload::setIgnoreSSLErrorsIfNeeded(*reply);
+    connect(reply, &QNetworkReply::finished, this, &QGCTileDownloadScheduler::_replyFinished);
+#if !defined(__mobile__)
+    manager->setProxy(proxy);
+#endif
+    download->reply = reply;
+    _replies.insert(reply, download);
+    _provider(download->type).inFlight++;
+    qCDebug(QGCTileDownloadSchedulerLog) << "Download started" << download->key << "priority" << download->priority << "queued msecs" << download->requestTime.elapsed();
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCTileDownloadScheduler::_replyFinished()
+{
+    QNetworkReply* reply = qobject_cast<QNetworkReply*>(QObject::sender());
+    if (!reply) {
+        return;
+    }
+    reply->deleteLater();
+    Download_t* download = _replies.take(reply);
+    if (!download) {
+        return;
+    }
+    _provider(download->type).inFlight--;
+    _downloads.remove(download->key);
+
+    QByteArray data;
+    QString errorString;
+    const QNetworkReply::NetworkError error = reply->error();
+    if (error == QNetworkReply::NoError) {
+        data = reply->readAll();
+    } else {
+        errorString = reply->errorString();
+    }
+
+    const qint64 latency = download->requestTime.elapsed();
+    double& average = _averageLatencyMsecs[download->priority];
+    average = average == 0 ? latency : average + (latency - average) * kLatencyAverageWeight;
+    qCDebug(QGCTileDownloadSchedulerLog) << "Download finished" << download->key << "priority" << download->priority << "latency" << latency << "error" << error
+                                         << "queued" << _queues[PriorityViewport].count() << _queues[PriorityPrefetch].count() << _queues[PriorityBulk].count();
+
+    //-- Handles may be deleted (or new downloads requested) from within finished
+    QList<QPointer<QGCTileDownload>> handles;
+    for (QGCTileDownload* handle: download->handles) {
+        handle->_scheduler = nullptr;
+        handles.append(handle);
+    }
+    delete download;
+
+    _dispatch();
+    emit queueDepthChanged();
+
+    for (const QPointer<QGCTileDownload>& handle: handles) {
+        if (handle) {
+            emit handle->finished(data, error, errorString);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCTileDownloadScheduler::_cancel(QGCTileDownload* handle)
+{
+    handle->_scheduler = nullptr;
+    Download_t* download = _downloads.value(handle->key(), nullptr);
+    if (!download) {
+        return;
+    }
+    download->handles.removeOne(handle);
+    if (!download->handles.isEmpty()) {
+        return;
+    }
+    qCDebug(QGCTileDownloadSchedulerLog) << "Download cancelled" << download->key << "in flight" << (download->reply != nullptr);
+    _downloads.remove(download->key);
+    if (download->reply) {
+        QNetworkReply* reply = download->reply;
+        _replies.remove(reply);
+        _provider(download->type).inFlight--;
+        disconnect(reply, nullptr, this, nullptr);
+        reply->abort();
+        reply->deleteLater();
+    } else {
+        _queues[download->priority].removeOne(download);
+    }
+    delete download;
+    _dispatch();
+    emit queueDepthChanged();
+}
@@ -0,0 +1,140 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file
+ *   @brief Map Tile Download Scheduler
+ *
+ */
+
+#ifndef QGC_TILE_DOWNLOAD_SCHEDULER_H
+#define QGC_TILE_DOWNLOAD_SCHEDULER_H
+
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+
+#include "QGCLoggingCategory.h"
+
+Q_DECLARE_LOGGING_CATEGORY(QGCTileDownloadSchedulerLog)
+
+class QNetworkAccessManager;
+class QGCTileDownloadScheduler;
+
+//-----------------------------------------------------------------------------
+/// Handle to a tile download requested from QGCTileDownloadScheduler. The requester owns the
+/// handle, deleting it (or calling cancel) withdraws the request. finished is emitted exactly once
+/// unless the request is withdrawn first.
+class QGCTileDownload : public QObject
+{
+    Q_OBJECT
+public:
+    ~QGCTileDownload();
+
+    quint64     key                 () const { return _key; }
+    void        cancel              ();
+
+signals:
+    void        finished            (QByteArray data, QNetworkReply::NetworkError error, QString errorString);
+
+private:
+    QGCTileDownload(QGCTileDownloadScheduler* scheduler, quint64 key);
+
+    QPointer<QGCTileDownloadScheduler>  _scheduler;
+    quint64                             _key;
+
+    friend class QGCTileDownloadScheduler;
+};
+
+//-----------------------------------------------------------------------------
+/// Shared download queue for map tiles. All tile network traffic goes through here so that:
+/// - tiles for the visible map are fetched ahead of prefetch and offline set downloads
+/// - each provider has its own concurrency and rate limits
+/// - a tile requested by several clients at once is only downloaded once
+/// Must only be used from the main thread.
+class QGCTileDownloadScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    enum Priority {
+        PriorityViewport = 0,   ///< Tiles for a map which is currently displayed
+        PriorityPrefetch,       ///< Tiles which are likely to be needed soon
+        PriorityBulk,           ///< Offline tile set downloads
+        PriorityCount
+    };
+
+    QGCTileDownloadScheduler        (QObject* parent = nullptr);
+    ~QGCTileDownloadScheduler       ();
+
+    /// Queues a download of the specified tile. An already pending download of the same tile is shared
+    /// and raised to the higher of the two priorities.
+    ///     @param type Map type, used to select the provider limits
+    QGCTileDownload*        download                (const QString& type, quint64 key, const QNetworkRequest& request, Priority priority);
+
+    /// Maximum number of simultaneous downloads from a provider. One of them is reserved for viewport tiles.
+    void                    setMaxConcurrent        (const QString& type, int maxConcurrent);
+    /// Maximum number of downloads started per second for a provider, 0 for no limit
+    void                    setMaxRequestsPerSecond (const QString& type, int maxRequestsPerSecond);
+
+    int                     queueDepth              (Priority priority) const { return _queues[priority].count(); }
+    int                     inFlightCount           () const { return _replies.count(); }
+    /// Running average of the time from request to completion
+    int                     averageLatencyMsecs     (Priority priority) const { return qRound(_averageLatencyMsecs[priority]); }
+
+    QNetworkAccessManager*  networkManager          ();
+
+signals:
+    void                    queueDepthChanged       ();
+
+private slots:
+    void                    _replyFinished          ();
+    void                    _dispatch               ();
+
+private:
+    typedef struct {
+        quint64                     key;
+        QString                     type;
+        QNetworkRequest             request;
+        Priority                    priority;
+        QList<QGCTileDownload*>     handles;
+        QNetworkReply*              reply;
+        QElapsedTimer               requestTime;
+    } Download_t;
+
+    typedef struct {
+        int                         maxConcurrent;
+        int                         maxRequestsPerSecond;
+        int                         inFlight;
+        QList<qint64>               recentStarts;
+    } Provider_t;
+
+    void                    _cancel                 (QGCTileDownload* handle);
+    void                    _start                  (Download_t* download);
+    Provider_t&             _provider               (const QString& type);
+
+    QNetworkAccessManager*              _networkManager;
+    QHash<quint64, Download_t*>         _downloads;
+    QHash<QNetworkReply*, Download_t*>  _replies;
+    QList<Download_t*>                  _queues[PriorityCount];
+    QHash<QString, Provider_t>          _providers;
+    double                              _averageLatencyMsecs[PriorityCount];
+    QTimer                              _rateLimitTimer;
+    QElapsedTimer                       _clock;
+
+    friend class QGCTileDownload;
+};
+
+#endif // QGC_TILE_DOWNLOAD_SCHEDULER_H
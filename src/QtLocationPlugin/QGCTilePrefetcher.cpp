@@ -0,0 +1,325 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file
+ *   @brief Background prefetch of map and terrain tiles along a flight path
+ *
+ */
+
+#include "QGCTilePrefetcher.h"
+#include "QGCMapEngine.h"
+#include "QGCTileDownloadScheduler.h"
+#include "TerrainTile.h"
+
+#include <QtMath>
+
+QGC_LOGGING_CATEGORY(QGCTilePrefetcherLog, "QGCTilePrefetcherLog")
+
+static const int    kMaxOutstandingDownloads    = 24;       // Enough to keep the scheduler busy without flooding its queue
+static const double kMinSampleSpacingMeters     = 50.0;
+static const double kMinMapFootprintMeters      = 100.0;
+static const double kEarthCircumferenceMeters   = 40075016.686;
+
+//-----------------------------------------------------------------------------
+QGCTilePrefetcher::QGCTilePrefetcher(QObject* parent)
+    : QObject(parent)
+    , _bufferMeters(300)
+    , _minZoom(13)
+    , _maxZoom(19)
+    , _maxTiles(100000)
+    , _running(false)
+    , _generation(0)
+    , _tileCount(0)
+    , _cachedCount(0)
+    , _downloadedCount(0)
+    , _errorCount(0)
+    , _cachedSize(0)
+    , _downloadedSize(0)
+{
+
+}
+
+//-----------------------------------------------------------------------------
+QGCTilePrefetcher::~QGCTilePrefetcher()
+{
+    qDeleteAll(_downloads);
+}
+
+//-----------------------------------------------------------------------------
+double
+QGCTilePrefetcher::progress() const
+{
+    if(!_tileCount) {
+        return 0.0;
+    }
+    return static_cast<double>(_cachedCount + _downloadedCount + _errorCount) / _tileCount;
+}
+
+//-----------------------------------------------------------------------------
+QString
+QGCTilePrefetcher::cachedSizeStr() const
+{
+    return QGCMapEngine::bigSizeToString(_cachedSize);
+}
+
+//-----------------------------------------------------------------------------
+QString
+QGCTilePrefetcher::downloadedSizeStr() const
+{
+    return QGCMapEngine::bigSizeToString(_downloadedSize);
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCTilePrefetcher::setZoomRange(int minZoom, int maxZoom)
+{
+    _minZoom = qBound(1, minZoom, static_cast<int>(MAX_MAP_ZOOM));
+    _maxZoom = qBound(_minZoom, maxZoom, static_cast<int>(MAX_MAP_ZOOM));
+}
+
+//-----------------------------------------------------------------------------
+int
+QGCTilePrefetcher::maxZoomForAltitude(double altitude)
+{
+    //-- Zoom at which a single tile spans roughly twice the altitude. Higher zoom levels show more detail than is useful in flight.
+    const double footprint = qIsNaN(altitude) ? kMinMapFootprintMeters : qMax(2.0 * altitude, kMinMapFootprintMeters);
+    return qBound(1, static_cast<int>(qFloor(std::log2(kEarthCircumferenceMeters / footprint))), static_cast<int>(MAX_MAP_ZOOM));
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCTilePrefetcher::addPath(const QList<QGeoCoordinate>& path)
+{
+    if(!path.isEmpty()) {
+        _paths.append(path);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCTilePrefetcher::addArea(const QGeoRectangle& area, double altitude)
+{
+    if(area.isValid()) {
+        _areas.append({ area, altitude });
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCTilePrefetcher::cancel()
+{
+    _generation++;
+    qDeleteAll(_downloads);
+    _downloads.clear();
+    _pendingKeys.clear();
+    _setRunning(false);
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCTilePrefetcher::start(const QString& mapType)
+{
+    cancel();
+    _keys.clear();
+    _tileCount          = 0;
+    _cachedCount        = 0;
+    _downloadedCount    = 0;
+    _errorCount         = 0;
+    _cachedSize         = 0;
+    _downloadedSize     = 0;
+
+    //-- Collect the tiles around each path, sampled often enough for the buffer to form a continuous corridor
+    bool full = false;
+    const double sampleSpacing = qMax(_bufferMeters, kMinSampleSpacingMeters);
+    for(const QList<QGeoCoordinate>& path: _paths) {
+        if(full) {
+            break;
+        }
+        if(path.count() == 1) {
+            full = !_addBufferedArea(mapType, path.first(), _bufferMeters, path.first().altitude());
+            continue;
+        }
+        for(int i = 1; i < path.count() && !full; i++) {
+            const QGeoCoordinate& from  = path[i - 1];
+            const QGeoCoordinate& to    = path[i];
+            const double distance       = from.distanceTo(to);
+            const double azimuth        = from.azimuthTo(to);
+            //-- The lower end of the segment determines how much detail is needed
+            const double altitude       = qMin(from.altitude(), to.altitude());
+            const int samples           = qMax(1, qCeil(distance / sampleSpacing));
+            for(int j = 0; j <= samples && !full; j++) {
+                full = !_addBufferedArea(mapType, from.atDistanceAndAzimuth(distance * j / samples, azimuth), _bufferMeters, altitude);
+            }
+        }
+    }
+    for(const Area_t& area: _areas) {
+        if(full) {
+            break;
+        }
+        const double diagonal = qMax(_bufferMeters, 1.0) * M_SQRT2;
+        QGeoRectangle rect(area.rect.topLeft().atDistanceAndAzimuth(diagonal, 315), area.rect.bottomRight().atDistanceAndAzimuth(diagonal, 135));
+        full = !_addTiles(mapType, rect, _minZoom, qMin(_maxZoom, maxZoomForAltitude(area.altitude))) ||
+               !_addTiles(UrlFactory::kCopernicusElevationProviderKey, rect, 1, 1);
+    }
+    _paths.clear();
+    _areas.clear();
+    if(full) {
+        qCWarning(QGCTilePrefetcherLog) << "Prefetch limited to" << _maxTiles << "tiles";
+    }
+
+    _tileCount = static_cast<quint32>(_keys.count());
+    emit progressChanged();
+    if(!_tileCount) {
+        return;
+    }
+    qCDebug(QGCTilePrefetcherLog) << "Prefetch started" << mapType << "tiles" << _tileCount;
+    _setRunning(true);
+
+    //-- Results for a prefetch which has since been cancelled or restarted are dropped
+    const int generation = _generation;
+    QGCFindMissingTilesTask* task = new QGCFindMissingTilesTask(_keys.values());
+    _keys.clear();
+    connect(task, &QGCFindMissingTilesTask::missingTilesFound, this, [this, generation](QList<quint64> missingKeys, quint64 cachedSize) {
+        if(generation == _generation) {
+            _missingTilesFound(missingKeys, cachedSize);
+        }
+    });
+    connect(task, &QGCMapTask::error, this, [this, generation](QGCMapTask::TaskType, QString errorString) {
+        if(generation == _generation) {
+            qCWarning(QGCTilePrefetcherLog) << "Prefetch failed:" << errorString;
+            _setRunning(false);
+        }
+    });
+    getQGCMapEngine()->addTask(task);
+}
+
+//-----------------------------------------------------------------------------
+bool
+QGCTilePrefetcher::_addBufferedArea(const QString& mapType, const QGeoCoordinate& center, double halfSize, double altitude)
+{
+    const double diagonal = qMax(halfSize, 1.0) * M_SQRT2;
+    QGeoRectangle rect(center.atDistanceAndAzimuth(diagonal, 315), center.atDistanceAndAzimuth(diagonal, 135));
+    return _addTiles(mapType, rect, _minZoom, qMin(_maxZoom, maxZoomForAltitude(altitude))) &&
+           _addTiles(UrlFactory::kCopernicusElevationProviderKey, rect, 1, 1);
+}
+
+//-----------------------------------------------------------------------------
+bool
+QGCTilePrefetcher::_addTiles(const QString& type, const QGeoRectangle& rect, int minZoom, int maxZoom)
+{
+    UrlFactory* urlFactory = getQGCMapEngine()->urlFactory();
+    for(int z = minZoom; z <= maxZoom; z++) {
+        //-- Not all providers number tiles from the north west corner
+        const int x0 = urlFactory->long2tileX(type, rect.topLeft().longitude(), z);
+        const int x1 = urlFactory->long2tileX(type, rect.bottomRight().longitude(), z);
+        const int y0 = urlFactory->lat2tileY(type, rect.topLeft().latitude(), z);
+        const int y1 = urlFactory->lat2tileY(type, rect.bottomRight().latitude(), z);
+        for(int x = qMin(x0, x1); x <= qMax(x0, x1); x++) {
+            for(int y = qMin(y0, y1); y <= qMax(y0, y1); y++) {
+                if(static_cast<quint32>(_keys.count()) >= _maxTiles) {
+                    return false;
+                }
+                _keys.insert(QGCMapEngine::getTileKey(type, x, y, z));
+            }
+        }
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCTilePrefetcher::_missingTilesFound(QList<quint64> missingKeys, quint64 cachedSize)
+{
+    _cachedCount    = _tileCount - static_cast<quint32>(missingKeys.count());
+    _cachedSize     = cachedSize;
+    _pendingKeys    = missingKeys;
+    qCDebug(QGCTilePrefetcherLog) << "Tiles already cached" << _cachedCount << "to download" << _pendingKeys.count();
+    emit progressChanged();
+    _downloadNext();
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCTilePrefetcher::_downloadNext()
+{
+    QGCTileDownloadScheduler* scheduler = getQGCMapEngine()->tileDownloadScheduler();
+    UrlFactory* urlFactory = getQGCMapEngine()->urlFactory();
+    bool errors = false;
+    while(!_pendingKeys.isEmpty() && _downloads.count() < kMaxOutstandingDownloads) {
+        const quint64 key = _pendingKeys.takeFirst();
+        const QString type = getQGCMapEngine()->tileKeyToType(key);
+        int x, y, z;
+        QNetworkRequest request;
+        if(QGCMapEngine::getTileFromKey(key, x, y, z)) {
+            request = urlFactory->getTileURL(type, x, y, z, scheduler->networkManager());
+        }
+        if(request.url().isEmpty()) {
+            _errorCount++;
+            errors = true;
+            continue;
+        }
+        QGCTileDownload* download = scheduler->download(type, key, request, QGCTileDownloadScheduler::PriorityPrefetch);
+        connect(download, &QGCTileDownload::finished, this, &QGCTilePrefetcher::_downloadFinished);
+        _downloads.insert(key, download);
+    }
+    if(errors) {
+        emit progressChanged();
+    }
+    if(_running && _pendingKeys.isEmpty() && _downloads.isEmpty()) {
+        qCDebug(QGCTilePrefetcherLog) << "Prefetch complete. Cached:" << _cachedCount << cachedSizeStr()
+                                      << "Downloaded:" << _downloadedCount << downloadedSizeStr() << "Errors:" << _errorCount;
+        _setRunning(false);
+    }
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCTilePrefetcher::_downloadFinished(QByteArray image, QNetworkReply::NetworkError error, QString errorString)
+{
+    QGCTileDownload* download = qobject_cast<QGCTileDownload*>(QObject::sender());
+    if(!download) {
+        return;
+    }
+    download->deleteLater();
+    const quint64 key = download->key();
+    _downloads.remove(key);
+    bool cached = false;
+    if(error == QNetworkReply::NoError) {
+        const QString type = getQGCMapEngine()->tileKeyToType(key);
+        if(getQGCMapEngine()->urlFactory()->isElevation(type)) {
+            image = TerrainTile::serializeFromAirMapJson(image);
+        }
+        const QString format = getQGCMapEngine()->urlFactory()->getImageFormat(type, image);
+        if(!format.isEmpty()) {
+            getQGCMapEngine()->cacheTile(type, key, image, format);
+            _downloadedCount++;
+            _downloadedSize += static_cast<quint64>(image.size());
+            cached = true;
+        }
+    } else {
+        qCDebug(QGCTilePrefetcherLog) << "Error fetching tile" << key << errorString;
+    }
+    if(!cached) {
+        _errorCount++;
+    }
+    emit progressChanged();
+    _downloadNext();
+}
+
+//-----------------------------------------------------------------------------
+void
+QGCTilePrefetcher::_setRunning(bool running)
+{
+    if(_running != running) {
+        _running = running;
+        emit runningChanged();
+    }
+}
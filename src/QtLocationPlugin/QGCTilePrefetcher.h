@@ -0,0 +1,121 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+
+/**
+ * @file
+ *   @brief Background prefetch of map and terrain tiles along a flight path
+ *
+ */
+
+#ifndef QGC_TILE_PREFETCHER_H
+#define QGC_TILE_PREFETCHER_H
+
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <QSet>
+#include <QList>
+#include <QGeoCoordinate>
+#include <QGeoRectangle>
+#include <QNetworkReply>
+
+#include "QGCLoggingCategory.h"
+
+Q_DECLARE_LOGGING_CATEGORY(QGCTilePrefetcherLog)
+
+class QGCTileDownload;
+
+//-----------------------------------------------------------------------------
+/// Downloads the map and terrain tiles covering a set of paths and areas into the default tile set,
+/// so they are available when flying without connectivity. Only tiles missing from the cache are
+/// downloaded, at prefetch priority so the visible map is never held up.
+class QGCTilePrefetcher : public QObject
+{
+    Q_OBJECT
+public:
+    QGCTilePrefetcher                   (QObject* parent = nullptr);
+    ~QGCTilePrefetcher                  ();
+
+    Q_PROPERTY(bool     running             READ running            NOTIFY runningChanged)
+    Q_PROPERTY(quint32  tileCount           READ tileCount          NOTIFY progressChanged)
+    Q_PROPERTY(quint32  completedCount      READ completedCount     NOTIFY progressChanged)    ///< Tiles found in cache or downloaded
+    Q_PROPERTY(quint32  errorCount          READ errorCount         NOTIFY progressChanged)
+    Q_PROPERTY(double   progress            READ progress           NOTIFY progressChanged)    ///< 0.0 to 1.0
+    Q_PROPERTY(QString  cachedSizeStr       READ cachedSizeStr      NOTIFY progressChanged)    ///< Size of tiles which were already cached and didn't need downloading
+    Q_PROPERTY(QString  downloadedSizeStr   READ downloadedSizeStr  NOTIFY progressChanged)
+
+    Q_INVOKABLE void cancel             ();
+
+    bool        running                 () const { return _running; }
+    quint32     tileCount               () const { return _tileCount; }
+    quint32     completedCount          () const { return _cachedCount + _downloadedCount; }
+    quint32     errorCount              () const { return _errorCount; }
+    double      progress                () const;
+    quint64     cachedSize              () const { return _cachedSize; }
+    quint64     downloadedSize          () const { return _downloadedSize; }
+    QString     cachedSizeStr           () const;
+    QString     downloadedSizeStr       () const;
+
+    /// Distance around paths and areas to include
+    void        setBuffer               (double meters) { _bufferMeters = meters; }
+    /// Zoom levels to prefetch. The maximum is further limited by the altitude of the path.
+    void        setZoomRange            (int minZoom, int maxZoom);
+    void        setMaxTiles             (quint32 maxTiles) { _maxTiles = maxTiles; }
+
+    /// Coordinate altitudes are taken as height above ground
+    void        addPath                 (const QList<QGeoCoordinate>& path);
+    void        addArea                 (const QGeoRectangle& area, double altitude);
+
+    /// Starts downloading the tiles for the paths and areas added so far, cancelling any prefetch in progress
+    ///     @param mapType Map tiles to fetch (terrain tiles are always included)
+    void        start                   (const QString& mapType);
+
+    /// @return Highest zoom level worth fetching when flying at the specified height above ground
+    static int  maxZoomForAltitude      (double altitude);
+
+signals:
+    void        runningChanged          ();
+    void        progressChanged         ();
+
+private slots:
+    void        _missingTilesFound      (QList<quint64> missingKeys, quint64 cachedSize);
+    void        _downloadFinished       (QByteArray image, QNetworkReply::NetworkError error, QString errorString);
+
+private:
+    typedef struct {
+        QGeoRectangle   rect;
+        double          altitude;
+    } Area_t;
+
+    bool        _addTiles               (const QString& type, const QGeoRectangle& rect, int minZoom, int maxZoom);
+    bool        _addBufferedArea        (const QString& mapType, const QGeoCoordinate& center, double halfSize, double altitude);
+    void        _downloadNext           ();
+    void        _setRunning             (bool running);
+
+    double                          _bufferMeters;
+    int                             _minZoom;
+    int                             _maxZoom;
+    quint32                         _maxTiles;
+    QList<QList<QGeoCoordinate>>    _paths;
+    QList<Area_t>                   _areas;
+    QSet<quint64>                   _keys;
+    QList<quint64>                  _pendingKeys;
+    QHash<quint64, QGCTileDownload*> _downloads;
+    bool                            _running;
+    int                             _generation;
+    quint32                         _tileCount;
+    quint32                         _cachedCount;
+    quint32                         _downloadedCount;
+    quint32                         _errorCount;
+    quint64                         _cachedSize;
+    quint64                         _downloadedSize;
+};
+
+#endif // QGC_TILE_PREFETCHER_H
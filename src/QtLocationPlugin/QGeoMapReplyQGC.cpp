@@ -57,11 +57,10 @@ int         QGeoTiledMapReplyQGC::_requestCount = 0;
 QByteArray  QGeoTiledMapReplyQGC::_bingNoTileImage;
 
 //-----------------------------------------------------------------------------
-QGeoTiledMapReplyQGC::QGeoTiledMapReplyQGC(QNetworkAccessManager *networkManager, const QNetworkRequest &request, const QGeoTileSpec &spec, QObject *parent)
+QGeoTiledMapReplyQGC::QGeoTiledMapReplyQGC(const QNetworkRequest &request, const QGeoTileSpec &spec, QObject *parent)
     : QGeoTiledMapReply(spec, parent)
-    , _reply(nullptr)
+    , _download(nullptr)
     , _request(request)
-    , _networkManager(networkManager)
 {
     if (_bingNoTileImage.count() == 0) {
         QFile file(":/res/BingNoTileBytes.dat");
@@ -98,9 +97,11 @@ void
 QGeoTiledMapReplyQGC::_clearReply()
 {
     _timer.stop();
-    if (_reply) {
-        _reply->deleteLater();
-        _reply = nullptr;
+    if (_download) {
+        //-- May be called from within the download's finished signal
+        _download->cancel();
+        _download->deleteLater();
+        _download = nullptr;
         _requestCount--;
     }
 }
@@ -109,26 +110,30 @@ QGeoTiledMapReplyQGC::_clearReply()
 void
 QGeoTiledMapReplyQGC::abort()
 {
-    _timer.stop();
-    if (_reply)
-        _reply->abort();
+    _clearReply();
     emit aborted();
 }
 
 //-----------------------------------------------------------------------------
 void
-QGeoTiledMapReplyQGC::networkReplyFinished()
+QGeoTiledMapReplyQGC::downloadFinished(QByteArray a, QNetworkReply::NetworkError error, QString errorString)
 {
     _timer.stop();
-    if (!_reply) {
-        emit aborted();
-        return;
-    }
-    if (_reply->error() != QNetworkReply::NoError) {
-        emit aborted();
+    if (error != QNetworkReply::NoError) {
+        //-- Test for a specialized, elevation data (not map tile)
+        if( getQGCMapEngine()->urlFactory()->isElevation(tileSpec().mapId())){
+            emit terrainDone(QByteArray(), error);
+        } else {
+            //-- Regular map tile
+            if (error != QNetworkReply::OperationCanceledError) {
+                qWarning() << "Fetch tile error:" << errorString;
+                setError(QGeoTiledMapReply::CommunicationError, errorString);
+            }
+            setFinished(true);
+        }
+        _clearReply();
         return;
     }
-    QByteArray a = _reply->readAll();
     UrlFactory* urlFactory = getQGCMapEngine()->urlFactory();
     QString format = urlFactory->getImageFormat(tileSpec().mapId(), a);
     //-- Test for a specialized, elevation data (not map tile)
@@ -163,28 +168,6 @@ QGeoTiledMapReplyQGC::networkReplyFinished()
     _clearReply();
 }
 
-//-----------------------------------------------------------------------------
-void
-QGeoTiledMapReplyQGC::networkReplyError(QNetworkReply::NetworkError error)
-{
-    _timer.stop();
-    if (!_reply) {
-        return;
-    }
-    //-- Test for a specialized, elevation data (not map tile)
-    if( getQGCMapEngine()->urlFactory()->isElevation(tileSpec().mapId())){
-        emit terrainDone(QByteArray(), error);
-    } else {
-        //-- Regular map tile
-        if (error != QNetworkReply::OperationCanceledError) {
-            qWarning() << "Fetch tile error:" << _reply->errorString();
-            setError(QGeoTiledMapReply::CommunicationError, _reply->errorString());
-        }
-        setFinished(true);
-    }
-    _clearReply();
-}
-
 //-----------------------------------------------------------------------------
 void
 QGeoTiledMapReplyQGC::cacheError(QGCMapTask::TaskType type, QString /*errorString*/)
@@ -200,23 +183,11 @@ QGeoTiledMapReplyQGC::cacheError(QGCMapTask::TaskType type, QString /*errorStrin
         if(type != QGCMapTask::taskFetchTile) {
             qWarning() << "QGeoTiledMapReplyQGC::cacheError() for wrong task";
         }
-        //-- Tile not in cache. Get it off the Internet.
-#if !defined(__mobile__)
-        QNetworkProxy proxy = _networkManager->proxy();
-        QNetworkProxy tProxy;
-        tProxy.setType(QNetworkProxy::DefaultProxy);
-        _networkManager->setProxy(tProxy);
-#endif
-        _reply = _networkManager->get(_request);
-        _reply->setParent(nullptr);
-
-        setIgnoreSSLErrorsIfNeeded(*_reply);
-
-        connect(_reply, &QNetworkReply::finished, this, &QGeoTiledMapReplyQGC::networkReplyFinished);
-        connect(_reply, SIGNAL(error(QNetworkReply::NetworkError)), this, SLOT(networkReplyError(QNetworkReply::NetworkError)));
-#if !defined(__mobile__)
-        _networkManager->setProxy(proxy);
-#endif
+        //-- Tile not in cache. Get it off the Internet, ahead of any prefetch or tile set downloads.
+        const QString type = getQGCMapEngine()->urlFactory()->getTypeFromId(tileSpec().mapId());
+        _download = getQGCMapEngine()->tileDownloadScheduler()->download(
+            type, QGCMapEngine::getTileKey(type, tileSpec().x(), tileSpec().y(), tileSpec().zoom()), _request, QGCTileDownloadScheduler::PriorityViewport);
+        connect(_download, &QGCTileDownload::finished, this, &QGeoTiledMapReplyQGC::downloadFinished);
         //- Wait for an answer up to 10 seconds
         connect(&_timer, &QTimer::timeout, this, &QGeoTiledMapReplyQGC::timeout);
         _timer.setSingleShot(true);
@@ -246,25 +217,6 @@ QGeoTiledMapReplyQGC::cacheReply(QGCCacheTile* tile)
 void
 QGeoTiledMapReplyQGC::timeout()
 {
-    if(_reply) {
-        _reply->abort();
-    }
+    _clearReply();
     emit aborted();
 }
-
-//-----------------------------------------------------------------------------
-void QGeoTiledMapReplyQGC::setIgnoreSSLErrorsIfNeeded(QNetworkReply& networkReply)
-{
-    // Some systems (like Ubuntu 22.04) only ship with OpenSSL 3.x, however Qt 5.15.2 links against OpenSSL 1.x.
-    // This results in unresolved symbols for EVP_PKEY_base_id and SSL_get_peer_certificate.
-    // To still get a connection we have to ignore certificate verification (connection is still encrypted but open to MITM attacks)
-    // See https://bugreports.qt.io/browse/QTBUG-115146
-    const bool sslLibraryBuildIs1x = (QSslSocket::sslLibraryBuildVersionNumber() & 0xf0000000) == 0x10000000;
-    const bool sslLibraryIs3x = (QSslSocket::sslLibraryVersionNumber() & 0xf0000000) == 0x30000000;
-    if (sslLibraryBuildIs1x && sslLibraryIs3x) {
-        //qWarning() << "Ignoring ssl certificates due to OpenSSL version mismatch";
-        QList<QSslError> errorsThatCanBeIgnored;
-        errorsThatCanBeIgnored << QSslError(QSslError::NoPeerCertificate);
-        networkReply.ignoreSslErrors(errorsThatCanBeIgnored);
-    }
-}
@@ -53,11 +53,13 @@
 
 #include "QGCMapEngineData.h"
 
+class QGCTileDownload;
+
 class QGeoTiledMapReplyQGC : public QGeoTiledMapReply
 {
     Q_OBJECT
 public:
-    QGeoTiledMapReplyQGC(QNetworkAccessManager*  networkManager, const QNetworkRequest& request, const QGeoTileSpec &spec, QObject *parent = 0);
+    QGeoTiledMapReplyQGC(const QNetworkRequest& request, const QGeoTileSpec &spec, QObject *parent = 0);
     ~QGeoTiledMapReplyQGC();
     void abort();
 
@@ -65,20 +67,17 @@ signals:
     void terrainDone            (QByteArray responseBytes, QNetworkReply::NetworkError error);
 
 private slots:
-    void networkReplyFinished   ();
-    void networkReplyError      (QNetworkReply::NetworkError error);
+    void downloadFinished       (QByteArray data, QNetworkReply::NetworkError error, QString errorString);
     void cacheReply             (QGCCacheTile* tile);
     void cacheError             (QGCMapTask::TaskType type, QString errorString);
     void timeout                ();
 
 private:
     void _clearReply            ();
-    void setIgnoreSSLErrorsIfNeeded(QNetworkReply& networkReply);
 
 private:
-    QNetworkReply*          _reply;
+    QGCTileDownload*        _download;
     QNetworkRequest         _request;
-    QNetworkAccessManager*  _networkManager;
     QByteArray              _badMapbox;
     QByteArray              _badTile;
     QTimer                  _timer;
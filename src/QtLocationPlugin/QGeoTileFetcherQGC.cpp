@@ -76,7 +76,7 @@ QGeoTileFetcherQGC::getTileImage(const QGeoTileSpec &spec)
     //-- Build URL
     QNetworkRequest request = getQGCMapEngine()->urlFactory()->getTileURL(spec.mapId(), spec.x(), spec.y(), spec.zoom(), _networkManager);
     if ( ! request.url().isEmpty() ) {
-        return new QGeoTiledMapReplyQGC(_networkManager, request, spec);
+        return new QGeoTiledMapReplyQGC(request, spec);
     }
     else {
         return nullptr;
@@ -42,6 +42,10 @@ Item {
     property Fact   _esriFact:          _settingsManager ? _settingsManager.appSettings.esriToken : null
     property Fact   _customURLFact:     _settingsManager ? _settingsManager.appSettings.customURL : null
     property Fact   _vworldFact:        _settingsManager ? _settingsManager.appSettings.vworldToken : null
+    property Fact   _missionPrefetchFact:       _settings ? _settings.missionPrefetch : null
+    property Fact   _missionPrefetchBufferFact: _settings ? _settings.missionPrefetchBuffer : null
+    property var    _tilePrefetcher:            globals.planMasterControllerPlanView ? globals.planMasterControllerPlanView.tilePrefetcher : null
+    property bool   _prefetchRunning:           _tilePrefetcher ? _tilePrefetcher.running : false
 
     property string mapType:            _fmSettings ? (_fmSettings.mapProvider.value + " " + _fmSettings.mapType.value) : ""
     property bool   isMapInteractive:   false
@@ -214,7 +218,7 @@ Item {
     QGCFileDialog {
         id:             fileDialog
         folder:         QGroundControl.settingsManager.appSettings.missionSavePath
-        nameFilters:    ["Tile Sets (*.qgctiledb)"]
+        nameFilters:    ["Tile Sets (*.qgctiledb)", "MBTiles (*.mbtiles)"]
 
         onAcceptedForSave: {
             if (QGroundControl.mapEngineManager.exportSets(file)) {
@@ -295,6 +299,47 @@ Item {
                     text:           qsTr("Memory cache changes require a restart to take effect.")
                 }
 
+                Item { width: 1; height: 1; visible: _missionPrefetchFact ? _missionPrefetchFact.visible : false }
+                FactCheckBox {
+                    text:       qsTr("Prefetch Tiles For Plans")
+                    fact:       _missionPrefetchFact
+                    visible:    _missionPrefetchFact ? _missionPrefetchFact.visible : false
+                }
+                QGCLabel {
+                    anchors.left:   parent.left
+                    anchors.right:  parent.right
+                    wrapMode:       Text.WordWrap
+                    text:           qsTr("Downloads the map and terrain tiles covering a plan when it is loaded or sent to the vehicle.")
+                    visible:        _missionPrefetchFact ? _missionPrefetchFact.visible : false
+                    font.pointSize: _adjustableFontPointSize
+                }
+                QGCLabel {
+                    text:       qsTr("Prefetch Distance Around Plan")
+                    visible:    _missionPrefetchBufferFact ? _missionPrefetchBufferFact.visible : false
+                }
+                FactTextField {
+                    fact:       _missionPrefetchBufferFact
+                    enabled:    _missionPrefetchFact ? _missionPrefetchFact.rawValue : false
+                    visible:    _missionPrefetchBufferFact ? _missionPrefetchBufferFact.visible : false
+                    width:      ScreenTools.defaultFontPixelWidth * 12
+                }
+                QGCLabel {
+                    anchors.left:   parent.left
+                    anchors.right:  parent.right
+                    wrapMode:       Text.WordWrap
+                    text:           _tilePrefetcher ?
+                                        qsTr("Current plan: %1 of %2 tiles (%3%), %4 already cached, %5 downloaded").arg(_tilePrefetcher.completedCount).arg(_tilePrefetcher.tileCount)
+                                            .arg((_tilePrefetcher.progress * 100).toFixed(0)).arg(_tilePrefetcher.cachedSizeStr).arg(_tilePrefetcher.downloadedSizeStr) :
+                                        ""
+                    visible:        _tilePrefetcher ? _tilePrefetcher.tileCount > 0 : false
+                    font.pointSize: _adjustableFontPointSize
+                }
+                QGCButton {
+                    text:       qsTr("Cancel Prefetch")
+                    visible:    _prefetchRunning
+                    onClicked:  _tilePrefetcher.cancel()
+                }
+
                 Item { width: 1; height: 1; visible: _mapboxFact ? _mapboxFact.visible : false }
                 QGCLabel { text: qsTr("Mapbox Access Token"); visible: _mapboxFact ? _mapboxFact.visible : false }
                 FactTextField {
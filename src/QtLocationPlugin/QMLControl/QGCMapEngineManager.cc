@@ -19,6 +19,8 @@
 #include "QGCApplication.h"
 #include "QGCMapTileSet.h"
 #include "QGCMapUrlEngine.h"
+#include "SettingsManager.h"
+#include "FlightMapSettings.h"
 
 #include <QSettings>
 #include <QStorageInfo>
@@ -447,7 +449,7 @@ QGCMapEngineManager::selectedCount() {
 
 //-----------------------------------------------------------------------------
 bool
-QGCMapEngineManager::importSets(QString path) {
+QGCMapEngineManager::importSets(QString path, QString mapType) {
     _importAction = ActionNone;
     emit importActionChanged();
     QString dir = path;
@@ -466,7 +468,13 @@ QGCMapEngineManager::importSets(QString path) {
     if(!dir.isEmpty()) {
         _importAction = ActionImporting;
         emit importActionChanged();
-        QGCImportTileTask* task = new QGCImportTileTask(dir, _importReplace);
+        //-- MBTiles from other tools don't name a map type. Unless the caller picks one, their tiles are imported as the
+        //   map type on display.
+        if(mapType.isEmpty()) {
+            FlightMapSettings* flightMapSettings = qgcApp()->toolbox()->settingsManager()->flightMapSettings();
+            mapType = flightMapSettings->mapProvider()->rawValue().toString() + " " + flightMapSettings->mapType()->rawValue().toString();
+        }
+        QGCImportTileTask* task = new QGCImportTileTask(dir, _importReplace, mapType);
         connect(task, &QGCImportTileTask::actionCompleted, this, &QGCMapEngineManager::_actionCompleted);
         connect(task, &QGCImportTileTask::actionProgress, this, &QGCMapEngineManager::_actionProgressHandler);
         connect(task, &QGCMapTask::error, this, &QGCMapEngineManager::taskError);
@@ -70,7 +70,7 @@ public:
     Q_INVOKABLE void                selectAll               ();
     Q_INVOKABLE void                selectNone              ();
     Q_INVOKABLE bool                exportSets              (QString path = QString());
-    Q_INVOKABLE bool                importSets              (QString path = QString());
+    Q_INVOKABLE bool                importSets              (QString path = QString(), QString mapType = QString());
     Q_INVOKABLE void                resetAction             ();
 
     quint64                         tileCount               () const{ return _imageSet.tileCount + _elevationSet.tileCount; }
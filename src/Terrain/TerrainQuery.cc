@@ -8,6 +8,7 @@
  ****************************************************************************/
 
 #include "TerrainQuery.h"
+#include "TerrainQueryCache.h"
 #include "QGCMapEngine.h"
 #include "QGeoMapReplyQGC.h"
 #include "QGCFileDownload.h"
@@ -363,22 +364,42 @@ void TerrainTileManager::addCoordinateQuery(TerrainOfflineAirMapQuery* terrainQu
     }
 }
 
-/// Returns a list of individual coordinates along the requested path spaced according to the terrain tile value spacing
-QList<QGeoCoordinate> TerrainTileManager::pathQueryToCoords(const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord, double& distanceBetween, double& finalDistanceBetween)
+/// Returns a list of individual coordinates along the requested path. The path is walked across the elevation data
+/// grid such that each step advances at most one grid cell along either axis, with at least one step for each cell
+/// boundary crossed. This way no grid cell crossed by the path is skipped.
+///     @param gridTile Loaded tile whose grid the path is walked across, nominal 1 arc-second grid aligned to the tile
+///                     edges if nullptr
+QList<QGeoCoordinate> TerrainTileManager::pathQueryToCoords(const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord, double& distanceBetween, double& finalDistanceBetween, const TerrainTile* gridTile)
 {
     QList<QGeoCoordinate> coordinates;
 
     double lat      = fromCoord.latitude();
     double lon      = fromCoord.longitude();
-    double steps    = qCeil(toCoord.distanceTo(fromCoord) / TerrainTile::tileValueSpacingMeters);
     double latDiff  = toCoord.latitude() - lat;
     double lonDiff  = toCoord.longitude() - lon;
 
+    double cellSizeLat  = TerrainTile::tileValueSpacingDegrees;
+    double cellSizeLon  = TerrainTile::tileValueSpacingDegrees;
+    double originLat    = qFloor(lat / TerrainTile::tileSizeDegrees) * TerrainTile::tileSizeDegrees;
+    double originLon    = qFloor(lon / TerrainTile::tileSizeDegrees) * TerrainTile::tileSizeDegrees;
+    if (gridTile && gridTile->isValid()) {
+        cellSizeLat = gridTile->cellSizeLat();
+        cellSizeLon = gridTile->cellSizeLon();
+        originLat   = gridTile->southWest().latitude();
+        originLon   = gridTile->southWest().longitude();
+    }
+    auto cellSteps = [](double from, double to, double origin, double cellSize) {
+        const int boundariesCrossed = qAbs(qFloor((to - origin) / cellSize) - qFloor((from - origin) / cellSize));
+        return qMax(qCeil(qAbs(to - from) / cellSize), boundariesCrossed);
+    };
+    double steps    = qMax(cellSteps(lat, toCoord.latitude(), originLat, cellSizeLat), cellSteps(lon, toCoord.longitude(), originLon, cellSizeLon));
+
     if (steps == 0) {
         coordinates.append(fromCoord);
         coordinates.append(toCoord);
         distanceBetween = finalDistanceBetween = coordinates[0].distanceTo(coordinates[1]);
     } else {
+        coordinates.reserve(static_cast<int>(steps) + 1);
         for (double i = 0.0; i <= steps; i = i + 1) {
             coordinates.append(QGeoCoordinate(lat + latDiff * i / steps, lon + lonDiff * i / steps));
         }
@@ -388,8 +409,6 @@ QList<QGeoCoordinate> TerrainTileManager::pathQueryToCoords(const QGeoCoordinate
         finalDistanceBetween = coordinates[coordinates.count() - 2].distanceTo(coordinates.last());
     }
 
-    //qDebug() << "terrain" << startPoint.distanceTo(endPoint) << coordinates.count() << distanceBetween;
-
     qCDebug(TerrainQueryLog) << "TerrainTileManager::pathQueryToCoords fromCoord:toCoord:distanceBetween:finalDisanceBetween:coordCount" << fromCoord << toCoord << distanceBetween << finalDistanceBetween << coordinates.count();
 
     return coordinates;
@@ -401,7 +420,10 @@ void TerrainTileManager::addPathQuery(TerrainOfflineAirMapQuery* terrainQueryInt
     double distanceBetween;
     double finalDistanceBetween;
 
-    coordinates = pathQueryToCoords(startPoint, endPoint, distanceBetween, finalDistanceBetween);
+    _tilesMutex.lock();
+    const quint64 startTileKey = _getTileKey(startPoint);
+    coordinates = pathQueryToCoords(startPoint, endPoint, distanceBetween, finalDistanceBetween, _tiles.contains(startTileKey) ? &_tiles[startTileKey] : nullptr);
+    _tilesMutex.unlock();
 
     bool error;
     QList<double> altitudes;
@@ -430,12 +452,12 @@ bool TerrainTileManager::getAltitudesForCoordinates(const QList<QGeoCoordinate>&
     error = false;
 
     for (const QGeoCoordinate& coordinate: coordinates) {
-        QString tileHash = _getTileHash(coordinate);
-        qCDebug(TerrainQueryLog) << "TerrainTileManager::getAltitudesForCoordinates hash:coordinate" << tileHash << coordinate;
+        quint64 tileKey = _getTileKey(coordinate);
+        qCDebug(TerrainQueryLog) << "TerrainTileManager::getAltitudesForCoordinates key:coordinate" << tileKey << coordinate;
 
         _tilesMutex.lock();
-        if (_tiles.contains(tileHash)) {
-            double elevation = _tiles[tileHash].elevation(coordinate);
+        if (_tiles.contains(tileKey)) {
+            double elevation = _tiles[tileKey].elevation(coordinate);
             if (qIsNaN(elevation)) {
                 error = true;
                 qCWarning(TerrainQueryLog) << "TerrainTileManager::getAltitudesForCoordinates Internal Error: missing elevation in tile cache";
@@ -456,7 +478,7 @@ bool TerrainTileManager::getAltitudesForCoordinates(const QList<QGeoCoordinate>&
                 spec.setY(getQGCMapEngine()->urlFactory()->lat2tileY(kMapType, coordinate.latitude(), 1));
                 spec.setZoom(1);
                 spec.setMapId(getQGCMapEngine()->urlFactory()->getIdFromType(kMapType));
-                QGeoTiledMapReplyQGC* reply = new QGeoTiledMapReplyQGC(&_networkManager, request, spec);
+                QGeoTiledMapReplyQGC* reply = new QGeoTiledMapReplyQGC(request, spec);
                 connect(reply, &QGeoTiledMapReplyQGC::terrainDone, this, &TerrainTileManager::_terrainDone);
                 _state = State::Downloading;
             }
@@ -496,7 +518,7 @@ void TerrainTileManager::_terrainDone(QByteArray responseBytes, QNetworkReply::N
 
     // remove from download queue
     QGeoTileSpec spec = reply->tileSpec();
-    QString hash = QGCMapEngine::getTileHash(kMapType, spec.x(), spec.y(), spec.zoom());
+    quint64 tileKey = QGCMapEngine::getTileKey(kMapType, spec.x(), spec.y(), spec.zoom());
 
     // handle potential errors
     if (error != QNetworkReply::NoError) {
@@ -517,8 +539,8 @@ void TerrainTileManager::_terrainDone(QByteArray responseBytes, QNetworkReply::N
     TerrainTile* terrainTile = new TerrainTile(responseBytes);
     if (terrainTile->isValid()) {
         _tilesMutex.lock();
-        if (!_tiles.contains(hash)) {
-            _tiles.insert(hash, *terrainTile);
+        if (!_tiles.contains(tileKey)) {
+            _tiles.insert(tileKey, *terrainTile);
         } else {
             delete terrainTile;
         }
@@ -560,14 +582,14 @@ void TerrainTileManager::_terrainDone(QByteArray responseBytes, QNetworkReply::N
     }
 }
 
-QString TerrainTileManager::_getTileHash(const QGeoCoordinate& coordinate)
+quint64 TerrainTileManager::_getTileKey(const QGeoCoordinate& coordinate)
 {
-    QString ret = QGCMapEngine::getTileHash(
+    quint64 ret = QGCMapEngine::getTileKey(
         kMapType,
         getQGCMapEngine()->urlFactory()->long2tileX(kMapType, coordinate.longitude(), 1),
         getQGCMapEngine()->urlFactory()->lat2tileY(kMapType, coordinate.latitude(), 1),
         1);
-    qCDebug(TerrainQueryVerboseLog) << "Computing unique tile hash for " << coordinate << ret;
+    qCDebug(TerrainQueryVerboseLog) << "Computing unique tile key for " << coordinate << ret;
 
     return ret;
 }
@@ -718,16 +740,33 @@ void TerrainAtCoordinateQuery::requestData(const QList<QGeoCoordinate>& coordina
         return;
     }
 
+    _coordinates = coordinates;
+
+    QList<double> heights;
+    if (!qgcApp()->runningUnitTests() && qgcApp()->toolbox()->terrainQueryCache()->lookupCoordinateHeights(coordinates, heights)) {
+        // Callers expect results to be signalled asynchronously
+        QTimer::singleShot(0, this, [this, heights]() mutable { _signalTerrainData(true, heights); });
+        return;
+    }
+
     _TerrainAtCoordinateBatchManager->addQuery(this, coordinates);
 }
 
 bool TerrainAtCoordinateQuery::getAltitudesForCoordinates(const QList<QGeoCoordinate>& coordinates, QList<double>& altitudes, bool& error)
 {
+    if (!qgcApp()->runningUnitTests() && qgcApp()->toolbox()->terrainQueryCache()->lookupCoordinateHeights(coordinates, altitudes)) {
+        error = false;
+        return true;
+    }
+
     return _terrainTileManager->getAltitudesForCoordinates(coordinates, altitudes, error);
 }
 
 void TerrainAtCoordinateQuery::_signalTerrainData(bool success, QList<double>& heights)
 {
+    if (success && !qgcApp()->runningUnitTests()) {
+        qgcApp()->toolbox()->terrainQueryCache()->insertCoordinateHeights(_coordinates, heights);
+    }
     emit terrainDataReceived(success, heights);
     if (_autoDelete) {
         deleteLater();
@@ -743,26 +782,106 @@ TerrainPathQuery::TerrainPathQuery(bool autoDelete)
 
 void TerrainPathQuery::requestData(const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord)
 {
+    _fromCoord  = fromCoord;
+    _toCoord    = toCoord;
+
+    double          distanceBetween;
+    double          finalDistanceBetween;
+    QList<double>   heights;
+    if (!qgcApp()->runningUnitTests() && qgcApp()->toolbox()->terrainQueryCache()->lookupPathHeights(fromCoord, toCoord, distanceBetween, finalDistanceBetween, heights)) {
+        _pathHeights(true /* success */, distanceBetween, finalDistanceBetween, heights);
+        return;
+    }
+
     _terrainQuery.requestPathHeights(fromCoord, toCoord);
 }
 
 void TerrainPathQuery::_pathHeights(bool success, double distanceBetween, double finalDistanceBetween, const QList<double>& heights)
 {
+    if (success && !qgcApp()->runningUnitTests()) {
+        qgcApp()->toolbox()->terrainQueryCache()->insertPathHeights(_fromCoord, _toCoord, distanceBetween, finalDistanceBetween, heights);
+    }
+
     PathHeightInfo_t pathHeightInfo;
     pathHeightInfo.distanceBetween =        distanceBetween;
     pathHeightInfo.finalDistanceBetween =   finalDistanceBetween;
     pathHeightInfo.heights =                heights;
+    if (success) {
+        pathHeightInfo.simplifiedProfile =  simplifyPathHeights(pathHeightInfo, simplifiedProfileMaxError);
+    }
     emit terrainDataReceived(success, pathHeightInfo);
     if (_autoDelete) {
         deleteLater();
     }
 }
 
+/// Reduces the raw path heights to the minimum set of profile points such that the terrain height interpolated
+/// between two adjacent profile points never deviates more than maxError from the raw heights (Douglas-Peucker
+/// using vertical distance). First and last height are always part of the profile.
+///     @return List of points where x is distance along path and y is terrain height
+QList<QPointF> TerrainPathQuery::simplifyPathHeights(const PathHeightInfo_t& pathHeightInfo, double maxError)
+{
+    QList<QPointF> profile;
+
+    const QList<double>& heights = pathHeightInfo.heights;
+    const int cHeights = heights.count();
+    if (cHeights == 0) {
+        return profile;
+    }
+
+    auto distanceAtIndex = [&](int index) {
+        if (index == cHeights - 1 && index > 0) {
+            return ((index - 1) * pathHeightInfo.distanceBetween) + pathHeightInfo.finalDistanceBetween;
+        }
+        return index * pathHeightInfo.distanceBetween;
+    };
+
+    QVector<bool> keep(cHeights, false);
+    keep[0] = true;
+    keep[cHeights - 1] = true;
+
+    QVector<QPair<int, int>> ranges;
+    ranges.append(qMakePair(0, cHeights - 1));
+    while (!ranges.isEmpty()) {
+        const QPair<int, int> range = ranges.takeLast();
+        const int fromIndex = range.first;
+        const int toIndex   = range.second;
+        if (toIndex - fromIndex < 2) {
+            continue;
+        }
+
+        const double fromDistance   = distanceAtIndex(fromIndex);
+        const double slope          = (heights[toIndex] - heights[fromIndex]) / (distanceAtIndex(toIndex) - fromDistance);
+
+        int     maxErrorIndex   = -1;
+        double  curMaxError     = maxError;
+        for (int i=fromIndex+1; i<toIndex; i++) {
+            const double error = qAbs(heights[i] - (heights[fromIndex] + (slope * (distanceAtIndex(i) - fromDistance))));
+            if (error > curMaxError) {
+                curMaxError = error;
+                maxErrorIndex = i;
+            }
+        }
+
+        if (maxErrorIndex != -1) {
+            keep[maxErrorIndex] = true;
+            ranges.append(qMakePair(fromIndex, maxErrorIndex));
+            ranges.append(qMakePair(maxErrorIndex, toIndex));
+        }
+    }
+
+    for (int i=0; i<cHeights; i++) {
+        if (keep[i]) {
+            profile.append(QPointF(distanceAtIndex(i), heights[i]));
+        }
+    }
+
+    return profile;
+}
+
 TerrainPolyPathQuery::TerrainPolyPathQuery(bool autoDelete)
     : _autoDelete   (autoDelete)
-    , _pathQuery    (false /* autoDelete */)
 {
-    connect(&_pathQuery, &TerrainPathQuery::terrainDataReceived, this, &TerrainPolyPathQuery::_terrainDataReceived);
 }
 
 void TerrainPolyPathQuery::requestData(const QVariantList& polyPath)
@@ -780,33 +899,72 @@ void TerrainPolyPathQuery::requestData(const QList<QGeoCoordinate>& polyPath)
 {
     qCDebug(TerrainQueryLog) << "TerrainPolyPathQuery::requestData count" << polyPath.count();
 
-    // Kick off first request
-    _rgCoords = polyPath;
-    _curIndex = 0;
-    _pathQuery.requestData(_rgCoords[0], _rgCoords[1]);
+    // Queries from a previous request are discarded along with any results they still have outstanding. They may be
+    // signalling right now, so they are deleted later.
+    for (TerrainPathQuery* pathQuery: _rgPathQueries) {
+        disconnect(pathQuery, &TerrainPathQuery::terrainDataReceived, this, &TerrainPolyPathQuery::_terrainDataReceived);
+        pathQuery->deleteLater();
+    }
+    _rgPathQueries.clear();
+    _cReceived = 0;
+    _failed = false;
+    _rgPathHeightInfo.clear();
+
+    if (polyPath.count() < 2) {
+        // There is no path to query, the caller still gets its (failed) result
+        qCWarning(TerrainQueryLog) << "TerrainPolyPathQuery::requestData called with less than two coordinates";
+        _failed = true;
+        emit terrainDataReceived(false /* success */, _rgPathHeightInfo);
+        if (_autoDelete) {
+            deleteLater();
+        }
+        return;
+    }
+
+    // All segments are independent of each other so they are all requested at once. Segments which are covered
+    // by already cached tiles complete immediately, the remainder complete together as the missing tiles arrive.
+    int cSegments = polyPath.count() - 1;
+    _rgPathHeightInfo.reserve(cSegments);
+    _rgPathQueries.reserve(cSegments);
+    for (int i=0; i<cSegments; i++) {
+        TerrainPathQuery* pathQuery = new TerrainPathQuery(false /* autoDelete */);
+        pathQuery->setParent(this);
+        connect(pathQuery, &TerrainPathQuery::terrainDataReceived, this, &TerrainPolyPathQuery::_terrainDataReceived);
+        _rgPathQueries.append(pathQuery);
+        _rgPathHeightInfo.append(TerrainPathQuery::PathHeightInfo_t());
+    }
+
+    for (int i=0; i<cSegments && !_failed; i++) {
+        _rgPathQueries[i]->requestData(polyPath[i], polyPath[i+1]);
+    }
 }
 
 void TerrainPolyPathQuery::_terrainDataReceived(bool success, const TerrainPathQuery::PathHeightInfo_t& pathHeightInfo)
 {
-    qCDebug(TerrainQueryLog) << "TerrainPolyPathQuery::_terrainDataReceived success:_curIndex" << success << _curIndex;
+    int segmentIndex = _rgPathQueries.indexOf(qobject_cast<TerrainPathQuery*>(sender()));
+
+    qCDebug(TerrainQueryLog) << "TerrainPolyPathQuery::_terrainDataReceived success:segmentIndex" << success << segmentIndex;
+
+    if (_failed || segmentIndex == -1) {
+        return;
+    }
 
     if (!success) {
+        _failed = true;
         _rgPathHeightInfo.clear();
         emit terrainDataReceived(false /* success */, _rgPathHeightInfo);
         return;
     }
 
-    _rgPathHeightInfo.append(pathHeightInfo);
+    _rgPathHeightInfo[segmentIndex] = pathHeightInfo;
 
-    if (++_curIndex >= _rgCoords.count() - 1) {
+    if (++_cReceived == _rgPathQueries.count()) {
         // We've finished all requests
         qCDebug(TerrainQueryLog) << "TerrainPolyPathQuery::_terrainDataReceived complete";
         emit terrainDataReceived(true /* success */, _rgPathHeightInfo);
         if (_autoDelete) {
             deleteLater();
         }
-    } else {
-        _pathQuery.requestData(_rgCoords[_curIndex], _rgCoords[_curIndex+1]);
     }
 }
 
@@ -19,6 +19,7 @@
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QTimer>
+#include <QPointF>
 #include <QtLocation/private/qgeotiledmapreply_p.h>
 
 Q_DECLARE_LOGGING_CATEGORY(TerrainQueryLog)
@@ -120,7 +121,7 @@ public:
     void addPathQuery               (TerrainOfflineAirMapQuery* terrainQueryInterface, const QGeoCoordinate& startPoint, const QGeoCoordinate& endPoint);
     bool getAltitudesForCoordinates (const QList<QGeoCoordinate>& coordinates, QList<double>& altitudes, bool& error);
 
-    static QList<QGeoCoordinate> pathQueryToCoords(const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord, double& distanceBetween, double& finalDistanceBetween);
+    static QList<QGeoCoordinate> pathQueryToCoords(const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord, double& distanceBetween, double& finalDistanceBetween, const TerrainTile* gridTile = nullptr);
 
 private slots:
     void _terrainDone(QByteArray responseBytes, QNetworkReply::NetworkError error);
@@ -146,14 +147,14 @@ private:
     } QueuedRequestInfo_t;
 
     void    _tileFailed                         (void);
-    QString _getTileHash                        (const QGeoCoordinate& coordinate);
+    quint64 _getTileKey                         (const QGeoCoordinate& coordinate);
 
     QList<QueuedRequestInfo_t>  _requestQueue;
     State                       _state = State::Idle;
     QNetworkAccessManager       _networkManager;
 
     QMutex                      _tilesMutex;
-    QHash<QString, TerrainTile> _tiles;
+    QHash<quint64, TerrainTile> _tiles;
 };
 
 /// Used internally by TerrainAtCoordinateQuery to batch coordinate requests together
@@ -233,7 +234,8 @@ signals:
     void terrainDataReceived(bool success, QList<double> heights);
 
 private:
-    bool _autoDelete;
+    bool                    _autoDelete;
+    QList<QGeoCoordinate>   _coordinates;
 };
 
 class TerrainPathQuery : public QObject
@@ -253,8 +255,13 @@ public:
         double          distanceBetween;        ///< Distance between each height value
         double          finalDistanceBetween;   ///< Distance between final two height values
         QList<double>   heights;                ///< Terrain heights along path
+        QList<QPointF>  simplifiedProfile;      ///< Heights reduced to (distance, height) points within simplifiedProfileMaxError
     } PathHeightInfo_t;
 
+    static QList<QPointF> simplifyPathHeights(const PathHeightInfo_t& pathHeightInfo, double maxError);
+
+    static constexpr double simplifiedProfileMaxError = 1.0;    ///< Maximum vertical error in meters for simplifiedProfile
+
 signals:
     /// Signalled when terrain data comes back from server
     void terrainDataReceived(bool success, const PathHeightInfo_t& pathHeightInfo);
@@ -264,6 +271,8 @@ private slots:
 
 private:
     bool                        _autoDelete;
+    QGeoCoordinate              _fromCoord;
+    QGeoCoordinate              _toCoord;
     TerrainOfflineAirMapQuery   _terrainQuery;
 };
 
@@ -292,10 +301,10 @@ private slots:
 
 private:
     bool                                        _autoDelete;
-    int                                         _curIndex = 0;
-    QList<QGeoCoordinate>                       _rgCoords;
+    bool                                        _failed     = false;
+    int                                         _cReceived  = 0;
+    QList<TerrainPathQuery*>                    _rgPathQueries;             ///< One query per segment, all in flight at once
     QList<TerrainPathQuery::PathHeightInfo_t>   _rgPathHeightInfo;
-    TerrainPathQuery                            _pathQuery;
 };
 
 /// @brief Provides unit test terrain query responses.
@@ -0,0 +1,283 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainQueryCache.h"
+#include "QGCMapUrlEngine.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDataStream>
+#include <QStandardPaths>
+
+QGC_LOGGING_CATEGORY(TerrainQueryCacheLog, "TerrainQueryCacheLog")
+
+TerrainQueryCache::TerrainQueryCache(const QString& cacheFile, const QString& dataVersion, int maxEntries, qint64 maxBytes, QObject* parent)
+    : QObject       (parent)
+    , _cacheFile    (cacheFile)
+    , _dataVersion  (dataVersion)
+    , _maxEntries   (maxEntries)
+    , _maxBytes     (maxBytes)
+{
+    _flushTimer.setSingleShot(true);
+    _flushTimer.setInterval(_flushDelayMsecs);
+    connect(&_flushTimer, &QTimer::timeout, this, &TerrainQueryCache::flush);
+}
+
+TerrainQueryCache::~TerrainQueryCache()
+{
+    flush();
+}
+
+TerrainQueryCache* TerrainQueryCache::createDefault(QObject* parent)
+{
+    // Bump the trailing version whenever the way path heights are sampled changes
+    return new TerrainQueryCache(
+                QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/QGCTerrainQueryCache.bin"),
+                QString(UrlFactory::kCopernicusElevationProviderKey) + QStringLiteral(":1"),
+                250000,
+                64 * 1024 * 1024,
+                parent);
+}
+
+qint64 TerrainQueryCache::_entryBytes(const QByteArray& key, const Entry_t& entry)
+{
+    // Payload plus a rough allowance for the hash node and container headers
+    static const qint64 overheadBytes = 64;
+    return key.size() + static_cast<qint64>(sizeof(Entry_t)) + (entry.heights.count() * static_cast<qint64>(sizeof(double))) + overheadBytes;
+}
+
+QByteArray TerrainQueryCache::_coordinateKey(const QGeoCoordinate& coordinate)
+{
+    QByteArray key;
+    QDataStream stream(&key, QIODevice::WriteOnly);
+    stream << static_cast<quint8>('C')
+           << static_cast<qint32>(qRound(coordinate.latitude() * 1e7))
+           << static_cast<qint32>(qRound(coordinate.longitude() * 1e7));
+    return key;
+}
+
+QByteArray TerrainQueryCache::_pathKey(const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord)
+{
+    QByteArray key;
+    QDataStream stream(&key, QIODevice::WriteOnly);
+    stream << static_cast<quint8>('P')
+           << static_cast<qint32>(qRound(fromCoord.latitude() * 1e7))
+           << static_cast<qint32>(qRound(fromCoord.longitude() * 1e7))
+           << static_cast<qint32>(qRound(toCoord.latitude() * 1e7))
+           << static_cast<qint32>(qRound(toCoord.longitude() * 1e7));
+    return key;
+}
+
+bool TerrainQueryCache::lookupCoordinateHeights(const QList<QGeoCoordinate>& coordinates, QList<double>& heights)
+{
+    _load();
+
+    heights.clear();
+    heights.reserve(coordinates.count());
+    for (const QGeoCoordinate& coordinate: coordinates) {
+        auto iter = _entries.constFind(_coordinateKey(coordinate));
+        if (iter == _entries.constEnd() || iter->heights.count() != 1) {
+            heights.clear();
+            return false;
+        }
+        heights.append(iter->heights.first());
+    }
+
+    qCDebug(TerrainQueryCacheLog) << "Coordinate heights cache hit count" << coordinates.count();
+    return true;
+}
+
+void TerrainQueryCache::insertCoordinateHeights(const QList<QGeoCoordinate>& coordinates, const QList<double>& heights)
+{
+    if (coordinates.count() != heights.count()) {
+        return;
+    }
+
+    _load();
+
+    for (int i=0; i<coordinates.count(); i++) {
+        Entry_t entry = { 0, 0, { heights[i] } };
+        _insert(_coordinateKey(coordinates[i]), entry);
+    }
+}
+
+bool TerrainQueryCache::lookupPathHeights(const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord, double& distanceBetween, double& finalDistanceBetween, QList<double>& heights)
+{
+    _load();
+
+    auto iter = _entries.constFind(_pathKey(fromCoord, toCoord));
+    if (iter == _entries.constEnd()) {
+        return false;
+    }
+
+    qCDebug(TerrainQueryCacheLog) << "Path heights cache hit" << fromCoord << toCoord;
+
+    distanceBetween         = iter->distanceBetween;
+    finalDistanceBetween    = iter->finalDistanceBetween;
+    heights                 = iter->heights;
+    return true;
+}
+
+void TerrainQueryCache::insertPathHeights(const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord, double distanceBetween, double finalDistanceBetween, const QList<double>& heights)
+{
+    if (heights.isEmpty()) {
+        return;
+    }
+
+    _load();
+
+    Entry_t entry = { distanceBetween, finalDistanceBetween, heights };
+    _insert(_pathKey(fromCoord, toCoord), entry);
+}
+
+void TerrainQueryCache::_insert(const QByteArray& key, const Entry_t& entry)
+{
+    if (_entries.contains(key)) {
+        return;
+    }
+
+    const qint64 entryBytes = _entryBytes(key, entry);
+    if (entryBytes > _maxBytes) {
+        return;
+    }
+    if (_entries.count() >= _maxEntries || _bytes + entryBytes > _maxBytes) {
+        // Results are cheap to recompute from the tile cache, so simply start over instead of tracking usage
+        qCDebug(TerrainQueryCacheLog) << "Maximum size reached, clearing cache" << _entries.count() << _bytes;
+        clear();
+    }
+
+    _entries.insert(key, entry);
+    _bytes += entryBytes;
+    _pendingKeys.append(key);
+    if (!_flushTimer.isActive()) {
+        _flushTimer.start();
+    }
+}
+
+void TerrainQueryCache::clear(void)
+{
+    _flushTimer.stop();
+    _entries.clear();
+    _bytes = 0;
+    _pendingKeys.clear();
+    _loaded = true;
+    _writeHeader();
+}
+
+bool TerrainQueryCache::_writeHeader(void)
+{
+    QDir().mkpath(QFileInfo(_cacheFile).absolutePath());
+
+    QFile file(_cacheFile);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(TerrainQueryCacheLog) << "Failed to open" << _cacheFile << file.errorString();
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+    stream << _magic << _fileVersion << _dataVersion;
+    return stream.status() == QDataStream::Ok;
+}
+
+void TerrainQueryCache::_rewrite(void)
+{
+    _pendingKeys = _entries.keys();
+    if (_writeHeader()) {
+        flush();
+    }
+}
+
+void TerrainQueryCache::flush(void)
+{
+    _flushTimer.stop();
+
+    if (_pendingKeys.isEmpty()) {
+        return;
+    }
+
+    QFile file(_cacheFile);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qCWarning(TerrainQueryCacheLog) << "Failed to open" << _cacheFile << file.errorString();
+        _pendingKeys.clear();
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+    for (const QByteArray& key: _pendingKeys) {
+        auto iter = _entries.constFind(key);
+        if (iter != _entries.constEnd()) {
+            stream << key << iter->distanceBetween << iter->finalDistanceBetween << iter->heights;
+        }
+    }
+    qCDebug(TerrainQueryCacheLog) << "Flushed entries" << _pendingKeys.count();
+    _pendingKeys.clear();
+}
+
+void TerrainQueryCache::_load(void)
+{
+    if (_loaded) {
+        return;
+    }
+    _loaded = true;
+
+    QFile file(_cacheFile);
+    if (!file.exists()) {
+        _writeHeader();
+        return;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(TerrainQueryCacheLog) << "Failed to open" << _cacheFile << file.errorString();
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic       = 0;
+    quint32 fileVersion = 0;
+    QString dataVersion;
+    stream >> magic >> fileVersion >> dataVersion;
+    if (stream.status() != QDataStream::Ok || magic != _magic || fileVersion != _fileVersion || dataVersion != _dataVersion) {
+        qCDebug(TerrainQueryCacheLog) << "Discarding cache file with mismatched version" << fileVersion << dataVersion;
+        file.close();
+        _writeHeader();
+        return;
+    }
+
+    bool corrupt = false;
+    while (!stream.atEnd()) {
+        QByteArray  key;
+        Entry_t     entry;
+        stream >> key >> entry.distanceBetween >> entry.finalDistanceBetween >> entry.heights;
+        if (stream.status() != QDataStream::Ok) {
+            // Most likely a partially written record from a previous session
+            corrupt = true;
+            break;
+        }
+        if (!_entries.contains(key)) {
+            _bytes += _entryBytes(key, entry);
+        }
+        _entries.insert(key, entry);
+    }
+    file.close();
+
+    qCDebug(TerrainQueryCacheLog) << "Loaded entries" << _entries.count() << "bytes" << _bytes << "corrupt" << corrupt;
+
+    const bool overLimit = _entries.count() > _maxEntries || _bytes > _maxBytes;
+    if (corrupt || overLimit) {
+        if (overLimit) {
+            _entries.clear();
+            _bytes = 0;
+        }
+        _rewrite();
+    }
+}
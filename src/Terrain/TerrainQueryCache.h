@@ -0,0 +1,89 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "QGCLoggingCategory.h"
+
+#include <QObject>
+#include <QGeoCoordinate>
+#include <QHash>
+#include <QByteArray>
+#include <QTimer>
+
+Q_DECLARE_LOGGING_CATEGORY(TerrainQueryCacheLog)
+
+/**
+ * Persistent cache of computed terrain query results (coordinate heights and path heights).
+ * Notes:
+ * - entries are keyed by the query geometry (coordinates quantized to 1e-7 degrees)
+ * - the cache file is tagged with the terrain data version, a mismatch discards all entries
+ * - new entries are appended to the cache file in batches
+ * - not thread-safe, must be used from the main thread
+ */
+class TerrainQueryCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// @param maxEntries Maximum number of entries, the cache starts over once it is reached
+    /// @param maxBytes Maximum size of the entries held in memory, the cache starts over once it is reached
+    TerrainQueryCache(const QString& cacheFile, const QString& dataVersion, int maxEntries, qint64 maxBytes, QObject* parent = nullptr);
+    ~TerrainQueryCache();
+
+    /// Creates the application wide cache in the standard cache location. It is owned by the toolbox.
+    static TerrainQueryCache* createDefault(QObject* parent);
+
+    /// @return true: all heights found in cache
+    bool lookupCoordinateHeights(const QList<QGeoCoordinate>& coordinates, QList<double>& heights);
+    void insertCoordinateHeights(const QList<QGeoCoordinate>& coordinates, const QList<double>& heights);
+
+    /// @return true: path heights found in cache
+    bool lookupPathHeights(const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord, double& distanceBetween, double& finalDistanceBetween, QList<double>& heights);
+    void insertPathHeights(const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord, double distanceBetween, double finalDistanceBetween, const QList<double>& heights);
+
+    int     count   (void) { _load(); return _entries.count(); }
+    qint64  bytes   (void) { _load(); return _bytes; }
+
+    /// Removes all entries from memory and disk
+    void clear(void);
+
+    /// Writes pending entries to disk
+    void flush(void);
+
+private:
+    typedef struct {
+        double          distanceBetween;
+        double          finalDistanceBetween;
+        QList<double>   heights;
+    } Entry_t;
+
+    static QByteArray _coordinateKey(const QGeoCoordinate& coordinate);
+    static QByteArray _pathKey      (const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord);
+    static qint64     _entryBytes   (const QByteArray& key, const Entry_t& entry);
+
+    void _load          (void);
+    void _insert        (const QByteArray& key, const Entry_t& entry);
+    bool _writeHeader   (void);
+    void _rewrite       (void);
+
+    QString                     _cacheFile;
+    QString                     _dataVersion;
+    int                         _maxEntries;
+    qint64                      _maxBytes;
+    qint64                      _bytes  = 0;        ///< Approximate memory used by _entries
+    bool                        _loaded = false;
+    QHash<QByteArray, Entry_t>  _entries;
+    QList<QByteArray>           _pendingKeys;
+    QTimer                      _flushTimer;
+
+    static constexpr quint32    _magic          = 0x7e55a1c0;
+    static constexpr quint32    _fileVersion    = 1;
+    static constexpr int        _flushDelayMsecs = 1000;
+};
@@ -62,6 +62,21 @@ public:
     */
     double avgElevation(void) const { return _isValid ? _tileInfo.avgElevation : qQNaN(); }
 
+    /**
+    * Accessors for the size of a cell of the elevation data grid
+    *
+    * @return cell size in degrees
+    */
+    double cellSizeLat(void) const { return _isValid ? _cellSizeLat : qQNaN(); }
+    double cellSizeLon(void) const { return _isValid ? _cellSizeLon : qQNaN(); }
+
+    /**
+    * Accessor for the south west corner, where the elevation data grid starts
+    *
+    * @return south west corner
+    */
+    QGeoCoordinate southWest(void) const { return _isValid ? QGeoCoordinate(_tileInfo.swLat, _tileInfo.swLon) : QGeoCoordinate(); }
+
     /**
     * Accessor for the center coordinate
     *
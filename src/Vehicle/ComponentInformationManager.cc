@@ -24,9 +24,7 @@ QGC_LOGGING_CATEGORY(ComponentInformationManagerLog, "ComponentInformationManage
 const ComponentInformationManager::StateFn ComponentInformationManager::_rgStates[]= {
     ComponentInformationManager::_stateRequestCompInfoGeneral,
     ComponentInformationManager::_stateRequestCompInfoGeneralComplete,
-    ComponentInformationManager::_stateRequestCompInfoParam,
-    ComponentInformationManager::_stateRequestCompInfoEvents,
-    ComponentInformationManager::_stateRequestCompInfoActuators,
+    ComponentInformationManager::_stateRequestCompInfoTypes,
     ComponentInformationManager::_stateRequestAllCompInfoComplete
 };
 
@@ -42,19 +40,31 @@ const RequestMetaDataTypeStateMachine::StateFn RequestMetaDataTypeStateMachine::
     RequestMetaDataTypeStateMachine::_stateRequestComplete,
 };
 
+const char* RequestMetaDataTypeStateMachine::_rgStateNames[]= {
+    "CompInfo",
+    "CompInfoDeprecated",
+    "MetaDataJson",
+    "MetaDataJsonFallback",
+    "TranslationJson",
+    "Translate",
+    "Complete",
+};
+
 const int RequestMetaDataTypeStateMachine::_cStates = sizeof(RequestMetaDataTypeStateMachine::_rgStates) / sizeof(RequestMetaDataTypeStateMachine::_rgStates[0]);
 
 ComponentInformationManager::ComponentInformationManager(Vehicle* vehicle)
     : _vehicle                  (vehicle)
-    , _requestTypeStateMachine  (this)
     , _cachedFileDownload(new QGCCachedFileDownload(this, QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/QGCCompInfoFileDownloadCache")))
     , _fileCache(ComponentInformationCache::defaultInstance())
-    , _translation(new ComponentInformationTranslation(this, _cachedFileDownload))
 {
     _compInfoMap[MAV_COMP_ID_AUTOPILOT1][COMP_METADATA_TYPE_GENERAL]    = new CompInfoGeneral   (MAV_COMP_ID_AUTOPILOT1, vehicle, this);
     _compInfoMap[MAV_COMP_ID_AUTOPILOT1][COMP_METADATA_TYPE_PARAMETER]  = new CompInfoParam     (MAV_COMP_ID_AUTOPILOT1, vehicle, this);
     _compInfoMap[MAV_COMP_ID_AUTOPILOT1][COMP_METADATA_TYPE_EVENTS]     = new CompInfoEvents    (MAV_COMP_ID_AUTOPILOT1, vehicle, this);
     _compInfoMap[MAV_COMP_ID_AUTOPILOT1][COMP_METADATA_TYPE_ACTUATORS]  = new CompInfoActuators (MAV_COMP_ID_AUTOPILOT1, vehicle, this);
+
+    for (int i=0; i<_compInfoMap[MAV_COMP_ID_AUTOPILOT1].count(); i++) {
+        _requestTypeStateMachines.append(new RequestMetaDataTypeStateMachine(this));
+    }
 }
 
 int ComponentInformationManager::stateCount(void) const
@@ -72,7 +82,11 @@ float ComponentInformationManager::progress() const
     if (!_active)
         return 1.f;
     // here we could compute a more fine-grained progress, based on ftp download progress
-    return _stateIndex / (float)_cStates;
+    float stateProgress = 0;
+    if (currentState() == _stateRequestCompInfoTypes && _totalTypeRequests > 0) {
+        stateProgress = qBound(0.f, (_totalTypeRequests - _pendingTypeRequests) / (float)_totalTypeRequests, 1.f);
+    }
+    return (_stateIndex + stateProgress) / (float)_cStates;
 }
 
 void ComponentInformationManager::advance()
@@ -85,6 +99,7 @@ void ComponentInformationManager::requestAllComponentInformation(RequestAllCompl
 {
     _requestAllCompleteFn       = requestAllCompletFn;
     _requestAllCompleteFnData   = requestAllCompleteFnData;
+    _requestAllTime.start();
     start();
     emit progressUpdate(progress());
 }
@@ -92,12 +107,14 @@ void ComponentInformationManager::requestAllComponentInformation(RequestAllCompl
 void ComponentInformationManager::_stateRequestCompInfoGeneral(StateMachine* stateMachine)
 {
     ComponentInformationManager* compMgr = static_cast<ComponentInformationManager*>(stateMachine);
-    compMgr->_requestTypeStateMachine.request(compMgr->_compInfoMap[MAV_COMP_ID_AUTOPILOT1][COMP_METADATA_TYPE_GENERAL]);
+    compMgr->_pendingTypeRequests = 1;
+    compMgr->_requestTypeStateMachines[0]->request(compMgr->_compInfoMap[MAV_COMP_ID_AUTOPILOT1][COMP_METADATA_TYPE_GENERAL]);
 }
 
 void ComponentInformationManager::_stateRequestCompInfoGeneralComplete(StateMachine* stateMachine)
 {
     ComponentInformationManager* compMgr = static_cast<ComponentInformationManager*>(stateMachine);
+    qCDebug(ComponentInformationManagerLog) << "General metadata complete (ms)" << compMgr->_requestAllTime.elapsed();
     compMgr->_updateAllUri();
     compMgr->advance();
 }
@@ -112,48 +129,45 @@ void ComponentInformationManager::_updateAllUri()
 
 void ComponentInformationManager::_stateRequestCompInfoComplete(void)
 {
-    advance();
-}
-
-void ComponentInformationManager::_stateRequestCompInfoParam(StateMachine* stateMachine)
-{
-    ComponentInformationManager* compMgr = static_cast<ComponentInformationManager*>(stateMachine);
-
-    if (compMgr->_isCompTypeSupported(COMP_METADATA_TYPE_PARAMETER)) {
-        compMgr->_requestTypeStateMachine.request(compMgr->_compInfoMap[MAV_COMP_ID_AUTOPILOT1][COMP_METADATA_TYPE_PARAMETER]);
+    if (--_pendingTypeRequests == 0) {
+        advance();
     } else {
-        qCDebug(ComponentInformationManagerLog) << "_stateRequestCompInfoParam skipping, not supported";
-        compMgr->advance();
+        emit progressUpdate(progress());
     }
 }
 
-void ComponentInformationManager::_stateRequestCompInfoEvents(StateMachine* stateMachine)
+void ComponentInformationManager::_stateRequestCompInfoTypes(StateMachine* stateMachine)
 {
     ComponentInformationManager* compMgr = static_cast<ComponentInformationManager*>(stateMachine);
 
-    if (compMgr->_isCompTypeSupported(COMP_METADATA_TYPE_EVENTS)) {
-        compMgr->_requestTypeStateMachine.request(compMgr->_compInfoMap[MAV_COMP_ID_AUTOPILOT1][COMP_METADATA_TYPE_EVENTS]);
-    } else {
-        qCDebug(ComponentInformationManagerLog) << "_stateRequestCompInfoEvents skipping, not supported";
-        compMgr->advance();
+    // The general metadata provided the uris, the remaining types do not depend on each other. All of them are requested
+    // at once, each checking the file cache first, so cached types complete right away and the downloads of the others
+    // overlap instead of adding up. MAVLink FTP downloads are queued by FTPManager, http downloads run concurrently.
+    QList<CompInfo*> compInfos;
+    for (CompInfo* compInfo : compMgr->_compInfoMap[MAV_COMP_ID_AUTOPILOT1]) {
+        if (compInfo->type == COMP_METADATA_TYPE_GENERAL) {
+            continue;
+        }
+        if (compMgr->_isCompTypeSupported(compInfo->type)) {
+            compInfos.append(compInfo);
+        } else {
+            qCDebug(ComponentInformationManagerLog) << "_stateRequestCompInfoTypes skipping, not supported" << compInfo->type;
+        }
     }
-}
-
-void ComponentInformationManager::_stateRequestCompInfoActuators(StateMachine* stateMachine)
-{
-    ComponentInformationManager* compMgr = static_cast<ComponentInformationManager*>(stateMachine);
 
-    if (compMgr->_isCompTypeSupported(COMP_METADATA_TYPE_ACTUATORS)) {
-        compMgr->_requestTypeStateMachine.request(compMgr->_compInfoMap[MAV_COMP_ID_AUTOPILOT1][COMP_METADATA_TYPE_ACTUATORS]);
-    } else {
-        qCDebug(ComponentInformationManagerLog) << "_stateRequestCompInfoActuators skipping, not supported";
-        compMgr->advance();
+    // The extra count keeps requests which complete synchronously from advancing before all requests are started
+    compMgr->_totalTypeRequests     = compInfos.count();
+    compMgr->_pendingTypeRequests   = compInfos.count() + 1;
+    for (int i=0; i<compInfos.count(); i++) {
+        compMgr->_requestTypeStateMachines[i]->request(compInfos[i]);
     }
+    compMgr->_stateRequestCompInfoComplete();
 }
 
 void ComponentInformationManager::_stateRequestAllCompInfoComplete(StateMachine* stateMachine)
 {
     ComponentInformationManager* compMgr = static_cast<ComponentInformationManager*>(stateMachine);
+    qCDebug(ComponentInformationManagerLog) << "All component information complete (ms)" << compMgr->_requestAllTime.elapsed();
     (*compMgr->_requestAllCompleteFn)(compMgr->_requestAllCompleteFnData);
     compMgr->_requestAllCompleteFn      = nullptr;
     compMgr->_requestAllCompleteFnData  = nullptr;
@@ -185,9 +199,10 @@ QString ComponentInformationManager::_getFileCacheTag(int compInfoType, uint32_t
 
 
 RequestMetaDataTypeStateMachine::RequestMetaDataTypeStateMachine(ComponentInformationManager* compMgr)
-    : _compMgr(compMgr)
+    : _compMgr      (compMgr)
+    , _translation  (new ComponentInformationTranslation(this, compMgr->_cachedFileDownload))
 {
-
+    setParent(compMgr);
 }
 
 void RequestMetaDataTypeStateMachine::request(CompInfo* compInfo)
@@ -196,10 +211,24 @@ void RequestMetaDataTypeStateMachine::request(CompInfo* compInfo)
     _stateIndex = -1;
     _jsonMetadataFileName.clear();
     _jsonTranslationFileName.clear();
+    _stateTimings.clear();
+    _requestTime.start();
+    _stateTime.start();
 
     start();
 }
 
+void RequestMetaDataTypeStateMachine::advance(void)
+{
+    if (_active && _stateIndex >= 0 && _stateIndex < _cStates) {
+        _stateTimings.append(QStringLiteral("%1:%2").arg(_rgStateNames[_stateIndex]).arg(_stateTime.restart()));
+        if (_stateIndex == _cStates - 1) {
+            qCDebug(ComponentInformationManagerLog) << typeToString() << "complete (ms)" << _requestTime.elapsed() << _stateTimings.join(' ');
+        }
+    }
+    StateMachine::advance();
+}
+
 int RequestMetaDataTypeStateMachine::stateCount(void) const
 {
     return _cStates;
@@ -356,8 +385,12 @@ QString RequestMetaDataTypeStateMachine::_downloadCompleteJsonWorker(const QStri
     return outputFileName;
 }
 
-void RequestMetaDataTypeStateMachine::_ftpDownloadComplete(const QString& fileName, const QString& errorMsg)
+void RequestMetaDataTypeStateMachine::_ftpDownloadComplete(const QString& fileName, const QString& errorMsg, const QString& fromURI)
 {
+    if (fromURI != _currentFtpURI) {
+        return;
+    }
+
     qCDebug(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_ftpDownloadComplete fileName:errorMsg" << fileName << errorMsg;
 
     disconnect(_compInfo->vehicle->ftpManager(), &FTPManager::downloadComplete, this, &RequestMetaDataTypeStateMachine::_ftpDownloadComplete);
@@ -374,8 +407,15 @@ void RequestMetaDataTypeStateMachine::_ftpDownloadComplete(const QString& fileNa
     advance();
 }
 
-void RequestMetaDataTypeStateMachine::_ftpDownloadProgress(float progress)
+void RequestMetaDataTypeStateMachine::_ftpDownloadProgress(float progress, const QString& uri)
 {
+    if (uri != _currentFtpURI) {
+        return;
+    }
+    if (!_downloadStartTime.isValid()) {
+        // Time spent waiting in the FTPManager queue behind other types does not count
+        _downloadStartTime.start();
+    }
     int elapsedSec = _downloadStartTime.elapsed() / 1000;
     float totalDownloadTime = elapsedSec / progress;
     // abort download if it's too slow (e.g. over telemetry link) and use the fallback.
@@ -383,12 +423,16 @@ void RequestMetaDataTypeStateMachine::_ftpDownloadProgress(float progress)
     const int maxDownloadTimeSec = 40;
     if (elapsedSec > 10 && progress < 0.5 && totalDownloadTime > maxDownloadTimeSec) {
         qCDebug(ComponentInformationManagerLog) << "Slow download, aborting. Total time (s):" << totalDownloadTime;
-        _compInfo->vehicle->ftpManager()->cancel();
+        _compInfo->vehicle->ftpManager()->cancel(_currentFtpURI);
     }
 }
 
 void RequestMetaDataTypeStateMachine::_httpDownloadComplete(QString remoteFile, QString localFile, QString errorMsg)
 {
+    if (remoteFile != _currentHttpURI) {
+        return;
+    }
+
     qCDebug(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_httpDownloadComplete remoteFile:localFile:errorMsg" << remoteFile << localFile << errorMsg;
 
     disconnect(qobject_cast<QGCCachedFileDownload*>(sender()), &QGCCachedFileDownload::downloadComplete, this, &RequestMetaDataTypeStateMachine::_httpDownloadComplete);
@@ -418,9 +462,10 @@ void RequestMetaDataTypeStateMachine::_requestFile(const QString& cacheFileTag,
         if (cachedFile.isEmpty()) {
             qCDebug(ComponentInformationManagerLog) << "Downloading json" << uri;
             if (_uriIsMAVLinkFTP(uri)) {
+                _currentFtpURI = uri;
                 connect(ftpManager, &FTPManager::downloadComplete, this, &RequestMetaDataTypeStateMachine::_ftpDownloadComplete);
                 if (ftpManager->download(MAV_COMP_ID_AUTOPILOT1, uri, QStandardPaths::writableLocation(QStandardPaths::TempLocation))) {
-                    _downloadStartTime.start();
+                    _downloadStartTime.invalidate();
                     connect(ftpManager, &FTPManager::commandProgress, this, &RequestMetaDataTypeStateMachine::_ftpDownloadProgress);
                 } else {
                     qCWarning(ComponentInformationManagerLog) << "RequestMetaDataTypeStateMachine::_requestFile FTPManager::download returned failure";
@@ -428,6 +473,7 @@ void RequestMetaDataTypeStateMachine::_requestFile(const QString& cacheFileTag,
                     advance();
                 }
             } else {
+                _currentHttpURI = uri;
                 connect(_compMgr->_cachedFileDownload, &QGCCachedFileDownload::downloadComplete, this,
                         &RequestMetaDataTypeStateMachine::_httpDownloadComplete);
                 if (_compMgr->_cachedFileDownload->download(uri, crcValid ? 0 : ComponentInformationManager::cachedFileMaxAgeSec)) {
@@ -484,7 +530,9 @@ void RequestMetaDataTypeStateMachine::_stateRequestTranslationJson(StateMachine*
     RequestMetaDataTypeStateMachine*    requestMachine  = static_cast<RequestMetaDataTypeStateMachine*>(stateMachine);
     CompInfo*                           compInfo        = requestMachine->compInfo();
     const QString                       uri             = compInfo->uriTranslation();
-    requestMachine->_requestFile("", false, uri, requestMachine->_jsonTranslationFileName);
+    // Not cached (no crc), the tag only keeps the temporary files of concurrently requested types apart
+    const QString                       fileTag         = ComponentInformationManager::_getFileCacheTag(compInfo->type, 0, true);
+    requestMachine->_requestFile(fileTag, false, uri, requestMachine->_jsonTranslationFileName);
 }
 
 void RequestMetaDataTypeStateMachine::_stateRequestTranslate(StateMachine* stateMachine)
@@ -494,12 +542,12 @@ void RequestMetaDataTypeStateMachine::_stateRequestTranslate(StateMachine* state
     if (requestMachine->_jsonTranslationFileName.isEmpty()) {
         requestMachine->advance();
     } else {
-        connect(requestMachine->_compMgr->translation(), &ComponentInformationTranslation::downloadComplete,
+        connect(requestMachine->_translation, &ComponentInformationTranslation::downloadComplete,
                 requestMachine, &RequestMetaDataTypeStateMachine::_downloadAndTranslationComplete);
-        if (!requestMachine->_compMgr->translation()->downloadAndTranslate(requestMachine->_jsonTranslationFileName,
+        if (!requestMachine->_translation->downloadAndTranslate(requestMachine->_jsonTranslationFileName,
                                                                            requestMachine->_jsonMetadataFileName,
                                                                            ComponentInformationManager::cachedFileMaxAgeSec)) {
-            disconnect(requestMachine->_compMgr->translation(), &ComponentInformationTranslation::downloadComplete,
+            disconnect(requestMachine->_translation, &ComponentInformationTranslation::downloadComplete,
                        requestMachine, &RequestMetaDataTypeStateMachine::_downloadAndTranslationComplete);
             qCDebug(ComponentInformationManagerLog) << "downloadAndTranslate() failed";
             requestMachine->advance();
@@ -509,7 +557,7 @@ void RequestMetaDataTypeStateMachine::_stateRequestTranslate(StateMachine* state
 
 void RequestMetaDataTypeStateMachine::_downloadAndTranslationComplete(QString translatedJsonTempFile, QString errorMsg)
 {
-    disconnect(_compMgr->translation(), &ComponentInformationTranslation::downloadComplete,
+    disconnect(_translation, &ComponentInformationTranslation::downloadComplete,
                this, &RequestMetaDataTypeStateMachine::_downloadAndTranslationComplete);
     _jsonMetadataTranslatedFileName = translatedJsonTempFile;
     if (!errorMsg.isEmpty()) {
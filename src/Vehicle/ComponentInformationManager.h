@@ -40,10 +40,11 @@ public:
     int             stateCount      (void) const final;
     const StateFn*  rgStates        (void) const final;
     void            statesCompleted (void) const final;
+    void            advance         (void) override;
 
 private slots:
-    void    _ftpDownloadComplete                (const QString& file, const QString& errorMsg);
-    void    _ftpDownloadProgress                (float progress);
+    void    _ftpDownloadComplete                (const QString& file, const QString& errorMsg, const QString& fromURI);
+    void    _ftpDownloadProgress                (float progress, const QString& uri);
     void    _httpDownloadComplete               (QString remoteFile, QString localFile, QString errorMsg);
     QString _downloadCompleteJsonWorker         (const QString& jsonFileName);
     void _downloadAndTranslationComplete(QString translatedJsonTempFile, QString errorMsg);
@@ -70,11 +71,18 @@ private:
 
     QString*                        _currentFileName            = nullptr;
     QString                         _currentCacheFileTag;
+    QString                         _currentFtpURI;             ///< FTPManager queues downloads from others as well
+    QString                         _currentHttpURI;            ///< QGCCachedFileDownload is shared with the other types
     bool                            _currentFileValidCrc        = false;
+    ComponentInformationTranslation* _translation               = nullptr;
 
-    QElapsedTimer                   _downloadStartTime;
+    QElapsedTimer                   _downloadStartTime;         ///< Started once the queued FTP download is active
+    QElapsedTimer                   _requestTime;
+    QElapsedTimer                   _stateTime;
+    QStringList                     _stateTimings;
 
     static const StateFn  _rgStates[];
+    static const char*    _rgStateNames[];
     static const int      _cStates;
 };
 
@@ -99,7 +107,6 @@ public:
     const StateFn*  rgStates    (void) const final;
 
     ComponentInformationCache& fileCache() { return _fileCache; }
-    ComponentInformationTranslation* translation() { return _translation; }
 
     float progress() const;
 
@@ -117,18 +124,18 @@ private:
 
     static void _stateRequestCompInfoGeneral        (StateMachine* stateMachine);
     static void _stateRequestCompInfoGeneralComplete(StateMachine* stateMachine);
-    static void _stateRequestCompInfoParam          (StateMachine* stateMachine);
-    static void _stateRequestCompInfoEvents         (StateMachine* stateMachine);
-    static void _stateRequestCompInfoActuators      (StateMachine* stateMachine);
+    static void _stateRequestCompInfoTypes          (StateMachine* stateMachine);
     static void _stateRequestAllCompInfoComplete    (StateMachine* stateMachine);
 
     Vehicle*                        _vehicle                    = nullptr;
-    RequestMetaDataTypeStateMachine _requestTypeStateMachine;
+    QList<RequestMetaDataTypeStateMachine*> _requestTypeStateMachines;  ///< One per metadata type so the types can be requested concurrently
+    int                             _pendingTypeRequests        = 0;
+    int                             _totalTypeRequests          = 0;
+    QElapsedTimer                   _requestAllTime;
     RequestAllCompleteFn            _requestAllCompleteFn       = nullptr;
     void*                           _requestAllCompleteFnData   = nullptr;
     QGCCachedFileDownload*          _cachedFileDownload         = nullptr;
     ComponentInformationCache&      _fileCache;
-    ComponentInformationTranslation* _translation               = nullptr;
 
     QMap<uint8_t /* compId */, QMap<COMP_METADATA_TYPE, CompInfo*>> _compInfoMap;
 
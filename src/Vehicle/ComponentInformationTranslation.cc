@@ -14,6 +14,7 @@
 
 #include <QStandardPaths>
 #include <QDir>
+#include <QFileInfo>
 #include <QJsonArray>
 #include <QXmlStreamReader>
 
@@ -36,7 +37,8 @@ bool ComponentInformationTranslation::downloadAndTranslate(const QString& summar
         return false;
     }
 
-    // Download file
+    // Download file. The download object is shared with other concurrent requests, completions are filtered on the url.
+    _url = url;
     connect(_cachedFileDownload, &QGCCachedFileDownload::downloadComplete, this, &ComponentInformationTranslation::onDownloadCompleted);
     if (!_cachedFileDownload->download(url, maxCacheAgeSec)) {
         qCWarning(ComponentInformationTranslationLog) << "Metadata translation download failed";
@@ -72,6 +74,9 @@ QString ComponentInformationTranslation::getUrlFromSummaryJson(const QString &su
 
 void ComponentInformationTranslation::onDownloadCompleted(QString remoteFile, QString localFile, QString errorMsg)
 {
+    if (remoteFile != _url) {
+        return;
+    }
     disconnect(_cachedFileDownload, &QGCCachedFileDownload::downloadComplete, this, &ComponentInformationTranslation::onDownloadCompleted);
 
     QString tsFileName = localFile;
@@ -80,7 +85,7 @@ void ComponentInformationTranslation::onDownloadCompleted(QString remoteFile, QS
 
         // Decompress if needed
         if (localFile.endsWith(".lzma", Qt::CaseInsensitive) || localFile.endsWith(".xz", Qt::CaseInsensitive)) {
-            tsFileName = QDir(QStandardPaths::writableLocation(QStandardPaths::TempLocation)).absoluteFilePath("qgc_translation_file_decompressed.ts");
+            tsFileName = QDir(QStandardPaths::writableLocation(QStandardPaths::TempLocation)).absoluteFilePath(QStringLiteral("qgc_translation_file_decompressed_%1.ts").arg(qHash(remoteFile), 8, 16, QLatin1Char('0')));
             if (QGCLZMA::inflateLZMAFile(localFile, tsFileName)) {
                 deleteFile = true;
             } else {
@@ -199,7 +204,9 @@ QString ComponentInformationTranslation::translateJsonUsingTS(const QString &toT
     jsonDoc.setObject(translate(translationObj, translations, jsonDoc.object()));
 
     // Write to file
-    QString translatedFileName = QDir(QStandardPaths::writableLocation(QStandardPaths::TempLocation)).absoluteFilePath("qgc_translated_metadata.json");
+    // Named after the source so that translations of different metadata types can run at the same time
+    QString translatedFileName = QDir(QStandardPaths::writableLocation(QStandardPaths::TempLocation)).absoluteFilePath(
+                QStringLiteral("qgc_translated_%1.json").arg(QFileInfo(toTranslateJsonFile).completeBaseName()));
 
     QFile translatedFile(translatedFileName);
     if (!translatedFile.open(QFile::WriteOnly|QFile::Truncate)) {
@@ -52,4 +52,5 @@ private:
 
     QGCCachedFileDownload* _cachedFileDownload = nullptr;
     QString _toTranslateJsonFile;
+    QString _url;                   ///< Translation file currently being downloaded
 };
@@ -14,6 +14,7 @@
 #include "QGCApplication.h"
 
 #include <QFile>
+#include <QFileInfo>
 #include <QDir>
 #include <string>
 
@@ -26,8 +27,8 @@ FTPManager::FTPManager(Vehicle* vehicle)
     , _vehicle  (vehicle)
 {
     _ackOrNakTimeoutTimer.setSingleShot(true);
-    // Mock link responds immediately if at all, speed up unit tests with faster timoue
-    _ackOrNakTimeoutTimer.setInterval(qgcApp()->runningUnitTests() ? 10 : _ackOrNakTimeoutMsecs);
+    // Mock link responds immediately if at all, speed up unit tests with faster timeout
+    _minAckOrNakTimeoutMsecs = qgcApp()->runningUnitTests() ? 10 : 250;
     connect(&_ackOrNakTimeoutTimer, &QTimer::timeout, this, &FTPManager::_ackOrNakTimeout);
     
     // Make sure we don't have bad structure packing
@@ -38,30 +39,119 @@ bool FTPManager::download(uint8_t fromCompId, const QString& fromURI, const QStr
 {
     qCDebug(FTPManagerLog) << "download fromURI:" << fromURI << "to:" << toDir << "fromCompId:" << fromCompId;
 
+    QString parsedURI;
+    uint8_t compId;
+    if (!_parseURI(fromCompId, fromURI, parsedURI, compId)) {
+        qCWarning(FTPManagerLog) << "_parseURI failed";
+        return false;
+    }
+
+    Operation_t operation;
+    operation.type      = OperationDownload;
+    operation.compId    = fromCompId;
+    operation.uri       = fromURI;
+    operation.localPath = toDir;
+    operation.fileName  = fileName;
+    operation.checksize = checksize;
+    _operationQueue.enqueue(operation);
+
     if (!_rgStateMachine.isEmpty()) {
-        qCDebug(FTPManagerLog) << "Cannot download. Already in another operation";
+        qCDebug(FTPManagerLog) << "Download queued behind current operation";
+    }
+    _startNextOperation();
+
+    return true;
+}
+
+bool FTPManager::upload(uint8_t toCompId, const QString& fromFile, const QString& toURI)
+{
+    qCDebug(FTPManagerLog) << "upload fromFile:" << fromFile << "toURI:" << toURI << "toCompId:" << toCompId;
+
+    if (!QFileInfo(fromFile).isFile()) {
+        qCWarning(FTPManagerLog) << "upload file does not exist" << fromFile;
+        return false;
+    }
+
+    QString parsedURI;
+    uint8_t compId;
+    if (!_parseURI(toCompId, toURI, parsedURI, compId)) {
+        qCWarning(FTPManagerLog) << "_parseURI failed";
+        return false;
+    }
+
+    Operation_t operation;
+    operation.type      = OperationUpload;
+    operation.compId    = toCompId;
+    operation.uri       = toURI;
+    operation.localPath = fromFile;
+    operation.checksize = true;
+    _operationQueue.enqueue(operation);
+    _startNextOperation();
+
+    return true;
+}
+
+bool FTPManager::listDirectory(uint8_t fromCompId, const QString& fromURI)
+{
+    qCDebug(FTPManagerLog) << "listDirectory fromURI:" << fromURI << "fromCompId:" << fromCompId;
+
+    QString parsedURI;
+    uint8_t compId;
+    if (!_parseURI(fromCompId, fromURI, parsedURI, compId)) {
+        qCWarning(FTPManagerLog) << "_parseURI failed";
         return false;
     }
 
+    Operation_t operation;
+    operation.type      = OperationList;
+    operation.compId    = fromCompId;
+    operation.uri       = fromURI;
+    operation.checksize = false;
+    _operationQueue.enqueue(operation);
+    _startNextOperation();
+
+    return true;
+}
+
+/// Starts the next queued operation if there is no operation in progress
+void FTPManager::_startNextOperation(void)
+{
+    if (!_rgStateMachine.isEmpty() || _operationQueue.isEmpty()) {
+        return;
+    }
+
+    _currentOperation = _operationQueue.dequeue();
+    switch (_currentOperation.type) {
+    case OperationDownload:
+        _startDownload(_currentOperation);
+        break;
+    case OperationUpload:
+        _startUpload(_currentOperation);
+        break;
+    case OperationList:
+        _startListDirectory(_currentOperation);
+        break;
+    }
+}
+
+void FTPManager::_startDownload(const Operation_t& operation)
+{
     static const StateFunctions_t rgDownloadStateMachine[] = {
         { &FTPManager::_openFileROBegin,            &FTPManager::_openFileROAckOrNak,           &FTPManager::_openFileROTimeout },
         { &FTPManager::_burstReadFileBegin,         &FTPManager::_burstReadFileAckOrNak,        &FTPManager::_burstReadFileTimeout },
         { &FTPManager::_fillMissingBlocksBegin,     &FTPManager::_fillMissingBlocksAckOrNak,    &FTPManager::_fillMissingBlocksTimeout },
         { &FTPManager::_resetSessionsBegin,         &FTPManager::_resetSessionsAckOrNak,        &FTPManager::_resetSessionsTimeout },
-        { &FTPManager::_downloadCompleteNoError,    nullptr,                                    nullptr },
+        { &FTPManager::_operationCompleteNoError,   nullptr,                                    nullptr },
     };
     for (size_t i=0; i<sizeof(rgDownloadStateMachine)/sizeof(rgDownloadStateMachine[0]); i++) {
         _rgStateMachine.append(rgDownloadStateMachine[i]);
     }
 
     _downloadState.reset();
-    _downloadState.toDir.setPath(toDir);
-    _downloadState.checksize = checksize;
+    _downloadState.toDir.setPath(operation.localPath);
+    _downloadState.checksize = operation.checksize;
 
-    if (!_parseURI(fromCompId, fromURI, _downloadState.fullPathOnVehicle, _ftpCompId)) {
-        qCWarning(FTPManagerLog) << "_parseURI failed";
-        return false;
-    }
+    _parseURI(operation.compId, operation.uri, _downloadState.fullPathOnVehicle, _ftpCompId);
 
     // We need to strip off the file name from the fully qualified path. We can't use the usual QDir
     // routines because this path does not exist locally.
@@ -73,17 +163,60 @@ bool FTPManager::download(uint8_t fromCompId, const QString& fromURI, const QStr
     }
     lastDirSlashIndex++; // move past slash
 
-    if (fileName.isEmpty()) {
+    if (operation.fileName.isEmpty()) {
         _downloadState.fileName = _downloadState.fullPathOnVehicle.right(_downloadState.fullPathOnVehicle.size() - lastDirSlashIndex);
     } else {
-        _downloadState.fileName = fileName;
+        _downloadState.fileName = operation.fileName;
     }
 
     qCDebug(FTPManagerLog) << "_downloadState.fullPathOnVehicle:_downloadState.fileName" << _downloadState.fullPathOnVehicle << _downloadState.fileName;
 
     _startStateMachine();
+}
 
-    return true;
+void FTPManager::_startUpload(const Operation_t& operation)
+{
+    static const StateFunctions_t rgUploadStateMachine[] = {
+        { &FTPManager::_createFileBegin,            &FTPManager::_createFileAckOrNak,           &FTPManager::_createFileTimeout },
+        { &FTPManager::_writeFileBegin,             &FTPManager::_writeFileAckOrNak,            &FTPManager::_writeFileTimeout },
+        { &FTPManager::_terminateSessionBegin,      &FTPManager::_terminateSessionAckOrNak,     &FTPManager::_terminateSessionTimeout },
+        { &FTPManager::_operationCompleteNoError,   nullptr,                                    nullptr },
+    };
+    for (size_t i=0; i<sizeof(rgUploadStateMachine)/sizeof(rgUploadStateMachine[0]); i++) {
+        _rgStateMachine.append(rgUploadStateMachine[i]);
+    }
+
+    _downloadState.reset();
+    _downloadState.checksize = operation.checksize;
+
+    _parseURI(operation.compId, operation.uri, _downloadState.fullPathOnVehicle, _ftpCompId);
+
+    _downloadState.file.setFileName(operation.localPath);
+    if (!_downloadState.file.open(QFile::ReadOnly)) {
+        qCDebug(FTPManagerLog) << "_startUpload file open failed" << _downloadState.file.errorString();
+        _operationComplete(tr("Upload failed: %1").arg(_downloadState.file.errorString()));
+        return;
+    }
+    _downloadState.fileSize = static_cast<uint32_t>(_downloadState.file.size());
+
+    _startStateMachine();
+}
+
+void FTPManager::_startListDirectory(const Operation_t& operation)
+{
+    static const StateFunctions_t rgListDirectoryStateMachine[] = {
+        { &FTPManager::_listDirectoryBegin,         &FTPManager::_listDirectoryAckOrNak,        &FTPManager::_listDirectoryTimeout },
+        { &FTPManager::_operationCompleteNoError,   nullptr,                                    nullptr },
+    };
+    for (size_t i=0; i<sizeof(rgListDirectoryStateMachine)/sizeof(rgListDirectoryStateMachine[0]); i++) {
+        _rgStateMachine.append(rgListDirectoryStateMachine[i]);
+    }
+
+    _downloadState.reset();
+
+    _parseURI(operation.compId, operation.uri, _downloadState.fullPathOnVehicle, _ftpCompId);
+
+    _startStateMachine();
 }
 
 void FTPManager::cancel()
@@ -102,9 +235,26 @@ void FTPManager::cancel()
         _rgStateMachine.append(rgTerminateStateMachine[i]);
     }
     _downloadState.retryCount = 0;
+    _downloadState.rgPendingRequests.clear();
     _startStateMachine();
 }
 
+void FTPManager::cancel(const QString& uri)
+{
+    for (int i=0; i<_operationQueue.count(); i++) {
+        if (_operationQueue[i].uri == uri) {
+            qCDebug(FTPManagerLog) << "cancel: removing queued operation" << uri;
+            const Operation_t operation = _operationQueue.takeAt(i);
+            _emitOperationComplete(operation, QString(), QStringList(), "Aborted");
+            return;
+        }
+    }
+
+    if (!_rgStateMachine.isEmpty() && _currentOperation.uri == uri) {
+        cancel();
+    }
+}
+
 void FTPManager::_terminateSessionBegin(void)
 {
     MavlinkFTP::Request request{};
@@ -133,7 +283,7 @@ void FTPManager::_terminateSessionTimeout(void)
 {
     if (++_downloadState.retryCount > _maxRetry) {
         qCDebug(FTPManagerLog) << QString("_terminateSessionTimeout retries exceeded");
-        _downloadComplete(tr("Download failed"));
+        _operationComplete(_currentOperation.type == OperationUpload ? tr("Upload failed") : tr("Download failed"));
     } else {
         // Try again
         qCDebug(FTPManagerLog) << QString("_terminateSessionTimeout: retrying - retryCount(%1)").arg(_downloadState.retryCount);
@@ -144,29 +294,49 @@ void FTPManager::_terminateSessionTimeout(void)
 
 void FTPManager::_terminateComplete(void)
 {
-    _downloadComplete("Aborted");
+    _operationComplete("Aborted");
 }
 
-/// Closes out a download session by writing the file and doing cleanup.
+/// Closes out the current operation by writing the file and doing cleanup, then starts the next queued operation.
 ///     @param errorMsg Error message, empty if no error
-void FTPManager::_downloadComplete(const QString& errorMsg)
+void FTPManager::_operationComplete(const QString& errorMsg)
 {
-    qCDebug(FTPManagerLog) << QString("_downloadComplete: errorMsg(%1)").arg(errorMsg);
+    qCDebug(FTPManagerLog) << QString("_operationComplete: errorMsg(%1)").arg(errorMsg);
     
-    QString downloadFilePath    = _downloadState.toDir.absoluteFilePath(_downloadState.fileName);
-    QString error               = errorMsg;
+    // The signal handlers may start the next operation, which reuses the state
+    const Operation_t   operation           = _currentOperation;
+    const QString       downloadFilePath    = _downloadState.toDir.absoluteFilePath(_downloadState.fileName);
+    const QStringList   directoryEntries    = _downloadState.rgDirectoryEntries;
 
     _ackOrNakTimeoutTimer.stop();
     _rgStateMachine.clear();
     _currentStateMachineIndex = -1;
+    _downloadState.rgPendingRequests.clear();
     if (_downloadState.file.isOpen()) {
         _downloadState.file.close();
-        if (!errorMsg.isEmpty()) {
+        if (!errorMsg.isEmpty() && operation.type == OperationDownload) {
             _downloadState.file.remove();
         }
     }
 
-    emit downloadComplete(downloadFilePath, errorMsg);
+    _emitOperationComplete(operation, downloadFilePath, directoryEntries, errorMsg);
+
+    _startNextOperation();
+}
+
+void FTPManager::_emitOperationComplete(const Operation_t& operation, const QString& downloadFilePath, const QStringList& directoryEntries, const QString& errorMsg)
+{
+    switch (operation.type) {
+    case OperationDownload:
+        emit downloadComplete(downloadFilePath, errorMsg, operation.uri);
+        break;
+    case OperationUpload:
+        emit uploadComplete(operation.uri, errorMsg);
+        break;
+    case OperationList:
+        emit listDirectoryComplete(operation.uri, directoryEntries, errorMsg);
+        break;
+    }
 }
 
 void FTPManager::_mavlinkMessageReceived(const mavlink_message_t& message)
@@ -191,10 +361,11 @@ void FTPManager::_mavlinkMessageReceived(const mavlink_message_t& message)
     
     MavlinkFTP::Request* request = (MavlinkFTP::Request*)&data.payload[0];
 
-    // Ignore old/reordered packets (handle wrap-around properly)
+    // Ignore old/reordered packets (handle wrap-around properly). With requests pipelined the oldest one in flight decides what is old.
     uint16_t actualIncomingSeqNumber = request->hdr.seqNumber;
-    if ((uint16_t)((_expectedIncomingSeqNumber - 1) - actualIncomingSeqNumber) < (std::numeric_limits<uint16_t>::max()/2)) {
-        qCDebug(FTPManagerLog) << "_mavlinkMessageReceived: Received old packet seqNum expected:actual" << _expectedIncomingSeqNumber << actualIncomingSeqNumber
+    uint16_t expectedIncomingSeqNumber = _downloadState.rgPendingRequests.isEmpty() ? _expectedIncomingSeqNumber : _downloadState.rgPendingRequests.first().seqNumber;
+    if ((uint16_t)((expectedIncomingSeqNumber - 1) - actualIncomingSeqNumber) < (std::numeric_limits<uint16_t>::max()/2)) {
+        qCDebug(FTPManagerLog) << "_mavlinkMessageReceived: Received old packet seqNum expected:actual" << expectedIncomingSeqNumber << actualIncomingSeqNumber
                                << "hdr.opcode:hdr.req_opcode" << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.opcode)) <<  MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.req_opcode));
 
         return;
@@ -204,6 +375,13 @@ void FTPManager::_mavlinkMessageReceived(const mavlink_message_t& message)
                            << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.opcode)) <<  MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.req_opcode))
                            << request->hdr.seqNumber;
 
+    if (!_lastRequestSampled && actualIncomingSeqNumber == (uint16_t)(_lastRequestSeqNumber + 1)) {
+        _lastRequestSampled = true;
+        if (!_lastRequestResent) {
+            _addRoundTripSample(_requestTimer.elapsed());
+        }
+    }
+
     (this->*_rgStateMachine[_currentStateMachineIndex].ackNakFn)(request);
 }
 
@@ -261,7 +439,7 @@ void FTPManager::_openFileROBegin(void)
 void FTPManager::_openFileROTimeout(void)
 {
     qCDebug(FTPManagerLog) << "_openFileROTimeout";
-    _downloadComplete(tr("Download failed"));
+    _operationComplete(tr("Download failed"));
 }
 
 void FTPManager::_openFileROAckOrNak(const MavlinkFTP::Request* ackOrNak)
@@ -283,7 +461,7 @@ void FTPManager::_openFileROAckOrNak(const MavlinkFTP::Request* ackOrNak)
 
         if (ackOrNak->hdr.size != sizeof(uint32_t)) {
             qCDebug(FTPManagerLog) << "_openFileROAckOrNak: Ack ack->hdr.size != sizeof(uint32_t)" << ackOrNak->hdr.size << sizeof(uint32_t);
-            _downloadComplete(tr("Download failed"));
+            _operationComplete(tr("Download failed"));
             return;
         }
 
@@ -296,11 +474,11 @@ void FTPManager::_openFileROAckOrNak(const MavlinkFTP::Request* ackOrNak)
             _advanceStateMachine();
         } else {
             qCDebug(FTPManagerLog) << "_openFileROAckOrNak: Ack _downloadState.file open failed" << _downloadState.file.errorString();
-            _downloadComplete(tr("Download failed"));
+            _operationComplete(tr("Download failed"));
         }
     } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
         qCDebug(FTPManagerLog) << "_handlOpenFileROAck: Nak -" << _errorMsgFromNak(ackOrNak);
-        _downloadComplete(tr("Download failed") + ": " + _errorMsgFromNak(ackOrNak));
+        _operationComplete(tr("Download failed") + ": " + _errorMsgFromNak(ackOrNak));
     }
 }
 
@@ -371,7 +549,7 @@ void FTPManager::_burstReadFileAckOrNak(const MavlinkFTP::Request* ackOrNak)
         _downloadState.file.seek(ackOrNak->hdr.offset);
         int bytesWritten = _downloadState.file.write((const char*)ackOrNak->data, ackOrNak->hdr.size);
         if (bytesWritten != ackOrNak->hdr.size) {
-            _downloadComplete(tr("Download failed: Error saving file"));
+            _operationComplete(tr("Download failed: Error saving file"));
             return;
         }
         _downloadState.bytesWritten += ackOrNak->hdr.size;
@@ -388,9 +566,7 @@ void FTPManager::_burstReadFileAckOrNak(const MavlinkFTP::Request* ackOrNak)
         }
 
         // Emit progress last, as cancel could be called in there
-        if (_downloadState.fileSize != 0) {
-            emit commandProgress((float)(_downloadState.bytesWritten) / (float)_downloadState.fileSize);
-        }
+        _emitProgress();
     } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
         MavlinkFTP::ErrorCode_t errorCode = static_cast<MavlinkFTP::ErrorCode_t>(ackOrNak->data[0]);
 
@@ -409,7 +585,7 @@ void FTPManager::_burstReadFileAckOrNak(const MavlinkFTP::Request* ackOrNak)
             }
         } else { /* Don't care is this is out of sequence */
             qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
-            _downloadComplete(tr("Download failed"));
+            _operationComplete(tr("Download failed"));
         }
     }
 }
@@ -418,7 +594,7 @@ void FTPManager::_burstReadFileTimeout(void)
 {
     if (++_downloadState.retryCount > _maxRetry) {
         qCDebug(FTPManagerLog) << QString("_burstReadFileTimeout retries exceeded");
-        _downloadComplete(tr("Download failed"));
+        _operationComplete(tr("Download failed"));
     } else {
         // Try again
         qCDebug(FTPManagerLog) << QString("_burstReadFileTimeout: retrying - retryCount(%1) offset(%2)").arg(_downloadState.retryCount).arg(_downloadState.expectedOffset);
@@ -426,44 +602,58 @@ void FTPManager::_burstReadFileTimeout(void)
     }
 }
 
-void FTPManager::_fillMissingBlocksWorker(bool firstRequest)
+void FTPManager::_sendReadRequest(PendingRequest_t& pendingRequest)
 {
-    if (_downloadState.rgMissingData.count()) {
-        MavlinkFTP::Request request{};
-        MissingData_t&      missingData = _downloadState.rgMissingData.first();
+    MavlinkFTP::Request request{};
 
-        uint32_t cBytesToRead = qMin((uint32_t)sizeof(request.data), missingData.cBytesMissing);
+    qCDebug(FTPManagerLog) << "_sendReadRequest: offset:cBytesToRead" << pendingRequest.offset << pendingRequest.size;
 
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksBegin: offset:cBytesToRead" << missingData.offset << cBytesToRead;
+    request.hdr.session = _downloadState.sessionId;
+    request.hdr.opcode  = MavlinkFTP::kCmdReadFile;
+    request.hdr.offset  = pendingRequest.offset;
+    request.hdr.size    = static_cast<uint8_t>(pendingRequest.size);
 
-        request.hdr.session                 = _downloadState.sessionId;
-        request.hdr.opcode                  = MavlinkFTP::kCmdReadFile;
-        request.hdr.offset                  = missingData.offset;
-        request.hdr.size                    = cBytesToRead;
+    _sendRequestExpectAck(&request);
+    pendingRequest.seqNumber = _expectedIncomingSeqNumber;
+}
 
-        if (firstRequest) {
-            _downloadState.retryCount = 0;
-        } else {
-            // Must used same sequence number as previous request
-            _expectedIncomingSeqNumber -= 2;
+/// Keeps up to maxPipelinedRequests reads of missing data in flight. Reads are independent of each other on the
+/// vehicle side, so holes are filled at the rate of the link instead of one round trip per block.
+void FTPManager::_fillMissingBlocksWorker(void)
+{
+    while (_downloadState.rgPendingRequests.count() < maxPipelinedRequests && _downloadState.rgMissingData.count()) {
+        MissingData_t&      missingData = _downloadState.rgMissingData.first();
+        PendingRequest_t    pendingRequest;
+
+        pendingRequest.offset   = missingData.offset;
+        pendingRequest.size     = qMin((uint32_t)sizeof(((MavlinkFTP::Request*)0)->data), missingData.cBytesMissing);
+
+        missingData.offset          += pendingRequest.size;
+        missingData.cBytesMissing   -= pendingRequest.size;
+        if (missingData.cBytesMissing == 0) {
+            _downloadState.rgMissingData.removeFirst();
         }
-        _downloadState.expectedOffset = request.hdr.offset;
 
-        _sendRequestExpectAck(&request);
-    } else {
+        _sendReadRequest(pendingRequest);
+        _downloadState.rgPendingRequests.append(pendingRequest);
+    }
+
+    if (_downloadState.rgPendingRequests.isEmpty()) {
         // We should have the full file now
         if (_downloadState.checksize == false || _downloadState.bytesWritten == _downloadState.fileSize) {
             _advanceStateMachine();
         } else {
             qCDebug(FTPManagerLog) << "_fillMissingBlocksWorker: no missing blocks but file still incomplete - bytesWritten:fileSize" << _downloadState.bytesWritten << _downloadState.fileSize;
-            _downloadComplete(tr("Download failed"));
+            _operationComplete(tr("Download failed"));
         }
     }
 }
 
 void FTPManager::_fillMissingBlocksBegin(void)
 {
-    _fillMissingBlocksWorker(true /* firstRequest */);
+    _downloadState.retryCount = 0;
+    _downloadState.rgPendingRequests.clear();
+    _fillMissingBlocksWorker();
 }
 
 void FTPManager::_fillMissingBlocksAckOrNak(const MavlinkFTP::Request* ackOrNak)
@@ -474,8 +664,9 @@ void FTPManager::_fillMissingBlocksAckOrNak(const MavlinkFTP::Request* ackOrNak)
         qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
         return;
     }
-    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
+    int pendingIndex = _pendingRequestIndex(ackOrNak->hdr.seqNumber);
+    if (pendingIndex == -1) {
+        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding due to sequence of no read in flight" << ackOrNak->hdr.seqNumber;
         return;
     }
     if (ackOrNak->hdr.session != _downloadState.sessionId) {
@@ -483,61 +674,58 @@ void FTPManager::_fillMissingBlocksAckOrNak(const MavlinkFTP::Request* ackOrNak)
         return;
     }
 
-    _ackOrNakTimeoutTimer.stop();
+    PendingRequest_t pendingRequest = _downloadState.rgPendingRequests.takeAt(pendingIndex);
 
     if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
         qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Ack offset:size" << ackOrNak->hdr.offset << ackOrNak->hdr.size;
 
-        if (ackOrNak->hdr.offset != _downloadState.expectedOffset) {
-            if (++_downloadState.retryCount > _maxRetry) {
-                qCDebug(FTPManagerLog) << QString("_fillMissingBlocksAckOrNak: offset mismatch, retries exceeded");
-                _downloadComplete(tr("Download failed"));
-                return;
-            }
-
-            // Ask for current offset again
-            qCDebug(FTPManagerLog) << QString("_fillMissingBlocksAckOrNak: Ack offset mismatch retry, retryCount(%1) offset(%2)").arg(_downloadState.retryCount).arg(_downloadState.expectedOffset);
-            _fillMissingBlocksWorker(false /* firstReqeust */);
-            return;
+        uint32_t cBytesReceived = 0;
+        if (ackOrNak->hdr.offset == pendingRequest.offset) {
+            cBytesReceived = qMin(static_cast<uint32_t>(ackOrNak->hdr.size), pendingRequest.size);
         }
 
-        _downloadState.file.seek(ackOrNak->hdr.offset);
-        int bytesWritten = _downloadState.file.write((const char*)ackOrNak->data, ackOrNak->hdr.size);
-        if (bytesWritten != ackOrNak->hdr.size) {
-            _downloadComplete(tr("Download failed: Error saving file"));
+        if (cBytesReceived) {
+            _downloadState.file.seek(ackOrNak->hdr.offset);
+            int bytesWritten = _downloadState.file.write((const char*)ackOrNak->data, cBytesReceived);
+            if (bytesWritten != static_cast<int>(cBytesReceived)) {
+                _operationComplete(tr("Download failed: Error saving file"));
+                return;
+            }
+            _downloadState.bytesWritten += cBytesReceived;
+            _downloadState.retryCount = 0;
+        } else if (++_downloadState.retryCount > _maxRetry) {
+            qCDebug(FTPManagerLog) << QString("_fillMissingBlocksAckOrNak: offset mismatch, retries exceeded");
+            _operationComplete(tr("Download failed"));
             return;
         }
-        _downloadState.bytesWritten += ackOrNak->hdr.size;
 
-        MissingData_t& missingData = _downloadState.rgMissingData.first();
-        missingData.offset += ackOrNak->hdr.size;
-        missingData.cBytesMissing -= ackOrNak->hdr.size;
-        if (missingData.cBytesMissing == 0) {
-            // This block is finished, remove it
-            _downloadState.rgMissingData.takeFirst();
+        if (cBytesReceived < pendingRequest.size) {
+            // Short or mismatched read, ask for the rest of the block again
+            MissingData_t missingData;
+            missingData.offset          = pendingRequest.offset + cBytesReceived;
+            missingData.cBytesMissing   = pendingRequest.size - cBytesReceived;
+            _downloadState.rgMissingData.prepend(missingData);
         }
 
         // Move on to fill in possible next hole
-        _fillMissingBlocksWorker(true /* firstReqeust */);
+        _ackOrNakTimeoutTimer.start(_ackOrNakTimeoutMsecs());
+        _fillMissingBlocksWorker();
 
         // Emit progress last, as cancel could be called in there
-        if (_downloadState.fileSize != 0) {
-            emit commandProgress((float)(_downloadState.bytesWritten) / (float)_downloadState.fileSize);
-        }
+        _emitProgress();
     } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
         MavlinkFTP::ErrorCode_t errorCode = static_cast<MavlinkFTP::ErrorCode_t>(ackOrNak->data[0]);
 
-        if (errorCode == MavlinkFTP::kErrEOF) {
-            qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak EOF";
-            if (_downloadState.checksize == false || _downloadState.bytesWritten == _downloadState.fileSize) {
-                // We've successfully complete filling in all missing blocks
-                _advanceStateMachine();
-                return;
-            }
+        if (errorCode == MavlinkFTP::kErrEOF && _downloadState.checksize == false) {
+            // File size from the open response is not reliable, there is nothing past the end to fill in
+            qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak EOF offset" << pendingRequest.offset;
+            _ackOrNakTimeoutTimer.start(_ackOrNakTimeoutMsecs());
+            _fillMissingBlocksWorker();
+            return;
         }
 
         qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
-        _downloadComplete(tr("Download failed"));
+        _operationComplete(tr("Download failed"));
     }
 
 }
@@ -546,11 +734,271 @@ void FTPManager::_fillMissingBlocksTimeout(void)
 {
     if (++_downloadState.retryCount > _maxRetry) {
         qCDebug(FTPManagerLog) << QString("_fillMissingBlocksTimeout retries exceeded");
-        _downloadComplete(tr("Download failed"));
+        _operationComplete(tr("Download failed"));
+    } else {
+        // Ask for all reads in flight again
+        qCDebug(FTPManagerLog) << QString("_fillMissingBlocksTimeout: retrying - retryCount(%1) pending(%2)").arg(_downloadState.retryCount).arg(_downloadState.rgPendingRequests.count());
+        _resendPendingRequests();
+    }
+}
+
+/// Sends all reads or writes in flight again. They get new sequence numbers, so late responses to the previous
+/// requests are disregarded as old.
+void FTPManager::_resendPendingRequests(void)
+{
+    for (PendingRequest_t& pendingRequest: _downloadState.rgPendingRequests) {
+        if (_currentOperation.type == OperationUpload) {
+            if (!_sendWriteRequest(pendingRequest)) {
+                return;
+            }
+        } else {
+            _sendReadRequest(pendingRequest);
+        }
+    }
+}
+
+int FTPManager::_pendingRequestIndex(uint16_t seqNumber) const
+{
+    for (int i=0; i<_downloadState.rgPendingRequests.count(); i++) {
+        if (_downloadState.rgPendingRequests[i].seqNumber == seqNumber) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void FTPManager::_createFileBegin(void)
+{
+    MavlinkFTP::Request request{};
+    request.hdr.session = 0;
+    request.hdr.opcode  = MavlinkFTP::kCmdCreateFile;
+    request.hdr.offset  = 0;
+    request.hdr.size    = 0;
+    _fillRequestDataWithString(&request, _downloadState.fullPathOnVehicle);
+    _sendRequestExpectAck(&request);
+}
+
+void FTPManager::_createFileTimeout(void)
+{
+    // Create is not idempotent on the vehicle, so it is not retried
+    qCDebug(FTPManagerLog) << "_createFileTimeout";
+    _operationComplete(tr("Upload failed"));
+}
+
+void FTPManager::_createFileAckOrNak(const MavlinkFTP::Request* ackOrNak)
+{
+    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
+    if (requestOpCode != MavlinkFTP::kCmdCreateFile) {
+        qCDebug(FTPManagerLog) << "_createFileAckOrNak: Ack disregarding ack for incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
+        return;
+    }
+    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
+        qCDebug(FTPManagerLog) << "_createFileAckOrNak: Ack disregarding ack for incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
+        return;
+    }
+
+    _ackOrNakTimeoutTimer.stop();
+
+    if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
+        qCDebug(FTPManagerLog) << "_createFileAckOrNak: Ack - sessionId" << ackOrNak->hdr.session;
+        _downloadState.sessionId = ackOrNak->hdr.session;
+        _advanceStateMachine();
+    } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
+        qCDebug(FTPManagerLog) << "_createFileAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
+        _operationComplete(tr("Upload failed") + ": " + _errorMsgFromNak(ackOrNak));
+    }
+}
+
+/// Reads the block from the local file and sends it
+///     @return false: local file could not be read, operation completed with an error
+bool FTPManager::_sendWriteRequest(PendingRequest_t& pendingRequest)
+{
+    MavlinkFTP::Request request{};
+
+    request.hdr.session = _downloadState.sessionId;
+    request.hdr.opcode  = MavlinkFTP::kCmdWriteFile;
+    request.hdr.offset  = pendingRequest.offset;
+    request.hdr.size    = static_cast<uint8_t>(pendingRequest.size);
+
+    if (!_downloadState.file.seek(pendingRequest.offset) || _downloadState.file.read((char*)request.data, pendingRequest.size) != pendingRequest.size) {
+        qCDebug(FTPManagerLog) << "_sendWriteRequest: read failed" << _downloadState.file.errorString();
+        _operationComplete(tr("Upload failed: Error reading file"));
+        return false;
+    }
+
+    qCDebug(FTPManagerLog) << "_sendWriteRequest: offset:size" << pendingRequest.offset << pendingRequest.size;
+
+    _sendRequestExpectAck(&request);
+    pendingRequest.seqNumber = _expectedIncomingSeqNumber;
+    return true;
+}
+
+/// Keeps up to maxPipelinedRequests writes in flight
+void FTPManager::_writeFileWorker(void)
+{
+    while (_downloadState.rgPendingRequests.count() < maxPipelinedRequests && _downloadState.expectedOffset < _downloadState.fileSize) {
+        PendingRequest_t pendingRequest;
+
+        pendingRequest.offset   = _downloadState.expectedOffset;
+        pendingRequest.size     = qMin((uint32_t)sizeof(((MavlinkFTP::Request*)0)->data), _downloadState.fileSize - _downloadState.expectedOffset);
+        if (!_sendWriteRequest(pendingRequest)) {
+            return;
+        }
+        _downloadState.rgPendingRequests.append(pendingRequest);
+        _downloadState.expectedOffset += pendingRequest.size;
+    }
+
+    if (_downloadState.rgPendingRequests.isEmpty()) {
+        // All data is acked
+        _advanceStateMachine();
+    }
+}
+
+void FTPManager::_writeFileBegin(void)
+{
+    _downloadState.retryCount       = 0;
+    _downloadState.expectedOffset   = 0;
+    _downloadState.rgPendingRequests.clear();
+    _writeFileWorker();
+}
+
+void FTPManager::_writeFileAckOrNak(const MavlinkFTP::Request* ackOrNak)
+{
+    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
+
+    if (requestOpCode != MavlinkFTP::kCmdWriteFile) {
+        qCDebug(FTPManagerLog) << "_writeFileAckOrNak: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
+        return;
+    }
+    int pendingIndex = _pendingRequestIndex(ackOrNak->hdr.seqNumber);
+    if (pendingIndex == -1) {
+        qCDebug(FTPManagerLog) << "_writeFileAckOrNak: Disregarding due to sequence of no write in flight" << ackOrNak->hdr.seqNumber;
+        return;
+    }
+    if (ackOrNak->hdr.session != _downloadState.sessionId) {
+        qCDebug(FTPManagerLog) << "_writeFileAckOrNak: Disregarding due to incorrect session id actual:expected" << ackOrNak->hdr.session << _downloadState.sessionId;
+        return;
+    }
+
+    PendingRequest_t pendingRequest = _downloadState.rgPendingRequests.takeAt(pendingIndex);
+
+    if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
+        qCDebug(FTPManagerLog) << "_writeFileAckOrNak: Ack offset:size" << pendingRequest.offset << pendingRequest.size;
+
+        _downloadState.bytesWritten += pendingRequest.size;
+        _downloadState.retryCount = 0;
+
+        _ackOrNakTimeoutTimer.start(_ackOrNakTimeoutMsecs());
+        _writeFileWorker();
+
+        // Emit progress last, as cancel could be called in there
+        _emitProgress();
+    } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
+        qCDebug(FTPManagerLog) << "_writeFileAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
+        _operationComplete(tr("Upload failed") + ": " + _errorMsgFromNak(ackOrNak));
+    }
+}
+
+void FTPManager::_writeFileTimeout(void)
+{
+    if (++_downloadState.retryCount > _maxRetry) {
+        qCDebug(FTPManagerLog) << QString("_writeFileTimeout retries exceeded");
+        _operationComplete(tr("Upload failed"));
     } else {
-        // Ask for current offset again
-        qCDebug(FTPManagerLog) << QString("_fillMissingBlocksTimeout: retrying - retryCount(%1) offset(%2)").arg(_downloadState.retryCount).arg(_downloadState.expectedOffset);
-        _fillMissingBlocksWorker(false /* firstReqeust */);
+        // Writes go to a fixed offset, sending them again is harmless
+        qCDebug(FTPManagerLog) << QString("_writeFileTimeout: retrying - retryCount(%1) pending(%2)").arg(_downloadState.retryCount).arg(_downloadState.rgPendingRequests.count());
+        _resendPendingRequests();
+    }
+}
+
+void FTPManager::_listDirectoryWorker(bool firstRequest)
+{
+    MavlinkFTP::Request request{};
+    request.hdr.session = 0;
+    request.hdr.opcode  = MavlinkFTP::kCmdListDirectory;
+    request.hdr.offset  = _downloadState.expectedOffset;
+    _fillRequestDataWithString(&request, _downloadState.fullPathOnVehicle);
+
+    if (firstRequest) {
+        _downloadState.retryCount = 0;
+    } else {
+        // Must used same sequence number as previous request
+        _expectedIncomingSeqNumber -= 2;
+    }
+
+    _sendRequestExpectAck(&request);
+}
+
+void FTPManager::_listDirectoryBegin(void)
+{
+    _downloadState.expectedOffset = 0;
+    _listDirectoryWorker(true /* firstRequest */);
+}
+
+void FTPManager::_listDirectoryAckOrNak(const MavlinkFTP::Request* ackOrNak)
+{
+    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
+
+    if (requestOpCode != MavlinkFTP::kCmdListDirectory) {
+        qCDebug(FTPManagerLog) << "_listDirectoryAckOrNak: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
+        return;
+    }
+    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
+        qCDebug(FTPManagerLog) << "_listDirectoryAckOrNak: Disregarding due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
+        return;
+    }
+
+    _ackOrNakTimeoutTimer.stop();
+
+    if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
+        // Entries are null terminated strings. 'S' entries are skipped by the vehicle, but still count for the offset.
+        int         cEntries    = 0;
+        const char* entries     = reinterpret_cast<const char*>(ackOrNak->data);
+        int         entriesSize = qMin(static_cast<int>(ackOrNak->hdr.size), static_cast<int>(sizeof(ackOrNak->data)));
+        int         index       = 0;
+        while (index < entriesSize) {
+            int cchEntry = static_cast<int>(qstrnlen(entries + index, entriesSize - index));
+            if (cchEntry == 0) {
+                break;
+            }
+            QString entry = QString::fromUtf8(entries + index, cchEntry);
+            if (!entry.startsWith('S')) {
+                _downloadState.rgDirectoryEntries.append(entry);
+            }
+            cEntries++;
+            index += cchEntry + 1;
+        }
+
+        qCDebug(FTPManagerLog) << "_listDirectoryAckOrNak: Ack offset:entries" << _downloadState.expectedOffset << cEntries;
+
+        if (cEntries == 0) {
+            _advanceStateMachine();
+        } else {
+            _downloadState.expectedOffset += cEntries;
+            _listDirectoryWorker(true /* firstRequest */);
+        }
+    } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
+        MavlinkFTP::ErrorCode_t errorCode = static_cast<MavlinkFTP::ErrorCode_t>(ackOrNak->data[0]);
+
+        if (errorCode == MavlinkFTP::kErrEOF) {
+            qCDebug(FTPManagerLog) << "_listDirectoryAckOrNak EOF";
+            _advanceStateMachine();
+        } else {
+            qCDebug(FTPManagerLog) << "_listDirectoryAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
+            _operationComplete(tr("List directory failed") + ": " + _errorMsgFromNak(ackOrNak));
+        }
+    }
+}
+
+void FTPManager::_listDirectoryTimeout(void)
+{
+    if (++_downloadState.retryCount > _maxRetry) {
+        qCDebug(FTPManagerLog) << QString("_listDirectoryTimeout retries exceeded");
+        _operationComplete(tr("List directory failed"));
+    } else {
+        // Try again
+        qCDebug(FTPManagerLog) << QString("_listDirectoryTimeout: retrying - retryCount(%1) offset(%2)").arg(_downloadState.retryCount).arg(_downloadState.expectedOffset);
+        _listDirectoryWorker(false /* firstReqeust */);
     }
 }
 
@@ -582,14 +1030,14 @@ void FTPManager::_resetSessionsAckOrNak(const MavlinkFTP::Request* ackOrNak)
         _advanceStateMachine();
     } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
         qCDebug(FTPManagerLog) << "_resetSessionsAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
-        _downloadComplete(QString());
+        _operationComplete(QString());
     }
 }
 
 void FTPManager::_resetSessionsTimeout(void)
 {
     qCDebug(FTPManagerLog) << "_resetSessionsTimeout";
-    _downloadComplete(QString());
+    _operationComplete(QString());
 }
 
 void FTPManager::_emitErrorMessage(const QString& msg)
@@ -598,9 +1046,41 @@ void FTPManager::_emitErrorMessage(const QString& msg)
     emit commandError(msg);
 }
 
+void FTPManager::_emitProgress(void)
+{
+    if (_downloadState.fileSize != 0) {
+        emit commandProgress((float)(_downloadState.bytesWritten) / (float)_downloadState.fileSize, _currentOperation.uri);
+    }
+}
+
+void FTPManager::_addRoundTripSample(qint64 sampleMilliseconds)
+{
+    // RFC 6298 smoothing
+    double sample = static_cast<double>(sampleMilliseconds);
+    if (_srttMilliseconds < 0) {
+        _srttMilliseconds   = sample;
+        _rttVarMilliseconds = sample / 2.0;
+    } else {
+        _rttVarMilliseconds = (0.75 * _rttVarMilliseconds) + (0.25 * qAbs(_srttMilliseconds - sample));
+        _srttMilliseconds   = (0.875 * _srttMilliseconds) + (0.125 * sample);
+    }
+}
+
+/// @return Ack/Nak timeout derived from the measured round trip time, doubled for each retry
+int FTPManager::_ackOrNakTimeoutMsecs(void) const
+{
+    int timeout;
+    if (_srttMilliseconds < 0) {
+        timeout = qMax(_minAckOrNakTimeoutMsecs, qgcApp()->runningUnitTests() ? 0 : _initialAckOrNakTimeoutMsecs);
+    } else {
+        timeout = qBound(_minAckOrNakTimeoutMsecs, qRound(_srttMilliseconds + (4.0 * _rttVarMilliseconds)), _maxAckOrNakTimeoutMsecs);
+    }
+    return qMin(timeout << qBound(0, _downloadState.retryCount, _maxRetry), _maxAckOrNakTimeoutMsecs);
+}
+
 void FTPManager::_sendRequestExpectAck(MavlinkFTP::Request* request)
 {
-    _ackOrNakTimeoutTimer.start();
+    _ackOrNakTimeoutTimer.start(_ackOrNakTimeoutMsecs());
     
     WeakLinkInterfacePtr weakLink = _vehicle->vehicleLinkManager()->primaryLink();
 
@@ -612,6 +1092,12 @@ void FTPManager::_sendRequestExpectAck(MavlinkFTP::Request* request)
         request->hdr.seqNumber = _expectedIncomingSeqNumber + 1;    // Outgoing is 1 past last incoming
         _expectedIncomingSeqNumber += 2;
 
+        // Karn's algorithm: the response to a repeated request can't be used as a round trip time sample
+        _lastRequestResent      = request->hdr.seqNumber == _lastRequestSeqNumber || _downloadState.retryCount > 0;
+        _lastRequestSeqNumber   = request->hdr.seqNumber;
+        _lastRequestSampled     = false;
+        _requestTimer.start();
+
         qCDebug(FTPManagerLog) << "_sendRequestExpectAck opcode:" << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.opcode)) << "seqNumber:" << request->hdr.seqNumber;
 
         mavlink_message_t message;
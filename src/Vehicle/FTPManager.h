@@ -13,6 +13,7 @@
 #include <QDir>
 #include <QTimer>
 #include <QQueue>
+#include <QElapsedTimer>
 
 #include "UASInterface.h"
 #include "QGCLoggingCategory.h"
@@ -42,18 +43,50 @@ public:
     ///                       and the indicated filesize from MAVFTP fileopen response is ignored.
     ///                       This is used for the APM parameter download where the filesize is wrong due to
     ///                       a dynamic file creation on the vehicle.
-    /// @return true: download has started, false: error, no download
+    /// @return true: download has started or is queued behind the current operation, false: error, no download
     /// Signals downloadComplete, commandError, commandProgress
     bool download(uint8_t fromCompId, const QString& fromURI, const QString& toDir, const QString& fileName="", bool checksize = true);
 
+    /// Uploads the specified file. Queued behind the current operation if there is one.
+    ///     @param toCompId   Component id of the component to upload to. If toCompId is MAV_COMP_ID_ALL, then MAV_COMP_ID_AUTOPILOT1 is used.
+    ///     @param fromFile   Local file to upload
+    ///     @param toURI      Fully qualified path of the file on the component, same format as download fromURI
+    /// @return true: upload has started or is queued, false: error, no upload
+    /// Signals uploadComplete, commandProgress
+    bool upload(uint8_t toCompId, const QString& fromFile, const QString& toURI);
+
+    /// Lists the entries of a directory. Queued behind the current operation if there is one.
+    ///     @param fromCompId Component id of the component to list from. If fromCompId is MAV_COMP_ID_ALL, then MAV_COMP_ID_AUTOPILOT1 is used.
+    ///     @param fromURI    Directory to list, same format as download fromURI
+    /// @return true: list has started or is queued, false: error, no list
+    /// Signals listDirectoryComplete
+    bool listDirectory(uint8_t fromCompId, const QString& fromURI);
+
     /// Cancel the current operation
     /// This will emit downloadComplete() when done, and if there's currently a download in progress
     void cancel();
 
+    /// Cancels the operation for the URI, operations for other URIs are not affected. A queued operation is removed from
+    /// the queue and signals completion with an error right away, the current operation is terminated as with cancel().
+    ///     @param uri URI as passed to download, upload or listDirectory
+    void cancel(const QString& uri);
+
+    /// @return Smoothed round trip time of FTP requests, -1 if not known yet
+    int roundTripTimeMilliseconds(void) const { return _srttMilliseconds < 0 ? -1 : qRound(_srttMilliseconds); }
+
     static const char* mavlinkFTPScheme;
 
+    static const int maxPipelinedRequests = 4;  ///< Maximum number of read or write requests in flight while filling holes or uploading
+
 signals:
-    void downloadComplete(const QString& file, const QString& errorMsg);
+    /// Signalled when a download completes
+    ///     @param fromURI URI as passed to download, to tell apart queued downloads
+    void downloadComplete(const QString& file, const QString& errorMsg, const QString& fromURI);
+
+    void uploadComplete(const QString& toURI, const QString& errorMsg);
+
+    /// Entries are prefixed with 'F' for files (followed by "<name>\t<size>") and 'D' for directories
+    void listDirectoryComplete(const QString& fromURI, const QStringList& entries, const QString& errorMsg);
     
     // Signals associated with all commands
     
@@ -64,7 +97,8 @@ signals:
     
     /// Signalled during a lengthy command to show progress
     ///     @param value Amount of progress: 0.0 = none, 1.0 = complete
-    void commandProgress(float value);
+    ///     @param uri   URI of the operation in progress
+    void commandProgress(float value, const QString& uri);
 	
 private slots:
     void _ackOrNakTimeout(void);
@@ -80,16 +114,41 @@ private:
         StateTimeoutFn  timeoutFn;
     };
 
+    typedef enum {
+        OperationDownload,
+        OperationUpload,
+        OperationList,
+    } OperationType_t;
+
+    /// Operation waiting for the current one to complete. Servers support a single session and the sequence numbers
+    /// are shared by all requests to a component, so operations run one after the other.
+    struct Operation_t {
+        OperationType_t type;
+        uint8_t         compId;
+        QString         uri;            ///< URI as passed by the caller
+        QString         localPath;      ///< Download: local directory, Upload: local file
+        QString         fileName;
+        bool            checksize;
+    };
+
     struct MissingData_t {
         uint32_t offset;
         uint32_t cBytesMissing;
     };
 
+    /// Read or write request in flight
+    struct PendingRequest_t {
+        uint32_t offset;
+        uint32_t size;
+        uint16_t seqNumber;     ///< Sequence number of the expected response
+    };
+
     struct DownloadState_t {
         uint8_t                 sessionId;
         uint32_t                expectedOffset;         ///< offset which should be coming next
         uint32_t                bytesWritten;
         QList<MissingData_t>    rgMissingData;
+        QList<PendingRequest_t> rgPendingRequests;      ///< Reads (download) or writes (upload) waiting for their ack, in sequence order
         QString                 fullPathOnVehicle;      ///< Fully qualified path to file on vehicle
         QDir                    toDir;                  ///< Directory to download file to
         QString                 fileName;               ///< Filename (no path) for download file
@@ -97,6 +156,7 @@ private:
         QFile                   file;
         int                     retryCount;
         bool                    checksize;
+        QStringList             rgDirectoryEntries;
 
         bool inProgress() const { return fileSize > 0; }
 
@@ -109,6 +169,8 @@ private:
             fullPathOnVehicle.clear();
             fileName.clear();
             rgMissingData.clear();
+            rgPendingRequests.clear();
+            rgDirectoryEntries.clear();
             file.close();
         }
     };
@@ -117,6 +179,10 @@ private:
     void    _mavlinkMessageReceived     (const mavlink_message_t& message);
     void    _startStateMachine          (void);
     void    _advanceStateMachine        (void);
+    void    _startNextOperation         (void);
+    void    _startDownload              (const Operation_t& operation);
+    void    _startUpload                (const Operation_t& operation);
+    void    _startListDirectory         (const Operation_t& operation);
     void    _openFileROBegin            (void);
     void    _openFileROAckOrNak         (const MavlinkFTP::Request* ackOrNak);
     void    _openFileROTimeout          (void);
@@ -126,18 +192,37 @@ private:
     void    _fillMissingBlocksBegin     (void);
     void    _fillMissingBlocksAckOrNak  (const MavlinkFTP::Request* ackOrNak);
     void    _fillMissingBlocksTimeout   (void);
+    void    _createFileBegin            (void);
+    void    _createFileAckOrNak         (const MavlinkFTP::Request* ackOrNak);
+    void    _createFileTimeout          (void);
+    void    _writeFileBegin             (void);
+    void    _writeFileAckOrNak          (const MavlinkFTP::Request* ackOrNak);
+    void    _writeFileTimeout           (void);
+    void    _listDirectoryBegin         (void);
+    void    _listDirectoryAckOrNak      (const MavlinkFTP::Request* ackOrNak);
+    void    _listDirectoryTimeout       (void);
     void    _resetSessionsBegin         (void);
     void    _resetSessionsAckOrNak      (const MavlinkFTP::Request* ackOrNak);
     void    _resetSessionsTimeout       (void);
     QString _errorMsgFromNak            (const MavlinkFTP::Request* nak);
     void    _sendRequestExpectAck       (MavlinkFTP::Request* request);
-    void    _downloadCompleteNoError    (void) { _downloadComplete(QString()); }
-    void    _downloadComplete           (const QString& errorMsg);
+    void    _operationCompleteNoError   (void) { _operationComplete(QString()); }
+    void    _operationComplete          (const QString& errorMsg);
+    void    _emitOperationComplete      (const Operation_t& operation, const QString& downloadFilePath, const QStringList& directoryEntries, const QString& errorMsg);
     void    _emitErrorMessage           (const QString& msg);
+    void    _emitProgress               (void);
     void    _fillRequestDataWithString(MavlinkFTP::Request* request, const QString& str);
-    void    _fillMissingBlocksWorker    (bool firstRequest);
+    void    _fillMissingBlocksWorker    (void);
     void    _burstReadFileWorker        (bool firstRequest);
+    void    _writeFileWorker            (void);
+    void    _listDirectoryWorker        (bool firstRequest);
+    void    _sendReadRequest            (PendingRequest_t& pendingRequest);
+    bool    _sendWriteRequest           (PendingRequest_t& pendingRequest);
+    void    _resendPendingRequests      (void);
+    int     _pendingRequestIndex        (uint16_t seqNumber) const;
     bool    _parseURI                   (uint8_t fromCompId, const QString& uri, QString& parsedURI, uint8_t& compId);
+    void    _addRoundTripSample         (qint64 sampleMilliseconds);
+    int     _ackOrNakTimeoutMsecs       (void) const;
 
     void    _terminateSessionBegin      (void);
     void    _terminateSessionAckOrNak   (const MavlinkFTP::Request* ackOrNak);
@@ -147,12 +232,23 @@ private:
     Vehicle*                _vehicle;
     uint8_t                 _ftpCompId = MAV_COMP_ID_AUTOPILOT1;
     QList<StateFunctions_t> _rgStateMachine;
+    QQueue<Operation_t>     _operationQueue;
+    Operation_t             _currentOperation;
     DownloadState_t         _downloadState;
     QTimer                  _ackOrNakTimeoutTimer;
     int                     _currentStateMachineIndex   = -1;
     uint16_t                _expectedIncomingSeqNumber  = 0;
+
+    // Round trip time of the last request which was sent only once (Karn's algorithm)
+    QElapsedTimer           _requestTimer;
+    uint16_t                _lastRequestSeqNumber       = 0;
+    bool                    _lastRequestResent          = false;
+    bool                    _lastRequestSampled         = true;
+    double                  _srttMilliseconds           = -1;
+    double                  _rttVarMilliseconds         = 0;
+    int                     _minAckOrNakTimeoutMsecs;
     
-    static const int _ackOrNakTimeoutMsecs  = 1000;
-    static const int _maxRetry              = 3;
+    static const int _initialAckOrNakTimeoutMsecs   = 1000; ///< Used until there is a round trip time sample
+    static const int _maxAckOrNakTimeoutMsecs       = 5000;
+    static const int _maxRetry                      = 3;
 };
-
@@ -12,6 +12,7 @@
 #include "QGCApplication.h"
 #include "MockLink.h"
 #include "FTPManager.h"
+#include "QGCTemporaryFile.h"
 
 const FTPManagerTest::TestCase_t FTPManagerTest::_rgTestCases[] = {
     {  "/general.json" },
@@ -105,11 +106,14 @@ void FTPManagerTest::_testLostPackets(void)
 
     QSignalSpy spyDownloadComplete(ftpManager, &FTPManager::downloadComplete);
 
+    QElapsedTimer transferTimer;
+    transferTimer.start();
     _mockLink->mockLinkFTP()->enableRandromDrops(true);
     ftpManager->download(MAV_COMP_ID_AUTOPILOT1, filename, QStandardPaths::writableLocation(QStandardPaths::TempLocation));
 
     QCOMPARE(spyDownloadComplete.wait(10000), true);
     QCOMPARE(spyDownloadComplete.count(), 1);
+    qDebug() << "Lossy download of" << fileSize << "bytes took" << transferTimer.elapsed() << "msecs, round trip time" << ftpManager->roundTripTimeMilliseconds();
 
     // void downloadComplete   (const QString& file, const QString& errorMsg);
     QList<QVariant> arguments = spyDownloadComplete.takeFirst();
@@ -120,6 +124,140 @@ void FTPManagerTest::_testLostPackets(void)
     _disconnectMockLink();
 }
 
+void FTPManagerTest::_testQueuedOperations(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    FTPManager* ftpManager  = _vehicle->ftpManager();
+    QString     filename1   = QStringLiteral("%1%2").arg(MockLinkFTP::sizeFilenamePrefix).arg(1024);
+    QString     filename2   = QStringLiteral("%1%2").arg(MockLinkFTP::sizeFilenamePrefix).arg(2048);
+    QStringList fileList    = { "Ffile.txt\t10" };
+
+    QSignalSpy spyDownloadComplete(ftpManager, &FTPManager::downloadComplete);
+    QSignalSpy spyListDirectoryComplete(ftpManager, &FTPManager::listDirectoryComplete);
+
+    // Operations requested while another one is in progress are run in order
+    _mockLink->mockLinkFTP()->setFileList(fileList);
+    QVERIFY(ftpManager->download(MAV_COMP_ID_AUTOPILOT1, filename1, QStandardPaths::writableLocation(QStandardPaths::TempLocation)));
+    QVERIFY(ftpManager->download(MAV_COMP_ID_AUTOPILOT1, filename2, QStandardPaths::writableLocation(QStandardPaths::TempLocation)));
+    QVERIFY(ftpManager->listDirectory(MAV_COMP_ID_AUTOPILOT1, "/"));
+
+    QCOMPARE(spyListDirectoryComplete.wait(10000), true);
+    QCOMPARE(spyDownloadComplete.count(), 2);
+
+    // void downloadComplete   (const QString& file, const QString& errorMsg, const QString& fromURI);
+    QList<QVariant> arguments = spyDownloadComplete.takeFirst();
+    QVERIFY(arguments[1].toString().isEmpty());
+    QCOMPARE(arguments[2].toString(), filename1);
+    _verifyFileSizeAndDelete(arguments[0].toString(), 1024);
+
+    arguments = spyDownloadComplete.takeFirst();
+    QVERIFY(arguments[1].toString().isEmpty());
+    QCOMPARE(arguments[2].toString(), filename2);
+    _verifyFileSizeAndDelete(arguments[0].toString(), 2048);
+
+    arguments = spyListDirectoryComplete.takeFirst();
+    QVERIFY(arguments[2].toString().isEmpty());
+
+    _disconnectMockLink();
+}
+
+void FTPManagerTest::_testCancelQueued(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    FTPManager* ftpManager  = _vehicle->ftpManager();
+    QString     filename1   = QStringLiteral("%1%2").arg(MockLinkFTP::sizeFilenamePrefix).arg(1024);
+    QString     filename2   = QStringLiteral("%1%2").arg(MockLinkFTP::sizeFilenamePrefix).arg(2048);
+
+    QSignalSpy spyDownloadComplete(ftpManager, &FTPManager::downloadComplete);
+
+    QVERIFY(ftpManager->download(MAV_COMP_ID_AUTOPILOT1, filename1, QStandardPaths::writableLocation(QStandardPaths::TempLocation)));
+    QVERIFY(ftpManager->download(MAV_COMP_ID_AUTOPILOT1, filename2, QStandardPaths::writableLocation(QStandardPaths::TempLocation)));
+
+    // Unknown URIs are ignored, a queued download completes with an error right away
+    ftpManager->cancel(QStringLiteral("unknown"));
+    QCOMPARE(spyDownloadComplete.count(), 0);
+    ftpManager->cancel(filename2);
+    QCOMPARE(spyDownloadComplete.count(), 1);
+
+    // void downloadComplete   (const QString& file, const QString& errorMsg, const QString& fromURI);
+    QList<QVariant> arguments = spyDownloadComplete.takeFirst();
+    QVERIFY(!arguments[1].toString().isEmpty());
+    QCOMPARE(arguments[2].toString(), filename2);
+
+    // The current download is not affected
+    QCOMPARE(spyDownloadComplete.wait(10000), true);
+    arguments = spyDownloadComplete.takeFirst();
+    QVERIFY(arguments[1].toString().isEmpty());
+    QCOMPARE(arguments[2].toString(), filename1);
+    _verifyFileSizeAndDelete(arguments[0].toString(), 1024);
+
+    // Nothing else was run
+    QCOMPARE(spyDownloadComplete.wait(500), false);
+
+    _disconnectMockLink();
+}
+
+void FTPManagerTest::_testListDirectory(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    FTPManager* ftpManager  = _vehicle->ftpManager();
+    QStringList fileList    = { "Ffile.txt\t10", "Ddirectory", "S" };
+
+    QSignalSpy spyListDirectoryComplete(ftpManager, &FTPManager::listDirectoryComplete);
+
+    _mockLink->mockLinkFTP()->setFileList(fileList);
+    QVERIFY(ftpManager->listDirectory(MAV_COMP_ID_AUTOPILOT1, "/"));
+
+    QCOMPARE(spyListDirectoryComplete.wait(10000), true);
+    QCOMPARE(spyListDirectoryComplete.count(), 1);
+
+    // void listDirectoryComplete(const QString& fromURI, const QStringList& entries, const QString& errorMsg);
+    QList<QVariant> arguments = spyListDirectoryComplete.takeFirst();
+    QVERIFY(arguments[2].toString().isEmpty());
+    QCOMPARE(arguments[1].toStringList(), QStringList({ "Ffile.txt\t10", "Ddirectory" }));
+
+    _disconnectMockLink();
+}
+
+void FTPManagerTest::_testUploadLostPackets(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    FTPManager* ftpManager  = _vehicle->ftpManager();
+    int         fileSize    = 4 * 1024;
+    QString     toURI       = QStringLiteral("/upload.bin");
+
+    QByteArray fileData;
+    for (int i=0; i<fileSize; i++) {
+        fileData.append(static_cast<char>(i % 255));
+    }
+    QGCTemporaryFile uploadFile("FTPManagerTestUpload");
+    QVERIFY(uploadFile.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    uploadFile.write(fileData);
+    uploadFile.close();
+
+    QSignalSpy spyUploadComplete(ftpManager, &FTPManager::uploadComplete);
+
+    _mockLink->mockLinkFTP()->enableRandromDrops(true);
+    QVERIFY(ftpManager->upload(MAV_COMP_ID_AUTOPILOT1, uploadFile.fileName(), toURI));
+
+    QCOMPARE(spyUploadComplete.wait(10000), true);
+    QCOMPARE(spyUploadComplete.count(), 1);
+
+    // void uploadComplete(const QString& toURI, const QString& errorMsg);
+    QList<QVariant> arguments = spyUploadComplete.takeFirst();
+    QCOMPARE(arguments[0].toString(), toURI);
+    QVERIFY(arguments[1].toString().isEmpty());
+    QCOMPARE(_mockLink->mockLinkFTP()->uploadedFile(toURI), fileData);
+
+    uploadFile.remove();
+
+    _disconnectMockLink();
+}
+
 void FTPManagerTest::_verifyFileSizeAndDelete(const QString& filename, int expectedSize)
 {
     QFileInfo fileInfo(filename);
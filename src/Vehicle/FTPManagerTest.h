@@ -17,6 +17,10 @@ class FTPManagerTest : public UnitTest
 
 private slots:
     void _testLostPackets           (void);
+    void _testQueuedOperations      (void);
+    void _testCancelQueued          (void);
+    void _testListDirectory         (void);
+    void _testUploadLostPackets     (void);
 
     // Overrides from UnitTest
     void cleanup(void) override;
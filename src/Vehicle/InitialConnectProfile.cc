@@ -0,0 +1,250 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "InitialConnectProfile.h"
+#include "QGCApplication.h"
+#include "SettingsManager.h"
+#include "AppSettings.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+#include <cstddef>
+
+InitialConnectProfile::InitialConnectProfile(QObject* parent)
+    : QObject(parent)
+{
+
+}
+
+void InitialConnectProfile::start(void)
+{
+    {
+        QMutexLocker lock(&_mutex);
+        _states.clear();
+        _sentPayloadHashes.clear();
+        _totalMsecs = 0;
+        _complete   = false;
+        _active     = true;
+        _timer.start();
+    }
+    emit profileChanged();
+}
+
+void InitialConnectProfile::startState(const QString& name)
+{
+    {
+        QMutexLocker lock(&_mutex);
+        if (!_active) {
+            return;
+        }
+        _endState();
+
+        StateProfile state;
+        state.name          = name;
+        state.startMsecs    = _timer.elapsed();
+        _states.append(state);
+    }
+    emit profileChanged();
+}
+
+void InitialConnectProfile::finish(void)
+{
+    {
+        QMutexLocker lock(&_mutex);
+        if (!_active) {
+            return;
+        }
+        _endState();
+        _totalMsecs = _timer.elapsed();
+        _active     = false;
+        _complete   = true;
+    }
+    emit profileChanged();
+}
+
+void InitialConnectProfile::_endState(void)
+{
+    if (!_states.isEmpty()) {
+        StateProfile& state = _states.last();
+        state.elapsedMsecs = _timer.elapsed() - state.startMsecs;
+    }
+    _sentPayloadHashes.clear();
+}
+
+void InitialConnectProfile::messageSent(const mavlink_message_t& message, int length)
+{
+    QMutexLocker lock(&_mutex);
+    if (!_active || _states.isEmpty()) {
+        return;
+    }
+
+    StateProfile& state = _states.last();
+    state.messagesSent++;
+    state.bytesSent += length;
+
+    // Heartbeats are repeated by design
+    if (message.msgid != MAVLINK_MSG_ID_HEARTBEAT) {
+        QByteArray payload(_MAV_PAYLOAD(&message), message.len);
+        if (message.msgid == MAVLINK_MSG_ID_FILE_TRANSFER_PROTOCOL) {
+            // A resent FTP request only differs by its sequence number
+            const int seqOffset = static_cast<int>(offsetof(mavlink_file_transfer_protocol_t, payload) + offsetof(MavlinkFTP::RequestHeader, seqNumber));
+            for (int i=seqOffset; i<seqOffset + static_cast<int>(sizeof(uint16_t)) && i<payload.size(); i++) {
+                payload[i] = 0;
+            }
+        }
+        uint hash = qHash(payload, message.msgid);
+        if (_sentPayloadHashes.contains(hash)) {
+            state.retries++;
+        } else {
+            _sentPayloadHashes.insert(hash);
+        }
+    }
+}
+
+void InitialConnectProfile::messageReceived(const mavlink_message_t& message)
+{
+    QMutexLocker lock(&_mutex);
+    if (!_active || _states.isEmpty()) {
+        return;
+    }
+
+    StateProfile& state = _states.last();
+    state.messagesReceived++;
+    state.bytesReceived += message.len + MAVLINK_NUM_NON_PAYLOAD_BYTES;
+}
+
+bool InitialConnectProfile::complete(void) const
+{
+    QMutexLocker lock(&_mutex);
+    return _complete;
+}
+
+qint64 InitialConnectProfile::totalMsecs(void) const
+{
+    QMutexLocker lock(&_mutex);
+    return _active ? _timer.elapsed() : _totalMsecs;
+}
+
+QList<InitialConnectProfile::StateProfile> InitialConnectProfile::states(void) const
+{
+    QMutexLocker lock(&_mutex);
+    QList<StateProfile> states = _states;
+    if (_active && !states.isEmpty()) {
+        states.last().elapsedMsecs = _timer.elapsed() - states.last().startMsecs;
+    }
+    return states;
+}
+
+InitialConnectProfile::StateProfile InitialConnectProfile::_totals(const QList<StateProfile>& states)
+{
+    StateProfile totals;
+    totals.name = tr("Total");
+    for (const StateProfile& state: states) {
+        totals.elapsedMsecs     += state.elapsedMsecs;
+        totals.messagesSent     += state.messagesSent;
+        totals.messagesReceived += state.messagesReceived;
+        totals.retries          += state.retries;
+        totals.bytesSent        += state.bytesSent;
+        totals.bytesReceived    += state.bytesReceived;
+    }
+    return totals;
+}
+
+QString InitialConnectProfile::report(void) const
+{
+    QList<StateProfile> rgStates = states();
+    if (rgStates.isEmpty()) {
+        return QString();
+    }
+
+    QString text = QStringLiteral("%1 %2 %3 %4 %5 %6 %7\n")
+            .arg(tr("State"), -26)
+            .arg(tr("ms"), 7)
+            .arg(tr("Sent"), 6)
+            .arg(tr("Recv"), 6)
+            .arg(tr("Retries"), 7)
+            .arg(tr("Bytes out"), 10)
+            .arg(tr("Bytes in"), 10);
+
+    rgStates.append(_totals(rgStates));
+    for (const StateProfile& state: rgStates) {
+        text += QStringLiteral("%1 %2 %3 %4 %5 %6 %7\n")
+                .arg(state.name, -26)
+                .arg(state.elapsedMsecs, 7)
+                .arg(state.messagesSent, 6)
+                .arg(state.messagesReceived, 6)
+                .arg(state.retries, 7)
+                .arg(state.bytesSent, 10)
+                .arg(state.bytesReceived, 10);
+    }
+    return text;
+}
+
+QJsonObject InitialConnectProfile::toJson(void) const
+{
+    static const char* kNameKey             = "name";
+    static const char* kStartMsecsKey       = "startMsecs";
+    static const char* kElapsedMsecsKey     = "elapsedMsecs";
+    static const char* kMessagesSentKey     = "messagesSent";
+    static const char* kMessagesReceivedKey = "messagesReceived";
+    static const char* kRetriesKey          = "retries";
+    static const char* kBytesSentKey        = "bytesSent";
+    static const char* kBytesReceivedKey    = "bytesReceived";
+
+    QList<StateProfile> rgStates = states();
+
+    QJsonArray statesArray;
+    for (const StateProfile& state: rgStates) {
+        QJsonObject stateObject;
+        stateObject[kNameKey]               = state.name;
+        stateObject[kStartMsecsKey]         = state.startMsecs;
+        stateObject[kElapsedMsecsKey]       = state.elapsedMsecs;
+        stateObject[kMessagesSentKey]       = state.messagesSent;
+        stateObject[kMessagesReceivedKey]   = state.messagesReceived;
+        stateObject[kRetriesKey]            = state.retries;
+        stateObject[kBytesSentKey]          = state.bytesSent;
+        stateObject[kBytesReceivedKey]      = state.bytesReceived;
+        statesArray.append(stateObject);
+    }
+
+    StateProfile totals = _totals(rgStates);
+
+    QJsonObject profileObject;
+    profileObject["complete"]               = complete();
+    profileObject["totalMsecs"]             = totalMsecs();
+    profileObject[kMessagesSentKey]         = totals.messagesSent;
+    profileObject[kMessagesReceivedKey]     = totals.messagesReceived;
+    profileObject[kRetriesKey]              = totals.retries;
+    profileObject[kBytesSentKey]            = totals.bytesSent;
+    profileObject[kBytesReceivedKey]        = totals.bytesReceived;
+    profileObject["states"]                 = statesArray;
+    return profileObject;
+}
+
+QString InitialConnectProfile::saveJson(void) const
+{
+    QString saveDir = qgcApp()->toolbox()->settingsManager()->appSettings()->logSavePath();
+    if (saveDir.isEmpty()) {
+        qWarning() << "InitialConnectProfile::saveJson no log save path";
+        return QString();
+    }
+
+    QString fileName = QDir(saveDir).absoluteFilePath(QStringLiteral("ConnectProfile-%1.json").arg(QDateTime::currentDateTime().toString("yyyy-MM-dd-hh-mm-ss")));
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "InitialConnectProfile::saveJson open failed" << fileName << file.errorString();
+        return QString();
+    }
+    file.write(QJsonDocument(toJson()).toJson());
+    return fileName;
+}
@@ -0,0 +1,90 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "QGCMAVLink.h"
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QMutex>
+#include <QSet>
+
+/// Breakdown of the time it takes to connect to a vehicle. For each InitialConnectStateMachine state the wall time, the
+/// MAVLink messages and bytes sent and received and the number of resent requests are recorded. A message sent again with
+/// an identical payload within the same state is counted as a retry. FTP requests are compared without their sequence
+/// number since FTPManager resends them with a new one.
+class InitialConnectProfile : public QObject
+{
+    Q_OBJECT
+
+public:
+    InitialConnectProfile(QObject* parent = nullptr);
+
+    Q_PROPERTY(bool     complete    READ complete   NOTIFY profileChanged)
+    Q_PROPERTY(qint64   totalMsecs  READ totalMsecs NOTIFY profileChanged)
+    Q_PROPERTY(QString  report      READ report     NOTIFY profileChanged)
+
+    struct StateProfile {
+        QString name;
+        qint64  startMsecs =        0;  ///< Relative to the start of the profile
+        qint64  elapsedMsecs =      0;
+        int     messagesSent =      0;
+        int     messagesReceived =  0;
+        int     retries =           0;
+        qint64  bytesSent =         0;
+        qint64  bytesReceived =     0;
+    };
+
+    /// Clears the previous profile and starts recording
+    void start(void);
+
+    /// Ends the current state and starts recording the specified one
+    void startState(const QString& name);
+
+    /// Ends the current state and stops recording
+    void finish(void);
+
+    /// Called for each message sent to the vehicle, thread safe
+    ///     @param length Number of bytes written to the link
+    void messageSent(const mavlink_message_t& message, int length);
+
+    /// Called for each message received from the vehicle, thread safe
+    void messageReceived(const mavlink_message_t& message);
+
+    bool                complete    (void) const;
+    qint64              totalMsecs  (void) const;
+    QList<StateProfile> states      (void) const;
+
+    /// @return Human readable table, one line per state plus totals
+    QString report(void) const;
+
+    QJsonObject toJson(void) const;
+
+    /// Saves the profile as JSON to the log save directory
+    /// @return File name of the saved profile, empty if it could not be written
+    Q_INVOKABLE QString saveJson(void) const;
+
+signals:
+    void profileChanged(void);
+
+private:
+    void _endState(void);
+
+    static StateProfile _totals(const QList<StateProfile>& states);
+
+    mutable QMutex      _mutex;
+    QElapsedTimer       _timer;
+    bool                _active =   false;
+    bool                _complete = false;
+    qint64              _totalMsecs = 0;
+    QList<StateProfile> _states;
+    QSet<uint>          _sentPayloadHashes;     ///< Payloads sent in the current state, used to detect retries
+};
@@ -0,0 +1,79 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "InitialConnectProfileTest.h"
+#include "InitialConnectProfile.h"
+#include "MultiVehicleManager.h"
+#include "QGCApplication.h"
+#include "LinkManager.h"
+#include "MockLink.h"
+#include "Vehicle.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+
+/// Connect benchmark: profiles the initial connect sequence over links with increasing latency and loss. The reports are
+/// logged so runs can be compared, losses are reproducible since MockLink uses a fixed seed.
+void InitialConnectProfileTest::_connectProfile(void)
+{
+    static const struct LinkProfile_s {
+        int         latencyMsecs;
+        int         lossPct;
+        const char* description;
+    } rgLinkProfiles[] = {
+        { 0,    0,  "Ideal link" },
+        { 25,   0,  "25 ms latency" },
+        { 25,   2,  "25 ms latency, 2% loss" },
+    };
+
+    auto *mvm = qgcApp()->toolbox()->multiVehicleManager();
+
+    for (const struct LinkProfile_s& linkProfile: rgLinkProfiles) {
+        QSignalSpy activeVehicleSpy{mvm, &MultiVehicleManager::activeVehicleChanged};
+
+        auto mockConfig = std::make_shared<MockConfiguration>(QString{"MockLink"});
+        mockConfig->setLinkSimulation(linkProfile.latencyMsecs, linkProfile.lossPct);
+
+        SharedLinkConfigurationPtr linkConfig = mockConfig;
+        _linkManager->createConnectedLink(linkConfig);
+
+        QVERIFY(activeVehicleSpy.wait());
+        auto *vehicle = mvm->activeVehicle();
+        QSignalSpy initialConnectCompleteSpy{vehicle, &Vehicle::initialConnectComplete};
+        QVERIFY(initialConnectCompleteSpy.wait(60000) || vehicle->isInitialConnectComplete());
+
+        InitialConnectProfile* profile = vehicle->initialConnectProfile();
+        QVERIFY(profile->complete());
+        qDebug().noquote() << "Connect profile:" << linkProfile.description << "\n" << profile->report();
+
+        const QList<InitialConnectProfile::StateProfile> states = profile->states();
+        QCOMPARE(states.count(), 8);
+        qint64 stateMsecs = 0;
+        for (const InitialConnectProfile::StateProfile& state: states) {
+            QVERIFY(state.elapsedMsecs >= 0);
+            stateMsecs += state.elapsedMsecs;
+        }
+        QVERIFY(stateMsecs <= profile->totalMsecs());
+
+        QJsonObject jsonProfile = profile->toJson();
+        QCOMPARE(jsonProfile["states"].toArray().count(), states.count());
+        QVERIFY(jsonProfile["messagesSent"].toInt() > 0);
+        QVERIFY(jsonProfile["messagesReceived"].toInt() > 0);
+        qDebug().noquote() << QJsonDocument(jsonProfile).toJson(QJsonDocument::Compact);
+
+        // Lost messages must show up as retries, including FTP requests which are resent with a new sequence number
+        if (linkProfile.lossPct > 0) {
+            QVERIFY(jsonProfile["retries"].toInt() > 0);
+        }
+
+        QSignalSpy activeVehicleRemovedSpy{mvm, &MultiVehicleManager::activeVehicleChanged};
+        _linkManager->disconnectAll();
+        QVERIFY(activeVehicleRemovedSpy.wait(10000));
+    }
+}
@@ -16,32 +16,43 @@
 #include "ComponentInformationManager.h"
 #include "MissionManager.h"
 
+#include <algorithm>
+#include <iterator>
+
 QGC_LOGGING_CATEGORY(InitialConnectStateMachineLog, "InitialConnectStateMachineLog")
 
 const StateMachine::StateFn InitialConnectStateMachine::_rgStates[] = {
     InitialConnectStateMachine::_stateRequestAutopilotVersion,
     InitialConnectStateMachine::_stateRequestProtocolVersion,
+    InitialConnectStateMachine::_stateRequestPlan,
     InitialConnectStateMachine::_stateRequestStandardModes,
     InitialConnectStateMachine::_stateRequestCompInfo,
     InitialConnectStateMachine::_stateRequestParameters,
-    InitialConnectStateMachine::_stateRequestMission,
-    InitialConnectStateMachine::_stateRequestGeoFence,
-    InitialConnectStateMachine::_stateRequestRallyPoints,
+    InitialConnectStateMachine::_stateWaitForPlan,
     InitialConnectStateMachine::_stateSignalInitialConnectComplete
 };
 
 const int InitialConnectStateMachine::_rgProgressWeights[] = {
     1, //_stateRequestCapabilities
     1, //_stateRequestProtocolVersion
+    0, //_stateRequestPlan
     1, //_stateRequestStandardModes
     5, //_stateRequestCompInfo
     5, //_stateRequestParameters
-    2, //_stateRequestMission
-    1, //_stateRequestGeoFence
-    1, //_stateRequestRallyPoints
+    4, //_stateWaitForPlan
     1, //_stateSignalInitialConnectComplete
 };
 
+const char* InitialConnectStateMachine::_rgStateNames[] = {
+    "AutopilotVersion",
+    "ProtocolVersion",
+    "RequestPlan",
+    "StandardModes",
+    "CompInfo",
+    "Parameters",
+    "WaitForPlan",
+    "SignalInitialConnectComplete",
+};
 
 const int InitialConnectStateMachine::_cStates = sizeof(InitialConnectStateMachine::_rgStates) / sizeof(InitialConnectStateMachine::_rgStates[0]);
 
@@ -50,6 +61,8 @@ InitialConnectStateMachine::InitialConnectStateMachine(Vehicle* vehicle)
 {
     static_assert(sizeof(_rgStates)/sizeof(_rgStates[0]) == sizeof(_rgProgressWeights)/sizeof(_rgProgressWeights[0]),
             "array size mismatch");
+    static_assert(sizeof(_rgStates)/sizeof(_rgStates[0]) == sizeof(_rgStateNames)/sizeof(_rgStateNames[0]),
+            "array size mismatch");
 
     _progressWeightTotal = 0;
     for (int i = 0; i < _cStates; ++i) {
@@ -74,6 +87,18 @@ void InitialConnectStateMachine::statesCompleted(void) const
 
 void InitialConnectStateMachine::advance()
 {
+    if (_active) {
+        InitialConnectProfile* profile = _vehicle->initialConnectProfile();
+        if (_stateIndex < 0) {
+            profile->start();
+        }
+        if (_stateIndex + 1 < _cStates) {
+            profile->startState(_rgStateNames[_stateIndex + 1]);
+        } else {
+            profile->finish();
+            qCDebug(InitialConnectStateMachineLog).noquote() << "Initial connect profile\n" << profile->report();
+        }
+    }
     StateMachine::advance();
     emit progressUpdate(_progress());
 }
@@ -322,87 +347,161 @@ void InitialConnectStateMachine::_stateRequestParameters(StateMachine* stateMach
     vehicle->_parameterManager->refreshAllParameters();
 }
 
-void InitialConnectStateMachine::_stateRequestMission(StateMachine* stateMachine)
+void InitialConnectStateMachine::_stateRequestPlan(StateMachine* stateMachine)
 {
     InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
     Vehicle*                    vehicle         = connectMachine->_vehicle;
     SharedLinkInterfacePtr      sharedLink      = vehicle->vehicleLinkManager()->primaryLink().lock();
 
-    disconnect(vehicle->_parameterManager, &ParameterManager::loadProgressChanged, connectMachine,
-            &InitialConnectStateMachine::gotProgressUpdate);
+    // Plan loads only depend on the capabilities and protocol version. They use their own protocol, so they run in the
+    // background while standard modes, component information and parameters are requested. _stateWaitForPlan collects them.
+    connectMachine->_pendingPlanLoads       = 3;
+    std::fill(std::begin(connectMachine->_rgPlanLoadProgress), std::end(connectMachine->_rgPlanLoadProgress), 0.f);
+    connectMachine->_concurrentPlanLoads    = vehicle->firmwarePlugin()->concurrentPlanReads();
+    connectMachine->_skipPlanLoads          = false;
 
     if (!sharedLink) {
-        qCDebug(InitialConnectStateMachineLog) << "_stateRequestMission: Skipping first mission load request due to no primary link";
-        connectMachine->advance();
+        qCDebug(InitialConnectStateMachineLog) << "_stateRequestPlan: Skipping first plan load requests due to no primary link";
+        connectMachine->_skipPlanLoads = true;
+    } else if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isPX4Flow() || sharedLink->isLogReplay()) {
+        qCDebug(InitialConnectStateMachineLog) << "_stateRequestPlan: Skipping first plan load requests due to link type";
+        connectMachine->_skipPlanLoads = true;
+    }
+
+    if (connectMachine->_concurrentPlanLoads) {
+        connectMachine->_startPlanLoad(MAV_MISSION_TYPE_MISSION);
+        connectMachine->_startPlanLoad(MAV_MISSION_TYPE_FENCE);
+        connectMachine->_startPlanLoad(MAV_MISSION_TYPE_RALLY);
     } else {
-        if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isPX4Flow() || sharedLink->isLogReplay()) {
-            qCDebug(InitialConnectStateMachineLog) << "_stateRequestMission: Skipping first mission load request due to link type";
-            vehicle->_firstMissionLoadComplete();
+        // Geofence and rally points follow as each load completes
+        connectMachine->_startPlanLoad(MAV_MISSION_TYPE_MISSION);
+    }
+
+    connectMachine->advance();
+}
+
+PlanManager* InitialConnectStateMachine::_planManager(MAV_MISSION_TYPE planType) const
+{
+    switch (planType) {
+    case MAV_MISSION_TYPE_MISSION:
+        return _vehicle->_missionManager;
+    case MAV_MISSION_TYPE_FENCE:
+        return _vehicle->_geoFenceManager;
+    case MAV_MISSION_TYPE_RALLY:
+        return _vehicle->_rallyPointManager;
+    default:
+        return nullptr;
+    }
+}
+
+void InitialConnectStateMachine::_startPlanLoad(MAV_MISSION_TYPE planType)
+{
+    if (!_skipPlanLoads) {
+        connect(_planManager(planType), &PlanManager::progressPct, this, [this, planType](double progressPct) { _planLoadProgress(planType, progressPct); });
+    }
+
+    switch (planType) {
+    case MAV_MISSION_TYPE_MISSION:
+        if (_skipPlanLoads) {
+            _vehicle->_firstMissionLoadComplete();
         } else {
-            qCDebug(InitialConnectStateMachineLog) << "_stateRequestMission";
-            vehicle->_missionManager->loadFromVehicle();
-            connect(vehicle->_missionManager, &MissionManager::progressPct, connectMachine,
-                    &InitialConnectStateMachine::gotProgressUpdate);
+            qCDebug(InitialConnectStateMachineLog) << "_startPlanLoad: mission";
+            _vehicle->_missionManager->loadFromVehicle();
         }
+        break;
+    case MAV_MISSION_TYPE_FENCE:
+        if (_skipPlanLoads) {
+            _vehicle->_firstGeoFenceLoadComplete();
+        } else if (_vehicle->_geoFenceManager->supported()) {
+            qCDebug(InitialConnectStateMachineLog) << "_startPlanLoad: geofence";
+            _vehicle->_geoFenceManager->loadFromVehicle();
+        } else {
+            qCDebug(InitialConnectStateMachineLog) << "_startPlanLoad: geofence skipped due to no support";
+            _vehicle->_firstGeoFenceLoadComplete();
+        }
+        break;
+    case MAV_MISSION_TYPE_RALLY:
+        if (_skipPlanLoads) {
+            _vehicle->_firstRallyPointLoadComplete();
+        } else if (_vehicle->_rallyPointManager->supported()) {
+            qCDebug(InitialConnectStateMachineLog) << "_startPlanLoad: rally points";
+            _vehicle->_rallyPointManager->loadFromVehicle();
+        } else {
+            qCDebug(InitialConnectStateMachineLog) << "_startPlanLoad: rally points skipped due to no support";
+            _vehicle->_firstRallyPointLoadComplete();
+        }
+        break;
+    default:
+        break;
     }
 }
 
-void InitialConnectStateMachine::_stateRequestGeoFence(StateMachine* stateMachine)
+void InitialConnectStateMachine::planLoadComplete(MAV_MISSION_TYPE planType)
 {
-    InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
-    Vehicle*                    vehicle         = connectMachine->_vehicle;
-    SharedLinkInterfacePtr      sharedLink      = vehicle->vehicleLinkManager()->primaryLink().lock();
+    if (_pendingPlanLoads <= 0) {
+        return;
+    }
+    _pendingPlanLoads--;
+    qCDebug(InitialConnectStateMachineLog) << "planLoadComplete" << planType << "pending" << _pendingPlanLoads;
 
-    disconnect(vehicle->_missionManager, &MissionManager::progressPct, connectMachine,
-               &InitialConnectStateMachine::gotProgressUpdate);
+    PlanManager* planManager = _planManager(planType);
+    if (planManager) {
+        disconnect(planManager, &PlanManager::progressPct, this, nullptr);
+        _rgPlanLoadProgress[planType] = 1.f;
+    }
 
-    if (!sharedLink) {
-        qCDebug(InitialConnectStateMachineLog) << "_stateRequestGeoFence: Skipping first geofence load request due to no primary link";
-        connectMachine->advance();
-    } else {
-        if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isPX4Flow() || sharedLink->isLogReplay()) {
-            qCDebug(InitialConnectStateMachineLog) << "_stateRequestGeoFence: Skipping first geofence load request due to link type";
-            vehicle->_firstGeoFenceLoadComplete();
+    if (!_concurrentPlanLoads) {
+        if (planType == MAV_MISSION_TYPE_MISSION) {
+            _startPlanLoad(MAV_MISSION_TYPE_FENCE);
+        } else if (planType == MAV_MISSION_TYPE_FENCE) {
+            _startPlanLoad(MAV_MISSION_TYPE_RALLY);
+        }
+    }
+
+    if (currentState() == _stateWaitForPlan) {
+        if (_pendingPlanLoads == 0) {
+            _planLoadsComplete();
         } else {
-            if (vehicle->_geoFenceManager->supported()) {
-                qCDebug(InitialConnectStateMachineLog) << "_stateRequestGeoFence";
-                vehicle->_geoFenceManager->loadFromVehicle();
-                connect(vehicle->_geoFenceManager, &GeoFenceManager::progressPct, connectMachine,
-                        &InitialConnectStateMachine::gotProgressUpdate);
-            } else {
-                qCDebug(InitialConnectStateMachineLog) << "_stateRequestGeoFence: skipped due to no support";
-                vehicle->_firstGeoFenceLoadComplete();
-            }
+            emit progressUpdate(_progress(_planProgress()));
         }
     }
 }
 
-void InitialConnectStateMachine::_stateRequestRallyPoints(StateMachine* stateMachine)
+/// Item progress of the plan loads is only shown once the sequence waits for them, before that it would move the
+/// progress bar backwards and forwards within the other states
+void InitialConnectStateMachine::_planLoadProgress(MAV_MISSION_TYPE planType, double progressPct)
+{
+    _rgPlanLoadProgress[planType] = static_cast<float>(progressPct);
+    if (currentState() == _stateWaitForPlan) {
+        emit progressUpdate(_progress(_planProgress()));
+    }
+}
+
+float InitialConnectStateMachine::_planProgress(void) const
+{
+    return (_rgPlanLoadProgress[MAV_MISSION_TYPE_MISSION] + _rgPlanLoadProgress[MAV_MISSION_TYPE_FENCE] + _rgPlanLoadProgress[MAV_MISSION_TYPE_RALLY]) / 3.f;
+}
+
+void InitialConnectStateMachine::_planLoadsComplete(void)
+{
+    _vehicle->_initialPlanRequestComplete = true;
+    emit _vehicle->initialPlanRequestCompleteChanged(true);
+    advance();
+}
+
+void InitialConnectStateMachine::_stateWaitForPlan(StateMachine* stateMachine)
 {
     InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
     Vehicle*                    vehicle         = connectMachine->_vehicle;
-    SharedLinkInterfacePtr      sharedLink      = vehicle->vehicleLinkManager()->primaryLink().lock();
 
-    disconnect(vehicle->_geoFenceManager, &GeoFenceManager::progressPct, connectMachine,
-               &InitialConnectStateMachine::gotProgressUpdate);
+    disconnect(vehicle->_parameterManager, &ParameterManager::loadProgressChanged, connectMachine,
+            &InitialConnectStateMachine::gotProgressUpdate);
 
-    if (!sharedLink) {
-        qCDebug(InitialConnectStateMachineLog) << "_stateRequestRallyPoints: Skipping first rally point load request due to no primary link";
-        connectMachine->advance();
+    if (connectMachine->_pendingPlanLoads == 0) {
+        connectMachine->_planLoadsComplete();
     } else {
-        if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isPX4Flow() || sharedLink->isLogReplay()) {
-            qCDebug(InitialConnectStateMachineLog) << "_stateRequestRallyPoints: Skipping first rally point load request due to link type";
-            vehicle->_firstRallyPointLoadComplete();
-        } else {
-            if (vehicle->_rallyPointManager->supported()) {
-                vehicle->_rallyPointManager->loadFromVehicle();
-                connect(vehicle->_rallyPointManager, &RallyPointManager::progressPct, connectMachine,
-                        &InitialConnectStateMachine::gotProgressUpdate);
-            } else {
-                qCDebug(InitialConnectStateMachineLog) << "_stateRequestRallyPoints: skipping due to no support";
-                vehicle->_firstRallyPointLoadComplete();
-            }
-        }
+        qCDebug(InitialConnectStateMachineLog) << "_stateWaitForPlan: waiting for plan loads" << connectMachine->_pendingPlanLoads;
+        emit connectMachine->progressUpdate(connectMachine->_progress(connectMachine->_planProgress()));
     }
 }
 
@@ -411,9 +510,6 @@ void InitialConnectStateMachine::_stateSignalInitialConnectComplete(StateMachine
     InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
     Vehicle*                    vehicle         = connectMachine->_vehicle;
 
-    disconnect(vehicle->_rallyPointManager, &RallyPointManager::progressPct, connectMachine,
-               &InitialConnectStateMachine::gotProgressUpdate);
-
     connectMachine->advance();
     qCDebug(InitialConnectStateMachineLog) << "Signalling initialConnectComplete";
     emit vehicle->initialConnectComplete();
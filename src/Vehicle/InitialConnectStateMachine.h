@@ -32,6 +32,9 @@ public:
 
     void advance() override;
 
+    /// Called when the first load of a plan type from the vehicle completes or was skipped
+    void planLoadComplete(MAV_MISSION_TYPE planType);
+
 signals:
     void progressUpdate(float progress);
 
@@ -46,21 +49,32 @@ private:
     static void _stateRequestStandardModes              (StateMachine* stateMachine);
     static void _stateRequestCompInfoComplete           (void* requestAllCompleteFnData);
     static void _stateRequestParameters                 (StateMachine* stateMachine);
-    static void _stateRequestMission                    (StateMachine* stateMachine);
-    static void _stateRequestGeoFence                   (StateMachine* stateMachine);
-    static void _stateRequestRallyPoints                (StateMachine* stateMachine);
+    static void _stateRequestPlan                       (StateMachine* stateMachine);
+    static void _stateWaitForPlan                       (StateMachine* stateMachine);
     static void _stateSignalInitialConnectComplete      (StateMachine* stateMachine);
 
     static void _autopilotVersionRequestMessageHandler  (void* resultHandlerData, MAV_RESULT commandResult, Vehicle::RequestMessageResultHandlerFailureCode_t failureCode, const mavlink_message_t& message);
     static void _protocolVersionRequestMessageHandler   (void* resultHandlerData, MAV_RESULT commandResult, Vehicle::RequestMessageResultHandlerFailureCode_t failureCode, const mavlink_message_t& message);
 
     float _progress(float subProgress = 0.f);
+    void  _startPlanLoad    (MAV_MISSION_TYPE planType);
+    float _planProgress     (void) const;
+    void  _planLoadsComplete(void);
+    void  _planLoadProgress (MAV_MISSION_TYPE planType, double progressPct);
+
+    PlanManager* _planManager(MAV_MISSION_TYPE planType) const;
 
     Vehicle* _vehicle;
 
     static const StateFn    _rgStates[];
+    static const char*      _rgStateNames[];
     static const int        _rgProgressWeights[];
     static const int        _cStates;
 
     int _progressWeightTotal;
+
+    int  _pendingPlanLoads      = 0;        ///< Mission, geofence and rally point loads still running
+    bool _concurrentPlanLoads   = false;    ///< true: All plan types are requested at once, false: one after the other
+    bool _skipPlanLoads         = false;
+    float _rgPlanLoadProgress[3] = {};      ///< Item progress of each plan load, indexed by MAV_MISSION_TYPE
 };
@@ -12,6 +12,8 @@
 #include "QGCApplication.h"
 #include "LinkManager.h"
 #include "MockLink.h"
+#include "FirmwarePlugin.h"
+
 
 void InitialConnectTest::_performTestCases(void)
 {
@@ -59,3 +61,22 @@ void InitialConnectTest::_boardVendorProductId(void)
 
     _linkManager->disconnectAll();
 }
+
+void InitialConnectTest::_concurrentPlanLoad(void)
+{
+    // ArduPilot serves mission, geofence and rally point reads independently, so all three are requested at once. The
+    // geofence and rally point reads must have started before the mission read was acked.
+    _connectMockLink(MAV_AUTOPILOT_ARDUPILOTMEGA);
+    QVERIFY(_vehicle->firmwarePlugin()->concurrentPlanReads());
+    QVERIFY(_vehicle->initialPlanRequestComplete());
+    QVERIFY(_vehicle->isInitialConnectComplete());
+    QCOMPARE(_mockLink->missionItemHandler()->maxConcurrentReads(), 3);
+    _disconnectMockLink();
+
+    // PX4 handles one transaction at a time, so the plan types are read one after the other
+    _connectMockLink(MAV_AUTOPILOT_PX4);
+    QVERIFY(!_vehicle->firmwarePlugin()->concurrentPlanReads());
+    QVERIFY(_vehicle->initialPlanRequestComplete());
+    QCOMPARE(_mockLink->missionItemHandler()->maxConcurrentReads(), 1);
+    _disconnectMockLink();
+}
@@ -20,4 +20,5 @@ class InitialConnectTest : public UnitTest
 private slots:
     void _performTestCases(void);
     void _boardVendorProductId(void);
+    void _concurrentPlanLoad(void);
 };
@@ -391,6 +391,7 @@ void Vehicle::_commonInit()
 
     _standardModes                  = new StandardModes                 (this, this);
     _componentInformationManager    = new ComponentInformationManager   (this);
+    _initialConnectProfile          = new InitialConnectProfile         (this);
     _initialConnectStateMachine     = new InitialConnectStateMachine    (this);
     _ftpManager                     = new FTPManager                    (this);
     _imageProtocolManager           = new ImageProtocolManager          ();
@@ -640,6 +641,8 @@ void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t mes
     // We give the link manager first whack since it it reponsible for adding new links
     _vehicleLinkManager->mavlinkMessageReceived(link, message);
 
+    _initialConnectProfile->messageReceived(message);
+
     //-- Check link status
     _messagesReceived++;
     emit messagesReceivedChanged();
@@ -1939,6 +1942,7 @@ bool Vehicle::sendMessageOnLinkThreadSafe(LinkInterface* link, mavlink_message_t
     int len = mavlink_msg_to_send_buffer(buffer, &message);
 
     link->writeBytesThreadSafe((const char*)buffer, len);
+    _initialConnectProfile->messageSent(message, len);
     _messagesSent++;
     emit messagesSentChanged();
 
@@ -2448,21 +2452,19 @@ void Vehicle::_gotProgressUpdate(float progressValue)
 void Vehicle::_firstMissionLoadComplete()
 {
     disconnect(_missionManager, &MissionManager::newMissionItemsAvailable, this, &Vehicle::_firstMissionLoadComplete);
-    _initialConnectStateMachine->advance();
+    _initialConnectStateMachine->planLoadComplete(MAV_MISSION_TYPE_MISSION);
 }
 
 void Vehicle::_firstGeoFenceLoadComplete()
 {
     disconnect(_geoFenceManager, &GeoFenceManager::loadComplete, this, &Vehicle::_firstGeoFenceLoadComplete);
-    _initialConnectStateMachine->advance();
+    _initialConnectStateMachine->planLoadComplete(MAV_MISSION_TYPE_FENCE);
 }
 
 void Vehicle::_firstRallyPointLoadComplete()
 {
     disconnect(_rallyPointManager, &RallyPointManager::loadComplete, this, &Vehicle::_firstRallyPointLoadComplete);
-    _initialPlanRequestComplete = true;
-    emit initialPlanRequestCompleteChanged(true);
-    _initialConnectStateMachine->advance();
+    _initialConnectStateMachine->planLoadComplete(MAV_MISSION_TYPE_RALLY);
 }
 
 void Vehicle::_parametersReady(bool parametersReady)
@@ -98,6 +98,9 @@ MockLink::MockLink(SharedLinkConfigurationPtr& config)
     _vehicleLongitude   = _defaultVehicleLongitude + ((_vehicleSystemId - 128) * 0.0001);
     _boardVendorId      = mockConfig->boardVendorId();
     _boardProductId     = mockConfig->boardProductId();
+    _simulatedLatencyMsecs = mockConfig->simulatedLatencyMsecs();
+    _simulatedLossPct   = mockConfig->simulatedLossPct();
+    _simulatedLossRandom.seed(1);
 
     QObject::connect(this, &MockLink::writeBytesQueuedSignal, this, &MockLink::_writeBytesQueued, Qt::QueuedConnection);
 
@@ -543,6 +546,28 @@ void MockLink::_sendVibration(void)
 }
 
 void MockLink::respondWithMavlinkMessage(const mavlink_message_t& msg)
+{
+    if (_simulateLinkLoss()) {
+        return;
+    }
+
+    if (_simulatedLatencyMsecs > 0) {
+        QTimer::singleShot(_simulatedLatencyMsecs, this, [this, msg]() { _sendMavlinkMessage(msg); });
+    } else {
+        _sendMavlinkMessage(msg);
+    }
+}
+
+bool MockLink::_simulateLinkLoss(void)
+{
+    if (_simulatedLossPct <= 0) {
+        return false;
+    }
+    QMutexLocker lock(&_simulatedLossMutex);
+    return static_cast<int>(_simulatedLossRandom.bounded(100)) < _simulatedLossPct;
+}
+
+void MockLink::_sendMavlinkMessage(const mavlink_message_t& msg)
 {
     if (!_commLost) {
         uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
@@ -621,6 +646,10 @@ void MockLink::_handleIncomingMavlinkBytes(const uint8_t* bytes, int cBytes)
 
 void MockLink::_handleIncomingMavlinkMsg(const mavlink_message_t &msg)
 {
+    if (_simulateLinkLoss()) {
+        return;
+    }
+
     if (_missionItemHandler.handleMessage(msg)) {
         return;
     }
@@ -1422,6 +1451,8 @@ MockConfiguration::MockConfiguration(MockConfiguration* source)
     _sendStatusText     = source->_sendStatusText;
     _incrementVehicleId = source->_incrementVehicleId;
     _failureMode        = source->_failureMode;
+    _simulatedLatencyMsecs = source->_simulatedLatencyMsecs;
+    _simulatedLossPct   = source->_simulatedLossPct;
 }
 
 void MockConfiguration::copyFrom(LinkConfiguration *source)
@@ -1439,6 +1470,8 @@ void MockConfiguration::copyFrom(LinkConfiguration *source)
     _sendStatusText     = usource->_sendStatusText;
     _incrementVehicleId = usource->_incrementVehicleId;
     _failureMode        = usource->_failureMode;
+    _simulatedLatencyMsecs = usource->_simulatedLatencyMsecs;
+    _simulatedLossPct   = usource->_simulatedLossPct;
 }
 
 void MockConfiguration::saveSettings(QSettings& settings, const QString& root)
@@ -1629,32 +1662,53 @@ void MockLink::_handleLogRequestData(const mavlink_message_t& msg)
     _logDownloadBytesRemaining = request.count;
 }
 
+void MockLink::setLogDownloadSimulation(uint32_t fileSize, int lossPct, int packetsPerTick)
+{
+    if (!_logDownloadFilename.isEmpty()) {
+        QFile::remove(_logDownloadFilename);
+        _logDownloadFilename.clear();
+    }
+    _logDownloadFileSize        = fileSize;
+    _logDownloadLossPct         = lossPct;
+    _logDownloadPacketsPerTick  = qMax(packetsPerTick, 1);
+    _logDownloadBytesRemaining  = 0;
+
+    // Fixed seed so a test always sees the same loss pattern
+    _logDownloadLossRandom.seed(1);
+}
+
 void MockLink::_logDownloadWorker(void)
 {
     if (_logDownloadBytesRemaining != 0) {
         QFile file(_logDownloadFilename);
         if (file.open(QIODevice::ReadOnly)) {
-            uint8_t buffer[MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN];
-
-            qint64 bytesToRead = qMin(_logDownloadBytesRemaining, (uint32_t)MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
-            Q_ASSERT(file.seek(_logDownloadCurrentOffset));
-            Q_ASSERT(file.read((char *)buffer, bytesToRead) == bytesToRead);
-
-            qCDebug(MockLinkLog) << "_logDownloadWorker" << _logDownloadCurrentOffset << _logDownloadBytesRemaining;
-
-            mavlink_message_t responseMsg;
-            mavlink_msg_log_data_pack_chan(_vehicleSystemId,
-                                           _vehicleComponentId,
-                                           mavlinkChannel(),
-                                           &responseMsg,
-                                           _logDownloadLogId,
-                                           _logDownloadCurrentOffset,
-                                           bytesToRead,
-                                           &buffer[0]);
-            respondWithMavlinkMessage(responseMsg);
-
-            _logDownloadCurrentOffset += bytesToRead;
-            _logDownloadBytesRemaining -= bytesToRead;
+            for (int i=0; i<_logDownloadPacketsPerTick && _logDownloadBytesRemaining != 0; i++) {
+                uint8_t buffer[MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN];
+
+                qint64 bytesToRead = qMin(_logDownloadBytesRemaining, (uint32_t)MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
+                Q_ASSERT(file.seek(_logDownloadCurrentOffset));
+                Q_ASSERT(file.read((char *)buffer, bytesToRead) == bytesToRead);
+
+                qCDebug(MockLinkLog) << "_logDownloadWorker" << _logDownloadCurrentOffset << _logDownloadBytesRemaining;
+
+                if (_logDownloadLossPct > 0 && static_cast<int>(_logDownloadLossRandom.bounded(100)) < _logDownloadLossPct) {
+                    qCDebug(MockLinkLog) << "_logDownloadWorker simulated loss" << _logDownloadCurrentOffset;
+                } else {
+                    mavlink_message_t responseMsg;
+                    mavlink_msg_log_data_pack_chan(_vehicleSystemId,
+                                                   _vehicleComponentId,
+                                                   mavlinkChannel(),
+                                                   &responseMsg,
+                                                   _logDownloadLogId,
+                                                   _logDownloadCurrentOffset,
+                                                   bytesToRead,
+                                                   &buffer[0]);
+                    respondWithMavlinkMessage(responseMsg);
+                }
+
+                _logDownloadCurrentOffset += bytesToRead;
+                _logDownloadBytesRemaining -= bytesToRead;
+            }
 
             file.close();
         } else {
@@ -14,6 +14,7 @@
 #include <QLoggingCategory>
 #include <QMap>
 #include <QMutex>
+#include <QRandomGenerator>
 
 #include "MockLinkMissionItemHandler.h"
 #include "MockLinkFTP.h"
@@ -53,6 +54,12 @@ public:
 
     void            setFirmwareType     (MAV_AUTOPILOT firmwareType)    { _firmwareType = firmwareType; emit firmwareChanged(); }
     void            setBoardVendorProduct(uint16_t vendorId, uint16_t productId) { _boardVendorId = vendorId; _boardProductId = productId; }
+
+    /// Simulates a slow and lossy link. Latency is added to every message sent by the vehicle, loss applies to messages in
+    /// both directions. Losses are reproducible since they are based on a fixed seed.
+    void            setLinkSimulation   (int latencyMsecs, int lossPct) { _simulatedLatencyMsecs = latencyMsecs; _simulatedLossPct = lossPct; }
+    int             simulatedLatencyMsecs(void) const                   { return _simulatedLatencyMsecs; }
+    int             simulatedLossPct    (void) const                    { return _simulatedLossPct; }
     void            setVehicleType      (MAV_TYPE vehicleType)          { _vehicleType = vehicleType; emit vehicleChanged(); }
     void            setSendStatusText   (bool sendStatusText)           { _sendStatusText = sendStatusText; emit sendStatusChanged(); }
 
@@ -91,6 +98,8 @@ private:
     bool            _incrementVehicleId = true;
     uint16_t        _boardVendorId      = 0;
     uint16_t        _boardProductId     = 0;
+    int             _simulatedLatencyMsecs = 0;
+    int             _simulatedLossPct   = 0;
 
     static const char* _firmwareTypeKey;
     static const char* _vehicleTypeKey;
@@ -149,9 +158,23 @@ public:
     /// Reset the state of the MissionItemHandler to no items, no transactions in progress.
     void resetMissionItemHandler(void) { _missionItemHandler.reset(); }
 
+    /// Simulates latency and loss for mission protocol messages
+    void setMissionItemLinkSimulation(int latencyMsecs, int lossPct) { _missionItemHandler.setLinkSimulation(latencyMsecs, lossPct); }
+
+    MockLinkMissionItemHandler* missionItemHandler(void) { return &_missionItemHandler; }
+
     /// Returns the filename for the simulated log file. Only available after a download is requested.
     QString logDownloadFile(void) { return _logDownloadFilename; }
 
+    /// Configures the simulated log file and link for log download
+    ///     @param fileSize Size of the simulated log file
+    ///     @param lossPct Percentage of LOG_DATA messages dropped
+    ///     @param packetsPerTick Number of LOG_DATA messages sent per 500Hz tick
+    void setLogDownloadSimulation(uint32_t fileSize, int lossPct, int packetsPerTick);
+
+    /// Changes the link simulation of a running link, see MockConfiguration::setLinkSimulation
+    void setLinkSimulation(int latencyMsecs, int lossPct) { _simulatedLatencyMsecs = latencyMsecs; _simulatedLossPct = lossPct; }
+
     Q_INVOKABLE void setCommLost                    (bool commLost)   { _commLost = commLost; }
     Q_INVOKABLE void simulateConnectionRemoved      (void);
     static MockLink* startPX4MockLink               (bool sendStatusText, MockConfiguration::FailureMode_t failureMode = MockConfiguration::FailNone);
@@ -215,6 +238,8 @@ private:
     void _handleIncomingNSHBytes        (const char* bytes, int cBytes);
     void _handleIncomingMavlinkBytes    (const uint8_t* bytes, int cBytes);
     void _handleIncomingMavlinkMsg      (const mavlink_message_t& msg);
+    void _sendMavlinkMessage            (const mavlink_message_t& msg);
+    bool _simulateLinkLoss              (void);
     void _loadParams                    (void);
     void _handleHeartBeat               (const mavlink_message_t& msg);
     void _handleSetMode                 (const mavlink_message_t& msg);
@@ -282,6 +307,10 @@ private:
     double                      _vehicleLongitude;
     double                      _vehicleAltitude;
     bool                        _commLost                       = false;
+    int                         _simulatedLatencyMsecs          = 0;
+    int                         _simulatedLossPct               = 0;
+    QRandomGenerator            _simulatedLossRandom;
+    QMutex                      _simulatedLossMutex;            ///< Messages are sent from the worker thread as well
     bool                        _highLatencyTransmissionEnabled = true;
 
     // These are just set for reporting the fields in _respondWithAutopilotVersion()
@@ -303,11 +332,14 @@ private:
     int _currentParamRequestListParamIndex;     // Current parameter index for param request list workflow
 
     static const uint16_t _logDownloadLogId = 0;        ///< Id of siumulated log file
-    static const uint32_t _logDownloadFileSize = 1000;  ///< Size of simulated log file
 
-    QString     _logDownloadFilename;       ///< Filename for log download which is in progress
-    uint32_t    _logDownloadCurrentOffset;  ///< Current offset we are sending from
-    uint32_t    _logDownloadBytesRemaining; ///< Number of bytes still to send, 0 = send inactive
+    QString             _logDownloadFilename;               ///< Filename for log download which is in progress
+    uint32_t            _logDownloadCurrentOffset;          ///< Current offset we are sending from
+    uint32_t            _logDownloadBytesRemaining;         ///< Number of bytes still to send, 0 = send inactive
+    uint32_t            _logDownloadFileSize =      1000;   ///< Size of simulated log file
+    int                 _logDownloadLossPct =       0;
+    int                 _logDownloadPacketsPerTick = 1;
+    QRandomGenerator    _logDownloadLossRandom;
 
     QGeoCoordinate  _adsbVehicleCoordinate;
     double          _adsbAngle;
@@ -14,6 +14,7 @@
 
 #include <QStringList>
 #include <QFile>
+#include <QMap>
 
 class MockLink;
 
@@ -56,6 +57,9 @@ public:
     void enableRandromDrops(bool enable) { _randomDropsEnabled = enable; }
     void enableBinParamFile(bool enable) { _BinParamFileEnabled = enable; }
 
+    /// @return Contents of a file uploaded through kCmdCreateFile/kCmdWriteFile
+    QByteArray uploadedFile(const QString& path) const { return _uploadedFiles.value(path); }
+
     static const char* sizeFilenamePrefix;
 
 signals:
@@ -74,6 +78,8 @@ private:
     void        _openCommand            (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
     void        _readCommand            (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
     void        _burstReadCommand          (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
+    void        _createCommand          (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
+    void        _writeCommand           (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
     void        _terminateCommand       (uint8_t senderSystemId, uint8_t senderComponentId, MavlinkFTP::Request* request, uint16_t seqNumber);
     void        _resetCommand           (uint8_t senderSystemId, uint8_t senderComponentId, uint16_t seqNumber);
     uint16_t    _nextSeqNumber          (uint16_t seqNumber);
@@ -94,6 +100,8 @@ private:
     mavlink_message_t       _lastReply;
     bool                    _randomDropsEnabled = false;
     bool                    _BinParamFileEnabled = false;
+    QString                 _uploadPath;                        ///< File written to by kCmdWriteFile
+    QMap<QString, QByteArray> _uploadedFiles;
 
     static const uint8_t    _sessionId          = 1;    ///< We only support a single fixed session
 };
@@ -39,11 +39,68 @@ void MockLinkMissionItemHandler::_startMissionItemResponseTimer(void)
         _missionItemResponseTimer = new QTimer();
         connect(_missionItemResponseTimer, &QTimer::timeout, this, &MockLinkMissionItemHandler::_missionItemResponseTimeout);
     }
-    _missionItemResponseTimer->start(500);
+    // On a lossy link the request is retried like an autopilot would, instead of failing
+    _missionItemResponseTimer->start(_simulatedLossPct > 0 ? 100 + (2 * _simulatedLatencyMsecs) : 500);
+}
+
+void MockLinkMissionItemHandler::setLinkSimulation(int latencyMsecs, int lossPct)
+{
+    _simulatedLatencyMsecs  = latencyMsecs;
+    _simulatedLossPct       = lossPct;
+
+    // Fixed seed so test runs see the same losses
+    _simulatedLossRandom.seed(1);
+}
+
+bool MockLinkMissionItemHandler::_simulateLoss(void)
+{
+    return _simulatedLossPct > 0 && static_cast<int>(_simulatedLossRandom.bounded(100)) < _simulatedLossPct;
+}
+
+void MockLinkMissionItemHandler::_respondWithMavlinkMessage(const mavlink_message_t& msg, bool allowLoss)
+{
+    // Items sent back for read requests are no longer in flight once they leave, or are lost
+    const bool readResponse = msg.msgid == MAVLINK_MSG_ID_MISSION_ITEM_INT;
+
+    if (allowLoss && _simulateLoss()) {
+        qCDebug(MockLinkMissionItemHandlerLog) << "_respondWithMavlinkMessage simulating loss of msgid" << msg.msgid;
+        if (readResponse) {
+            _readRequestsInFlight--;
+        }
+        return;
+    }
+
+    if (_simulatedLatencyMsecs > 0) {
+        QTimer::singleShot(_simulatedLatencyMsecs, _mockLink, [this, msg, readResponse]() {
+            if (readResponse) {
+                _readRequestsInFlight--;
+            }
+            _mockLink->respondWithMavlinkMessage(msg);
+        });
+    } else {
+        if (readResponse) {
+            _readRequestsInFlight--;
+        }
+        _mockLink->respondWithMavlinkMessage(msg);
+    }
 }
 
 bool MockLinkMissionItemHandler::handleMessage(const mavlink_message_t& msg)
 {
+    switch (msg.msgid) {
+    case MAVLINK_MSG_ID_MISSION_REQUEST_LIST:
+    case MAVLINK_MSG_ID_MISSION_REQUEST_INT:
+    case MAVLINK_MSG_ID_MISSION_ITEM_INT:
+    case MAVLINK_MSG_ID_MISSION_COUNT:
+        if (_simulateLoss()) {
+            qCDebug(MockLinkMissionItemHandlerLog) << "handleMessage simulating loss of msgid" << msg.msgid;
+            return true;
+        }
+        break;
+    default:
+        break;
+    }
+
     switch (msg.msgid) {
     case MAVLINK_MSG_ID_MISSION_REQUEST_LIST:
         _handleMissionRequestList(msg);
@@ -62,8 +119,13 @@ bool MockLinkMissionItemHandler::handleMessage(const mavlink_message_t& msg)
         break;
 
     case MAVLINK_MSG_ID_MISSION_ACK:
-        // Acks are received back for each MISSION_ITEM message
+    {
+        // Acks are received back for each MISSION_ITEM message, the ack of a read ends it
+        mavlink_mission_ack_t ack;
+        mavlink_msg_mission_ack_decode(&msg, &ack);
+        _readsInProgress.remove(ack.mission_type);
         break;
+    }
 
     case MAVLINK_MSG_ID_MISSION_SET_CURRENT:
         // Sets the currently active mission item
@@ -135,6 +197,9 @@ void MockLinkMissionItemHandler::_handleMissionRequestList(const mavlink_message
 
         _requestType = (MAV_MISSION_TYPE)request.mission_type;
 
+        _readsInProgress.insert(_requestType);
+        _maxConcurrentReads = qMax(_maxConcurrentReads, _readsInProgress.count());
+
         int itemCount;
         switch (_requestType) {
         case MAV_MISSION_TYPE_MISSION:
@@ -163,7 +228,7 @@ void MockLinkMissionItemHandler::_handleMissionRequestList(const mavlink_message
                                             msg.compid,                 // Target is original sender
                                             itemCount,                  // Number of mission items
                                             _requestType);
-        _mockLink->respondWithMavlinkMessage(responseMsg);
+        _respondWithMavlinkMessage(responseMsg);
     }
 }
 
@@ -235,8 +300,10 @@ void MockLinkMissionItemHandler::_handleMissionRequest(const mavlink_message_t&
                                                    missionItemInt.autocontinue,
                                                    missionItemInt.param1, missionItemInt.param2, missionItemInt.param3, missionItemInt.param4,
                                                    missionItemInt.x, missionItemInt.y, missionItemInt.z,
-                                                   _requestType);
-            _mockLink->respondWithMavlinkMessage(responseMsg);
+                                                   request.mission_type);   // Reads of different types may be interleaved
+            _readRequestCount++;
+            _maxReadRequestsInFlight = qMax(_maxReadRequestsInFlight, ++_readRequestsInFlight);
+            _respondWithMavlinkMessage(responseMsg);
         }
     }
 }
@@ -316,7 +383,8 @@ void MockLinkMissionItemHandler::_requestNextMissionItem(int sequenceNumber)
                                                       _mavlinkProtocol->getComponentId(),
                                                       sequenceNumber,
                                                       _requestType);
-            _mockLink->respondWithMavlinkMessage(message);
+            _writeRequestCount++;
+            _respondWithMavlinkMessage(message);
 
             // If response with Mission Item doesn't come before timer fires it's an error
             _startMissionItemResponseTimer();
@@ -338,15 +406,14 @@ void MockLinkMissionItemHandler::_sendAck(MAV_MISSION_RESULT ackType)
                                       _mavlinkProtocol->getComponentId(),
                                       ackType,
                                       _requestType);
-    _mockLink->respondWithMavlinkMessage(message);
+    // Acks are not dropped, a lost final ack fails the transaction on both sides which would make loss testing unpredictable
+    _respondWithMavlinkMessage(message, false /* allowLoss */);
 }
 
 void MockLinkMissionItemHandler::_handleMissionItem(const mavlink_message_t& msg)
 {
     qCDebug(MockLinkMissionItemHandlerLog) << "_handleMissionItem write sequence";
     
-    _missionItemResponseTimer->stop();
-    
     MAV_MISSION_TYPE            missionType;
     uint16_t                    seq;
     mavlink_mission_item_int_t  missionItemInt;
@@ -354,6 +421,17 @@ void MockLinkMissionItemHandler::_handleMissionItem(const mavlink_message_t& msg
     mavlink_msg_mission_item_int_decode(&msg, &missionItemInt);
     missionType = static_cast<MAV_MISSION_TYPE>(missionItemInt.mission_type);
     seq = missionItemInt.seq;
+
+    if (seq != _writeSequenceIndex) {
+        _unrequestedItemCount++;
+    }
+    if (_simulatedLossPct > 0 && seq != _writeSequenceIndex) {
+        // Like a real autopilot, only accept the item we are waiting for. The response timer keeps running so it is requested again.
+        qCDebug(MockLinkMissionItemHandlerLog) << "_handleMissionItem dropping out of sequence item expected:actual" << _writeSequenceIndex << seq;
+        return;
+    }
+
+    _missionItemResponseTimer->stop();
     
     switch (missionType) {
     case MAV_MISSION_TYPE_MISSION:
@@ -393,6 +471,12 @@ void MockLinkMissionItemHandler::_handleMissionItem(const mavlink_message_t& msg
 
 void MockLinkMissionItemHandler::_missionItemResponseTimeout(void)
 {
+    if (_simulatedLossPct > 0) {
+        qCDebug(MockLinkMissionItemHandlerLog) << "_missionItemResponseTimeout requesting again" << _writeSequenceIndex;
+        _requestNextMissionItem(_writeSequenceIndex);
+        return;
+    }
+
     qWarning() << "Timeout waiting for next MISSION_ITEM_INT";
     Q_ASSERT(false);
 }
@@ -12,7 +12,9 @@
 
 #include <QObject>
 #include <QMap>
+#include <QSet>
 #include <QTimer>
+#include <QRandomGenerator>
 
 #include "QGCMAVLink.h"
 #include "QGCLoggingCategory.h"
@@ -65,6 +67,26 @@ public:
     ///     @param failureMode Type of failure to simulate
     ///     @param failureAckResult Error to send if one the ack error modes
     void setFailureMode(FailureMode_t failureMode, MAV_MISSION_RESULT failureAckResult);
+
+    /// Simulates a slow, lossy link for mission protocol messages. While loss is simulated the handler also behaves like
+    /// a real autopilot does on such a link: out of sequence items are dropped and unanswered requests are sent again.
+    ///     @param latencyMsecs Delay added to each message sent back to the ground station
+    ///     @param lossPct Percentage of messages dropped in each direction
+    void setLinkSimulation(int latencyMsecs, int lossPct);
+
+    /// Read request statistics, counted from the last resetReadRequestStats call
+    void    resetReadRequestStats       (void) { _readRequestCount = 0; _readRequestsInFlight = 0; _maxReadRequestsInFlight = 0; }
+    int     readRequestCount            (void) const { return _readRequestCount; }          ///< MISSION_REQUEST_INT answered with an item
+    int     maxReadRequestsInFlight     (void) const { return _maxReadRequestsInFlight; }   ///< Most requests received before their items were sent back
+
+    /// Write request statistics, counted from the last resetWriteRequestStats call
+    void    resetWriteRequestStats      (void) { _writeRequestCount = 0; _unrequestedItemCount = 0; }
+    int     writeRequestCount           (void) const { return _writeRequestCount; }         ///< MISSION_REQUEST_INT sent to ask for an item
+    int     unrequestedItemCount        (void) const { return _unrequestedItemCount; }      ///< Items received which were not the one requested
+
+    /// @return Most reads of different plan types in progress at once. A read starts with MISSION_REQUEST_LIST and ends
+    ///         when the ground station acks it.
+    int     maxConcurrentReads          (void) const { return _maxConcurrentReads; }
     
     /// Called to send a MISSION_ACK message while the MissionManager is in idle state
     void sendUnexpectedMissionAck(MAV_MISSION_RESULT ackType);
@@ -92,6 +114,8 @@ private:
     void _requestNextMissionItem        (int sequenceNumber);
     void _sendAck                       (MAV_MISSION_RESULT ackType);
     void _startMissionItemResponseTimer (void);
+    void _respondWithMavlinkMessage     (const mavlink_message_t& msg, bool allowLoss = true);
+    bool _simulateLoss                  (void);
 
 private:
     MockLink* _mockLink;
@@ -114,5 +138,15 @@ private:
     bool                _failReadRequestListFirstResponse;
     bool                _failReadRequest1FirstResponse;
     bool                _failWriteMissionCountFirstResponse;
+    int                 _simulatedLatencyMsecs =    0;
+    int                 _simulatedLossPct =         0;
+    QRandomGenerator    _simulatedLossRandom;
+    int                 _readRequestCount =         0;
+    int                 _readRequestsInFlight =     0;
+    int                 _maxReadRequestsInFlight =  0;
+    int                 _writeRequestCount =        0;
+    int                 _unrequestedItemCount =     0;
+    QSet<int>           _readsInProgress;           ///< MAV_MISSION_TYPE of each read not acked yet
+    int                 _maxConcurrentReads =       0;
 };
 
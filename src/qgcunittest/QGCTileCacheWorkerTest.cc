@@ -0,0 +1,567 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCTileCacheWorkerTest.h"
+#include "QGCMapEngine.h"
+#include "QGCTileCacheWorker.h"
+#include "QGCMapTileSet.h"
+#include "TerrainTile.h"
+
+#include <QElapsedTimer>
+#include <QSet>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStandardPaths>
+
+QGCTileCacheWorkerTest::QGCTileCacheWorkerTest()
+{
+    _databasePath = QStandardPaths::writableLocation(QStandardPaths::TempLocation) + QLatin1String("/QGCTileCacheWorkerTest.db");
+    _mbtilesPath = QStandardPaths::writableLocation(QStandardPaths::TempLocation) + QLatin1String("/QGCTileCacheWorkerTest.mbtiles");
+}
+
+void QGCTileCacheWorkerTest::init(void)
+{
+    UnitTest::init();
+
+    QFile::remove(_databasePath);
+    QFile::remove(_mbtilesPath);
+    _worker = new QGCCacheWorker();
+    _worker->setDatabaseFile(_databasePath);
+}
+
+void QGCTileCacheWorkerTest::cleanup(void)
+{
+    _worker->quit();
+    _worker->wait();
+    delete _worker;
+    _worker = nullptr;
+    QFile::remove(_databasePath);
+    QFile::remove(_mbtilesPath);
+
+    UnitTest::cleanup();
+}
+
+/// Initializes the database. The worker signals totals once the init task is complete.
+bool QGCTileCacheWorkerTest::_startWorker(void)
+{
+    QSignalSpy spyTotals(_worker, &QGCCacheWorker::updateTotals);
+    _worker->enqueueTask(new QGCMapTask(QGCMapTask::taskInit));
+    return spyTotals.wait(10000);
+}
+
+bool QGCTileCacheWorkerTest::_fetchTile(quint64 key)
+{
+    QGCFetchTileTask* task = new QGCFetchTileTask(key);
+    QSignalSpy spyFetched(task, &QGCFetchTileTask::tileFetched);
+    if (!_worker->enqueueTask(task) || !spyFetched.wait(60000)) {
+        return false;
+    }
+    delete spyFetched[0][0].value<QGCCacheTile*>();
+    return true;
+}
+
+/// Tasks run in order, so once a task queued now has run all earlier ones are complete and their writes committed
+bool QGCTileCacheWorkerTest::_waitForWorker(void)
+{
+    // No tile has key 0, the fetch always reports an error
+    QGCFetchTileTask* task = new QGCFetchTileTask(0);
+    QSignalSpy spyError(task, &QGCMapTask::error);
+    return _worker->enqueueTask(task) && spyError.wait(60000);
+}
+
+/// Creates a tile set of the test map type and saves those of its tiles which aren't in the cache yet
+QGCCachedTileSet* QGCTileCacheWorkerTest::_createTileSet(const QString& name, int zoom, double topleftLat, double topleftLon, double bottomRightLat, double bottomRightLon)
+{
+    const QString       type    = QStringLiteral("Bing Road");
+    const QGCTileSet    tiles   = QGCMapEngine::getTileCount(zoom, topleftLon, topleftLat, bottomRightLon, bottomRightLat, type);
+
+    QGCCachedTileSet* tileSet = new QGCCachedTileSet(name);
+    tileSet->setType(type);
+    tileSet->setMapTypeStr(type);
+    tileSet->setMinZoom(zoom);
+    tileSet->setMaxZoom(zoom);
+    tileSet->setTopleftLat(topleftLat);
+    tileSet->setTopleftLon(topleftLon);
+    tileSet->setBottomRightLat(bottomRightLat);
+    tileSet->setBottomRightLon(bottomRightLon);
+    tileSet->setTotalTileCount(static_cast<quint32>(tiles.tileCount));
+    QGCCreateTileSetTask* createTask = new QGCCreateTileSetTask(tileSet);
+    QSignalSpy spySaved(createTask, &QGCCreateTileSetTask::tileSetSaved);
+    if (!_worker->enqueueTask(createTask) || !spySaved.wait(10000)) {
+        return nullptr;
+    }
+    // Tiles already cached are shared by the set rather than saved again
+    for (int x=tiles.tileX0; x<=tiles.tileX1; x++) {
+        for (int y=tiles.tileY0; y<=tiles.tileY1; y++) {
+            _worker->enqueueTask(new QGCSaveTileTask(new QGCCacheTile(QGCMapEngine::getTileKey(type, x, y, zoom), _tileImage(x, y, zoom), QStringLiteral("png"), type, tileSet->id())));
+        }
+    }
+    return tileSet;
+}
+
+QList<QGCCachedTileSet*> QGCTileCacheWorkerTest::_fetchTileSets(void)
+{
+    QList<QGCCachedTileSet*> tileSets;
+    QGCFetchTileSetTask* task = new QGCFetchTileSetTask();
+    QSignalSpy spyFetched(task, &QGCFetchTileSetTask::tileSetFetched);
+    if (_worker->enqueueTask(task) && _waitForWorker()) {
+        for (const QList<QVariant>& args: spyFetched) {
+            tileSets.append(args[0].value<QGCCachedTileSet*>());
+        }
+    }
+    return tileSets;
+}
+
+/// Compares the totals the worker keeps up to date with what the database holds. The default set reports the totals
+/// of the whole cache as saved and those of its unique tiles as total.
+void QGCTileCacheWorkerTest::_compareTotals(void)
+{
+    const QList<QGCCachedTileSet*> tileSets = _fetchTileSets();
+    QVERIFY(!tileSets.isEmpty());
+
+    const QString uniqueTiles = QStringLiteral("S.tileID IN (SELECT tileID FROM SetTiles GROUP BY tileID HAVING COUNT(tileID) = 1)");
+    for (QGCCachedTileSet* tileSet: tileSets) {
+        const QString setTiles = QStringLiteral("FROM Tiles T JOIN SetTiles S ON T.tileID = S.tileID WHERE S.setID = %1").arg(tileSet->id());
+        const quint32 uniqueCount = _queryValue(_databasePath, QStringLiteral("SELECT COUNT(*) %1 AND %2").arg(setTiles, uniqueTiles)).toUInt();
+        const quint64 uniqueSize  = _queryValue(_databasePath, QStringLiteral("SELECT SUM(T.size) %1 AND %2").arg(setTiles, uniqueTiles)).toULongLong();
+        if (tileSet->defaultSet()) {
+            QCOMPARE(tileSet->savedTileCount(), _queryValue(_databasePath, QStringLiteral("SELECT COUNT(*) FROM Tiles")).toUInt());
+            QCOMPARE(tileSet->savedTileSize(),  _queryValue(_databasePath, QStringLiteral("SELECT SUM(size) FROM Tiles")).toULongLong());
+            QCOMPARE(tileSet->totalTileCount(), uniqueCount);
+            QCOMPARE(tileSet->totalTilesSize(), uniqueSize);
+        } else {
+            QCOMPARE(tileSet->savedTileCount(), _queryValue(_databasePath, QStringLiteral("SELECT COUNT(*) %1").arg(setTiles)).toUInt());
+            QCOMPARE(tileSet->savedTileSize(),  _queryValue(_databasePath, QStringLiteral("SELECT SUM(T.size) %1").arg(setTiles)).toULongLong());
+            QCOMPARE(tileSet->uniqueTileCount(), uniqueCount);
+            QCOMPARE(tileSet->uniqueTileSize(),  uniqueSize);
+        }
+    }
+    qDeleteAll(tileSets);
+}
+
+/// Runs a single value query through a separate connection. The worker must be stopped or waited for first, such
+/// that its writes are committed.
+QVariant QGCTileCacheWorkerTest::_queryValue(const QString& databasePath, const QString& sql)
+{
+    static const char* kConnectionName = "QGCTileCacheWorkerTest";
+
+    QVariant value;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), kConnectionName);
+        db.setDatabaseName(databasePath);
+        if (db.open()) {
+            QSqlQuery query(db);
+            if (query.exec(sql) && query.next()) {
+                value = query.value(0);
+            }
+            db.close();
+        }
+    }
+    QSqlDatabase::removeDatabase(kConnectionName);
+    return value;
+}
+
+/// Runs statements through a separate connection, used to set up databases in layouts the worker no longer creates
+bool QGCTileCacheWorkerTest::_execSql(const QString& databasePath, const QStringList& statements)
+{
+    static const char* kConnectionName = "QGCTileCacheWorkerTestSetup";
+
+    bool ok = false;
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), kConnectionName);
+        db.setDatabaseName(databasePath);
+        if (db.open()) {
+            QSqlQuery query(db);
+            ok = true;
+            for (const QString& statement: statements) {
+                if (!query.exec(statement)) {
+                    qWarning() << statement << query.lastError().text();
+                    ok = false;
+                    break;
+                }
+            }
+            db.close();
+        }
+    }
+    QSqlDatabase::removeDatabase(kConnectionName);
+    return ok;
+}
+
+int QGCTileCacheWorkerTest::_rowCount(const QString& table)
+{
+    const QVariant count = _queryValue(_databasePath, QStringLiteral("SELECT COUNT(*) FROM %1").arg(table));
+    return count.isValid() ? count.toInt() : -1;
+}
+
+/// Tile content which identifies the tile, so a tile stored at the wrong position is noticed
+QByteArray QGCTileCacheWorkerTest::_tileImage(int x, int y, int z)
+{
+    return QStringLiteral("tile %1/%2/%3").arg(z).arg(x).arg(y).toUtf8();
+}
+
+void QGCTileCacheWorkerTest::_saveTileThroughput_test(void)
+{
+    QVERIFY(_startWorker());
+
+    const QString       type = QStringLiteral("Bing Road");
+    const QByteArray    img(4096, 'x');
+    quint64             lastKey = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i=0; i<_cTilesBenchmark; i++) {
+        lastKey = QGCMapEngine::getTileKey(type, i % 1024, i / 1024, 10);
+        QVERIFY(_worker->enqueueTask(new QGCSaveTileTask(new QGCCacheTile(lastKey, img, QStringLiteral("png"), type))));
+    }
+
+    // Tasks are run in order, so once the last tile can be fetched all tiles are written
+    QVERIFY(_fetchTile(lastKey));
+    qint64 elapsedMsecs = qMax(timer.elapsed(), static_cast<qint64>(1));
+
+    qDebug() << "QGCTileCacheWorker saved" << _cTilesBenchmark << "tiles in" << elapsedMsecs << "msecs -"
+             << (_cTilesBenchmark * 1000.0) / elapsedMsecs << "tiles/sec";
+
+    // Every tile must have been stored, each with its default set entry
+    _worker->quit();
+    _worker->wait();
+    QCOMPARE(_rowCount(QStringLiteral("Tiles")), _cTilesBenchmark);
+    QCOMPARE(_rowCount(QStringLiteral("SetTiles")), _cTilesBenchmark);
+}
+
+void QGCTileCacheWorkerTest::_tileKey_test(void)
+{
+    const QString type1 = QStringLiteral("Bing Road");
+    const QString type2 = QStringLiteral("Bing Satellite");
+
+    // Every tile of the first few zoom levels gets its own key
+    QSet<quint64> keys;
+    int cTiles = 0;
+    for (int z=0; z<=5; z++) {
+        for (int x=0; x<(1 << z); x++) {
+            for (int y=0; y<(1 << z); y++) {
+                keys.insert(QGCMapEngine::getTileKey(type1, x, y, z));
+                keys.insert(QGCMapEngine::getTileKey(type2, x, y, z));
+                cTiles += 2;
+            }
+        }
+    }
+    QCOMPARE(keys.count(), cTiles);
+
+    // Map type is recovered from the key, also for the largest tile coordinates
+    const int maxZoom = static_cast<int>(MAX_MAP_ZOOM);
+    const int maxTile = (1 << maxZoom) - 1;
+    QCOMPARE(getQGCMapEngine()->tileKeyToType(QGCMapEngine::getTileKey(type1, maxTile, maxTile, maxZoom)), type1);
+    QCOMPARE(getQGCMapEngine()->tileKeyToType(QGCMapEngine::getTileKey(type2, 0, 0, 0)), type2);
+    QVERIFY(QGCMapEngine::getTileKey(type1, maxTile, maxTile, maxZoom) < QGCMapEngine::getTileKey(type1, 0, 0, 0) + (Q_UINT64_C(1) << 47));
+}
+
+void QGCTileCacheWorkerTest::_elevationTileKey_test(void)
+{
+    // Elevation tiles are a flat lat/lon grid with far more columns than a quadtree has at the zoom level terrain
+    // queries use. Each tile and its neighbours must still get distinct keys which map back to the same tile.
+    const QString   elevationType   = UrlFactory::kCopernicusElevationProviderKey;
+    const int       zoom            = 1;
+    UrlFactory*     urlFactory      = getQGCMapEngine()->urlFactory();
+    const int       maxX            = urlFactory->long2tileX(elevationType, 179.999, zoom);
+    const int       maxY            = urlFactory->lat2tileY(elevationType, 89.999, zoom);
+    QVERIFY(maxX > (1 << zoom));
+
+    const QList<QPair<int, int>> tiles = { { 0, 0 }, { 1, 1 }, { 18000, 9000 }, { maxX - 1, maxY - 1 } };
+    for (const QPair<int, int>& tile: tiles) {
+        QSet<quint64> keys;
+        for (int dx=0; dx<=1; dx++) {
+            for (int dy=0; dy<=1; dy++) {
+                const int       x   = tile.first + dx;
+                const int       y   = tile.second + dy;
+                const quint64   key = QGCMapEngine::getTileKey(elevationType, x, y, zoom);
+                keys.insert(key);
+
+                int keyX, keyY, keyZ;
+                QVERIFY(QGCMapEngine::getTileFromKey(key, keyX, keyY, keyZ));
+                QCOMPARE(keyX, x);
+                QCOMPARE(keyY, y);
+                QCOMPARE(getQGCMapEngine()->tileKeyToType(key), elevationType);
+            }
+        }
+        QCOMPARE(keys.count(), 4);
+    }
+
+    // The coordinates terrain queries use for neighbouring cells end up in different tiles
+    const QGeoCoordinate    coord(47.3971, 8.5456);
+    const QGeoCoordinate    eastCoord(coord.latitude(), coord.longitude() + TerrainTile::tileSizeDegrees);
+    const QGeoCoordinate    northCoord(coord.latitude() + TerrainTile::tileSizeDegrees, coord.longitude());
+    auto keyForCoord = [&](const QGeoCoordinate& c) {
+        return QGCMapEngine::getTileKey(elevationType, urlFactory->long2tileX(elevationType, c.longitude(), zoom), urlFactory->lat2tileY(elevationType, c.latitude(), zoom), zoom);
+    };
+    QVERIFY(keyForCoord(coord) != keyForCoord(eastCoord));
+    QVERIFY(keyForCoord(coord) != keyForCoord(northCoord));
+    QVERIFY(keyForCoord(eastCoord) != keyForCoord(northCoord));
+}
+
+void QGCTileCacheWorkerTest::_mbtilesRoundTrip_test(void)
+{
+    QVERIFY(_startWorker());
+
+    const QString   type    = QStringLiteral("Bing Road");
+    const int       zoom    = 3;
+
+    // A tile set which holds a 2x3 block of tiles
+    QGCCachedTileSet* tileSet = new QGCCachedTileSet(QStringLiteral("Export Set"));
+    tileSet->setType(type);
+    tileSet->setMapTypeStr(type);
+    tileSet->setMinZoom(zoom);
+    tileSet->setMaxZoom(zoom);
+    QGCCreateTileSetTask* createTask = new QGCCreateTileSetTask(tileSet);
+    QSignalSpy spySaved(createTask, &QGCCreateTileSetTask::tileSetSaved);
+    QVERIFY(_worker->enqueueTask(createTask));
+    QVERIFY(spySaved.wait(10000));
+
+    const int cTiles = 6;
+    quint64 lastKey = 0;
+    for (int x=1; x<=2; x++) {
+        for (int y=2; y<=4; y++) {
+            lastKey = QGCMapEngine::getTileKey(type, x, y, zoom);
+            QVERIFY(_worker->enqueueTask(new QGCSaveTileTask(new QGCCacheTile(lastKey, _tileImage(x, y, zoom), QStringLiteral("png"), type, tileSet->id()))));
+        }
+    }
+    QVERIFY(_fetchTile(lastKey));
+
+    QGCExportTileTask* exportTask = new QGCExportTileTask({ tileSet }, _mbtilesPath);
+    QSignalSpy spyExported(exportTask, &QGCExportTileTask::actionCompleted);
+    QSignalSpy spyExportError(exportTask, &QGCMapTask::error);
+    QVERIFY(_worker->enqueueTask(exportTask));
+    QVERIFY(spyExported.wait(10000));
+    QCOMPARE(spyExportError.count(), 0);
+
+    // Rows are numbered bottom up (TMS) and the metadata names the map type and zoom range
+    QCOMPARE(_queryValue(_mbtilesPath, QStringLiteral("SELECT COUNT(*) FROM tiles")).toInt(), cTiles);
+    QCOMPARE(_queryValue(_mbtilesPath, QStringLiteral("SELECT tile_data FROM tiles WHERE zoom_level = %1 AND tile_column = 1 AND tile_row = %2").arg(zoom).arg((1 << zoom) - 1 - 2)).toByteArray(), _tileImage(1, 2, zoom));
+    QCOMPARE(_queryValue(_mbtilesPath, QStringLiteral("SELECT tile_data FROM tiles WHERE zoom_level = %1 AND tile_column = 2 AND tile_row = %2").arg(zoom).arg((1 << zoom) - 1 - 4)).toByteArray(), _tileImage(2, 4, zoom));
+    QCOMPARE(_queryValue(_mbtilesPath, QStringLiteral("SELECT value FROM metadata WHERE name = 'qgc_map_type'")).toString(), type);
+    QCOMPARE(_queryValue(_mbtilesPath, QStringLiteral("SELECT value FROM metadata WHERE name = 'name'")).toString(), tileSet->name());
+    QCOMPARE(_queryValue(_mbtilesPath, QStringLiteral("SELECT value FROM metadata WHERE name = 'minzoom'")).toInt(), zoom);
+    QCOMPARE(_queryValue(_mbtilesPath, QStringLiteral("SELECT value FROM metadata WHERE name = 'maxzoom'")).toInt(), zoom);
+
+    // Importing next to the original gives a new set which shares the cached tiles
+    QGCImportTileTask* importTask = new QGCImportTileTask(_mbtilesPath, false /* replace */);
+    QSignalSpy spyImported(importTask, &QGCImportTileTask::actionCompleted);
+    QSignalSpy spyImportError(importTask, &QGCMapTask::error);
+    QVERIFY(_worker->enqueueTask(importTask));
+    QVERIFY(spyImported.wait(10000));
+    QCOMPARE(spyImportError.count(), 0);
+
+    _worker->quit();
+    _worker->wait();
+    delete tileSet;
+
+    const QString importedSet = QStringLiteral("FROM TileSets WHERE name = 'Export Set 01'");
+    QCOMPARE(_queryValue(_databasePath, QStringLiteral("SELECT typeStr %1").arg(importedSet)).toString(), type);
+    QCOMPARE(_queryValue(_databasePath, QStringLiteral("SELECT numTiles %1").arg(importedSet)).toInt(), cTiles);
+    QCOMPARE(_queryValue(_databasePath, QStringLiteral("SELECT minZoom %1").arg(importedSet)).toInt(), zoom);
+    QCOMPARE(_queryValue(_databasePath, QStringLiteral("SELECT COUNT(*) FROM SetTiles WHERE setID = (SELECT setID %1)").arg(importedSet)).toInt(), cTiles);
+    QCOMPARE(_rowCount(QStringLiteral("Tiles")), cTiles);
+
+    // Each tile is back at its own position
+    const QString tileQuery = QStringLiteral("SELECT tile FROM Tiles WHERE tileKey = %1");
+    QCOMPARE(_queryValue(_databasePath, tileQuery.arg(QGCMapEngine::getTileKey(type, 1, 2, zoom))).toByteArray(), _tileImage(1, 2, zoom));
+    QCOMPARE(_queryValue(_databasePath, tileQuery.arg(QGCMapEngine::getTileKey(type, 2, 4, zoom))).toByteArray(), _tileImage(2, 4, zoom));
+}
+
+void QGCTileCacheWorkerTest::_mbtilesForeignImport_test(void)
+{
+    // MBTiles written by other tools don't record a map type, their tiles are stored as the map type the caller picks
+    const QString   type = QStringLiteral("Bing Satellite");
+    const int       zoom = 2;
+    QVERIFY(_execSql(_mbtilesPath, {
+        QStringLiteral("CREATE TABLE metadata (name TEXT, value TEXT)"),
+        QStringLiteral("CREATE TABLE tiles (zoom_level INTEGER, tile_column INTEGER, tile_row INTEGER, tile_data BLOB)"),
+        QStringLiteral("INSERT INTO metadata(name, value) VALUES('name', 'Foreign'), ('format', 'jpg')"),
+        QStringLiteral("INSERT INTO tiles(zoom_level, tile_column, tile_row, tile_data) VALUES(%1, 1, 0, x'%2'), (%1, 2, 3, x'%3')")
+            .arg(zoom).arg(QString(_tileImage(1, 3, zoom).toHex())).arg(QString(_tileImage(2, 0, zoom).toHex())),
+    }));
+
+    QVERIFY(_startWorker());
+
+    // Without a map type there is nothing to file the tiles under
+    QGCImportTileTask* rejectedTask = new QGCImportTileTask(_mbtilesPath, false /* replace */);
+    QSignalSpy spyRejectedError(rejectedTask, &QGCMapTask::error);
+    QVERIFY(_worker->enqueueTask(rejectedTask));
+    QVERIFY(spyRejectedError.wait(10000));
+
+    QGCImportTileTask* importTask = new QGCImportTileTask(_mbtilesPath, false /* replace */, type);
+    QSignalSpy spyImported(importTask, &QGCImportTileTask::actionCompleted);
+    QSignalSpy spyImportError(importTask, &QGCMapTask::error);
+    QVERIFY(_worker->enqueueTask(importTask));
+    QVERIFY(spyImported.wait(10000));
+    QCOMPARE(spyImportError.count(), 0);
+
+    // The tiles can be read back at their (flipped TMS) position as tiles of the chosen map type
+    for (const QPoint& tile: { QPoint(1, 3), QPoint(2, 0) }) {
+        QGCFetchTileTask* fetchTask = new QGCFetchTileTask(QGCMapEngine::getTileKey(type, tile.x(), tile.y(), zoom));
+        QSignalSpy spyFetched(fetchTask, &QGCFetchTileTask::tileFetched);
+        QVERIFY(_worker->enqueueTask(fetchTask));
+        QVERIFY(spyFetched.wait(10000));
+        QScopedPointer<QGCCacheTile> cacheTile(spyFetched[0][0].value<QGCCacheTile*>());
+        QCOMPARE(cacheTile->img(), _tileImage(tile.x(), tile.y(), zoom));
+        QCOMPARE(cacheTile->format(), QStringLiteral("jpg"));
+    }
+
+    _worker->quit();
+    _worker->wait();
+    QCOMPARE(_rowCount(QStringLiteral("Tiles")), 2);
+    QCOMPARE(_queryValue(_databasePath, QStringLiteral("SELECT typeStr FROM TileSets WHERE name = 'Foreign'")).toString(), type);
+    QCOMPARE(_queryValue(_databasePath, QStringLiteral("SELECT numTiles FROM TileSets WHERE name = 'Foreign'")).toInt(), 2);
+}
+
+void QGCTileCacheWorkerTest::_migrateDB_test(void)
+{
+    const QString   type        = QStringLiteral("Bing Road");
+    const int       zoom        = 3;
+    const int       mapId       = getQGCMapEngine()->urlFactory()->getIdFromType(type);
+    const int       unknownId   = 999999999;
+    auto hash = [](int id, int x, int y, int z) {
+        return QString::asprintf("%010d%08d%08d%03d", id, x, y, z);
+    };
+
+    // A cache as written before tiles were keyed by integer: tile 1 is in the default set only, tile 2 is shared by
+    // the default set and set 2, tile 3 is in set 2 only and tile 4 belongs to a map type which no longer exists.
+    QVERIFY(_execSql(_databasePath, {
+        QStringLiteral("CREATE TABLE Tiles (tileID INTEGER PRIMARY KEY NOT NULL, hash TEXT NOT NULL UNIQUE, format TEXT NOT NULL, tile BLOB NULL, size INTEGER, type INTEGER, date INTEGER DEFAULT 0)"),
+        QStringLiteral("CREATE TABLE TileSets (setID INTEGER PRIMARY KEY NOT NULL, name TEXT NOT NULL UNIQUE, typeStr TEXT, topleftLat REAL DEFAULT 0.0, topleftLon REAL DEFAULT 0.0, bottomRightLat REAL DEFAULT 0.0, bottomRightLon REAL DEFAULT 0.0, minZoom INTEGER DEFAULT 3, maxZoom INTEGER DEFAULT 3, type INTEGER DEFAULT -1, numTiles INTEGER DEFAULT 0, defaultSet INTEGER DEFAULT 0, date INTEGER DEFAULT 0)"),
+        QStringLiteral("CREATE TABLE SetTiles (setID INTEGER, tileID INTEGER)"),
+        QStringLiteral("CREATE TABLE TilesDownload (setID INTEGER, hash TEXT NOT NULL UNIQUE, type INTEGER, x INTEGER, y INTEGER, z INTEGER, state INTEGER DEFAULT 0)"),
+        QStringLiteral("INSERT INTO TileSets(setID, name, defaultSet) VALUES(1, 'Default Tile Set', 1), (2, 'Old Set', 0)"),
+        QStringLiteral("INSERT INTO Tiles(tileID, hash, format, tile, size, type) VALUES(1, '%1', 'png', x'01', 10, %2), (2, '%3', 'png', x'02', 20, %2), (3, '%4', 'png', x'03', 30, %2), (4, '%5', 'png', x'04', 40, %6)")
+            .arg(hash(mapId, 1, 2, zoom)).arg(mapId).arg(hash(mapId, 2, 2, zoom)).arg(hash(mapId, 3, 2, zoom)).arg(hash(unknownId, 4, 2, zoom)).arg(unknownId),
+        QStringLiteral("INSERT INTO SetTiles(setID, tileID) VALUES(1, 1), (1, 2), (2, 2), (2, 3), (1, 4)"),
+        QStringLiteral("INSERT INTO TilesDownload(setID, hash, type, x, y, z, state) VALUES(2, '%1', %2, 3, 2, %3, 0), (2, '%4', %2, 4, 2, %3, 0), (2, '%5', %6, 5, 2, %3, 0)")
+            .arg(hash(mapId, 3, 2, zoom)).arg(mapId).arg(zoom).arg(hash(mapId, 4, 2, zoom)).arg(hash(unknownId, 5, 2, zoom)).arg(unknownId),
+    }));
+
+    // Totals are computed from the migrated tables: three tiles, of which tile 1 is unique to the default set
+    QSignalSpy spyTotals(_worker, &QGCCacheWorker::updateTotals);
+    QVERIFY(_worker->enqueueTask(new QGCMapTask(QGCMapTask::taskInit)));
+    QVERIFY(spyTotals.wait(10000));
+    const QList<QVariant> totals = spyTotals.last();
+    QCOMPARE(totals[0].toUInt(), 3u);
+    QCOMPARE(totals[1].toULongLong(), Q_UINT64_C(60));
+    QCOMPARE(totals[2].toUInt(), 1u);
+    QCOMPARE(totals[3].toULongLong(), Q_UINT64_C(10));
+
+    // Tiles are found by their new key
+    QVERIFY(_fetchTile(QGCMapEngine::getTileKey(type, 1, 2, zoom)));
+    QVERIFY(_fetchTile(QGCMapEngine::getTileKey(type, 3, 2, zoom)));
+
+    _worker->quit();
+    _worker->wait();
+
+    // Tile IDs are kept, so set membership is unchanged apart from the dropped tile
+    QCOMPARE(_rowCount(QStringLiteral("Tiles")), 3);
+    for (int tileID=1; tileID<=3; tileID++) {
+        QCOMPARE(_queryValue(_databasePath, QStringLiteral("SELECT tileKey FROM Tiles WHERE tileID = %1").arg(tileID)).toULongLong(), QGCMapEngine::getTileKey(type, tileID, 2, zoom));
+    }
+    QCOMPARE(_queryValue(_databasePath, QStringLiteral("SELECT tile FROM Tiles WHERE tileID = 2")).toByteArray(), QByteArray(1, '\x02'));
+    QCOMPARE(_rowCount(QStringLiteral("SetTiles")), 4);
+    QCOMPARE(_queryValue(_databasePath, QStringLiteral("SELECT GROUP_CONCAT(tileID) FROM (SELECT tileID FROM SetTiles WHERE setID = 1 ORDER BY tileID)")).toString(), QStringLiteral("1,2"));
+    QCOMPARE(_queryValue(_databasePath, QStringLiteral("SELECT GROUP_CONCAT(tileID) FROM (SELECT tileID FROM SetTiles WHERE setID = 2 ORDER BY tileID)")).toString(), QStringLiteral("2,3"));
+
+    // Pending downloads are rekeyed as well
+    QCOMPARE(_rowCount(QStringLiteral("TilesDownload")), 2);
+    QCOMPARE(_queryValue(_databasePath, QStringLiteral("SELECT COUNT(*) FROM TilesDownload WHERE setID = 2 AND tileKey IN (%1, %2)").arg(QGCMapEngine::getTileKey(type, 3, 2, zoom)).arg(QGCMapEngine::getTileKey(type, 4, 2, zoom))).toInt(), 2);
+}
+
+void QGCTileCacheWorkerTest::_tileSetTotals_test(void)
+{
+    QVERIFY(_startWorker());
+
+    const QString   type = QStringLiteral("Bing Road");
+    const int       zoom = 4;
+
+    // Tiles browsed into the default set, then two sets which overlap each other and the browsed tiles. Set totals
+    // are only updated incrementally from here on.
+    for (int x=6; x<=9; x++) {
+        QVERIFY(_worker->enqueueTask(new QGCSaveTileTask(new QGCCacheTile(QGCMapEngine::getTileKey(type, x, 6, zoom), _tileImage(x, 6, zoom), QStringLiteral("png"), type))));
+    }
+    QScopedPointer<QGCCachedTileSet> setA(_createTileSet(QStringLiteral("Set A"), zoom, 60.0, -100.0, 10.0, -10.0));
+    QVERIFY(setA);
+    QScopedPointer<QGCCachedTileSet> setB(_createTileSet(QStringLiteral("Set B"), zoom, 40.0, -50.0, -20.0, 40.0));
+    QVERIFY(setB);
+    QVERIFY(_waitForWorker());
+
+    // The sets must really share tiles with each other and with the default set for the test to mean anything
+    const QString sharedTiles = QStringLiteral("SELECT COUNT(*) FROM SetTiles A JOIN SetTiles B ON A.tileID = B.tileID WHERE A.setID = %1 AND B.setID = %2");
+    QVERIFY(_queryValue(_databasePath, sharedTiles.arg(setA->id()).arg(setB->id())).toInt() > 0);
+    QVERIFY(_queryValue(_databasePath, sharedTiles.arg(setB->id()).arg(1)).toInt() > 0);
+    _compareTotals();
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    // Tiles shared by the deleted set and one other set become unique to the other set
+    QGCDeleteTileSetTask* deleteTask = new QGCDeleteTileSetTask(setA->id());
+    QSignalSpy spyDeleted(deleteTask, &QGCDeleteTileSetTask::tileSetDeleted);
+    QVERIFY(_worker->enqueueTask(deleteTask));
+    QVERIFY(spyDeleted.wait(10000));
+    QVERIFY(_waitForWorker());
+    QCOMPARE(_queryValue(_databasePath, QStringLiteral("SELECT COUNT(*) FROM SetTiles WHERE setID = %1").arg(setA->id())).toInt(), 0);
+    _compareTotals();
+}
+
+void QGCTileCacheWorkerTest::_pruneCache_test(void)
+{
+    QVERIFY(_startWorker());
+
+    const QString   type        = QStringLiteral("Bing Road");
+    const int       zoom        = 4;
+    const int       cTiles      = 10;
+    const int       tileSize    = 100;
+    auto tileKey = [&](int x) {
+        return QGCMapEngine::getTileKey(type, x, 0, zoom);
+    };
+
+    for (int x=0; x<cTiles; x++) {
+        QVERIFY(_worker->enqueueTask(new QGCSaveTileTask(new QGCCacheTile(tileKey(x), QByteArray(tileSize, 'x'), QStringLiteral("png"), type))));
+    }
+    QVERIFY(_fetchTile(tileKey(cTiles - 1)));
+    _worker->quit();
+    _worker->wait();
+
+    // Tiles were last used in the order they were saved, long ago
+    QVERIFY(_execSql(_databasePath, { QStringLiteral("UPDATE Tiles SET access = 1000 + tileID") }));
+    QCOMPARE(_queryValue(_databasePath, QStringLiteral("SELECT tileID FROM Tiles WHERE tileKey = %1").arg(tileKey(0))).toInt(), 1);
+
+    // Reading the oldest tile only records the hit in memory while more tasks are queued. The prune queued right
+    // behind it must still see it as the most recently used tile.
+    QGCFetchTileTask* fetchTask = new QGCFetchTileTask(tileKey(0));
+    QSignalSpy spyFetched(fetchTask, &QGCFetchTileTask::tileFetched);
+    QGCPruneCacheTask* pruneTask = new QGCPruneCacheTask(static_cast<quint64>(tileSize * 4 + tileSize / 2));
+    QSignalSpy spyPruned(pruneTask, &QGCPruneCacheTask::pruned);
+    QVERIFY(_worker->enqueueTask(fetchTask));
+    QVERIFY(_worker->enqueueTask(pruneTask));
+    QVERIFY(spyPruned.wait(10000));
+    QCOMPARE(spyFetched.count(), 1);
+    delete spyFetched[0][0].value<QGCCacheTile*>();
+
+    _worker->quit();
+    _worker->wait();
+
+    // The five least recently used tiles are evicted, the tile just read and the newer ones are kept
+    QCOMPARE(_rowCount(QStringLiteral("Tiles")), cTiles - 5);
+    QCOMPARE(_rowCount(QStringLiteral("SetTiles")), cTiles - 5);
+    const QString tileCount = QStringLiteral("SELECT COUNT(*) FROM Tiles WHERE tileKey = %1");
+    QCOMPARE(_queryValue(_databasePath, tileCount.arg(tileKey(0))).toInt(), 1);
+    for (int x=1; x<=5; x++) {
+        QCOMPARE(_queryValue(_databasePath, tileCount.arg(tileKey(x))).toInt(), 0);
+    }
+    for (int x=6; x<cTiles; x++) {
+        QCOMPARE(_queryValue(_databasePath, tileCount.arg(tileKey(x))).toInt(), 1);
+    }
+    QVERIFY(_queryValue(_databasePath, QStringLiteral("SELECT access FROM Tiles WHERE tileKey = %1").arg(tileKey(0))).toLongLong() > 1000 + cTiles);
+}
@@ -0,0 +1,56 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class QGCCacheWorker;
+class QGCCachedTileSet;
+
+/// Exercises the map tile cache database and reports tile write throughput
+class QGCTileCacheWorkerTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    QGCTileCacheWorkerTest();
+
+protected slots:
+    void init   (void) override;
+    void cleanup(void) override;
+
+private slots:
+    void _saveTileThroughput_test(void);
+    void _tileKey_test           (void);
+    void _elevationTileKey_test  (void);
+    void _mbtilesRoundTrip_test  (void);
+    void _mbtilesForeignImport_test(void);
+    void _migrateDB_test           (void);
+    void _tileSetTotals_test       (void);
+    void _pruneCache_test          (void);
+
+private:
+    bool        _startWorker    (void);
+    bool        _fetchTile      (quint64 key);
+    bool        _waitForWorker  (void);
+    QGCCachedTileSet* _createTileSet(const QString& name, int zoom, double topleftLat, double topleftLon, double bottomRightLat, double bottomRightLon);
+    QList<QGCCachedTileSet*> _fetchTileSets(void);
+    void        _compareTotals  (void);
+    int         _rowCount       (const QString& table);
+    QVariant    _queryValue     (const QString& databasePath, const QString& sql);
+    bool        _execSql        (const QString& databasePath, const QStringList& statements);
+    QByteArray  _tileImage      (int x, int y, int z);
+
+    QString         _databasePath;
+    QString         _mbtilesPath;
+    QGCCacheWorker* _worker = nullptr;
+
+    static const int _cTilesBenchmark = 5000;
+};
@@ -0,0 +1,139 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCTileDownloadSchedulerTest.h"
+#include "QGCTileDownloadScheduler.h"
+
+#include <QTcpSocket>
+
+const char* QGCTileDownloadSchedulerTest::_providerType = "Test Provider";
+
+QGCTileDownloadSchedulerTest::QGCTileDownloadSchedulerTest()
+{
+    connect(&_server, &QTcpServer::newConnection, this, &QGCTileDownloadSchedulerTest::_newConnection);
+}
+
+void QGCTileDownloadSchedulerTest::init(void)
+{
+    UnitTest::init();
+
+    _requestedPaths.clear();
+    QVERIFY(_server.listen(QHostAddress::LocalHost));
+    _scheduler = new QGCTileDownloadScheduler();
+}
+
+void QGCTileDownloadSchedulerTest::cleanup(void)
+{
+    delete _scheduler;
+    _scheduler = nullptr;
+    _server.close();
+
+    UnitTest::cleanup();
+}
+
+/// Minimal HTTP server standing in for a tile provider: responds to each GET with the requested path as the body
+void QGCTileDownloadSchedulerTest::_newConnection(void)
+{
+    while (_server.hasPendingConnections()) {
+        QTcpSocket* socket = _server.nextPendingConnection();
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+            const QByteArray buffer = socket->property("buffer").toByteArray() + socket->readAll();
+            if (buffer.indexOf("\r\n\r\n") < 0) {
+                socket->setProperty("buffer", buffer);
+                return;
+            }
+            const QByteArray path = buffer.left(buffer.indexOf("\r\n")).split(' ').value(1);
+            _requestedPaths.append(QString::fromLatin1(path));
+            socket->write("HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nConnection: close\r\nContent-Length: " +
+                          QByteArray::number(path.size()) + "\r\n\r\n" + path);
+            socket->disconnectFromHost();
+        });
+    }
+}
+
+QNetworkRequest QGCTileDownloadSchedulerTest::_tileRequest(const QString& path)
+{
+    return QNetworkRequest(QUrl(QStringLiteral("http://127.0.0.1:%1%2").arg(_server.serverPort()).arg(path)));
+}
+
+void QGCTileDownloadSchedulerTest::_viewportPriority_test(void)
+{
+    // Two slots: one shared, one reserved for the viewport. Bulk downloads therefore run one at a time.
+    _scheduler->setMaxConcurrent(_providerType, 2);
+
+    QList<QGCTileDownload*> bulkDownloads;
+    for (int i=0; i<3; i++) {
+        bulkDownloads.append(_scheduler->download(_providerType, i, _tileRequest(QStringLiteral("/bulk/%1").arg(i)), QGCTileDownloadScheduler::PriorityBulk));
+    }
+    QGCTileDownload* viewportDownload = _scheduler->download(_providerType, 100, _tileRequest(QStringLiteral("/viewport")), QGCTileDownloadScheduler::PriorityViewport);
+
+    QCOMPARE(_scheduler->inFlightCount(), 2);
+    QCOMPARE(_scheduler->queueDepth(QGCTileDownloadScheduler::PriorityBulk), 2);
+    QCOMPARE(_scheduler->queueDepth(QGCTileDownloadScheduler::PriorityViewport), 0);
+
+    QSignalSpy spyViewport(viewportDownload, &QGCTileDownload::finished);
+    QSignalSpy spyLastBulk(bulkDownloads.last(), &QGCTileDownload::finished);
+    QVERIFY(spyViewport.count() || spyViewport.wait(10000));
+    QVERIFY(spyLastBulk.count() || spyLastBulk.wait(10000));
+
+    QCOMPARE(spyViewport[0][0].toByteArray(), QByteArray("/viewport"));
+    QCOMPARE(spyViewport[0][1].value<QNetworkReply::NetworkError>(), QNetworkReply::NoError);
+    QCOMPARE(_requestedPaths.count(), 4);
+    QVERIFY(_requestedPaths.indexOf(QStringLiteral("/viewport")) < _requestedPaths.indexOf(QStringLiteral("/bulk/1")));
+    QCOMPARE(_requestedPaths.last(), QStringLiteral("/bulk/2"));
+
+    QCOMPARE(_scheduler->inFlightCount(), 0);
+    QCOMPARE(_scheduler->queueDepth(QGCTileDownloadScheduler::PriorityBulk), 0);
+    QVERIFY(_scheduler->averageLatencyMsecs(QGCTileDownloadScheduler::PriorityViewport) >= 0);
+
+    qDeleteAll(bulkDownloads);
+    delete viewportDownload;
+}
+
+void QGCTileDownloadSchedulerTest::_duplicateRequest_test(void)
+{
+    QGCTileDownload* prefetchDownload    = _scheduler->download(_providerType, 1, _tileRequest(QStringLiteral("/tile")), QGCTileDownloadScheduler::PriorityPrefetch);
+    QGCTileDownload* viewportDownload    = _scheduler->download(_providerType, 1, _tileRequest(QStringLiteral("/tile")), QGCTileDownloadScheduler::PriorityViewport);
+
+    QSignalSpy spyPrefetch(prefetchDownload, &QGCTileDownload::finished);
+    QSignalSpy spyViewport(viewportDownload, &QGCTileDownload::finished);
+    QVERIFY(spyViewport.wait(10000));
+
+    QCOMPARE(spyPrefetch.count(), 1);
+    QCOMPARE(spyPrefetch[0][0].toByteArray(), QByteArray("/tile"));
+    QCOMPARE(spyViewport[0][0].toByteArray(), QByteArray("/tile"));
+    QCOMPARE(_requestedPaths, QStringList(QStringLiteral("/tile")));
+
+    delete prefetchDownload;
+    delete viewportDownload;
+}
+
+void QGCTileDownloadSchedulerTest::_cancelQueued_test(void)
+{
+    _scheduler->setMaxConcurrent(_providerType, 1);
+
+    QGCTileDownload* firstDownload   = _scheduler->download(_providerType, 1, _tileRequest(QStringLiteral("/first")), QGCTileDownloadScheduler::PriorityBulk);
+    QGCTileDownload* cancelDownload  = _scheduler->download(_providerType, 2, _tileRequest(QStringLiteral("/cancel")), QGCTileDownloadScheduler::PriorityBulk);
+    QGCTileDownload* lastDownload    = _scheduler->download(_providerType, 3, _tileRequest(QStringLiteral("/last")), QGCTileDownloadScheduler::PriorityBulk);
+    QCOMPARE(_scheduler->queueDepth(QGCTileDownloadScheduler::PriorityBulk), 2);
+
+    QSignalSpy spyCancel(cancelDownload, &QGCTileDownload::finished);
+    QSignalSpy spyLast(lastDownload, &QGCTileDownload::finished);
+    cancelDownload->cancel();
+    QCOMPARE(_scheduler->queueDepth(QGCTileDownloadScheduler::PriorityBulk), 1);
+
+    QVERIFY(spyLast.wait(10000));
+    QCOMPARE(spyCancel.count(), 0);
+    QCOMPARE(_requestedPaths, QStringList({ QStringLiteral("/first"), QStringLiteral("/last") }));
+
+    delete firstDownload;
+    delete cancelDownload;
+    delete lastDownload;
+}
@@ -0,0 +1,45 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+#include <QTcpServer>
+#include <QNetworkRequest>
+
+class QGCTileDownloadScheduler;
+
+/// Runs the tile download scheduler against a local HTTP server standing in for a tile provider
+class QGCTileDownloadSchedulerTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    QGCTileDownloadSchedulerTest();
+
+protected slots:
+    void init   (void) override;
+    void cleanup(void) override;
+
+private slots:
+    void _viewportPriority_test (void);
+    void _duplicateRequest_test (void);
+    void _cancelQueued_test     (void);
+
+private:
+    void            _newConnection  (void);
+    QNetworkRequest _tileRequest    (const QString& path);
+
+    QTcpServer                  _server;
+    QStringList                 _requestedPaths;
+    QGCTileDownloadScheduler*   _scheduler = nullptr;
+
+    static const char*          _providerType;
+};
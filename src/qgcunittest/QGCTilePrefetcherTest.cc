@@ -0,0 +1,124 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCTilePrefetcherTest.h"
+#include "QGCTilePrefetcher.h"
+#include "QGCMapEngine.h"
+
+const char* QGCTilePrefetcherTest::_mapType = "Bing Road";
+
+QGCTilePrefetcherTest::QGCTilePrefetcherTest()
+{
+
+}
+
+void QGCTilePrefetcherTest::init(void)
+{
+    UnitTest::init();
+
+    _prefetcher = new QGCTilePrefetcher(this);
+    _prefetcher->setBuffer(300);
+    _prefetcher->setZoomRange(13, 19);
+    _prefetcher->setMaxTiles(100000);
+}
+
+void QGCTilePrefetcherTest::cleanup(void)
+{
+    _prefetcher->cancel();
+    delete _prefetcher;
+    _prefetcher = nullptr;
+
+    UnitTest::cleanup();
+}
+
+/// Prefetches around a single point and cancels before anything is downloaded
+quint32 QGCTilePrefetcherTest::_pointTileCount(double buffer, double altitude)
+{
+    _prefetcher->setBuffer(buffer);
+    _prefetcher->addPath({ QGeoCoordinate(47.3971, 8.5456, altitude) });
+    _prefetcher->start(_mapType);
+    _prefetcher->cancel();
+    return _prefetcher->tileCount();
+}
+
+void QGCTilePrefetcherTest::_maxZoomForAltitude_test(void)
+{
+    // Detail stops increasing close to the ground, an unknown altitude is treated as being on the ground
+    QCOMPARE(QGCTilePrefetcher::maxZoomForAltitude(0), QGCTilePrefetcher::maxZoomForAltitude(10));
+    QCOMPARE(QGCTilePrefetcher::maxZoomForAltitude(qQNaN()), QGCTilePrefetcher::maxZoomForAltitude(0));
+    QVERIFY(QGCTilePrefetcher::maxZoomForAltitude(0) <= static_cast<int>(MAX_MAP_ZOOM));
+
+    // Higher altitudes need less detail, by one zoom level for each doubling
+    QCOMPARE(QGCTilePrefetcher::maxZoomForAltitude(200) - QGCTilePrefetcher::maxZoomForAltitude(400), 1);
+    int lastZoom = QGCTilePrefetcher::maxZoomForAltitude(0);
+    for (double altitude=50; altitude<1e7; altitude*=2) {
+        const int zoom = QGCTilePrefetcher::maxZoomForAltitude(altitude);
+        QVERIFY(zoom <= lastZoom);
+        lastZoom = zoom;
+    }
+    QCOMPARE(lastZoom, 1);
+}
+
+void QGCTilePrefetcherTest::_pathTiles_test(void)
+{
+    QSignalSpy spyRunning(_prefetcher, &QGCTilePrefetcher::runningChanged);
+
+    const QList<QGeoCoordinate> path = { QGeoCoordinate(47.3971, 8.5456, 50), QGeoCoordinate(47.4071, 8.5556, 50) };
+    _prefetcher->addPath(path);
+    _prefetcher->start(_mapType);
+    QVERIFY(_prefetcher->running());
+    const quint32 pathTileCount = _prefetcher->tileCount();
+    QVERIFY(pathTileCount > 0);
+    _prefetcher->cancel();
+    QVERIFY(!_prefetcher->running());
+    QCOMPARE(spyRunning.count(), 2);
+    QCOMPARE(_prefetcher->completedCount(), 0u);
+
+    // Paths are used up by start, a restart without new ones has nothing to fetch
+    _prefetcher->start(_mapType);
+    QCOMPARE(_prefetcher->tileCount(), 0u);
+    QVERIFY(!_prefetcher->running());
+
+    // The path covers more than either of its ends
+    const quint32 pointTileCount = _pointTileCount(300, 50);
+    QVERIFY(pointTileCount > 0);
+    QVERIFY(pathTileCount > pointTileCount);
+
+    // A wider buffer and a lower altitude both need more tiles
+    QVERIFY(_pointTileCount(1000, 50) > pointTileCount);
+    QVERIFY(_pointTileCount(300, 2000) < pointTileCount);
+}
+
+void QGCTilePrefetcherTest::_areaTiles_test(void)
+{
+    const QGeoRectangle area(QGeoCoordinate(47.41, 8.53), QGeoCoordinate(47.39, 8.56));
+
+    _prefetcher->addArea(area, 50);
+    _prefetcher->start(_mapType);
+    _prefetcher->cancel();
+    const quint32 areaTileCount = _prefetcher->tileCount();
+    QVERIFY(areaTileCount > 0);
+
+    // The area is at least as large as a prefetch around its center
+    QVERIFY(areaTileCount >= _pointTileCount(300, 50));
+
+    // Invalid areas are ignored
+    _prefetcher->addArea(QGeoRectangle(), 50);
+    _prefetcher->start(_mapType);
+    QCOMPARE(_prefetcher->tileCount(), 0u);
+}
+
+void QGCTilePrefetcherTest::_maxTiles_test(void)
+{
+    const quint32 tileCount = _pointTileCount(1000, 50);
+    QVERIFY(tileCount > 10);
+
+    _prefetcher->setMaxTiles(10);
+    QCOMPARE(_pointTileCount(1000, 50), 10u);
+}
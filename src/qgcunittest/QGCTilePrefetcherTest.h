@@ -0,0 +1,40 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class QGCTilePrefetcher;
+
+/// Checks which tiles the plan prefetcher collects. Each prefetch is cancelled before any tile is downloaded.
+class QGCTilePrefetcherTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    QGCTilePrefetcherTest();
+
+protected slots:
+    void init   (void) override;
+    void cleanup(void) override;
+
+private slots:
+    void _maxZoomForAltitude_test   (void);
+    void _pathTiles_test            (void);
+    void _areaTiles_test            (void);
+    void _maxTiles_test             (void);
+
+private:
+    quint32 _pointTileCount         (double buffer, double altitude);
+
+    QGCTilePrefetcher* _prefetcher = nullptr;
+
+    static const char* _mapType;
+};
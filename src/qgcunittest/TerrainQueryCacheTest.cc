@@ -0,0 +1,132 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainQueryCacheTest.h"
+#include "TerrainQueryCache.h"
+
+#include <QStandardPaths>
+
+static const char*  kDataVersion    = "TerrainQueryCacheTest:1";
+static const int    kMaxEntries     = 1000;
+static const qint64 kMaxBytes       = 1024 * 1024;
+
+TerrainQueryCacheTest::TerrainQueryCacheTest()
+{
+    _cacheFile = QStandardPaths::writableLocation(QStandardPaths::TempLocation) + QLatin1String("/TerrainQueryCacheTest.bin");
+}
+
+void TerrainQueryCacheTest::init(void)
+{
+    UnitTest::init();
+    QFile::remove(_cacheFile);
+}
+
+void TerrainQueryCacheTest::cleanup(void)
+{
+    QFile::remove(_cacheFile);
+    UnitTest::cleanup();
+}
+
+void TerrainQueryCacheTest::_coordinateHeights_test(void)
+{
+    TerrainQueryCache cache(_cacheFile, kDataVersion, kMaxEntries, kMaxBytes);
+
+    QList<QGeoCoordinate>   coordinates = { QGeoCoordinate(47.1, 8.1), QGeoCoordinate(47.2, 8.2) };
+    QList<double>           heights;
+    QVERIFY(!cache.lookupCoordinateHeights(coordinates, heights));
+
+    cache.insertCoordinateHeights(coordinates, { 410.5, 520.25 });
+    QCOMPARE(cache.count(), 2);
+    QVERIFY(cache.lookupCoordinateHeights(coordinates, heights));
+    QCOMPARE(heights, QList<double>({ 410.5, 520.25 }));
+
+    // All coordinates must be present for a hit
+    coordinates.append(QGeoCoordinate(47.3, 8.3));
+    QVERIFY(!cache.lookupCoordinateHeights(coordinates, heights));
+    QVERIFY(heights.isEmpty());
+}
+
+void TerrainQueryCacheTest::_pathHeights_test(void)
+{
+    TerrainQueryCache cache(_cacheFile, kDataVersion, kMaxEntries, kMaxBytes);
+
+    QGeoCoordinate  fromCoord(47.1, 8.1);
+    QGeoCoordinate  toCoord(47.2, 8.2);
+    double          distanceBetween         = 0;
+    double          finalDistanceBetween    = 0;
+    QList<double>   heights;
+    QVERIFY(!cache.lookupPathHeights(fromCoord, toCoord, distanceBetween, finalDistanceBetween, heights));
+
+    cache.insertPathHeights(fromCoord, toCoord, 30, 12.5, { 1, 2, 3 });
+    QVERIFY(cache.lookupPathHeights(fromCoord, toCoord, distanceBetween, finalDistanceBetween, heights));
+    QCOMPARE(distanceBetween, 30.0);
+    QCOMPARE(finalDistanceBetween, 12.5);
+    QCOMPARE(heights, QList<double>({ 1, 2, 3 }));
+
+    // Paths are directional
+    QVERIFY(!cache.lookupPathHeights(toCoord, fromCoord, distanceBetween, finalDistanceBetween, heights));
+}
+
+void TerrainQueryCacheTest::_persistence_test(void)
+{
+    QGeoCoordinate fromCoord(47.1, 8.1);
+    QGeoCoordinate toCoord(47.2, 8.2);
+    {
+        TerrainQueryCache cache(_cacheFile, kDataVersion, kMaxEntries, kMaxBytes);
+        cache.insertCoordinateHeights({ fromCoord }, { 410.5 });
+        cache.insertPathHeights(fromCoord, toCoord, 30, 12.5, { 1, 2, 3 });
+        cache.flush();
+    }
+
+    TerrainQueryCache   cache(_cacheFile, kDataVersion, kMaxEntries, kMaxBytes);
+    double              distanceBetween         = 0;
+    double              finalDistanceBetween    = 0;
+    QList<double>       heights;
+    QCOMPARE(cache.count(), 2);
+    QVERIFY(cache.lookupCoordinateHeights({ fromCoord }, heights));
+    QCOMPARE(heights, QList<double>({ 410.5 }));
+    QVERIFY(cache.lookupPathHeights(fromCoord, toCoord, distanceBetween, finalDistanceBetween, heights));
+    QCOMPARE(heights, QList<double>({ 1, 2, 3 }));
+}
+
+void TerrainQueryCacheTest::_dataVersion_test(void)
+{
+    {
+        TerrainQueryCache cache(_cacheFile, kDataVersion, kMaxEntries, kMaxBytes);
+        cache.insertCoordinateHeights({ QGeoCoordinate(47.1, 8.1) }, { 410.5 });
+        cache.flush();
+    }
+
+    // Results from other terrain data are discarded
+    TerrainQueryCache cache(_cacheFile, QStringLiteral("TerrainQueryCacheTest:2"), kMaxEntries, kMaxBytes);
+    QCOMPARE(cache.count(), 0);
+}
+
+void TerrainQueryCacheTest::_maxBytes_test(void)
+{
+    // Few but large path entries hit the byte limit long before the entry limit
+    const qint64    maxBytes = 64 * 1024;
+    QList<double>   heights;
+    for (int i=0; i<1000; i++) {
+        heights.append(i);
+    }
+
+    TerrainQueryCache cache(_cacheFile, kDataVersion, kMaxEntries, maxBytes);
+    for (int i=0; i<50; i++) {
+        cache.insertPathHeights(QGeoCoordinate(47, 8 + (i * 0.01)), QGeoCoordinate(47.1, 8 + (i * 0.01)), 30, 30, heights);
+        QVERIFY(cache.bytes() <= maxBytes);
+    }
+    QVERIFY(cache.count() > 0);
+    QVERIFY(cache.count() < 50);
+    cache.flush();
+
+    // The limit also applies to what is loaded back from disk
+    TerrainQueryCache smallerCache(_cacheFile, kDataVersion, kMaxEntries, 1024);
+    QVERIFY(smallerCache.bytes() <= 1024);
+}
@@ -0,0 +1,35 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Terrain query results are kept in memory, persisted to disk and bounded in size
+class TerrainQueryCacheTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    TerrainQueryCacheTest();
+
+protected slots:
+    void init   (void) override;
+    void cleanup(void) override;
+
+private slots:
+    void _coordinateHeights_test(void);
+    void _pathHeights_test      (void);
+    void _persistence_test      (void);
+    void _dataVersion_test      (void);
+    void _maxBytes_test         (void);
+
+private:
+    QString _cacheFile;
+};
@@ -0,0 +1,161 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TerrainQueryTest.h"
+#include "TerrainQuery.h"
+#include "TerrainTile.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+#include <QtMath>
+
+TerrainQueryTest::TerrainQueryTest()
+{
+
+}
+
+void TerrainQueryTest::_simplifyPathHeights_test(void)
+{
+    // Synthetic profile: a flat stretch, a steady climb, rolling hills and a cliff, with a short final segment
+    TerrainPathQuery::PathHeightInfo_t pathHeightInfo;
+    pathHeightInfo.distanceBetween      = 30.0;
+    pathHeightInfo.finalDistanceBetween = 12.0;
+    for (int i=0; i<100; i++) {
+        pathHeightInfo.heights.append(100.0);
+    }
+    for (int i=0; i<100; i++) {
+        pathHeightInfo.heights.append(100.0 + i * 0.75);
+    }
+    for (int i=0; i<200; i++) {
+        pathHeightInfo.heights.append(175.0 + 20.0 * qSin(i / 8.0));
+    }
+    pathHeightInfo.heights.append(400.0);
+    pathHeightInfo.heights.append(401.0);
+
+    const int cHeights = pathHeightInfo.heights.count();
+    auto distanceAtIndex = [&](int index) {
+        return index == cHeights - 1 ? ((index - 1) * pathHeightInfo.distanceBetween) + pathHeightInfo.finalDistanceBetween : index * pathHeightInfo.distanceBetween;
+    };
+
+    for (double maxError: { 0.5, TerrainPathQuery::simplifiedProfileMaxError, 5.0 }) {
+        const QList<QPointF> profile = TerrainPathQuery::simplifyPathHeights(pathHeightInfo, maxError);
+
+        // End points are kept and the profile is much smaller than the raw heights
+        QVERIFY(profile.count() >= 2);
+        QVERIFY(profile.count() < cHeights / 2);
+        QCOMPARE(profile.first(), QPointF(0.0, pathHeightInfo.heights.first()));
+        QCOMPARE(profile.last(), QPointF(distanceAtIndex(cHeights - 1), pathHeightInfo.heights.last()));
+
+        // Interpolating between the profile points never strays further than maxError from any raw height
+        int profileIndex = 0;
+        for (int i=0; i<cHeights; i++) {
+            const double distance = distanceAtIndex(i);
+            while (profile[profileIndex + 1].x() < distance) {
+                profileIndex++;
+            }
+            const QPointF& from   = profile[profileIndex];
+            const QPointF& to     = profile[profileIndex + 1];
+            QVERIFY(to.x() > from.x());
+            const double interpolated = from.y() + (to.y() - from.y()) * (distance - from.x()) / (to.x() - from.x());
+            QVERIFY2(qAbs(interpolated - pathHeightInfo.heights[i]) <= maxError + 1e-9, qPrintable(QStringLiteral("index %1 error %2 max %3").arg(i).arg(qAbs(interpolated - pathHeightInfo.heights[i])).arg(maxError)));
+        }
+    }
+
+    // A flat path needs nothing but its end points
+    TerrainPathQuery::PathHeightInfo_t flatPathHeightInfo;
+    flatPathHeightInfo.distanceBetween      = 30.0;
+    flatPathHeightInfo.finalDistanceBetween = 30.0;
+    flatPathHeightInfo.heights              = QList<double>({ 10.0, 10.0, 10.0, 10.0 });
+    QCOMPARE(TerrainPathQuery::simplifyPathHeights(flatPathHeightInfo, 1.0).count(), 2);
+}
+
+void TerrainQueryTest::_pathQueryToCoords_test(void)
+{
+    // A tile with a coarser grid than the nominal 1 arc-second one, and different cell sizes along lat and lon
+    const int       cRows       = 5;
+    const int       cColumns    = 20;
+    const double    swLat       = 47.0;
+    const double    swLon       = 8.0;
+    const double    cellSizeLat = TerrainTile::tileSizeDegrees / cRows;
+    const double    cellSizeLon = TerrainTile::tileSizeDegrees / cColumns;
+    QJsonArray carpet;
+    for (int row=0; row<cRows; row++) {
+        QJsonArray values;
+        for (int column=0; column<cColumns; column++) {
+            values.append(100 + row * cColumns + column);
+        }
+        carpet.append(values);
+    }
+    const QJsonObject data {
+        { "bounds", QJsonObject { { "sw", QJsonArray { swLat, swLon } }, { "ne", QJsonArray { swLat + TerrainTile::tileSizeDegrees, swLon + TerrainTile::tileSizeDegrees } } } },
+        { "stats",  QJsonObject { { "min", 100 }, { "max", 100 + cRows * cColumns }, { "avg", 150 } } },
+        { "carpet", carpet },
+    };
+    const TerrainTile tile(TerrainTile::serializeFromAirMapJson(QJsonDocument(QJsonObject { { "status", "success" }, { "data", data } }).toJson()));
+    QVERIFY(tile.isValid());
+    QCOMPARE(tile.cellSizeLat(), cellSizeLat);
+    QCOMPARE(tile.cellSizeLon(), cellSizeLon);
+
+    const QGeoCoordinate fromCoord(swLat + 0.0011, swLon + 0.0012);
+    const QGeoCoordinate toCoord(swLat + 0.0089, swLon + 0.0093);
+    double distanceBetween;
+    double finalDistanceBetween;
+    const QList<QGeoCoordinate> coords = TerrainTileManager::pathQueryToCoords(fromCoord, toCoord, distanceBetween, finalDistanceBetween, &tile);
+
+    // The path crosses 16 column boundaries over 16.2 columns, which takes 17 steps of at most one column each
+    QCOMPARE(coords.count(), 18);
+    QCOMPARE(coords.first(), fromCoord);
+    QCOMPARE(coords.last(), toCoord);
+    QVERIFY(distanceBetween > 0.0);
+    QVERIFY(finalDistanceBetween > 0.0 && finalDistanceBetween <= distanceBetween + 1e-6);
+
+    // Each step moves to a neighbouring cell at most, so every row and column between the end points is sampled
+    auto row    = [&](const QGeoCoordinate& coord) { return qFloor((coord.latitude() - swLat) / cellSizeLat); };
+    auto column = [&](const QGeoCoordinate& coord) { return qFloor((coord.longitude() - swLon) / cellSizeLon); };
+    QSet<int> rows;
+    QSet<int> columns;
+    for (int i=0; i<coords.count(); i++) {
+        rows.insert(row(coords[i]));
+        columns.insert(column(coords[i]));
+        if (i > 0) {
+            QVERIFY(qAbs(row(coords[i]) - row(coords[i - 1])) <= 1);
+            QVERIFY(qAbs(column(coords[i]) - column(coords[i - 1])) <= 1);
+        }
+    }
+    QCOMPARE(rows.count(), row(toCoord) - row(fromCoord) + 1);
+    QCOMPARE(columns.count(), column(toCoord) - column(fromCoord) + 1);
+
+    // Without a loaded tile the nominal 1 arc-second grid is assumed
+    const QList<QGeoCoordinate> nominalCoords = TerrainTileManager::pathQueryToCoords(fromCoord, toCoord, distanceBetween, finalDistanceBetween);
+    QCOMPARE(nominalCoords.count(), qCeil(0.0081 / TerrainTile::tileValueSpacingDegrees) + 1);
+}
+
+void TerrainQueryTest::_polyPathTooShort_test(void)
+{
+    TerrainPolyPathQuery query(false /* autoDelete */);
+
+    int     cResults    = 0;
+    bool    success     = true;
+    connect(&query, &TerrainPolyPathQuery::terrainDataReceived, this, [&](bool querySuccess, const QList<TerrainPathQuery::PathHeightInfo_t>& rgPathHeightInfo) {
+        cResults++;
+        success = querySuccess;
+        QVERIFY(rgPathHeightInfo.isEmpty());
+    });
+
+    // Callers waiting for the result must not hang when there is no path to query
+    query.requestData(QList<QGeoCoordinate>({ QGeoCoordinate(47.0, 8.0) }));
+    QCOMPARE(cResults, 1);
+    QCOMPARE(success, false);
+
+    query.requestData(QList<QGeoCoordinate>());
+    QCOMPARE(cResults, 2);
+    QCOMPARE(success, false);
+}
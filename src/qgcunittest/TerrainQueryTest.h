@@ -0,0 +1,26 @@
+/****************************************************************************
+ *
+ * (c) 2009-2020 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Terrain path sampling and the simplified height profile of path queries
+class TerrainQueryTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    TerrainQueryTest();
+
+private slots:
+    void _simplifyPathHeights_test  (void);
+    void _pathQueryToCoords_test    (void);
+    void _polyPathTooShort_test     (void);
+};
@@ -29,7 +29,11 @@
 //#include "FileManagerTest.h"
 #include "ParameterManagerTest.h"
 #include "MissionCommandTreeTest.h"
-//#include "LogDownloadTest.h"
+#include "LogDownloadTest.h"
+#include "GeoTagControllerTest.h"
+#include "ULogReaderTest.h"
+#include "LogAnalysisStoreTest.h"
+#include "MAVLinkTimeSeriesTest.h"
 #include "SendMavCommandWithSignallingTest.h"
 #include "SendMavCommandWithHandlerTest.h"
 #include "VisualMissionItemTest.h"
@@ -51,6 +55,12 @@
 #include "VehicleLinkManagerTest.h"
 #include "LandingComplexItemTest.h"
 #include "InitialConnectTest.h"
+#include "InitialConnectProfileTest.h"
+#include "QGCTileCacheWorkerTest.h"
+#include "QGCTileDownloadSchedulerTest.h"
+#include "QGCTilePrefetcherTest.h"
+#include "TerrainQueryCacheTest.h"
+#include "TerrainQueryTest.h"
 
 UT_REGISTER_TEST(ComponentInformationCacheTest)
 UT_REGISTER_TEST(ComponentInformationTranslationTest)
@@ -73,7 +83,11 @@ UT_REGISTER_TEST(MissionManagerTest)
 //UT_REGISTER_TEST(FileManagerTest)
 UT_REGISTER_TEST(ParameterManagerTest)
 UT_REGISTER_TEST(MissionCommandTreeTest)
-//UT_REGISTER_TEST(LogDownloadTest)
+UT_REGISTER_TEST(LogDownloadTest)
+UT_REGISTER_TEST(GeoTagControllerTest)
+UT_REGISTER_TEST(ULogReaderTest)
+UT_REGISTER_TEST(LogAnalysisStoreTest)
+UT_REGISTER_TEST(MAVLinkTimeSeriesTest)
 UT_REGISTER_TEST(SurveyComplexItemTest)
 UT_REGISTER_TEST(CameraSectionTest)
 UT_REGISTER_TEST(SpeedSectionTest)
@@ -88,8 +102,14 @@ UT_REGISTER_TEST(QGCMapPolylineTest)
 UT_REGISTER_TEST(CameraCalcTest)
 UT_REGISTER_TEST(FWLandingPatternTest)
 UT_REGISTER_TEST(LandingComplexItemTest)
+UT_REGISTER_TEST(QGCTileCacheWorkerTest)
+UT_REGISTER_TEST(QGCTileDownloadSchedulerTest)
+UT_REGISTER_TEST(QGCTilePrefetcherTest)
+UT_REGISTER_TEST(TerrainQueryCacheTest)
+UT_REGISTER_TEST(TerrainQueryTest)
 
 UT_REGISTER_TEST_STANDALONE(MissionCommandTreeEditorTest)
+UT_REGISTER_TEST_STANDALONE(InitialConnectProfileTest)
 
 // List of unit test which are currently disabled.
 // If disabling a new test, include reason in comment.
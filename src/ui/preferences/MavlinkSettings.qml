@@ -37,6 +37,7 @@ Rectangle {
     property var  _activeVehicle:       QGroundControl.multiVehicleManager.activeVehicle
     property bool _isPX4:               _activeVehicle ? _activeVehicle.px4Firmware : false
     property bool _isAPM:               _activeVehicle ? _activeVehicle.apmFirmware : false
+    property var  _connectProfile:      _activeVehicle ? _activeVehicle.initialConnectProfile : null
     property Fact _disableDataPersistenceFact: QGroundControl.settingsManager.appSettings.disableAllPersistence
     property bool _disableDataPersistence:     _disableDataPersistenceFact ? _disableDataPersistenceFact.rawValue : false
 
@@ -366,6 +367,51 @@ Rectangle {
                 }
             }
             //-----------------------------------------------------------------
+            //-- Connect Profile
+            Item {
+                width:              __mavlinkRoot.width * 0.8
+                height:             connectProfileLabel.height
+                anchors.margins:    ScreenTools.defaultFontPixelWidth
+                anchors.horizontalCenter: parent.horizontalCenter
+                visible:            _connectProfile && _connectProfile.report !== ""
+                QGCLabel {
+                    id:             connectProfileLabel
+                    text:           qsTr("Connect Profile (Current Vehicle)")
+                    font.family:    ScreenTools.demiboldFontFamily
+                }
+            }
+            Rectangle {
+                height:         connectProfileColumn.height + (ScreenTools.defaultFontPixelHeight * 2)
+                width:          __mavlinkRoot.width * 0.8
+                color:          qgcPal.windowShade
+                anchors.margins: ScreenTools.defaultFontPixelWidth
+                anchors.horizontalCenter: parent.horizontalCenter
+                visible:        _connectProfile && _connectProfile.report !== ""
+                Column {
+                    id:         connectProfileColumn
+                    spacing:    _columnSpacing
+                    anchors.centerIn: parent
+                    QGCLabel {
+                        text:           _connectProfile ? _connectProfile.report : ""
+                        font.family:    ScreenTools.fixedFontFamily
+                    }
+                    Row {
+                        spacing:    ScreenTools.defaultFontPixelWidth
+                        anchors.horizontalCenter: parent.horizontalCenter
+                        QGCButton {
+                            text:       qsTr("Save JSON")
+                            enabled:    _connectProfile && _connectProfile.complete && !_disableDataPersistence
+                            onClicked:  savedProfileLabel.text = _connectProfile.saveJson()
+                            anchors.verticalCenter: parent.verticalCenter
+                        }
+                        QGCLabel {
+                            id:         savedProfileLabel
+                            anchors.verticalCenter: parent.verticalCenter
+                        }
+                    }
+                }
+            }
+            //-----------------------------------------------------------------
             //-- Mavlink Logging
             Item {
                 width:              __mavlinkRoot.width * 0.8